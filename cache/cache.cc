@@ -64,6 +64,21 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    enable_custom_split_merge),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"cold_compression_type",
+         {offsetof(struct CompressedSecondaryCacheOptions,
+                   cold_compression_type),
+          OptionType::kCompressionType, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"compression_threads",
+         {offsetof(struct CompressedSecondaryCacheOptions,
+                   compression_threads),
+          OptionType::kInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"max_pending_compression_bytes",
+         {offsetof(struct CompressedSecondaryCacheOptions,
+                   max_pending_compression_bytes),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
 };
 
 namespace {
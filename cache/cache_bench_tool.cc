@@ -13,6 +13,7 @@
 #include <sstream>
 
 #include "cache/cache_key.h"
+#include "cache/tiny_lfu_admission_cache.h"
 #include "cache/sharded_cache.h"
 #include "db/db_impl/db_impl.h"
 #include "monitoring/histogram.h"
@@ -119,6 +120,14 @@ DEFINE_string(secondary_cache_uri, "",
 
 DEFINE_string(cache_type, "lru_cache", "Type of block cache.");
 
+DEFINE_bool(tiny_lfu_admission, false,
+            "Wrap the cache with a TinyLFU-style admission filter "
+            "(NewTinyLfuAdmissionCache)");
+
+DEFINE_uint32(scan_percent, 0,
+              "Percentage of lookup+insert operations that use a key never "
+              "used before, simulating cache pollution by scans");
+
 DEFINE_bool(use_jemalloc_no_dump_allocator, false,
             "Whether to use JemallocNoDumpAllocator");
 
@@ -130,6 +139,13 @@ DEFINE_bool(jemalloc_no_dump_allocator_limit_tcache_size,
             ROCKSDB_NAMESPACE::JemallocAllocatorOptions().limit_tcache_size,
             "JemallocNodumpAllocator::limit_tcache_size");
 
+DEFINE_bool(use_huge_page_allocator, false,
+            "Whether to use HugePageAllocator (NewHugePageAllocator)");
+
+DEFINE_uint64(huge_page_allocator_page_size,
+              ROCKSDB_NAMESPACE::HugePageAllocatorOptions().huge_page_size,
+              "HugePageAllocatorOptions::huge_page_size");
+
 // ## BEGIN stress_cache_key sub-tool options ##
 // See class StressCacheKey below.
 DEFINE_bool(stress_cache_key, false,
@@ -261,7 +277,10 @@ struct KeyGen {
     for (uint32_t i = 0; i < skew; ++i) {
       raw = std::min(raw, rnd.Next());
     }
-    uint64_t key = FastRange64(raw, max_key);
+    return Get(FastRange64(raw, max_key));
+  }
+
+  Slice Get(uint64_t key) {
     if (FLAGS_degenerate_hash_bits) {
       uint64_t key_hash =
           Hash64(reinterpret_cast<const char*>(&key), sizeof(key));
@@ -346,7 +365,15 @@ void ConfigureSecondaryCache(ShardedCacheOptions& opts) {
   }
 }
 
+Cache* StripAdmissionFilter(Cache* c) {
+  if (FLAGS_tiny_lfu_admission) {
+    c = static_cast_with_check<CacheWrapper>(c)->GetTarget().get();
+  }
+  return c;
+}
+
 ShardedCacheBase* AsShardedCache(Cache* c) {
+  c = StripAdmissionFilter(c);
   if (!FLAGS_secondary_cache_uri.empty()) {
     c = static_cast_with_check<CacheWrapper>(c)->GetTarget().get();
   }
@@ -385,6 +412,15 @@ class CacheBench {
           FLAGS_jemalloc_no_dump_allocator_limit_tcache_size;
       Status s = NewJemallocNodumpAllocator(opts, &allocator);
       assert(s.ok());
+    } else if (FLAGS_use_huge_page_allocator) {
+      HugePageAllocatorOptions opts;
+      opts.huge_page_size =
+          static_cast<size_t>(FLAGS_huge_page_allocator_page_size);
+      Status s = NewHugePageAllocator(opts, &allocator);
+      if (!s.ok()) {
+        fprintf(stderr, "NewHugePageAllocator: %s\n", s.ToString().c_str());
+        exit(1);
+      }
     }
     if (FLAGS_cache_type == "clock_cache") {
       fprintf(stderr, "Old clock cache implementation has been removed.\n");
@@ -422,11 +458,24 @@ class CacheBench {
       fprintf(stderr, "Cache type not supported.\n");
       exit(1);
     }
+    if (FLAGS_tiny_lfu_admission) {
+      TinyLfuAdmissionOptions opts;
+      opts.estimated_entry_charge = FLAGS_value_bytes;
+      // The benchmark uses a mix of roles
+      opts.filtered_roles = CacheEntryRoleSet::All();
+      cache_ = NewTinyLfuAdmissionCache(cache_, opts);
+      if (cache_ == nullptr) {
+        fprintf(stderr, "TinyLFU admission requires lru_cache.\n");
+        exit(1);
+      }
+    }
   }
 
   ~CacheBench() = default;
 
   void PopulateCache() {
+    // Filling up the cache is not subject to admission filtering
+    Cache* cache = StripAdmissionFilter(cache_.get());
     Random64 rnd(FLAGS_seed);
     KeyGen keygen;
     size_t max_occ = 0;
@@ -440,29 +489,29 @@ class CacheBench {
            keys_since_last_not_found < 100) {
       Slice key = keygen.GetRand(rnd, max_key_, FLAGS_skew);
 
-      Cache::Handle* handle = cache_->Lookup(key);
+      Cache::Handle* handle = cache->Lookup(key);
       if (handle != nullptr) {
-        cache_->Release(handle);
+        cache->Release(handle);
         ++keys_since_last_not_found;
         continue;
       }
       keys_since_last_not_found = 0;
 
       Status s =
-          cache_->Insert(key, createValue(rnd, cache_->memory_allocator()),
+          cache->Insert(key, createValue(rnd, cache->memory_allocator()),
                          &helper1, FLAGS_value_bytes);
       assert(s.ok());
 
-      handle = cache_->Lookup(key);
+      handle = cache->Lookup(key);
       if (!handle) {
         fprintf(stderr, "Failed to lookup key just inserted.\n");
         assert(false);
         exit(42);
       } else {
-        cache_->Release(handle);
+        cache->Release(handle);
       }
 
-      size_t occ = cache_->GetOccupancyCount();
+      size_t occ = cache->GetOccupancyCount();
       if (occ > max_occ) {
         max_occ = occ;
         inserts_since_max_occ_increase = 0;
@@ -531,6 +580,11 @@ class CacheBench {
     printf("Thread ops/sec = %u\n", ops_per_sec);
 
     printf("Lookup hit ratio: %g\n", shared.GetLookupHitRatio());
+    if (FLAGS_tiny_lfu_admission) {
+      printf("Inserts not admitted: %" PRIu64 "\n",
+             static_cast_with_check<TinyLfuAdmissionCache>(cache_.get())
+                 ->TEST_GetNumRejected());
+    }
 
     size_t occ = cache_->GetOccupancyCount();
     size_t slot = cache_->GetTableAddressCount();
@@ -538,6 +592,18 @@ class CacheBench {
 
     printf("Final pinned count: %zu\n", shared.GetPinnedCount());
 
+    HugePageAllocatorStats allocator_stats;
+    if (cache_->memory_allocator() != nullptr &&
+        GetHugePageAllocatorStats(*cache_->memory_allocator(),
+                                  &allocator_stats)
+            .ok()) {
+      printf("Huge page allocator: %zu mapped (%zu huge pages), "
+             "fragmentation %g, %zu fallback allocations\n",
+             allocator_stats.mapped_bytes, allocator_stats.huge_page_bytes,
+             allocator_stats.FragmentationRatio(),
+             allocator_stats.fallback_allocations);
+    }
+
     if (FLAGS_histograms) {
       printf("\nOperation latency (ns):\n");
       HistogramImpl combined;
@@ -692,6 +758,8 @@ class CacheBench {
     size_t pin_count = (total_pin_count + thread->tid) / FLAGS_threads;
 
     KeyGen gen;
+    // For generating keys never used before
+    uint64_t next_scan_key = max_key_ + thread->tid;
     const auto clock = SystemClock::Default().get();
     uint64_t start_time = clock->NowMicros();
     StopWatchNano timer(clock);
@@ -699,7 +767,15 @@ class CacheBench {
     size_t steps_to_next_capacity_change = 0;
 
     for (uint64_t i = 0; i < FLAGS_ops_per_thread; i++) {
-      Slice key = gen.GetRand(thread->rnd, max_key_, FLAGS_skew);
+      const bool scan = FLAGS_scan_percent > 0 &&
+                        thread->rnd.Uniform(100) < FLAGS_scan_percent;
+      Slice key;
+      if (scan) {
+        key = gen.Get(next_scan_key);
+        next_scan_key += FLAGS_threads;
+      } else {
+        key = gen.GetRand(thread->rnd, max_key_, FLAGS_skew);
+      }
       uint64_t random_op = thread->rnd.Next();
 
       if (FLAGS_vary_capacity_ratio > 0.0 && thread->tid == 0) {
@@ -719,7 +795,7 @@ class CacheBench {
         timer.Start();
       }
 
-      if (random_op < lookup_insert_threshold_) {
+      if (scan || random_op < lookup_insert_threshold_) {
         // do lookup
         auto handle = cache_->Lookup(key, &helper2, /*context*/ nullptr,
                                      Cache::Priority::LOW);
@@ -826,6 +902,7 @@ class CacheBench {
     printf("Max key             : %" PRIu64 "\n", max_key_);
     printf("Resident ratio      : %g\n", FLAGS_resident_ratio);
     printf("Skew degree         : %u\n", FLAGS_skew);
+    printf("Scan percentage     : %u%%\n", FLAGS_scan_percent);
     printf("Populate cache      : %d\n", int{FLAGS_populate_cache});
     printf("Lookup+Insert pct   : %u%%\n", FLAGS_lookup_insert_percent);
     printf("Insert percentage   : %u%%\n", FLAGS_insert_percent);
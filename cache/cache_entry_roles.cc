@@ -101,4 +101,19 @@ std::string BlockCacheEntryStatsMapKeys::UsedPercent(CacheEntryRole role) {
   return GetPrefixedCacheEntryRoleName(kPrefix, role);
 }
 
+std::string BlockCacheEntryStatsMapKeys::OwnerUsedBytes(
+    const std::string& owner_name) {
+  return "owner.bytes." + owner_name;
+}
+
+std::string BlockCacheEntryStatsMapKeys::OwnerHits(
+    const std::string& owner_name) {
+  return "owner.hits." + owner_name;
+}
+
+std::string BlockCacheEntryStatsMapKeys::OwnerMisses(
+    const std::string& owner_name) {
+  return "owner.misses." + owner_name;
+}
+
 }  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,236 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/cache_owner.h"
+
+#include <map>
+#include <utility>
+
+#include "port/lang.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+bool IsChargedToOwner(CacheEntryRole role) {
+  switch (role) {
+    case CacheEntryRole::kDataBlock:
+    case CacheEntryRole::kFilterBlock:
+    case CacheEntryRole::kFilterMetaBlock:
+    case CacheEntryRole::kDeprecatedFilterBlock:
+    case CacheEntryRole::kIndexBlock:
+    case CacheEntryRole::kOtherBlock:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// The live owners, by cache and name
+struct CacheOwnerRegistry {
+  port::Mutex mutex;
+  std::map<std::pair<const Cache*, std::string>, CacheOwner*> owners;
+};
+
+CacheOwnerRegistry& GetCacheOwnerRegistry() {
+  STATIC_AVOID_DESTRUCTION(CacheOwnerRegistry, registry);
+  return registry;
+}
+}  // namespace
+
+CacheOwner* CacheOwner::Ref(const Cache* cache,
+                            const CacheOwnerOptions& opts) {
+  CacheOwnerRegistry& registry = GetCacheOwnerRegistry();
+  MutexLock l(&registry.mutex);
+  CacheOwner*& owner = registry.owners[{cache, opts.name}];
+  if (owner != nullptr) {
+    uint64_t refs = owner->refs_.Load();
+    while (refs > 0 && !owner->refs_.CasWeak(refs, refs + 1)) {
+    }
+    if (refs > 0) {
+      if (owner->soft_quota_ != opts.soft_quota ||
+          owner->hard_quota_ != opts.hard_quota) {
+        // Not the last reference
+        owner->refs_.FetchSub(1);
+        return nullptr;
+      }
+      return owner;
+    }
+    // Being destroyed, which leaves the new owner in the registry
+  }
+  owner = new CacheOwner(cache, opts);
+  return owner;
+}
+
+void CacheOwner::Unref() {
+  if (refs_.FetchSub(1) != 1) {
+    return;
+  }
+  {
+    CacheOwnerRegistry& registry = GetCacheOwnerRegistry();
+    MutexLock l(&registry.mutex);
+    auto it = registry.owners.find({cache_, name_});
+    if (it != registry.owners.end() && it->second == this) {
+      registry.owners.erase(it);
+    }
+  }
+  delete this;
+}
+
+const Cache::CacheItemHelper* CacheOwner::GetOwnedHelper(
+    const Cache::CacheItemHelper* helper) {
+  if (helper == nullptr || helper->owner != nullptr ||
+      !IsChargedToOwner(helper->role)) {
+    return helper;
+  }
+  const size_t num_helpers = num_helpers_.Load();
+  for (size_t i = 0; i < num_helpers; ++i) {
+    if (originals_[i] == helper) {
+      return owned_[i].get();
+    }
+  }
+  MutexLock l(&mutex_);
+  return GetOwnedHelperLocked(helper);
+}
+
+const Cache::CacheItemHelper* CacheOwner::GetOwnedHelperLocked(
+    const Cache::CacheItemHelper* helper) {
+  const size_t num_helpers = num_helpers_.LoadRelaxed();
+  for (size_t i = 0; i < num_helpers; ++i) {
+    if (originals_[i] == helper) {
+      return owned_[i].get();
+    }
+  }
+  if (num_helpers == kMaxHelpers) {
+    return helper;
+  }
+  std::unique_ptr<Cache::CacheItemHelper> owned(
+      new Cache::CacheItemHelper(*helper));
+  owned->owner = this;
+  if (helper->without_secondary_compat == helper) {
+    owned->without_secondary_compat = owned.get();
+  } else {
+    const Cache::CacheItemHelper* without_secondary_compat =
+        GetOwnedHelperLocked(helper->without_secondary_compat);
+    if (without_secondary_compat->owner != this) {
+      // Out of slots
+      return helper;
+    }
+    owned->without_secondary_compat = without_secondary_compat;
+  }
+  // Possibly changed by the recursive call
+  const size_t i = num_helpers_.LoadRelaxed();
+  if (i == kMaxHelpers) {
+    return helper;
+  }
+  originals_[i] = helper;
+  owned_[i] = std::move(owned);
+  num_helpers_.Store(i + 1);
+  return owned_[i].get();
+}
+
+CacheOwnerView::CacheOwnerView(std::shared_ptr<Cache> target,
+                               const CacheOwnerOptions& opts,
+                               CacheOwner* owner)
+    : CacheWrapper(std::move(target)), opts_(opts), owner_(owner) {
+  assert(owner_ != nullptr);
+}
+
+CacheOwnerView::~CacheOwnerView() { owner_->Unref(); }
+
+Status CacheOwnerView::Insert(const Slice& key, ObjectPtr value,
+                              const CacheItemHelper* helper, size_t charge,
+                              Handle** handle, Priority priority,
+                              const Slice& compressed_value,
+                              CompressionType type) {
+  const CacheItemHelper* owned_helper = owner_->GetOwnedHelper(helper);
+  if (owned_helper == helper) {
+    return target_->Insert(key, value, helper, charge, handle, priority,
+                           compressed_value, type);
+  }
+
+  if (owner_->WouldExceedHardQuota(charge)) {
+    // As if inserted and evicted right away
+    if (handle == nullptr) {
+      if (helper->del_cb) {
+        helper->del_cb(value, target_->memory_allocator());
+      }
+    } else {
+      // Not charged to the cache nor to the owner, which is already at its
+      // hard quota
+      *handle = target_->CreateStandalone(key, value, helper, /*charge=*/0,
+                                          /*allow_uncharged=*/true);
+      assert(*handle != nullptr);
+    }
+    return Status::OK();
+  }
+  if (owner_->IsOverSoftQuota()) {
+    priority = Priority::BOTTOM;
+  }
+  return target_->Insert(key, value, owned_helper, charge, handle, priority,
+                         compressed_value, type);
+}
+
+Cache::Handle* CacheOwnerView::CreateStandalone(const Slice& key,
+                                                ObjectPtr value,
+                                                const CacheItemHelper* helper,
+                                                size_t charge,
+                                                bool allow_uncharged) {
+  return target_->CreateStandalone(
+      key, value, owner_->GetOwnedHelper(helper), charge, allow_uncharged);
+}
+
+Cache::Handle* CacheOwnerView::Lookup(const Slice& key,
+                                      const CacheItemHelper* helper,
+                                      CreateContext* create_context,
+                                      Priority priority, Statistics* stats) {
+  const CacheItemHelper* owned_helper = owner_->GetOwnedHelper(helper);
+  Handle* handle =
+      target_->Lookup(key, owned_helper, create_context, priority, stats);
+  if (owned_helper != helper) {
+    if (handle != nullptr) {
+      owner_->RecordHit();
+    } else {
+      owner_->RecordMiss();
+    }
+  }
+  return handle;
+}
+
+void CacheOwnerView::StartAsyncLookup(AsyncLookupHandle& async_handle) {
+  async_handle.helper = owner_->GetOwnedHelper(async_handle.helper);
+  target_->StartAsyncLookup(async_handle);
+}
+
+std::string CacheOwnerView::GetPrintableOptions() const {
+  std::string ret = target_->GetPrintableOptions();
+  char buffer[200];
+  snprintf(buffer, sizeof(buffer), "    cache_owner.name : %s\n",
+           opts_.name.c_str());
+  ret.append(buffer);
+  snprintf(buffer, sizeof(buffer),
+           "    cache_owner.soft_quota : %" ROCKSDB_PRIszt "\n",
+           opts_.soft_quota);
+  ret.append(buffer);
+  snprintf(buffer, sizeof(buffer),
+           "    cache_owner.hard_quota : %" ROCKSDB_PRIszt "\n",
+           opts_.hard_quota);
+  ret.append(buffer);
+  return ret;
+}
+
+std::shared_ptr<Cache> NewCacheOwnerView(std::shared_ptr<Cache> cache,
+                                         const CacheOwnerOptions& opts) {
+  if (cache == nullptr) {
+    return nullptr;
+  }
+  CacheOwner* owner = CacheOwner::Ref(cache.get(), opts);
+  if (owner == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<CacheOwnerView>(std::move(cache), opts, owner);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,154 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "port/port.h"
+#include "rocksdb/advanced_cache.h"
+#include "rocksdb/cache.h"
+#include "util/atomic.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// An owner (tenant) of entries in a shared cache. Entries are charged to an
+// owner through their CacheItemHelper: CacheOwnerView inserts block entries
+// with owner-tagged copies of their helpers, and the LRU and HyperClock
+// shards add the total charge of such entries to the owner's usage when they
+// are created and subtract it when they are freed.
+//
+// There is one owner per name in each cache that views are attached to. It
+// is referenced by the views and by its entries, since entries (and their
+// helpers) can outlive any view of the cache, and destroyed with the last
+// of them.
+class CacheOwner {
+ public:
+  // Returns a reference to the owner named opts.name of the entries of
+  // `cache`, creating it if needed. Returns nullptr if the owner exists with
+  // other quotas.
+  static CacheOwner* Ref(const Cache* cache, const CacheOwnerOptions& opts);
+  void Unref();
+
+  const std::string& name() const { return name_; }
+
+  // Total charge of the entries of this owner
+  size_t GetUsage() const {
+    const int64_t usage = usage_.LoadRelaxed();
+    return usage > 0 ? static_cast<size_t>(usage) : 0;
+  }
+  // Called by the cache shards for each entry created and freed with an
+  // owner-tagged helper. The entry holds a reference in between.
+  void AddEntry(size_t charge) {
+    refs_.FetchAdd(1);
+    usage_.FetchAddRelaxed(static_cast<int64_t>(charge));
+  }
+  void RemoveEntry(size_t charge) {
+    usage_.FetchSubRelaxed(static_cast<int64_t>(charge));
+    Unref();
+  }
+
+  bool IsOverSoftQuota() const {
+    return soft_quota_ > 0 && GetUsage() > soft_quota_;
+  }
+  bool WouldExceedHardQuota(size_t charge) const {
+    return hard_quota_ > 0 && GetUsage() + charge > hard_quota_;
+  }
+
+  void RecordHit() { hits_.FetchAddRelaxed(1); }
+  void RecordMiss() { misses_.FetchAddRelaxed(1); }
+  uint64_t GetHits() const { return hits_.LoadRelaxed(); }
+  uint64_t GetMisses() const { return misses_.LoadRelaxed(); }
+
+  // Returns the copy of `helper` charging entries to this owner, or `helper`
+  // itself for entries that are not charged to owners (non-block roles,
+  // entries of other owners, or once kMaxHelpers helpers are tagged).
+  const Cache::CacheItemHelper* GetOwnedHelper(
+      const Cache::CacheItemHelper* helper);
+
+ private:
+  // Plenty for the helpers of all block types
+  static constexpr size_t kMaxHelpers = 32;
+
+  CacheOwner(const Cache* cache, const CacheOwnerOptions& opts)
+      : cache_(cache),
+        name_(opts.name),
+        soft_quota_(opts.soft_quota),
+        hard_quota_(opts.hard_quota) {}
+
+  // REQUIRES: mutex_ held
+  const Cache::CacheItemHelper* GetOwnedHelperLocked(
+      const Cache::CacheItemHelper* helper);
+
+  const Cache* const cache_;
+  const std::string name_;
+  const size_t soft_quota_;
+  const size_t hard_quota_;
+  // By the views and the entries. The owner is being destroyed once they
+  // drop to 0, and is then no longer handed out by Ref().
+  AcqRelAtomic<uint64_t> refs_{1};
+  RelaxedAtomic<int64_t> usage_{0};
+  RelaxedAtomic<uint64_t> hits_{0};
+  RelaxedAtomic<uint64_t> misses_{0};
+
+  // Helpers and their owner-tagged copies. Looked up without locking:
+  // entries below num_helpers_ are never modified.
+  const Cache::CacheItemHelper* originals_[kMaxHelpers] = {};
+  std::unique_ptr<Cache::CacheItemHelper> owned_[kMaxHelpers];
+  AcqRelAtomic<size_t> num_helpers_{0};
+  port::Mutex mutex_;
+};
+
+// A view of a shared cache charging the block entries inserted through it to
+// one CacheOwner, and enforcing the quotas of the owner (see
+// CacheOwnerOptions):
+// * Over the soft quota, entries are inserted with Priority::BOTTOM, which
+//   both LRU and HyperClock caches evict first.
+// * Entries that would take the owner over the hard quota behave as if they
+//   were inserted and evicted right away: without a handle requested, the
+//   object is deleted and OK is returned; with a handle requested, a
+//   standalone (not cached) handle with no charge is returned.
+// Lookups through the view count as hits or misses of the owner.
+class CacheOwnerView : public CacheWrapper {
+ public:
+  // Takes over the reference to `owner`, the owner named opts.name of the
+  // entries of `target`
+  CacheOwnerView(std::shared_ptr<Cache> target, const CacheOwnerOptions& opts,
+                 CacheOwner* owner);
+  ~CacheOwnerView() override;
+
+  static const char* kClassName() { return "CacheOwnerView"; }
+  const char* Name() const override { return kClassName(); }
+
+  Status Insert(
+      const Slice& key, ObjectPtr value, const CacheItemHelper* helper,
+      size_t charge, Handle** handle = nullptr,
+      Priority priority = Priority::LOW,
+      const Slice& compressed_value = Slice(),
+      CompressionType type = CompressionType::kNoCompression) override;
+
+  Handle* CreateStandalone(const Slice& key, ObjectPtr value,
+                           const CacheItemHelper* helper, size_t charge,
+                           bool allow_uncharged) override;
+
+  Handle* Lookup(const Slice& key, const CacheItemHelper* helper,
+                 CreateContext* create_context,
+                 Priority priority = Priority::LOW,
+                 Statistics* stats = nullptr) override;
+
+  void StartAsyncLookup(AsyncLookupHandle& async_handle) override;
+
+  std::string GetPrintableOptions() const override;
+
+  CacheOwner* owner() const { return owner_; }
+
+ private:
+  const CacheOwnerOptions opts_;
+  CacheOwner* const owner_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
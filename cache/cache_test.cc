@@ -15,6 +15,7 @@
 #include <string>
 #include <vector>
 
+#include "cache/cache_owner.h"
 #include "cache/lru_cache.h"
 #include "cache/typed_cache.h"
 #include "port/stack_trace.h"
@@ -948,6 +949,100 @@ TEST_P(CacheTest, GetChargeAndDeleter) {
   cache_->Release(h1);
 }
 
+namespace {
+// Records the priority of the last insert
+class PriorityRecordingCache : public CacheWrapper {
+ public:
+  explicit PriorityRecordingCache(std::shared_ptr<Cache> target)
+      : CacheWrapper(std::move(target)) {}
+
+  const char* Name() const override { return "PriorityRecordingCache"; }
+
+  Status Insert(const Slice& key, ObjectPtr value,
+                const CacheItemHelper* helper, size_t charge,
+                Handle** handle = nullptr, Priority priority = Priority::LOW,
+                const Slice& compressed_value = Slice(),
+                CompressionType type = kNoCompression) override {
+    last_priority = priority;
+    return target_->Insert(key, value, helper, charge, handle, priority,
+                           compressed_value, type);
+  }
+
+  Priority last_priority = Priority::LOW;
+};
+}  // namespace
+
+TEST_P(CacheTest, OwnerUsageAndQuotas) {
+  const Cache::CacheItemHelper helper(CacheEntryRole::kDataBlock,
+                                      &CacheTest::Deleter);
+  // A single shard, so that no entry is evicted before the quotas are hit
+  cache_ = NewCache(kCacheSize, 0 /*num_shard_bits*/, false);
+  auto recording_cache = std::make_shared<PriorityRecordingCache>(cache_);
+  CacheOwnerOptions opts;
+  opts.name = "OwnerUsageAndQuotas";
+  opts.soft_quota = 100;
+  opts.hard_quota = 200;
+  std::shared_ptr<Cache> view = NewCacheOwnerView(recording_cache, opts);
+  CacheOwner* owner = static_cast<CacheOwnerView*>(view.get())->owner();
+  ASSERT_EQ(0U, owner->GetUsage());
+
+  // Owners are scoped to the cache, and views of the same owner must agree
+  // on the quotas
+  std::shared_ptr<Cache> same_view = NewCacheOwnerView(recording_cache, opts);
+  ASSERT_EQ(owner, static_cast<CacheOwnerView*>(same_view.get())->owner());
+  std::shared_ptr<Cache> other_cache_view = NewCacheOwnerView(cache_, opts);
+  ASSERT_NE(owner,
+            static_cast<CacheOwnerView*>(other_cache_view.get())->owner());
+  CacheOwnerOptions conflicting_opts = opts;
+  conflicting_opts.hard_quota = 300;
+  ASSERT_EQ(nullptr, NewCacheOwnerView(recording_cache, conflicting_opts));
+  same_view.reset();
+  other_cache_view.reset();
+
+  // Block entries are charged to the owner, other entries are not
+  ASSERT_OK(view->Insert(EncodeKey(1), EncodeValue(101), &helper, 60));
+  ASSERT_EQ(Cache::Priority::LOW, recording_cache->last_priority);
+  ASSERT_OK(view->Insert(EncodeKey(2), EncodeValue(102), &kHelper, 60));
+  ASSERT_EQ(60U, owner->GetUsage());
+  Cache::Handle* h = view->Lookup(EncodeKey(1), &helper);
+  ASSERT_NE(nullptr, h);
+  ASSERT_EQ(owner, cache_->GetCacheItemHelper(h)->owner);
+  ASSERT_EQ(CacheEntryRole::kDataBlock, cache_->GetCacheItemHelper(h)->role);
+  cache_->Release(h);
+  ASSERT_EQ(nullptr, view->Lookup(EncodeKey(3), &helper));
+  ASSERT_EQ(1U, owner->GetHits());
+  ASSERT_EQ(1U, owner->GetMisses());
+
+  // Over the soft quota, entries are inserted with the lowest priority
+  ASSERT_OK(view->Insert(EncodeKey(3), EncodeValue(103), &helper, 60));
+  ASSERT_EQ(Cache::Priority::LOW, recording_cache->last_priority);
+  ASSERT_OK(view->Insert(EncodeKey(4), EncodeValue(104), &helper, 60));
+  ASSERT_EQ(Cache::Priority::BOTTOM, recording_cache->last_priority);
+  ASSERT_EQ(180U, owner->GetUsage());
+
+  // Over the hard quota, entries are not kept
+  ASSERT_OK(view->Insert(EncodeKey(5), EncodeValue(105), &helper, 60));
+  ASSERT_EQ(180U, owner->GetUsage());
+  ASSERT_EQ(-1, Lookup(cache_, 5));
+  ASSERT_EQ(std::vector<int>({105}), deleted_values_);
+  Cache::Handle* standalone = nullptr;
+  ASSERT_OK(view->Insert(EncodeKey(6), EncodeValue(106), &helper, 60,
+                         &standalone));
+  ASSERT_NE(nullptr, standalone);
+  ASSERT_EQ(-1, Lookup(cache_, 6));
+  ASSERT_EQ(0U, cache_->GetCharge(standalone));
+  ASSERT_EQ(180U, owner->GetUsage());
+  cache_->Release(standalone);
+  ASSERT_EQ(180U, owner->GetUsage());
+  ASSERT_EQ(std::vector<int>({105, 106}), deleted_values_);
+
+  // Freed entries are no longer charged
+  cache_->Erase(EncodeKey(1));
+  ASSERT_EQ(120U, owner->GetUsage());
+  cache_->EraseUnRefEntries();
+  ASSERT_EQ(0U, owner->GetUsage());
+}
+
 namespace {
 bool AreTwoCacheKeysOrdered(Cache* cache) {
   std::vector<std::string> keys;
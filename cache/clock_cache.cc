@@ -24,6 +24,7 @@
 #include <type_traits>
 
 #include "cache/cache_key.h"
+#include "cache/cache_owner.h"
 #include "cache/secondary_cache_adapter.h"
 #include "logging/logging.h"
 #include "monitoring/perf_context_imp.h"
@@ -379,6 +380,19 @@ void ClockHandleBasicData::FreeData(MemoryAllocator* allocator) const {
   if (helper->del_cb) {
     helper->del_cb(value, allocator);
   }
+  UnchargeOwner();
+}
+
+void ClockHandleBasicData::ChargeOwner() const {
+  if (helper->owner != nullptr) {
+    helper->owner->AddEntry(total_charge);
+  }
+}
+
+void ClockHandleBasicData::UnchargeOwner() const {
+  if (helper->owner != nullptr) {
+    helper->owner->RemoveEntry(total_charge);
+  }
 }
 
 template <class HandleImpl>
@@ -563,7 +577,9 @@ void BaseClockTable::TrackAndReleaseEvictedEntry(ClockHandle* h) {
                            static_cast<Cache::Handle*>(h),
                            h->meta.LoadRelaxed() & ClockHandle::kHitBitMask);
   }
-  if (!took_value_ownership) {
+  if (took_value_ownership) {
+    h->UnchargeOwner();
+  } else {
     h->FreeData(allocator_);
   }
   MarkEmpty(*h);
@@ -1271,9 +1287,15 @@ Status ClockCacheShard<Table>::Insert(const Slice& key,
   proto.value = value;
   proto.helper = helper;
   proto.total_charge = charge;
-  return table_.template Insert<Table>(proto, handle, priority,
-                                       capacity_.LoadRelaxed(),
-                                       eec_and_scl_.LoadRelaxed());
+  proto.ChargeOwner();
+  Status s = table_.template Insert<Table>(proto, handle, priority,
+                                           capacity_.LoadRelaxed(),
+                                           eec_and_scl_.LoadRelaxed());
+  if (!s.ok()) {
+    // Not taken by the table
+    proto.UnchargeOwner();
+  }
+  return s;
 }
 
 template <class Table>
@@ -1288,9 +1310,14 @@ typename Table::HandleImpl* ClockCacheShard<Table>::CreateStandalone(
   proto.value = obj;
   proto.helper = helper;
   proto.total_charge = charge;
-  return table_.template CreateStandalone<Table>(proto, capacity_.LoadRelaxed(),
-                                                 eec_and_scl_.LoadRelaxed(),
-                                                 allow_uncharged);
+  HandleImpl* h = table_.template CreateStandalone<Table>(
+      proto, capacity_.LoadRelaxed(), eec_and_scl_.LoadRelaxed(),
+      allow_uncharged);
+  if (h != nullptr) {
+    // With the charge possibly dropped by allow_uncharged
+    h->ChargeOwner();
+  }
+  return h;
 }
 
 template <class Table>
@@ -311,6 +311,11 @@ struct ClockHandleBasicData : public Cache::Handle {
   // Calls deleter (if non-null) on cache key and value
   void FreeData(MemoryAllocator* allocator) const;
 
+  // Adds or removes the entry and its total charge to or from the owner of
+  // the entry, if any (see CacheOwner). FreeData() includes the latter.
+  void ChargeOwner() const;
+  void UnchargeOwner() const;
+
   // Required by concept HandleImpl
   const UniqueId64x2& GetHash() const { return hashed_key; }
 };
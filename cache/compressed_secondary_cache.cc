@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <thread>
 
 #include "memory/memory_allocator_impl.h"
 #include "monitoring/perf_context_imp.h"
@@ -17,6 +18,24 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+namespace {
+// For the dummy blocks inserted by Lookup() on hits, which tell that the
+// entry is hot when it is inserted again
+const Cache::CacheItemHelper kHitDummyHelper{CacheEntryRole::kMisc};
+
+// Header of an entry (without custom split/merge): type, source and size of
+// the data that follows
+size_t EncodeHeader(char* header, CompressionType type, CacheTier source,
+                    size_t data_size) {
+  char* p = EncodeVarint32(header, static_cast<uint32_t>(type));
+  p = EncodeVarint32(p, static_cast<uint32_t>(source));
+  p = EncodeVarint64(p, data_size);
+  return static_cast<size_t>(p - header);
+}
+// Two varint32 and a varint64
+constexpr size_t kMaxHeaderSize = 20;
+}  // namespace
+
 CompressedSecondaryCache::CompressedSecondaryCache(
     const CompressedSecondaryCacheOptions& opts)
     : cache_(opts.LRUCacheOptions::MakeSharedCache()),
@@ -24,9 +43,26 @@ CompressedSecondaryCache::CompressedSecondaryCache(
       cache_res_mgr_(std::make_shared<ConcurrentCacheReservationManager>(
           std::make_shared<CacheReservationManagerImpl<CacheEntryRole::kMisc>>(
               cache_))),
-      disable_cache_(opts.capacity == 0) {}
+      disable_cache_(opts.capacity == 0),
+      cold_compression_type_(opts.compression_type),
+      codec_counters_(new CodecCounters[kNumCodecCounters]) {
+  // Custom split/merge does not record the compression type of entries
+  if (opts.cold_compression_type != kDisableCompressionOption &&
+      !opts.enable_custom_split_merge &&
+      CompressionTypeSupported(opts.cold_compression_type)) {
+    cold_compression_type_ = opts.cold_compression_type;
+  }
+  if (opts.compression_threads > 0) {
+    compression_pool_.reset(NewThreadPool(opts.compression_threads));
+  }
+}
 
-CompressedSecondaryCache::~CompressedSecondaryCache() = default;
+CompressedSecondaryCache::~CompressedSecondaryCache() {
+  if (compression_pool_) {
+    // Entries not yet compressed are dropped
+    compression_pool_->JoinAllThreads();
+  }
+}
 
 std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
     const Slice& key, const Cache::CacheItemHelper* helper,
@@ -91,17 +127,17 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
   Cache::ObjectPtr value{nullptr};
   size_t charge{0};
   if (source == CacheTier::kVolatileCompressedTier) {
-    if (cache_options_.compression_type == kNoCompression ||
-        cache_options_.do_not_compress_roles.Contains(helper->role)) {
+    if (cache_options_.enable_custom_split_merge) {
+      type = GetCompressionType(helper->role, /*hot=*/true);
+    }
+    if (type == kNoCompression) {
       s = helper->create_cb(Slice(data_ptr, handle_value_charge),
                             kNoCompression, CacheTier::kVolatileTier,
                             create_context, allocator, &value, &charge);
     } else {
-      UncompressionContext uncompression_context(
-          cache_options_.compression_type);
-      UncompressionInfo uncompression_info(uncompression_context,
-                                           UncompressionDict::GetEmptyDict(),
-                                           cache_options_.compression_type);
+      UncompressionContext uncompression_context(type);
+      UncompressionInfo uncompression_info(
+          uncompression_context, UncompressionDict::GetEmptyDict(), type);
 
       size_t uncompressed_size{0};
       CacheAllocationPtr uncompressed =
@@ -131,11 +167,9 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
 
   if (advise_erase) {
     cache_->Release(lru_handle, /*erase_if_last_ref=*/true);
-    // Insert a dummy handle.
-    cache_
-        ->Insert(key, /*obj=*/nullptr,
-                 GetHelper(cache_options_.enable_custom_split_merge),
-                 /*charge=*/0)
+    // Insert a dummy handle, telling that the entry is hot if inserted
+    // again.
+    cache_->Insert(key, /*obj=*/nullptr, &kHitDummyHelper, /*charge=*/0)
         .PermitUncheckedError();
   } else {
     kept_in_sec_cache = true;
@@ -146,7 +180,8 @@ std::unique_ptr<SecondaryCacheResultHandle> CompressedSecondaryCache::Lookup(
   return handle;
 }
 
-bool CompressedSecondaryCache::MaybeInsertDummy(const Slice& key) {
+bool CompressedSecondaryCache::MaybeInsertDummy(const Slice& key,
+                                                bool* was_hit) {
   auto internal_helper = GetHelper(cache_options_.enable_custom_split_merge);
   Cache::Handle* lru_handle = cache_->Lookup(key);
   if (lru_handle == nullptr) {
@@ -156,77 +191,128 @@ bool CompressedSecondaryCache::MaybeInsertDummy(const Slice& key) {
         .PermitUncheckedError();
     return true;
   } else {
+    if (was_hit != nullptr) {
+      *was_hit = cache_->GetCacheItemHelper(lru_handle) == &kHitDummyHelper;
+    }
     cache_->Release(lru_handle, /*erase_if_last_ref=*/false);
   }
 
   return false;
 }
 
+CompressionType CompressedSecondaryCache::GetCompressionType(
+    CacheEntryRole role, bool hot) const {
+  // cold_compression_type_ applies even without compression of hot entries
+  if (cache_options_.do_not_compress_roles.Contains(role)) {
+    return kNoCompression;
+  }
+  return hot ? cache_options_.compression_type : cold_compression_type_;
+}
+
 Status CompressedSecondaryCache::InsertInternal(
     const Slice& key, Cache::ObjectPtr value,
     const Cache::CacheItemHelper* helper, CompressionType type,
-    CacheTier source) {
+    CacheTier source, bool hot) {
   if (source != CacheTier::kVolatileCompressedTier &&
       cache_options_.enable_custom_split_merge) {
     // We don't support custom split/merge for the tiered case
     return Status::OK();
   }
 
-  auto internal_helper = GetHelper(cache_options_.enable_custom_split_merge);
-  char header[20];
-  char* payload = header;
-  payload = EncodeVarint32(payload, static_cast<uint32_t>(type));
-  payload = EncodeVarint32(payload, static_cast<uint32_t>(source));
-  size_t data_size = (*helper->size_cb)(value);
-  char* data_size_ptr = payload;
-  payload = EncodeVarint64(payload, data_size);
-
-  size_t header_size = payload - header;
-  size_t total_size = data_size + header_size;
-  CacheAllocationPtr ptr =
-      AllocateBlock(total_size, cache_options_.memory_allocator.get());
+  const CompressionType compression_type =
+      type == kNoCompression ? GetCompressionType(helper->role, hot)
+                             : kNoCompression;
+  const size_t data_size = (*helper->size_cb)(value);
+  MemoryAllocator* allocator = cache_options_.memory_allocator.get();
+
+  if (compression_type != kNoCompression && compression_pool_ &&
+      pending_compression_bytes_.LoadRelaxed() + data_size <=
+          cache_options_.max_pending_compression_bytes) {
+    // Only copy the entry, leaving the compression to a background thread
+    auto entry = std::make_shared<PendingEntry>();
+    entry->key = key.ToString();
+    entry->data = AllocateBlock(data_size, allocator);
+    entry->size = data_size;
+    entry->compression_type = compression_type;
+    Status s = (*helper->saveto_cb)(value, 0, data_size, entry->data.get());
+    if (!s.ok()) {
+      return s;
+    }
+    pending_compression_entries_.FetchAddRelaxed(1);
+    pending_compression_bytes_.FetchAddRelaxed(data_size);
+    compression_pool_->SubmitJob([this, entry]() {
+      CompressAndInsert(entry->key, Slice(entry->data.get(), entry->size),
+                        /*saved=*/nullptr, entry->compression_type,
+                        kNoCompression, CacheTier::kVolatileCompressedTier)
+          .PermitUncheckedError();
+      pending_compression_bytes_.FetchSubRelaxed(entry->size);
+      pending_compression_entries_.FetchSubRelaxed(1);
+    });
+    return Status::OK();
+  }
+
+  // Saved after room for the header, so that it needs no copy if stored
+  // uncompressed
+  char header[kMaxHeaderSize];
+  const size_t header_size = EncodeHeader(header, type, source, data_size);
+  CacheAllocationPtr ptr = AllocateBlock(header_size + data_size, allocator);
   char* data_ptr = ptr.get() + header_size;
 
   Status s = (*helper->saveto_cb)(value, 0, data_size, data_ptr);
   if (!s.ok()) {
     return s;
   }
-  Slice val(data_ptr, data_size);
+  return CompressAndInsert(key, Slice(data_ptr, data_size), &ptr,
+                           compression_type, type, source);
+}
 
+Status CompressedSecondaryCache::CompressAndInsert(
+    const Slice& key, const Slice& data, CacheAllocationPtr* saved,
+    CompressionType compression_type, CompressionType type,
+    CacheTier source) {
+  Slice val = data;
   std::string compressed_val;
-  if (cache_options_.compression_type != kNoCompression &&
-      type == kNoCompression &&
-      !cache_options_.do_not_compress_roles.Contains(helper->role)) {
-    PERF_COUNTER_ADD(compressed_sec_cache_uncompressed_bytes, data_size);
-    CompressionContext compression_context(cache_options_.compression_type,
+  if (compression_type != kNoCompression) {
+    PERF_COUNTER_ADD(compressed_sec_cache_uncompressed_bytes, data.size());
+    CompressionContext compression_context(compression_type,
                                            cache_options_.compression_opts);
-    CompressionInfo compression_info(
-        cache_options_.compression_opts, compression_context,
-        CompressionDict::GetEmptyDict(), cache_options_.compression_type);
+    CompressionInfo compression_info(cache_options_.compression_opts,
+                                     compression_context,
+                                     CompressionDict::GetEmptyDict(),
+                                     compression_type);
 
     bool success =
-        CompressData(val, compression_info,
+        CompressData(data, compression_info,
                      cache_options_.compress_format_version, &compressed_val);
 
     if (!success) {
       return Status::Corruption("Error compressing value.");
     }
-
-    val = Slice(compressed_val);
-    data_size = compressed_val.size();
-    payload = EncodeVarint64(data_size_ptr, data_size);
-    header_size = payload - header;
-    total_size = header_size + data_size;
-    PERF_COUNTER_ADD(compressed_sec_cache_compressed_bytes, data_size);
-
-    if (!cache_options_.enable_custom_split_merge) {
-      ptr = AllocateBlock(total_size, cache_options_.memory_allocator.get());
-      data_ptr = ptr.get() + header_size;
-      memcpy(data_ptr, compressed_val.data(), data_size);
+    PERF_COUNTER_ADD(compressed_sec_cache_compressed_bytes,
+                     compressed_val.size());
+
+    // Without custom split/merge, the entry is kept uncompressed if that
+    // saves too little (e.g. for data already compressed). With it, entries
+    // are always compressed, as Lookup() cannot tell otherwise.
+    const uint64_t max_compressed_size =
+        (static_cast<uint64_t>(
+             cache_options_.compression_opts.max_compressed_bytes_per_kb) *
+         data.size()) >>
+        10;
+    if (cache_options_.enable_custom_split_merge ||
+        compressed_val.size() <= max_compressed_size) {
+      val = Slice(compressed_val);
+      type = compression_type;
     }
   }
 
+  CodecCounters& counters = codec_counters_[static_cast<uint8_t>(type)];
+  counters.num_inserted_entries.FetchAddRelaxed(1);
+  counters.inserted_uncompressed_bytes.FetchAddRelaxed(data.size());
+  counters.inserted_stored_bytes.FetchAddRelaxed(val.size());
+
   PERF_COUNTER_ADD(compressed_sec_cache_insert_real_count, 1);
+  auto internal_helper = GetHelper(cache_options_.enable_custom_split_merge);
   if (cache_options_.enable_custom_split_merge) {
     size_t split_charge{0};
     CacheValueChunk* value_chunks_head = SplitValueIntoChunks(
@@ -234,6 +320,18 @@ Status CompressedSecondaryCache::InsertInternal(
     return cache_->Insert(key, value_chunks_head, internal_helper,
                           split_charge);
   } else {
+    char header[kMaxHeaderSize];
+    const size_t header_size = EncodeHeader(header, type, source, val.size());
+    const size_t total_size = header_size + val.size();
+    CacheAllocationPtr ptr;
+    if (saved != nullptr && val.data() == data.data()) {
+      // Same header size, as the same data and type
+      assert(saved->get() + header_size == data.data());
+      ptr = std::move(*saved);
+    } else {
+      ptr = AllocateBlock(total_size, cache_options_.memory_allocator.get());
+      memcpy(ptr.get() + header_size, val.data(), val.size());
+    }
 #ifdef ROCKSDB_MALLOC_USABLE_SIZE
     size_t charge = malloc_usable_size(ptr.get());
 #else
@@ -254,12 +352,14 @@ Status CompressedSecondaryCache::Insert(const Slice& key,
     return Status::InvalidArgument();
   }
 
-  if (!force_insert && MaybeInsertDummy(key)) {
+  // Hit in the primary cache (force_insert) or in this cache
+  bool hot = force_insert;
+  if (!force_insert && MaybeInsertDummy(key, &hot)) {
     return Status::OK();
   }
 
   return InsertInternal(key, value, helper, kNoCompression,
-                        CacheTier::kVolatileCompressedTier);
+                        CacheTier::kVolatileCompressedTier, hot);
 }
 
 Status CompressedSecondaryCache::InsertSaved(
@@ -276,7 +376,7 @@ Status CompressedSecondaryCache::InsertSaved(
 
   return InsertInternal(
       key, static_cast<Cache::ObjectPtr>(const_cast<Slice*>(&saved)),
-      slice_helper, type, source);
+      slice_helper, type, source, /*hot=*/false);
 }
 
 void CompressedSecondaryCache::Erase(const Slice& key) { cache_->Erase(key); }
@@ -312,9 +412,64 @@ std::string CompressedSecondaryCache::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "    compress_format_version : %d\n",
            cache_options_.compress_format_version);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    cold_compression_type : %s\n",
+           CompressionTypeToString(cold_compression_type_).c_str());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    compression_threads : %d\n",
+           cache_options_.compression_threads);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize,
+           "    max_pending_compression_bytes : %" ROCKSDB_PRIszt "\n",
+           cache_options_.max_pending_compression_bytes);
+  ret.append(buffer);
   return ret;
 }
 
+void CompressedSecondaryCache::GetStats(
+    CompressedSecondaryCacheStats* stats) const {
+  *stats = CompressedSecondaryCacheStats();
+  {
+    MutexLock l(&capacity_mutex_);
+    stats->capacity = cache_options_.capacity;
+  }
+  uint64_t total_stored_bytes = 0;
+  for (size_t i = 0; i < kNumCodecCounters; ++i) {
+    const CodecCounters& counters = codec_counters_[i];
+    if (counters.num_inserted_entries.LoadRelaxed() == 0) {
+      continue;
+    }
+    CompressedSecondaryCacheCodecStats codec;
+    codec.type = static_cast<CompressionType>(i);
+    codec.num_inserted_entries = counters.num_inserted_entries.LoadRelaxed();
+    codec.inserted_uncompressed_bytes =
+        counters.inserted_uncompressed_bytes.LoadRelaxed();
+    codec.inserted_stored_bytes = counters.inserted_stored_bytes.LoadRelaxed();
+    total_stored_bytes += codec.inserted_stored_bytes;
+    stats->codecs.push_back(codec);
+  }
+  if (total_stored_bytes > 0) {
+    // The part of the capacity of a codec, inserted_stored_bytes /
+    // total_stored_bytes, times its ratio, inserted_uncompressed_bytes /
+    // inserted_stored_bytes
+    for (auto& codec : stats->codecs) {
+      codec.effective_capacity = static_cast<uint64_t>(
+          static_cast<double>(stats->capacity) *
+          static_cast<double>(codec.inserted_uncompressed_bytes) /
+          static_cast<double>(total_stored_bytes));
+      stats->effective_capacity += codec.effective_capacity;
+    }
+  }
+  stats->pending_compression_entries =
+      pending_compression_entries_.LoadRelaxed();
+  stats->pending_compression_bytes = pending_compression_bytes_.LoadRelaxed();
+}
+
+void CompressedSecondaryCache::TEST_WaitForPendingCompressions() {
+  while (pending_compression_entries_.LoadRelaxed() > 0) {
+    std::this_thread::yield();
+  }
+}
+
 CompressedSecondaryCache::CacheValueChunk*
 CompressedSecondaryCache::SplitValueIntoChunks(const Slice& value,
                                                CompressionType compression_type,
@@ -431,6 +586,16 @@ CompressedSecondaryCacheOptions::MakeSharedSecondaryCache() const {
   return std::make_shared<CompressedSecondaryCache>(*this);
 }
 
+Status GetCompressedSecondaryCacheStats(const SecondaryCache& secondary_cache,
+                                        CompressedSecondaryCacheStats* stats) {
+  const auto* cache = secondary_cache.CheckedCast<CompressedSecondaryCache>();
+  if (cache == nullptr) {
+    return Status::InvalidArgument("Not a CompressedSecondaryCache");
+  }
+  cache->GetStats(stats);
+  return Status::OK();
+}
+
 Status CompressedSecondaryCache::Deflate(size_t decrease) {
   return cache_res_mgr_->UpdateCacheReservation(decrease, /*increase=*/true);
 }
@@ -8,6 +8,7 @@
 #include <array>
 #include <cstddef>
 #include <memory>
+#include <string>
 
 #include "cache/cache_reservation_manager.h"
 #include "cache/lru_cache.h"
@@ -15,6 +16,8 @@
 #include "rocksdb/secondary_cache.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/status.h"
+#include "rocksdb/threadpool.h"
+#include "util/atomic.h"
 #include "util/compression.h"
 #include "util/mutexlock.h"
 
@@ -61,6 +64,15 @@ class CompressedSecondaryCacheResultHandle : public SecondaryCacheResultHandle {
 //    CompressedSecondaryCache.
 // 2. If not, we just insert a dummy block (size 0) in CompressedSecondaryCache.
 //
+// Each entry is compressed with CompressedSecondaryCacheOptions::
+// compression_type, or cold_compression_type if it was neither hit in the
+// primary cache before its eviction (force_insert) nor hit in this cache
+// before (a "hit" dummy block, inserted by Lookup() with advise_erase). An
+// entry not compressing well enough is stored uncompressed, and the
+// compression type of each entry is recorded in its header. With
+// compression_threads > 0, the entry is copied by Insert() and compressed and
+// inserted into the cache by a background thread.
+//
 // Users can also cast a pointer to CompressedSecondaryCache and call methods on
 // it directly, especially custom methods that may be added
 // in the future.  For example -
@@ -74,7 +86,8 @@ class CompressedSecondaryCache : public SecondaryCache {
       const CompressedSecondaryCacheOptions& opts);
   ~CompressedSecondaryCache() override;
 
-  const char* Name() const override { return "CompressedSecondaryCache"; }
+  static const char* kClassName() { return "CompressedSecondaryCache"; }
+  const char* Name() const override { return kClassName(); }
 
   Status Insert(const Slice& key, Cache::ObjectPtr value,
                 const Cache::CacheItemHelper* helper,
@@ -104,8 +117,13 @@ class CompressedSecondaryCache : public SecondaryCache {
 
   std::string GetPrintableOptions() const override;
 
+  void GetStats(CompressedSecondaryCacheStats* stats) const;
+
   size_t TEST_GetUsage() { return cache_->GetUsage(); }
 
+  // Waits for the background threads to insert all the pending entries
+  void TEST_WaitForPendingCompressions();
+
  private:
   friend class CompressedSecondaryCacheTestBase;
   static constexpr std::array<uint16_t, 8> malloc_bin_sizes_{
@@ -133,11 +151,42 @@ class CompressedSecondaryCache : public SecondaryCache {
   CacheAllocationPtr MergeChunksIntoValue(const void* chunks_head,
                                           size_t& charge);
 
-  bool MaybeInsertDummy(const Slice& key);
+  // An uncompressed entry waiting for a background thread
+  struct PendingEntry {
+    std::string key;
+    CacheAllocationPtr data;
+    size_t size = 0;
+    CompressionType compression_type = kNoCompression;
+  };
+
+  // Cumulative counters by compression type of the entries inserted
+  struct CodecCounters {
+    RelaxedAtomic<uint64_t> num_inserted_entries{0};
+    RelaxedAtomic<uint64_t> inserted_uncompressed_bytes{0};
+    RelaxedAtomic<uint64_t> inserted_stored_bytes{0};
+  };
+  // One per value of CompressionType
+  static constexpr size_t kNumCodecCounters = 256;
+
+  // Returns true if a dummy block was inserted, or else sets `*was_hit` (if
+  // not nullptr) to whether the existing block is a dummy inserted on a hit
+  bool MaybeInsertDummy(const Slice& key, bool* was_hit = nullptr);
+
+  // The compression type for an uncompressed entry of `role`
+  CompressionType GetCompressionType(CacheEntryRole role, bool hot) const;
 
   Status InsertInternal(const Slice& key, Cache::ObjectPtr value,
                         const Cache::CacheItemHelper* helper,
-                        CompressionType type, CacheTier source);
+                        CompressionType type, CacheTier source, bool hot);
+
+  // Compresses `data` with `compression_type` (unless kNoCompression) and
+  // inserts it. `type` and `source` are as in InsertSaved(). If not nullptr,
+  // `saved` holds `data` after room for the header of the entry, to be
+  // reused if stored uncompressed.
+  Status CompressAndInsert(const Slice& key, const Slice& data,
+                           CacheAllocationPtr* saved,
+                           CompressionType compression_type,
+                           CompressionType type, CacheTier source);
 
   size_t TEST_GetCharge(const Slice& key);
 
@@ -148,6 +197,13 @@ class CompressedSecondaryCache : public SecondaryCache {
   mutable port::Mutex capacity_mutex_;
   std::shared_ptr<ConcurrentCacheReservationManager> cache_res_mgr_;
   bool disable_cache_;
+  // cold_compression_type of the options, resolved to the type to use
+  CompressionType cold_compression_type_;
+  std::unique_ptr<CodecCounters[]> codec_counters_;
+  RelaxedAtomic<uint64_t> pending_compression_entries_{0};
+  RelaxedAtomic<uint64_t> pending_compression_bytes_{0};
+  // Last member, so that the threads are joined first on destruction
+  std::unique_ptr<ThreadPool> compression_pool_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -7,6 +7,7 @@
 
 #include <array>
 #include <iterator>
+#include <map>
 #include <memory>
 #include <tuple>
 
@@ -980,6 +981,233 @@ TEST_P(CompressedSecondaryCacheTest, SplictValueAndMergeChunksTest) {
   SplictValueAndMergeChunksTest();
 }
 
+TEST_P(CompressedSecondaryCacheTest, StatsWithoutCompression) {
+  CompressedSecondaryCacheOptions opts;
+  opts.capacity = 1 << 20;
+  opts.num_shard_bits = 0;
+  opts.compression_type = kNoCompression;
+  std::shared_ptr<SecondaryCache> sec_cache = NewCompressedSecondaryCache(opts);
+
+  CompressedSecondaryCacheStats stats;
+  ASSERT_OK(GetCompressedSecondaryCacheStats(*sec_cache, &stats));
+  ASSERT_EQ(stats.capacity, opts.capacity);
+  ASSERT_EQ(stats.effective_capacity, 0);
+  ASSERT_TRUE(stats.codecs.empty());
+
+  Random rnd(301);
+  std::string str1 = rnd.RandomString(1000);
+  TestItem item1(str1.data(), str1.length());
+  ASSERT_OK(sec_cache->Insert(key1, &item1, GetHelper(), true));
+  std::string str2 = rnd.RandomString(500);
+  TestItem item2(str2.data(), str2.length());
+  // Only a dummy block the first time
+  ASSERT_OK(sec_cache->Insert(key2, &item2, GetHelper(), false));
+  ASSERT_OK(sec_cache->Insert(key2, &item2, GetHelper(), false));
+
+  ASSERT_OK(GetCompressedSecondaryCacheStats(*sec_cache, &stats));
+  ASSERT_EQ(stats.codecs.size(), 1);
+  ASSERT_EQ(stats.codecs[0].type, kNoCompression);
+  ASSERT_EQ(stats.codecs[0].num_inserted_entries, 2);
+  ASSERT_EQ(stats.codecs[0].inserted_uncompressed_bytes, 1500);
+  ASSERT_EQ(stats.codecs[0].inserted_stored_bytes, 1500);
+  ASSERT_EQ(stats.codecs[0].effective_capacity, opts.capacity);
+  ASSERT_EQ(stats.effective_capacity, opts.capacity);
+  ASSERT_EQ(stats.pending_compression_entries, 0);
+}
+
+TEST_P(CompressedSecondaryCacheTest, PerEntryCompressionType) {
+  std::vector<CompressionType> supported;
+  for (CompressionType type : GetSupportedCompressions()) {
+    if (type != kNoCompression) {
+      supported.push_back(type);
+    }
+  }
+  if (supported.empty()) {
+    ROCKSDB_GTEST_BYPASS("Requires compression support");
+    return;
+  }
+  CompressedSecondaryCacheOptions opts;
+  opts.capacity = 1 << 20;
+  opts.num_shard_bits = 0;
+  opts.compression_type = supported.front();
+  opts.cold_compression_type = supported.back();
+  std::shared_ptr<SecondaryCache> sec_cache = NewCompressedSecondaryCache(opts);
+
+  Random rnd(301);
+  std::string compressible;
+  std::string part = rnd.RandomString(100);
+  for (int i = 0; i < 10; ++i) {
+    compressible.append(part);
+  }
+  std::string junk = rnd.RandomString(1000);
+  TestItem item(compressible.data(), compressible.length());
+  TestItem junk_item(junk.data(), junk.length());
+
+  std::map<CompressionType, uint64_t> expected;
+  // Hot, as hit in the primary cache
+  ASSERT_OK(sec_cache->Insert(key0, &item, GetHelper(), true));
+  expected[opts.compression_type]++;
+  // Cold, as admitted on its second eviction
+  ASSERT_OK(sec_cache->Insert(key1, &item, GetHelper(), false));
+  ASSERT_OK(sec_cache->Insert(key1, &item, GetHelper(), false));
+  expected[opts.cold_compression_type]++;
+  // Kept uncompressed, as not compressible
+  ASSERT_OK(sec_cache->Insert(key2, &junk_item, GetHelper(), true));
+  expected[kNoCompression]++;
+
+  bool kept_in_sec_cache = false;
+  for (const std::string* key : {&key0, &key1, &key2}) {
+    std::unique_ptr<SecondaryCacheResultHandle> handle =
+        sec_cache->Lookup(*key, GetHelper(), this, true,
+                          /*advise_erase=*/true, /*stats=*/nullptr,
+                          kept_in_sec_cache);
+    ASSERT_NE(handle, nullptr);
+    std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+    if (key == &key2) {
+      ASSERT_EQ(Slice(val->Buf(), val->Size()), junk);
+    } else {
+      ASSERT_EQ(Slice(val->Buf(), val->Size()), compressible);
+    }
+  }
+
+  // Hot, as hit in this cache before
+  ASSERT_OK(sec_cache->Insert(key1, &item, GetHelper(), false));
+  expected[opts.compression_type]++;
+
+  CompressedSecondaryCacheStats stats;
+  ASSERT_OK(GetCompressedSecondaryCacheStats(*sec_cache, &stats));
+  std::map<CompressionType, uint64_t> actual;
+  uint64_t effective_capacity = 0;
+  for (const auto& codec : stats.codecs) {
+    actual[codec.type] = codec.num_inserted_entries;
+    effective_capacity += codec.effective_capacity;
+    if (codec.type == kNoCompression) {
+      ASSERT_EQ(codec.inserted_stored_bytes,
+                codec.inserted_uncompressed_bytes);
+    } else {
+      ASSERT_LT(codec.inserted_stored_bytes,
+                codec.inserted_uncompressed_bytes);
+    }
+  }
+  ASSERT_EQ(actual, expected);
+  ASSERT_EQ(stats.effective_capacity, effective_capacity);
+  ASSERT_GT(stats.effective_capacity, stats.capacity);
+}
+
+TEST_P(CompressedSecondaryCacheTest, ColdCompressionOnly) {
+  std::vector<CompressionType> supported;
+  for (CompressionType type : GetSupportedCompressions()) {
+    if (type != kNoCompression) {
+      supported.push_back(type);
+    }
+  }
+  if (supported.empty()) {
+    ROCKSDB_GTEST_BYPASS("Requires compression support");
+    return;
+  }
+  CompressedSecondaryCacheOptions opts;
+  opts.capacity = 1 << 20;
+  opts.num_shard_bits = 0;
+  opts.compression_type = kNoCompression;
+  opts.cold_compression_type = supported.back();
+  std::shared_ptr<SecondaryCache> sec_cache = NewCompressedSecondaryCache(opts);
+
+  Random rnd(301);
+  std::string compressible;
+  std::string part = rnd.RandomString(100);
+  for (int i = 0; i < 10; ++i) {
+    compressible.append(part);
+  }
+  TestItem item(compressible.data(), compressible.length());
+
+  // Hot, as hit in the primary cache
+  ASSERT_OK(sec_cache->Insert(key0, &item, GetHelper(), true));
+  // Cold, as admitted on its second eviction
+  ASSERT_OK(sec_cache->Insert(key1, &item, GetHelper(), false));
+  ASSERT_OK(sec_cache->Insert(key1, &item, GetHelper(), false));
+
+  CompressedSecondaryCacheStats stats;
+  ASSERT_OK(GetCompressedSecondaryCacheStats(*sec_cache, &stats));
+  std::map<CompressionType, uint64_t> actual;
+  for (const auto& codec : stats.codecs) {
+    actual[codec.type] = codec.num_inserted_entries;
+  }
+  std::map<CompressionType, uint64_t> expected{
+      {kNoCompression, 1}, {opts.cold_compression_type, 1}};
+  ASSERT_EQ(actual, expected);
+
+  bool kept_in_sec_cache = false;
+  for (const std::string* key : {&key0, &key1}) {
+    std::unique_ptr<SecondaryCacheResultHandle> handle =
+        sec_cache->Lookup(*key, GetHelper(), this, true,
+                          /*advise_erase=*/true, /*stats=*/nullptr,
+                          kept_in_sec_cache);
+    ASSERT_NE(handle, nullptr);
+    std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+    ASSERT_EQ(Slice(val->Buf(), val->Size()), compressible);
+  }
+}
+
+TEST_P(CompressedSecondaryCacheTest, BackgroundCompression) {
+  std::vector<CompressionType> supported;
+  for (CompressionType type : GetSupportedCompressions()) {
+    if (type != kNoCompression) {
+      supported.push_back(type);
+    }
+  }
+  if (supported.empty()) {
+    ROCKSDB_GTEST_BYPASS("Requires compression support");
+    return;
+  }
+  for (size_t max_pending : {size_t{0}, size_t{1} << 20}) {
+    CompressedSecondaryCacheOptions opts;
+    opts.capacity = 1 << 20;
+    opts.num_shard_bits = 0;
+    opts.compression_type = supported.front();
+    opts.compression_threads = 2;
+    opts.max_pending_compression_bytes = max_pending;
+    std::shared_ptr<SecondaryCache> sec_cache =
+        NewCompressedSecondaryCache(opts);
+    auto comp_sec_cache =
+        static_cast<CompressedSecondaryCache*>(sec_cache.get());
+
+    Random rnd(301);
+    constexpr int kNumEntries = 20;
+    std::vector<std::string> values;
+    for (int i = 0; i < kNumEntries; ++i) {
+      std::string part = rnd.RandomString(100);
+      std::string value;
+      for (int j = 0; j < 10; ++j) {
+        value.append(part);
+      }
+      TestItem item(value.data(), value.length());
+      ASSERT_OK(
+          sec_cache->Insert(std::to_string(i), &item, GetHelper(), true));
+      values.push_back(std::move(value));
+    }
+    comp_sec_cache->TEST_WaitForPendingCompressions();
+
+    CompressedSecondaryCacheStats stats;
+    ASSERT_OK(GetCompressedSecondaryCacheStats(*sec_cache, &stats));
+    ASSERT_EQ(stats.pending_compression_entries, 0);
+    ASSERT_EQ(stats.pending_compression_bytes, 0);
+    ASSERT_EQ(stats.codecs.size(), 1);
+    ASSERT_EQ(stats.codecs[0].type, opts.compression_type);
+    ASSERT_EQ(stats.codecs[0].num_inserted_entries, kNumEntries);
+
+    for (int i = 0; i < kNumEntries; ++i) {
+      bool kept_in_sec_cache = false;
+      std::unique_ptr<SecondaryCacheResultHandle> handle =
+          sec_cache->Lookup(std::to_string(i), GetHelper(), this, true,
+                            /*advise_erase=*/false, /*stats=*/nullptr,
+                            kept_in_sec_cache);
+      ASSERT_NE(handle, nullptr);
+      std::unique_ptr<TestItem> val(static_cast<TestItem*>(handle->Value()));
+      ASSERT_EQ(Slice(val->Buf(), val->Size()), values[i]);
+    }
+  }
+}
+
 using secondary_cache_test_util::WithCacheType;
 
 class CompressedSecCacheTestWithTiered
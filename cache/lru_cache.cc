@@ -200,6 +200,20 @@ void LRUCacheShard::ApplyToSomeEntries(
       index_begin, index_end);
 }
 
+void LRUCacheShard::ApplyToEvictionCandidates(
+    size_t charge, size_t max_entries,
+    const std::function<void(const Slice& key)>& callback) {
+  DMutexLock l(mutex_);
+  // Same order and stopping condition as EvictFromLRU
+  size_t usage = usage_;
+  for (LRUHandle* e = lru_.next;
+       e != &lru_ && usage + charge > capacity_ && max_entries > 0;
+       e = e->next, --max_entries) {
+    callback(e->key());
+    usage -= e->total_charge;
+  }
+}
+
 void LRUCacheShard::TEST_GetLRUList(LRUHandle** lru, LRUHandle** lru_low_pri,
                                     LRUHandle** lru_bottom_pri) {
   DMutexLock l(mutex_);
@@ -343,6 +357,7 @@ void LRUCacheShard::NotifyEvicted(
         eviction_callback_(entry->key(), static_cast<Cache::Handle*>(entry),
                            entry->HasHit())) {
       // Callback took ownership of obj; just free handle
+      entry->UnchargeOwner();
       free(entry);
     } else {
       // Free the entries here outside of mutex for performance reasons.
@@ -388,6 +403,7 @@ Status LRUCacheShard::InsertItem(LRUHandle* e, LRUHandle** handle) {
         // into cache and get evicted immediately.
         last_reference_list.push_back(e);
       } else {
+        e->UnchargeOwner();
         free(e);
         e = nullptr;
         *handle = nullptr;
@@ -509,6 +525,7 @@ bool LRUCacheShard::Release(LRUHandle* e, bool /*useful*/,
         eviction_callback_(e->key(), static_cast<Cache::Handle*>(e),
                            e->HasHit())) {
       // Callback took ownership of obj; just free handle
+      e->UnchargeOwner();
       free(e);
     } else {
       e->Free(table_.GetAllocator());
@@ -541,6 +558,7 @@ LRUHandle* LRUCacheShard::CreateHandle(const Slice& key, uint32_t hash,
   e->next = e->prev = nullptr;
   memcpy(e->key_data, key.data(), key.size());
   e->CalcTotalCharge(charge, metadata_charge_policy_);
+  e->ChargeOwner();
 
   return e;
 }
@@ -574,8 +592,12 @@ LRUHandle* LRUCacheShard::CreateStandalone(const Slice& key, uint32_t hash,
 
     if (strict_capacity_limit_ && (usage_ + e->total_charge) > capacity_) {
       if (allow_uncharged) {
+        // Recharged to the owner without the charge
+        e->UnchargeOwner();
         e->total_charge = 0;
+        e->ChargeOwner();
       } else {
+        e->UnchargeOwner();
         free(e);
         e = nullptr;
       }
@@ -687,6 +709,13 @@ void LRUCache::ApplyToHandle(
            h->helper);
 }
 
+void LRUCache::ApplyToEvictionCandidates(
+    const Slice& key, size_t charge, size_t max_entries,
+    const std::function<void(const Slice& key)>& callback) {
+  GetShard(LRUCacheShard::ComputeHash(key, GetHashSeed()))
+      .ApplyToEvictionCandidates(charge, max_entries, callback);
+}
+
 size_t LRUCache::TEST_GetLRUSize() {
   return SumOverShards([](LRUCacheShard& cs) { return cs.TEST_GetLRUSize(); });
 }
@@ -11,6 +11,7 @@
 #include <memory>
 #include <string>
 
+#include "cache/cache_owner.h"
 #include "cache/sharded_cache.h"
 #include "port/lang.h"
 #include "port/likely.h"
@@ -170,9 +171,23 @@ struct LRUHandle : public Cache::Handle {
       helper->del_cb(value, allocator);
     }
 
+    UnchargeOwner();
     free(this);
   }
 
+  // Adds or removes the entry and its total charge to or from the owner of
+  // the entry, if any (see CacheOwner)
+  void ChargeOwner() {
+    if (helper->owner != nullptr) {
+      helper->owner->AddEntry(total_charge);
+    }
+  }
+  void UnchargeOwner() {
+    if (helper->owner != nullptr) {
+      helper->owner->RemoveEntry(total_charge);
+    }
+  }
+
   inline size_t CalcuMetaCharge(
       CacheMetadataChargePolicy metadata_charge_policy) const {
     if (metadata_charge_policy != kFullChargeCacheMetadata) {
@@ -333,6 +348,13 @@ class ALIGN_AS(CACHE_LINE_SIZE) LRUCacheShard final : public CacheShardBase {
 
   void EraseUnRefEntries();
 
+  // Calls `callback` with the keys of the entries that would be evicted, in
+  // order, to make room for a new entry of the given charge, stopping after
+  // `max_entries`. The callback runs under the shard mutex.
+  void ApplyToEvictionCandidates(
+      size_t charge, size_t max_entries,
+      const std::function<void(const Slice& key)>& callback);
+
  public:  // other function definitions
   void TEST_GetLRUList(LRUHandle** lru, LRUHandle** lru_low_pri,
                        LRUHandle** lru_bottom_pri);
@@ -447,7 +469,8 @@ class LRUCache
     : public ShardedCache<LRUCacheShard> {
  public:
   explicit LRUCache(const LRUCacheOptions& opts);
-  const char* Name() const override { return "LRUCache"; }
+  static const char* kClassName() { return "LRUCache"; }
+  const char* Name() const override { return kClassName(); }
   ObjectPtr Value(Handle* handle) override;
   size_t GetCharge(Handle* handle) const override;
   const CacheItemHelper* GetCacheItemHelper(Handle* handle) const override;
@@ -458,6 +481,11 @@ class LRUCache
                                const CacheItemHelper* helper)>& callback)
       override;
 
+  // LRUCacheShard::ApplyToEvictionCandidates() on the shard of `key`
+  void ApplyToEvictionCandidates(
+      const Slice& key, size_t charge, size_t max_entries,
+      const std::function<void(const Slice& key)>& callback);
+
   // Retrieves number of elements in LRU, for unit test purpose only.
   size_t TEST_GetLRUSize();
   // Retrieves high pri pool ratio.
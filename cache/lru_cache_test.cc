@@ -2412,6 +2412,94 @@ TEST_P(DBSecondaryCacheTest, LRUCacheDumpLoadWithFilter) {
   ASSERT_OK(DestroyDB(dbname2, options));
 }
 
+TEST_P(DBSecondaryCacheTest, BlockCacheSnapshotSaveLoad) {
+  std::shared_ptr<CacheWithStats> cache = std::make_shared<CacheWithStats>(
+      NewCache(1024 * 1024 /* capacity */, 0 /* num_shard_bits */,
+               false /* strict_capacity_limit */));
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = cache;
+  table_options.block_size = 4 * 1024;
+  Options options = GetDefaultOptions();
+  options.create_if_missing = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  options.env = fault_env_.get();
+  DestroyAndReopen(options);
+
+  const int N = 256;
+  const std::string value(1000, 'a');
+  for (int i = 0; i < N; i++) {
+    ASSERT_OK(Put(Key(i), value));
+  }
+  ASSERT_OK(Flush());
+  cache->ResetCount();
+  for (int i = 0; i < N; i++) {
+    ASSERT_EQ(value, Get(Key(i)));
+  }
+  const uint32_t num_blocks = cache->GetInsertCount();
+  ASSERT_GT(num_blocks, 0U);
+
+  BlockCacheSnapshotOptions snapshot_options;
+  snapshot_options.num_shards = 4;
+  const std::string snapshot_dir = dbname_ + "/cache_snapshot";
+  ASSERT_OK(SaveBlockCacheSnapshot(snapshot_options, db_, {}, snapshot_dir));
+  std::vector<std::string> files;
+  ASSERT_OK(env_->GetChildren(snapshot_dir, &files));
+  int num_files = 0;
+  for (const std::string& f : files) {
+    num_files += Slice(f).starts_with("block_cache_snapshot.") ? 1 : 0;
+  }
+  ASSERT_EQ(4, num_files);
+
+  // Reopen with an empty block cache, and load the snapshot
+  cache = std::make_shared<CacheWithStats>(
+      NewCache(1024 * 1024 /* capacity */, 0 /* num_shard_bits */,
+               false /* strict_capacity_limit */));
+  table_options.block_cache = cache;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  cache->ResetCount();
+  ASSERT_OK(LoadBlockCacheSnapshot(snapshot_options, db_, {}, snapshot_dir));
+  ASSERT_EQ(num_blocks, cache->GetInsertCount());
+
+  // All the reads are served from the loaded blocks
+  cache->ResetCount();
+  for (int i = 0; i < N; i++) {
+    ASSERT_EQ(value, Get(Key(i)));
+  }
+  ASSERT_EQ(0, static_cast<int>(cache->GetInsertCount()));
+  ASSERT_EQ(N, static_cast<int>(cache->GetLookupcount()));
+
+  // Blocks of files no longer live are skipped
+  ASSERT_OK(Put(Key(0), value));
+  CompactRangeOptions cro;
+  cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+  ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+  cache = std::make_shared<CacheWithStats>(
+      NewCache(1024 * 1024 /* capacity */, 0 /* num_shard_bits */,
+               false /* strict_capacity_limit */));
+  table_options.block_cache = cache;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  cache->ResetCount();
+  ASSERT_OK(LoadBlockCacheSnapshot(snapshot_options, db_, {}, snapshot_dir));
+  ASSERT_EQ(0, static_cast<int>(cache->GetInsertCount()));
+
+  // A record whose sizes go past the end of the file is rejected before its
+  // contents are read
+  const std::string shard_file = snapshot_dir + "/block_cache_snapshot.0";
+  std::string contents;
+  ASSERT_OK(ReadFileToString(env_, shard_file, &contents));
+  // File header, then the checksum and key size of the first record
+  const size_t block_size_offset = 12 + 4 + 4;
+  ASSERT_GT(contents.size(), block_size_offset + 4);
+  EncodeFixed32(&contents[block_size_offset], 0xffffffff);
+  ASSERT_OK(WriteStringToFile(env_, contents, shard_file));
+  ASSERT_TRUE(LoadBlockCacheSnapshot(snapshot_options, db_, {}, snapshot_dir)
+                  .IsCorruption());
+
+  Destroy(options);
+}
+
 // Test the option not to use the secondary cache in a certain DB.
 TEST_P(DBSecondaryCacheTest, TestSecondaryCacheOptionBasic) {
   std::shared_ptr<TestSecondaryCache> secondary_cache(
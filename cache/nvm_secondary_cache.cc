@@ -0,0 +1,455 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/nvm_secondary_cache.h"
+
+#include <cinttypes>
+#include <cstring>
+#include <limits>
+
+#include "test_util/sync_point.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+NvmSecondaryCacheResultHandle::~NvmSecondaryCacheResultHandle() {
+  if (io_handle_ != nullptr && !read_done_) {
+    std::vector<void*> io_handles{io_handle_};
+    cache_->opts_.fs->AbortIO(io_handles).PermitUncheckedError();
+  }
+  DestroyIOHandle();
+}
+
+bool NvmSecondaryCacheResultHandle::IsReady() {
+  if (!ready_ && read_done_) {
+    Complete();
+  }
+  return ready_;
+}
+
+void NvmSecondaryCacheResultHandle::Wait() {
+  if (!read_done_) {
+    assert(io_handle_ != nullptr);
+    std::vector<void*> io_handles{io_handle_};
+    IOStatus s = cache_->opts_.fs->Poll(io_handles, /*min_completions=*/1);
+    if (!s.ok()) {
+      read_done_ = true;
+      read_status_ = s;
+    }
+  }
+  if (!ready_) {
+    Complete();
+  }
+}
+
+void NvmSecondaryCacheResultHandle::ReadCallback(FSReadRequest& req,
+                                                 void* cb_arg) {
+  auto* handle = static_cast<NvmSecondaryCacheResultHandle*>(cb_arg);
+  handle->read_status_ = req.status;
+  handle->read_result_ = req.result;
+  handle->read_done_ = true;
+}
+
+void NvmSecondaryCacheResultHandle::Complete() {
+  assert(read_done_);
+  DestroyIOHandle();
+  // The region might have been reused since the lookup
+  if (read_status_.ok() && read_result_.size() == buf_size_ &&
+      cache_->IsRegionCurrent(region_, epoch_)) {
+    NvmSecondaryCache::CreateFromRecord(read_result_, key_, helper_,
+                                        create_context_, &value_, &size_);
+  }
+  read_status_.PermitUncheckedError();
+  buf_.reset();
+  ready_ = true;
+}
+
+void NvmSecondaryCacheResultHandle::DestroyIOHandle() {
+  if (io_handle_ != nullptr && del_fn_ != nullptr) {
+    del_fn_(io_handle_);
+  }
+  io_handle_ = nullptr;
+  del_fn_ = nullptr;
+}
+
+NvmSecondaryCache::NvmSecondaryCache(
+    const NvmSecondaryCacheOptions& opts,
+    std::unique_ptr<FSRandomRWFile>&& writer,
+    std::unique_ptr<FSRandomAccessFile>&& reader)
+    : opts_(opts),
+      num_regions_(static_cast<uint32_t>(opts.capacity / opts.region_size)),
+      writer_(std::move(writer)),
+      reader_(std::move(reader)),
+      cv_(&mutex_),
+      region_keys_(num_regions_),
+      region_epochs_(num_regions_, 0),
+      write_buf_(new char[opts.region_size]) {
+  assert(opts_.fs != nullptr);
+  assert(num_regions_ > 0);
+  writer_thread_ = port::Thread(&NvmSecondaryCache::BackgroundWriter, this);
+}
+
+NvmSecondaryCache::~NvmSecondaryCache() {
+  {
+    MutexLock l(&mutex_);
+    // Regions not written out yet are dropped with the cache
+    shutting_down_ = true;
+    cv_.SignalAll();
+  }
+  writer_thread_.join();
+  writer_->Close(IOOptions(), /*dbg=*/nullptr).PermitUncheckedError();
+}
+
+template <typename FillFn>
+Status NvmSecondaryCache::AppendRecord(const Slice& key, size_t data_size,
+                                       CompressionType type, CacheTier source,
+                                       const FillFn& fill) {
+  const size_t record_size = kRecordHeaderSize + key.size() + data_size;
+  if (record_size > opts_.region_size) {
+    // Not cached
+    return Status::OK();
+  }
+
+  MutexLock l(&mutex_);
+  std::string key_str = key.ToString();
+  if (index_.find(key_str) != index_.end()) {
+    return Status::OK();
+  }
+  if (write_pos_ + record_size > opts_.region_size && !SwitchRegion()) {
+    // Not cached, rather than waiting for the flash
+    return Status::OK();
+  }
+
+  char* record = write_buf_.get() + write_pos_;
+  EncodeFixed32(record + 4, static_cast<uint32_t>(key.size()));
+  EncodeFixed32(record + 8, static_cast<uint32_t>(data_size));
+  record[12] = static_cast<char>(type);
+  record[13] = static_cast<char>(source);
+  memcpy(record + kRecordHeaderSize, key.data(), key.size());
+  Status s = fill(record + kRecordHeaderSize + key.size());
+  if (!s.ok()) {
+    return s;
+  }
+  EncodeFixed32(record,
+                crc32c::Mask(crc32c::Value(record + 4, record_size - 4)));
+
+  index_[key_str] = Location{write_region_, static_cast<uint32_t>(write_pos_),
+                             static_cast<uint32_t>(record_size)};
+  region_keys_[write_region_].push_back(std::move(key_str));
+  write_pos_ += record_size;
+  return Status::OK();
+}
+
+bool NvmSecondaryCache::SwitchRegion() {
+  mutex_.AssertHeld();
+
+  if (pending_writes_.size() >= kMaxPendingWrites) {
+    return false;
+  }
+  std::unique_ptr<char[]> buf;
+  if (!free_bufs_.empty()) {
+    buf = std::move(free_bufs_.back());
+    free_bufs_.pop_back();
+  } else {
+    buf.reset(new char[opts_.region_size]);
+  }
+  pending_writes_.push_back(PendingWrite{write_region_,
+                                         region_epochs_[write_region_],
+                                         std::move(write_buf_), write_pos_});
+  write_buf_ = std::move(buf);
+  cv_.SignalAll();
+
+  write_region_ = (write_region_ + 1) % num_regions_;
+  write_pos_ = 0;
+  for (const std::string& key : region_keys_[write_region_]) {
+    auto it = index_.find(key);
+    if (it != index_.end() && it->second.region == write_region_) {
+      index_.erase(it);
+    }
+  }
+  region_keys_[write_region_].clear();
+  ++region_epochs_[write_region_];
+  return true;
+}
+
+void NvmSecondaryCache::BackgroundWriter() {
+  MutexLock l(&mutex_);
+  while (true) {
+    while (!shutting_down_ && pending_writes_.empty()) {
+      cv_.Wait();
+    }
+    if (shutting_down_) {
+      return;
+    }
+
+    // Stays at the front of the queue, where lookups find it, until written
+    const PendingWrite& write = pending_writes_.front();
+    const uint32_t region = write.region;
+    const uint64_t epoch = write.epoch;
+    const Slice data(write.buf.get(), write.size);
+    mutex_.Unlock();
+    TEST_SYNC_POINT("NvmSecondaryCache::BackgroundWriter:BeforeWrite");
+    IOStatus s = writer_->Write(uint64_t{region} * opts_.region_size, data,
+                                IOOptions(), /*dbg=*/nullptr);
+    mutex_.Lock();
+
+    // Drop the blocks of the region not written out, unless the region has
+    // already been reclaimed
+    if (!s.ok() && region_epochs_[region] == epoch) {
+      for (const std::string& key : region_keys_[region]) {
+        auto it = index_.find(key);
+        if (it != index_.end() && it->second.region == region) {
+          index_.erase(it);
+        }
+      }
+      region_keys_[region].clear();
+    }
+    free_bufs_.push_back(std::move(pending_writes_.front().buf));
+    pending_writes_.pop_front();
+    cv_.SignalAll();
+  }
+}
+
+bool NvmSecondaryCache::IsRegionCurrent(uint32_t region, uint64_t epoch) {
+  MutexLock l(&mutex_);
+  return region_epochs_[region] == epoch;
+}
+
+Status NvmSecondaryCache::Insert(const Slice& key, Cache::ObjectPtr value,
+                                 const Cache::CacheItemHelper* helper,
+                                 bool /*force_insert*/) {
+  if (value == nullptr || helper == nullptr ||
+      !helper->IsSecondaryCacheCompatible()) {
+    return Status::InvalidArgument();
+  }
+  const size_t data_size = helper->size_cb(value);
+  return AppendRecord(key, data_size, kNoCompression, CacheTier::kVolatileTier,
+                      [&](char* out) {
+                        return helper->saveto_cb(value, 0, data_size, out);
+                      });
+}
+
+Status NvmSecondaryCache::InsertSaved(const Slice& key, const Slice& saved,
+                                      CompressionType type, CacheTier source) {
+  return AppendRecord(key, saved.size(), type, source, [&](char* out) {
+    memcpy(out, saved.data(), saved.size());
+    return Status::OK();
+  });
+}
+
+bool NvmSecondaryCache::CreateFromRecord(const Slice& record, const Slice& key,
+                                         const Cache::CacheItemHelper* helper,
+                                         Cache::CreateContext* create_context,
+                                         Cache::ObjectPtr* value,
+                                         size_t* charge) {
+  if (record.size() < kRecordHeaderSize) {
+    return false;
+  }
+  const char* p = record.data();
+  const uint32_t key_size = DecodeFixed32(p + 4);
+  const uint32_t data_size = DecodeFixed32(p + 8);
+  if (uint64_t{kRecordHeaderSize} + key_size + data_size != record.size() ||
+      crc32c::Unmask(DecodeFixed32(p)) !=
+          crc32c::Value(p + 4, record.size() - 4) ||
+      Slice(p + kRecordHeaderSize, key_size) != key) {
+    return false;
+  }
+  const auto type = static_cast<CompressionType>(p[12]);
+  const auto source = static_cast<CacheTier>(p[13]);
+  Status s = helper->create_cb(
+      Slice(p + kRecordHeaderSize + key_size, data_size), type, source,
+      create_context, /*allocator=*/nullptr, value, charge);
+  if (!s.ok()) {
+    *value = nullptr;
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<SecondaryCacheResultHandle> NvmSecondaryCache::Lookup(
+    const Slice& key, const Cache::CacheItemHelper* helper,
+    Cache::CreateContext* create_context, bool wait, bool /*advise_erase*/,
+    Statistics* /*stats*/, bool& kept_in_sec_cache) {
+  assert(helper);
+  kept_in_sec_cache = false;
+
+  std::unique_ptr<NvmSecondaryCacheResultHandle> handle(
+      new NvmSecondaryCacheResultHandle(this, key, helper, create_context));
+  uint64_t offset = 0;
+  {
+    MutexLock l(&mutex_);
+    auto it = index_.find(handle->key_);
+    if (it == index_.end()) {
+      return nullptr;
+    }
+    const Location& loc = it->second;
+    handle->region_ = loc.region;
+    handle->epoch_ = region_epochs_[loc.region];
+    handle->buf_size_ = loc.size;
+    handle->buf_.reset(new char[loc.size]);
+    const char* region_buf = nullptr;
+    if (loc.region == write_region_) {
+      region_buf = write_buf_.get();
+    } else {
+      for (const PendingWrite& write : pending_writes_) {
+        // Entries in the index are from the current epoch of their region
+        if (write.region == loc.region &&
+            write.epoch == region_epochs_[loc.region]) {
+          region_buf = write.buf.get();
+        }
+      }
+    }
+    if (region_buf != nullptr) {
+      // Not written out yet
+      memcpy(handle->buf_.get(), region_buf + loc.offset, loc.size);
+      handle->read_result_ = Slice(handle->buf_.get(), loc.size);
+      handle->read_done_ = true;
+    } else {
+      offset = uint64_t{loc.region} * opts_.region_size + loc.offset;
+    }
+  }
+
+  if (!handle->read_done_) {
+    FSReadRequest req;
+    req.offset = offset;
+    req.len = handle->buf_size_;
+    req.scratch = handle->buf_.get();
+    IOStatus s = reader_->ReadAsync(
+        req, IOOptions(), NvmSecondaryCacheResultHandle::ReadCallback,
+        handle.get(), &handle->io_handle_, &handle->del_fn_, /*dbg=*/nullptr);
+    req.status.PermitUncheckedError();
+    if (s.IsNotSupported()) {
+      // No asynchronous reads on this file system (e.g. POSIX without
+      // io_uring)
+      handle->DestroyIOHandle();
+      s = reader_->Read(offset, handle->buf_size_, IOOptions(),
+                        &handle->read_result_, handle->buf_.get(),
+                        /*dbg=*/nullptr);
+      handle->read_done_ = s.ok();
+    }
+    if (!s.ok()) {
+      handle->DestroyIOHandle();
+      return nullptr;
+    }
+  }
+
+  if (wait) {
+    handle->Wait();
+  } else {
+    handle->IsReady();
+  }
+  kept_in_sec_cache = true;
+  return handle;
+}
+
+void NvmSecondaryCache::WaitAll(
+    std::vector<SecondaryCacheResultHandle*> handles) {
+  std::vector<void*> io_handles;
+  for (SecondaryCacheResultHandle* h : handles) {
+    auto* handle = static_cast<NvmSecondaryCacheResultHandle*>(h);
+    if (!handle->read_done_ && handle->io_handle_ != nullptr) {
+      io_handles.push_back(handle->io_handle_);
+    }
+  }
+  if (!io_handles.empty()) {
+    opts_.fs->Poll(io_handles, io_handles.size()).PermitUncheckedError();
+  }
+  for (SecondaryCacheResultHandle* h : handles) {
+    // Falls back to waiting on the handle alone if the poll failed
+    h->Wait();
+  }
+}
+
+void NvmSecondaryCache::Erase(const Slice& key) {
+  MutexLock l(&mutex_);
+  // The space is only reclaimed with the region
+  index_.erase(key.ToString());
+}
+
+Status NvmSecondaryCache::GetCapacity(size_t& capacity) {
+  capacity = opts_.capacity;
+  return Status::OK();
+}
+
+std::string NvmSecondaryCache::GetPrintableOptions() const {
+  std::string ret;
+  ret.reserve(2000);
+  const int kBufferSize = 200;
+  char buffer[kBufferSize];
+  snprintf(buffer, kBufferSize, "    path : %s\n", opts_.path.c_str());
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    capacity : %" ROCKSDB_PRIszt "\n",
+           opts_.capacity);
+  ret.append(buffer);
+  snprintf(buffer, kBufferSize, "    region_size : %" ROCKSDB_PRIszt "\n",
+           opts_.region_size);
+  ret.append(buffer);
+  return ret;
+}
+
+size_t NvmSecondaryCache::TEST_GetNumEntries() {
+  MutexLock l(&mutex_);
+  return index_.size();
+}
+
+void NvmSecondaryCache::TEST_WaitForPendingWrites() {
+  MutexLock l(&mutex_);
+  while (!pending_writes_.empty()) {
+    cv_.Wait();
+  }
+}
+
+Status NewNvmSecondaryCache(const NvmSecondaryCacheOptions& opts,
+                            std::shared_ptr<SecondaryCache>* result) {
+  if (result == nullptr) {
+    return Status::InvalidArgument("result is nullptr");
+  }
+  if (opts.path.empty()) {
+    return Status::InvalidArgument("NvmSecondaryCache needs a path");
+  }
+  if (opts.region_size == 0 ||
+      opts.region_size > std::numeric_limits<uint32_t>::max() ||
+      opts.capacity < opts.region_size) {
+    return Status::InvalidArgument(
+        "NvmSecondaryCache capacity must be at least one region, with a "
+        "region size no larger than 4GB");
+  }
+
+  NvmSecondaryCacheOptions sanitized = opts;
+  if (sanitized.fs == nullptr) {
+    sanitized.fs = FileSystem::Default();
+  }
+  FileSystem* fs = sanitized.fs.get();
+  const FileOptions file_opts;
+
+  // Start from an empty file
+  std::unique_ptr<FSWritableFile> file;
+  IOStatus s = fs->NewWritableFile(sanitized.path, file_opts, &file,
+                                   /*dbg=*/nullptr);
+  if (s.ok()) {
+    s = file->Close(IOOptions(), /*dbg=*/nullptr);
+  }
+  std::unique_ptr<FSRandomRWFile> writer;
+  if (s.ok()) {
+    s = fs->NewRandomRWFile(sanitized.path, file_opts, &writer,
+                            /*dbg=*/nullptr);
+  }
+  std::unique_ptr<FSRandomAccessFile> reader;
+  if (s.ok()) {
+    s = fs->NewRandomAccessFile(sanitized.path, file_opts, &reader,
+                                /*dbg=*/nullptr);
+  }
+  if (!s.ok()) {
+    return s;
+  }
+
+  *result = std::make_shared<NvmSecondaryCache>(sanitized, std::move(writer),
+                                                std::move(reader));
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,210 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/secondary_cache.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class NvmSecondaryCache;
+
+// Result of a lookup in NvmSecondaryCache. Unless the block was found in the
+// region still being filled in memory, the block is read asynchronously, and
+// the handle becomes ready once the read has completed and the object has
+// been created from the data read.
+class NvmSecondaryCacheResultHandle : public SecondaryCacheResultHandle {
+ public:
+  ~NvmSecondaryCacheResultHandle() override;
+
+  bool IsReady() override;
+
+  void Wait() override;
+
+  Cache::ObjectPtr Value() override { return value_; }
+
+  size_t Size() override { return value_ != nullptr ? size_ : 0; }
+
+ private:
+  friend class NvmSecondaryCache;
+
+  NvmSecondaryCacheResultHandle(NvmSecondaryCache* cache, const Slice& key,
+                                const Cache::CacheItemHelper* helper,
+                                Cache::CreateContext* create_context)
+      : cache_(cache),
+        key_(key.ToString()),
+        helper_(helper),
+        create_context_(create_context) {}
+
+  static void ReadCallback(FSReadRequest& req, void* cb_arg);
+
+  // Creates the object from the record read (if any) and marks the handle
+  // ready
+  void Complete();
+
+  void DestroyIOHandle();
+
+  NvmSecondaryCache* const cache_;
+  const std::string key_;
+  const Cache::CacheItemHelper* const helper_;
+  Cache::CreateContext* const create_context_;
+
+  // Where the record was found, and the epoch of the region at that time
+  uint32_t region_ = 0;
+  uint64_t epoch_ = 0;
+
+  std::unique_ptr<char[]> buf_;
+  size_t buf_size_ = 0;
+  void* io_handle_ = nullptr;
+  IOHandleDeleter del_fn_ = nullptr;
+  bool read_done_ = false;
+  IOStatus read_status_;
+  Slice read_result_;
+
+  Cache::ObjectPtr value_ = nullptr;
+  size_t size_ = 0;
+  bool ready_ = false;
+};
+
+// A SecondaryCache storing blocks in a file, normally on local flash (see
+// NvmSecondaryCacheOptions). The file is divided into regions that are
+// filled in turn like a circular log: records are appended to an in-memory
+// buffer for the current region, which is written out when full, and the
+// next region is then reclaimed, evicting all the records in it. An
+// in-memory hash index maps each cached key to its record. Full regions are
+// written out by a background thread, and lookups keep reading a region from
+// its buffer until the write has completed. So that inserts, which come from
+// the eviction path of the primary cache, never wait for the flash, an
+// insert that needs a new region while kMaxPendingWrites regions are still
+// waiting to be written out is dropped.
+//
+// Each record is self-describing (key, compression type and source tier of
+// the data, and a checksum), so that a read racing with the reuse of its
+// region is detected, on top of the region epochs tracked in memory.
+class NvmSecondaryCache : public SecondaryCache {
+ public:
+  NvmSecondaryCache(const NvmSecondaryCacheOptions& opts,
+                    std::unique_ptr<FSRandomRWFile>&& writer,
+                    std::unique_ptr<FSRandomAccessFile>&& reader);
+  ~NvmSecondaryCache() override;
+
+  const char* Name() const override { return "NvmSecondaryCache"; }
+
+  Status Insert(const Slice& key, Cache::ObjectPtr value,
+                const Cache::CacheItemHelper* helper,
+                bool force_insert) override;
+
+  Status InsertSaved(const Slice& key, const Slice& saved,
+                     CompressionType type = kNoCompression,
+                     CacheTier source = CacheTier::kVolatileTier) override;
+
+  std::unique_ptr<SecondaryCacheResultHandle> Lookup(
+      const Slice& key, const Cache::CacheItemHelper* helper,
+      Cache::CreateContext* create_context, bool wait, bool advise_erase,
+      Statistics* stats, bool& kept_in_sec_cache) override;
+
+  // Blocks stay on flash when promoted to the primary cache, so that they
+  // are still available once evicted from there
+  bool SupportForceErase() const override { return false; }
+
+  void Erase(const Slice& key) override;
+
+  void WaitAll(std::vector<SecondaryCacheResultHandle*> handles) override;
+
+  Status GetCapacity(size_t& capacity) override;
+
+  std::string GetPrintableOptions() const override;
+
+  size_t TEST_GetNumEntries();
+  // Waits until all full regions have been written out
+  void TEST_WaitForPendingWrites();
+
+ private:
+  friend class NvmSecondaryCacheResultHandle;
+
+  // Record layout: checksum (fixed32, of everything after it), key size
+  // (fixed32), data size (fixed32), compression type (1 byte), source tier
+  // (1 byte), key, data
+  static constexpr size_t kRecordHeaderSize = 14;
+
+  struct Location {
+    uint32_t region;
+    uint32_t offset;
+    uint32_t size;
+  };
+
+  // Appends a record to the current region, where `fill` writes the
+  // `data_size` bytes of data
+  template <typename FillFn>
+  Status AppendRecord(const Slice& key, size_t data_size, CompressionType type,
+                      CacheTier source, const FillFn& fill);
+
+  // A full region waiting to be written out, with its epoch at the time
+  struct PendingWrite {
+    uint32_t region;
+    uint64_t epoch;
+    std::unique_ptr<char[]> buf;
+    size_t size;
+  };
+  // Regions waiting to be written out (or being written out), each holding
+  // a region_size buffer
+  static constexpr size_t kMaxPendingWrites = 2;
+
+  // Queues the current region to be written out, and reclaims the next one.
+  // Returns false, changing nothing, if kMaxPendingWrites regions are already
+  // waiting.
+  // REQUIRES: mutex_ held
+  bool SwitchRegion();
+  // Writes out the queued regions, in order. If a write fails, the blocks of
+  // the region are dropped.
+  void BackgroundWriter();
+
+  // Returns whether the region has not been reclaimed since it had the given
+  // epoch
+  bool IsRegionCurrent(uint32_t region, uint64_t epoch);
+
+  // Parses the record and creates an object from its data with the helper.
+  // Returns false if the record is not a valid one for the key.
+  static bool CreateFromRecord(const Slice& record, const Slice& key,
+                               const Cache::CacheItemHelper* helper,
+                               Cache::CreateContext* create_context,
+                               Cache::ObjectPtr* value, size_t* charge);
+
+  const NvmSecondaryCacheOptions opts_;
+  const uint32_t num_regions_;
+  std::unique_ptr<FSRandomRWFile> writer_;
+  std::unique_ptr<FSRandomAccessFile> reader_;
+
+  port::Mutex mutex_;
+  // Signaled when a region is queued, when one has been written out, and on
+  // shutdown
+  port::CondVar cv_;
+  std::unordered_map<std::string, Location> index_;
+  // Keys of the records written to each region, for evicting them when the
+  // region is reclaimed
+  std::vector<std::vector<std::string>> region_keys_;
+  // Bumped every time a region is reclaimed
+  std::vector<uint64_t> region_epochs_;
+  // The region being filled in memory
+  uint32_t write_region_ = 0;
+  std::unique_ptr<char[]> write_buf_;
+  size_t write_pos_ = 0;
+  std::deque<PendingWrite> pending_writes_;
+  // Buffers of regions written out, for reuse
+  std::vector<std::unique_ptr<char[]>> free_bufs_;
+  bool shutting_down_ = false;
+  port::Thread writer_thread_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,381 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/nvm_secondary_cache.h"
+
+#include <cstring>
+#include <string>
+
+#include "port/stack_trace.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/file_system.h"
+#include "test_util/sync_point.h"
+#include "test_util/testharness.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+struct TestItem {
+  explicit TestItem(const Slice& _data) : data(_data.ToString()) {}
+  std::string data;
+  CompressionType type = kNoCompression;
+};
+
+size_t SizeCallback(Cache::ObjectPtr obj) {
+  return static_cast<TestItem*>(obj)->data.size();
+}
+
+Status SaveToCallback(Cache::ObjectPtr from_obj, size_t from_offset,
+                      size_t length, char* out) {
+  const std::string& data = static_cast<TestItem*>(from_obj)->data;
+  memcpy(out, data.data() + from_offset, length);
+  return Status::OK();
+}
+
+void DeletionCallback(Cache::ObjectPtr obj, MemoryAllocator* /*alloc*/) {
+  delete static_cast<TestItem*>(obj);
+}
+
+Status CreateCallback(const Slice& data, CompressionType type,
+                      CacheTier /*source*/, Cache::CreateContext* /*context*/,
+                      MemoryAllocator* /*allocator*/, Cache::ObjectPtr* out_obj,
+                      size_t* out_charge) {
+  auto* item = new TestItem(data);
+  item->type = type;
+  *out_obj = item;
+  *out_charge = data.size();
+  return Status::OK();
+}
+
+const Cache::CacheItemHelper kBasicHelper{CacheEntryRole::kMisc,
+                                          &DeletionCallback};
+const Cache::CacheItemHelper kHelper{
+    CacheEntryRole::kMisc, &DeletionCallback, &SizeCallback,
+    &SaveToCallback,       &CreateCallback,   &kBasicHelper};
+
+std::string Key(int k) {
+  std::string key;
+  PutFixed64(&key, static_cast<uint64_t>(k));
+  PutFixed64(&key, 0);
+  return key;
+}
+
+// Completes asynchronous reads only when polled
+class DeferredReadFileSystem : public FileSystemWrapper {
+ public:
+  explicit DeferredReadFileSystem(const std::shared_ptr<FileSystem>& target)
+      : FileSystemWrapper(target) {}
+
+  static const char* kClassName() { return "DeferredReadFileSystem"; }
+  const char* Name() const override { return kClassName(); }
+
+  IOStatus NewRandomAccessFile(const std::string& fname,
+                               const FileOptions& opts,
+                               std::unique_ptr<FSRandomAccessFile>* result,
+                               IODebugContext* dbg) override {
+    std::unique_ptr<FSRandomAccessFile> file;
+    IOStatus s = target()->NewRandomAccessFile(fname, opts, &file, dbg);
+    if (s.ok()) {
+      result->reset(new DeferredReadFile(std::move(file)));
+    }
+    return s;
+  }
+
+  IOStatus Poll(std::vector<void*>& io_handles,
+                size_t /*min_completions*/) override {
+    for (void* io_handle : io_handles) {
+      auto* pending = static_cast<PendingRead*>(io_handle);
+      if (!pending->done) {
+        FSReadRequest& req = pending->req;
+        req.status = pending->file->Read(req.offset, req.len, IOOptions(),
+                                         &req.result, req.scratch, nullptr);
+        pending->done = true;
+        pending->cb(req, pending->cb_arg);
+      }
+    }
+    return IOStatus::OK();
+  }
+
+  IOStatus AbortIO(std::vector<void*>& io_handles) override {
+    for (void* io_handle : io_handles) {
+      static_cast<PendingRead*>(io_handle)->done = true;
+    }
+    return IOStatus::OK();
+  }
+
+ private:
+  struct PendingRead {
+    FSRandomAccessFile* file;
+    FSReadRequest req;
+    std::function<void(FSReadRequest&, void*)> cb;
+    void* cb_arg;
+    bool done = false;
+  };
+
+  class DeferredReadFile : public FSRandomAccessFileOwnerWrapper {
+   public:
+    explicit DeferredReadFile(std::unique_ptr<FSRandomAccessFile>&& file)
+        : FSRandomAccessFileOwnerWrapper(std::move(file)) {}
+
+    IOStatus ReadAsync(FSReadRequest& req, const IOOptions& /*opts*/,
+                       std::function<void(FSReadRequest&, void*)> cb,
+                       void* cb_arg, void** io_handle, IOHandleDeleter* del_fn,
+                       IODebugContext* /*dbg*/) override {
+      auto* pending = new PendingRead{target(), {}, std::move(cb), cb_arg};
+      pending->req.offset = req.offset;
+      pending->req.len = req.len;
+      pending->req.scratch = req.scratch;
+      *io_handle = pending;
+      *del_fn = [](void* h) { delete static_cast<PendingRead*>(h); };
+      return IOStatus::OK();
+    }
+  };
+};
+}  // namespace
+
+class NvmSecondaryCacheTest : public testing::Test {
+ public:
+  static constexpr size_t kRegionSize = 4096;
+  static constexpr size_t kNumRegions = 4;
+  // Four records per region
+  static constexpr size_t kValueSize = 990;
+
+  NvmSecondaryCacheTest()
+      : path_(test::PerThreadDBPath("nvm_secondary_cache_test")) {}
+
+  ~NvmSecondaryCacheTest() override {
+    cache_.reset();
+    Env::Default()->DeleteFile(path_).PermitUncheckedError();
+  }
+
+  void NewCache(std::shared_ptr<FileSystem> fs = nullptr) {
+    NvmSecondaryCacheOptions opts;
+    opts.path = path_;
+    opts.capacity = kNumRegions * kRegionSize;
+    opts.region_size = kRegionSize;
+    opts.fs = std::move(fs);
+    ASSERT_OK(NewNvmSecondaryCache(opts, &cache_));
+  }
+
+  static std::string Value(int k) {
+    return std::string(kValueSize, static_cast<char>('a' + k % 26));
+  }
+
+  // Also waits for the write of the region it fills, so that no insert is
+  // dropped
+  void InsertItem(int k) {
+    TestItem item(Value(k));
+    ASSERT_OK(cache_->Insert(Key(k), &item, &kHelper, /*force_insert=*/false));
+    static_cast<NvmSecondaryCache*>(cache_.get())->TEST_WaitForPendingWrites();
+  }
+
+  // Returns the value found by a (waiting) lookup, or "" on a miss
+  std::string LookupValue(int k) {
+    bool kept_in_sec_cache = false;
+    std::unique_ptr<SecondaryCacheResultHandle> handle =
+        cache_->Lookup(Key(k), &kHelper, /*create_context=*/nullptr,
+                       /*wait=*/true, /*advise_erase=*/false,
+                       /*stats=*/nullptr, kept_in_sec_cache);
+    if (handle == nullptr) {
+      return "";
+    }
+    EXPECT_TRUE(handle->IsReady());
+    EXPECT_TRUE(kept_in_sec_cache);
+    std::unique_ptr<TestItem> item(static_cast<TestItem*>(handle->Value()));
+    if (item == nullptr) {
+      return "";
+    }
+    EXPECT_EQ(item->data.size(), handle->Size());
+    return item->data;
+  }
+
+ protected:
+  std::string path_;
+  std::shared_ptr<SecondaryCache> cache_;
+};
+
+TEST_F(NvmSecondaryCacheTest, InvalidOptions) {
+  NvmSecondaryCacheOptions opts;
+  ASSERT_TRUE(NewNvmSecondaryCache(opts, &cache_).IsInvalidArgument());
+  opts.path = path_;
+  opts.region_size = kRegionSize;
+  opts.capacity = kRegionSize - 1;
+  ASSERT_TRUE(NewNvmSecondaryCache(opts, &cache_).IsInvalidArgument());
+}
+
+TEST_F(NvmSecondaryCacheTest, InsertAndLookup) {
+  NewCache();
+  size_t capacity = 0;
+  ASSERT_OK(cache_->GetCapacity(capacity));
+  ASSERT_EQ(kNumRegions * kRegionSize, capacity);
+
+  ASSERT_EQ("", LookupValue(1));
+  InsertItem(1);
+  ASSERT_EQ(Value(1), LookupValue(1));
+
+  // Saved data keeps its compression type
+  ASSERT_OK(cache_->InsertSaved(Key(2), "compressed", kZSTD));
+  bool kept_in_sec_cache = false;
+  std::unique_ptr<SecondaryCacheResultHandle> handle =
+      cache_->Lookup(Key(2), &kHelper, /*create_context=*/nullptr,
+                     /*wait=*/true, /*advise_erase=*/true, /*stats=*/nullptr,
+                     kept_in_sec_cache);
+  ASSERT_NE(nullptr, handle);
+  std::unique_ptr<TestItem> item(static_cast<TestItem*>(handle->Value()));
+  ASSERT_EQ("compressed", item->data);
+  ASSERT_EQ(kZSTD, item->type);
+
+  cache_->Erase(Key(1));
+  ASSERT_EQ("", LookupValue(1));
+
+  // Too large for a region
+  TestItem large(std::string(kRegionSize, 'x'));
+  ASSERT_OK(cache_->Insert(Key(3), &large, &kHelper, /*force_insert=*/true));
+  ASSERT_EQ("", LookupValue(3));
+}
+
+TEST_F(NvmSecondaryCacheTest, EvictsOldestRegion) {
+  NewCache();
+  // 4 items per region
+  const int kNumItems = 4 * static_cast<int>(kNumRegions + 2);
+  for (int k = 0; k < kNumItems; ++k) {
+    InsertItem(k);
+  }
+  // The last region is in memory, and the three before it are on disk. The
+  // first regions have been reused.
+  auto* nvm_cache = static_cast<NvmSecondaryCache*>(cache_.get());
+  ASSERT_EQ(4 * kNumRegions, nvm_cache->TEST_GetNumEntries());
+  for (int k = 0; k < kNumItems; ++k) {
+    if (k < kNumItems - 4 * static_cast<int>(kNumRegions)) {
+      ASSERT_EQ("", LookupValue(k));
+    } else {
+      ASSERT_EQ(Value(k), LookupValue(k));
+    }
+  }
+}
+
+TEST_F(NvmSecondaryCacheTest, DropsInsertsWhenWriterIsSaturated) {
+  SyncPoint::GetInstance()->LoadDependency(
+      {{"NvmSecondaryCacheTest::DropsInsertsWhenWriterIsSaturated:Resume",
+        "NvmSecondaryCache::BackgroundWriter:BeforeWrite"}});
+  SyncPoint::GetInstance()->EnableProcessing();
+  NewCache();
+  auto* nvm_cache = static_cast<NvmSecondaryCache*>(cache_.get());
+
+  // The first two full regions wait to be written out, so the blocks that
+  // need a fourth one are dropped instead of waiting for them
+  const int kNumItems = 4 * static_cast<int>(kNumRegions);
+  for (int k = 0; k < kNumItems; ++k) {
+    TestItem item(Value(k));
+    ASSERT_OK(cache_->Insert(Key(k), &item, &kHelper, /*force_insert=*/false));
+  }
+  ASSERT_EQ(kNumItems - 4, nvm_cache->TEST_GetNumEntries());
+  for (int k = 0; k < kNumItems; ++k) {
+    ASSERT_EQ(k < kNumItems - 4 ? Value(k) : "", LookupValue(k));
+  }
+
+  TEST_SYNC_POINT(
+      "NvmSecondaryCacheTest::DropsInsertsWhenWriterIsSaturated:Resume");
+  nvm_cache->TEST_WaitForPendingWrites();
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  InsertItem(kNumItems - 1);
+  for (int k = 0; k < kNumItems; ++k) {
+    ASSERT_EQ(k < kNumItems - 4 || k == kNumItems - 1 ? Value(k) : "",
+              LookupValue(k));
+  }
+}
+
+TEST_F(NvmSecondaryCacheTest, AsyncLookups) {
+  NewCache(std::make_shared<DeferredReadFileSystem>(FileSystem::Default()));
+  const int kNumItems = 4 * static_cast<int>(kNumRegions);
+  for (int k = 0; k < kNumItems; ++k) {
+    InsertItem(k);
+  }
+
+  std::vector<std::unique_ptr<SecondaryCacheResultHandle>> handles;
+  std::vector<SecondaryCacheResultHandle*> handle_ptrs;
+  for (int k = 0; k < kNumItems; ++k) {
+    bool kept_in_sec_cache = false;
+    handles.push_back(cache_->Lookup(
+        Key(k), &kHelper, /*create_context=*/nullptr, /*wait=*/false,
+        /*advise_erase=*/false, /*stats=*/nullptr, kept_in_sec_cache));
+    ASSERT_NE(nullptr, handles.back());
+    // Only the blocks still in memory are ready right away
+    ASSERT_EQ(k >= kNumItems - 4, handles.back()->IsReady());
+    handle_ptrs.push_back(handles.back().get());
+  }
+
+  cache_->WaitAll(handle_ptrs);
+  for (int k = 0; k < kNumItems; ++k) {
+    ASSERT_TRUE(handles[k]->IsReady());
+    std::unique_ptr<TestItem> item(static_cast<TestItem*>(handles[k]->Value()));
+    ASSERT_NE(nullptr, item);
+    ASSERT_EQ(Value(k), item->data);
+  }
+
+  // A lookup racing with the reuse of the region it reads from misses
+  bool kept_in_sec_cache = false;
+  std::unique_ptr<SecondaryCacheResultHandle> handle = cache_->Lookup(
+      Key(0), &kHelper, /*create_context=*/nullptr, /*wait=*/false,
+      /*advise_erase=*/false, /*stats=*/nullptr, kept_in_sec_cache);
+  ASSERT_NE(nullptr, handle);
+  ASSERT_FALSE(handle->IsReady());
+  InsertItem(kNumItems);
+  handle->Wait();
+  ASSERT_TRUE(handle->IsReady());
+  ASSERT_EQ(nullptr, handle->Value());
+
+  // Pending lookups can be abandoned
+  handle = cache_->Lookup(Key(kNumItems - 5), &kHelper,
+                          /*create_context=*/nullptr, /*wait=*/false,
+                          /*advise_erase=*/false, /*stats=*/nullptr,
+                          kept_in_sec_cache);
+  ASSERT_NE(nullptr, handle);
+  ASSERT_FALSE(handle->IsReady());
+  handle.reset();
+}
+
+TEST_F(NvmSecondaryCacheTest, BottomTierOfTieredCache) {
+  NewCache();
+
+  LRUCacheOptions lru_opts;
+  lru_opts.num_shard_bits = 0;
+  TieredCacheOptions opts;
+  opts.cache_opts = &lru_opts;
+  opts.cache_type = PrimaryCacheType::kCacheTypeLRU;
+  opts.adm_policy = TieredAdmissionPolicy::kAdmPolicyThreeQueue;
+  opts.comp_cache_opts.num_shard_bits = 0;
+  opts.total_capacity = 64 << 10;
+  opts.compressed_secondary_ratio = 0.5;
+  opts.nvm_sec_cache = cache_;
+  std::shared_ptr<Cache> tiered_cache = NewTieredCache(opts);
+  ASSERT_NE(nullptr, tiered_cache);
+
+  // Blocks read from storage in compressed form warm the flash tier
+  const std::string compressed = "compressed";
+  ASSERT_OK(tiered_cache->Insert(Key(1), new TestItem(Value(1)), &kHelper,
+                                 kValueSize, /*handle=*/nullptr,
+                                 Cache::Priority::LOW, compressed, kZSTD));
+  tiered_cache->Erase(Key(1));
+
+  Cache::Handle* handle = tiered_cache->Lookup(
+      Key(1), &kHelper, /*create_context=*/nullptr, Cache::Priority::LOW);
+  ASSERT_NE(nullptr, handle);
+  auto* item = static_cast<TestItem*>(tiered_cache->Value(handle));
+  ASSERT_EQ(compressed, item->data);
+  ASSERT_EQ(kZSTD, item->type);
+  tiered_cache->Release(handle);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,196 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/tiny_lfu_admission_cache.h"
+
+#include "cache/lru_cache.h"
+#include "util/hash.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Smallest power of two (but at least 1024) not below `expected_entries`
+size_t FrequencySketch::GetWidthFor(size_t expected_entries) {
+  size_t width = 1024;
+  while (width < expected_entries) {
+    width <<= 1;
+  }
+  return width;
+}
+
+FrequencySketch::FrequencySketch(size_t expected_entries)
+    : width_(GetWidthFor(expected_entries)),
+      sample_size_(uint64_t{10} * width_),
+      counters_(new RelaxedAtomic<uint8_t>[kNumRows * width_]) {}
+
+size_t FrequencySketch::Index(uint64_t hash, int row) const {
+  // Multiply-shift hashing with a different odd multiplier for each row, so
+  // that keys colliding in one row are unlikely to collide in the others
+  // (unlike double hashing on the two halves of a hash, where keys colliding
+  // in both halves modulo the width collide in all the rows)
+  static constexpr uint64_t kRowMultipliers[kNumRows] = {
+      0x9e3779b97f4a7c15U, 0xc2b2ae3d27d4eb4fU, 0x165667b19e3779f9U,
+      0xd6e8feb86659fd93U};
+  return row * width_ + FastRange64(hash * kRowMultipliers[row], width_);
+}
+
+void FrequencySketch::Increment(uint64_t hash) {
+  for (int row = 0; row < kNumRows; ++row) {
+    RelaxedAtomic<uint8_t>& counter = counters_[Index(hash, row)];
+    const uint8_t count = counter.LoadRelaxed();
+    if (count < kMaxCount) {
+      counter.StoreRelaxed(static_cast<uint8_t>(count + 1));
+    }
+  }
+  // Exactly one thread sees the count reaching the sample size
+  if (increments_.FetchAddRelaxed(1) + 1 == sample_size_) {
+    Age();
+  }
+}
+
+uint32_t FrequencySketch::Estimate(uint64_t hash) const {
+  uint32_t estimate = kMaxCount;
+  for (int row = 0; row < kNumRows; ++row) {
+    const uint32_t count = counters_[Index(hash, row)].LoadRelaxed();
+    estimate = std::min(estimate, count);
+  }
+  return estimate;
+}
+
+void FrequencySketch::Age() {
+  for (size_t i = 0; i < kNumRows * width_; ++i) {
+    counters_[i].StoreRelaxed(
+        static_cast<uint8_t>(counters_[i].LoadRelaxed() >> 1));
+  }
+  increments_.FetchSubRelaxed(sample_size_ / 2);
+}
+
+TinyLfuAdmissionCache::TinyLfuAdmissionCache(
+    std::shared_ptr<Cache> target, const TinyLfuAdmissionOptions& opts)
+    : CacheWrapper(std::move(target)),
+      opts_(opts),
+      lru_target_(target_->CheckedCast<lru_cache::LRUCache>()) {
+  assert(lru_target_ != nullptr);
+  sketches_.emplace_back(
+      new FrequencySketch(GetExpectedEntries(target_->GetCapacity())));
+  sketch_.Store(sketches_.back().get());
+}
+
+Status TinyLfuAdmissionCache::Insert(const Slice& key, ObjectPtr value,
+                                     const CacheItemHelper* helper,
+                                     size_t charge, Handle** handle,
+                                     Priority priority,
+                                     const Slice& compressed_value,
+                                     CompressionType type) {
+  if (!IsFiltered(helper)) {
+    return target_->Insert(key, value, helper, charge, handle, priority,
+                           compressed_value, type);
+  }
+
+  const uint64_t hash = GetSliceNPHash64(key);
+  if (ShouldAdmit(key, hash, charge)) {
+    return target_->Insert(key, value, helper, charge, handle, priority,
+                           compressed_value, type);
+  }
+
+  // Not admitted; as if inserted and evicted right away
+  num_rejected_.FetchAddRelaxed(1);
+  if (handle == nullptr) {
+    if (helper->del_cb) {
+      helper->del_cb(value, target_->memory_allocator());
+    }
+  } else {
+    // Not charged, so that it does not displace cached entries either
+    *handle = target_->CreateStandalone(key, value, helper, /*charge=*/0,
+                                        /*allow_uncharged=*/true);
+    assert(*handle != nullptr);
+  }
+  return Status::OK();
+}
+
+Cache::Handle* TinyLfuAdmissionCache::Lookup(const Slice& key,
+                                             const CacheItemHelper* helper,
+                                             CreateContext* create_context,
+                                             Priority priority,
+                                             Statistics* stats) {
+  if (IsFiltered(helper)) {
+    sketch_.Load()->Increment(GetSliceNPHash64(key));
+  }
+  return target_->Lookup(key, helper, create_context, priority, stats);
+}
+
+void TinyLfuAdmissionCache::StartAsyncLookup(AsyncLookupHandle& async_handle) {
+  if (IsFiltered(async_handle.helper)) {
+    sketch_.Load()->Increment(GetSliceNPHash64(async_handle.key));
+  }
+  target_->StartAsyncLookup(async_handle);
+}
+
+bool TinyLfuAdmissionCache::ShouldAdmit(const Slice& key, uint64_t hash,
+                                        size_t charge) const {
+  if (target_->GetUsage() + charge <= target_->GetCapacity()) {
+    // Nothing to displace
+    return true;
+  }
+
+  const FrequencySketch* sketch = sketch_.Load();
+  const uint32_t frequency = sketch->Estimate(hash);
+  if (frequency == FrequencySketch::kMaxCount) {
+    return true;
+  }
+  // Hotter than each of the entries it would displace
+  uint32_t victim_frequency = 0;
+  lru_target_->ApplyToEvictionCandidates(
+      key, charge, kMaxEvictionCandidates, [&](const Slice& victim_key) {
+        victim_frequency = std::max(
+            victim_frequency, sketch->Estimate(GetSliceNPHash64(victim_key)));
+      });
+  return frequency > victim_frequency;
+}
+
+void TinyLfuAdmissionCache::SetCapacity(size_t capacity) {
+  target_->SetCapacity(capacity);
+
+  const size_t expected_entries = GetExpectedEntries(capacity);
+  const size_t width = FrequencySketch::GetWidthFor(expected_entries);
+  MutexLock l(&sketches_mutex_);
+  if (sketch_.Load()->GetWidth() == width) {
+    return;
+  }
+  for (const auto& sketch : sketches_) {
+    if (sketch->GetWidth() == width) {
+      sketch_.Store(sketch.get());
+      return;
+    }
+  }
+  sketches_.emplace_back(new FrequencySketch(expected_entries));
+  sketch_.Store(sketches_.back().get());
+}
+
+std::string TinyLfuAdmissionCache::GetPrintableOptions() const {
+  std::string ret = target_->GetPrintableOptions();
+  char buffer[200];
+  snprintf(buffer, sizeof(buffer),
+           "    tiny_lfu_admission.estimated_entry_charge : %" ROCKSDB_PRIszt
+           "\n",
+           opts_.estimated_entry_charge);
+  ret.append(buffer);
+  snprintf(buffer, sizeof(buffer),
+           "    tiny_lfu_admission.sketch_width : %" ROCKSDB_PRIszt "\n",
+           sketch_.Load()->GetWidth());
+  ret.append(buffer);
+  return ret;
+}
+
+std::shared_ptr<Cache> NewTinyLfuAdmissionCache(
+    std::shared_ptr<Cache> target, const TinyLfuAdmissionOptions& opts) {
+  if (target == nullptr ||
+      target->CheckedCast<lru_cache::LRUCache>() == nullptr) {
+    return nullptr;
+  }
+  return std::make_shared<TinyLfuAdmissionCache>(std::move(target), opts);
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,131 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#include <vector>
+
+#include "port/port.h"
+#include "rocksdb/advanced_cache.h"
+#include "rocksdb/cache.h"
+#include "util/atomic.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// A count-min sketch of (approximate) access frequencies of cache keys, with
+// periodic halving of all counts so that it follows changes in the workload.
+// Counts saturate at kMaxCount. Updates are lock-free and not exact under
+// concurrency, which is fine for an estimate.
+class FrequencySketch {
+ public:
+  static constexpr uint32_t kMaxCount = 15;
+
+  // Sized for tracking about `expected_entries` distinct keys
+  explicit FrequencySketch(size_t expected_entries);
+
+  // Width of a sketch for `expected_entries` distinct keys
+  static size_t GetWidthFor(size_t expected_entries);
+
+  // Records an access to the key with the given hash
+  void Increment(uint64_t hash);
+
+  // Returns the estimated number of accesses to the key with the given hash
+  // (since the last few agings)
+  uint32_t Estimate(uint64_t hash) const;
+
+  size_t GetWidth() const { return width_; }
+
+ private:
+  static constexpr int kNumRows = 4;
+
+  size_t Index(uint64_t hash, int row) const;
+
+  // Halves all the counts
+  void Age();
+
+  size_t width_;
+  // Number of increments between agings
+  uint64_t sample_size_;
+  // kNumRows x width_ counters
+  std::unique_ptr<RelaxedAtomic<uint8_t>[]> counters_;
+  RelaxedAtomic<uint64_t> increments_{0};
+};
+
+namespace lru_cache {
+class LRUCache;
+}  // namespace lru_cache
+
+// A cache wrapper that filters insertions into the wrapped LRU cache in the
+// style of TinyLFU: accesses to all keys (cached or not) are recorded in a
+// FrequencySketch, and once the cache is full, a new entry is admitted only
+// if it is estimated to be accessed more frequently than each of the entries
+// it would displace, which are the next ones in LRU order in its shard. That
+// keeps one-off accesses (e.g. scans) from evicting the hot working set.
+//
+// The sketch is resized along with the cache by SetCapacity(). As lookups
+// might still be using the previous sketch, sketches are kept (and reused
+// for the same width) until the cache is destroyed.
+//
+// Inserts that are not admitted behave as if the entry was inserted and
+// evicted right away: without a handle requested, the object is deleted and
+// OK is returned; with a handle requested, a standalone (not cached, and not
+// charged to the cache) handle is returned.
+class TinyLfuAdmissionCache : public CacheWrapper {
+ public:
+  TinyLfuAdmissionCache(std::shared_ptr<Cache> target,
+                        const TinyLfuAdmissionOptions& opts);
+
+  static const char* kClassName() { return "TinyLfuAdmissionCache"; }
+  const char* Name() const override { return kClassName(); }
+
+  Status Insert(
+      const Slice& key, ObjectPtr value, const CacheItemHelper* helper,
+      size_t charge, Handle** handle = nullptr,
+      Priority priority = Priority::LOW,
+      const Slice& compressed_value = Slice(),
+      CompressionType type = CompressionType::kNoCompression) override;
+
+  Handle* Lookup(const Slice& key, const CacheItemHelper* helper,
+                 CreateContext* create_context,
+                 Priority priority = Priority::LOW,
+                 Statistics* stats = nullptr) override;
+
+  void StartAsyncLookup(AsyncLookupHandle& async_handle) override;
+
+  void SetCapacity(size_t capacity) override;
+
+  std::string GetPrintableOptions() const override;
+
+  uint64_t TEST_GetNumRejected() const { return num_rejected_.LoadRelaxed(); }
+  size_t TEST_GetSketchWidth() const { return sketch_.Load()->GetWidth(); }
+
+ private:
+  // Most entries compared against for admitting a new one
+  static constexpr size_t kMaxEvictionCandidates = 8;
+
+  bool IsFiltered(const CacheItemHelper* helper) const {
+    return helper != nullptr && opts_.filtered_roles.Contains(helper->role);
+  }
+
+  size_t GetExpectedEntries(size_t capacity) const {
+    return capacity / std::max(size_t{1}, opts_.estimated_entry_charge);
+  }
+
+  bool ShouldAdmit(const Slice& key, uint64_t hash, size_t charge) const;
+
+  const TinyLfuAdmissionOptions opts_;
+  lru_cache::LRUCache* const lru_target_;
+  // Current sketch, one of sketches_
+  AcqRelAtomic<FrequencySketch*> sketch_;
+  port::Mutex sketches_mutex_;
+  std::vector<std::unique_ptr<FrequencySketch>> sketches_;
+  RelaxedAtomic<uint64_t> num_rejected_{0};
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,219 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "cache/tiny_lfu_admission_cache.h"
+
+#include <string>
+
+#include "port/stack_trace.h"
+#include "rocksdb/cache.h"
+#include "test_util/testharness.h"
+#include "util/coding.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+int num_deleted = 0;
+
+void DeleteFn(Cache::ObjectPtr value, MemoryAllocator* /*alloc*/) {
+  delete static_cast<int*>(value);
+  ++num_deleted;
+}
+
+const Cache::CacheItemHelper kDataHelper(CacheEntryRole::kDataBlock, DeleteFn);
+const Cache::CacheItemHelper kIndexHelper(CacheEntryRole::kIndexBlock,
+                                          DeleteFn);
+
+std::string Key(int k) {
+  std::string key;
+  PutFixed64(&key, static_cast<uint64_t>(k));
+  PutFixed64(&key, 0);
+  return key;
+}
+}  // namespace
+
+class TinyLfuAdmissionCacheTest : public testing::Test {
+ public:
+  static constexpr size_t kCapacity = 100;
+
+  TinyLfuAdmissionCacheTest() {
+    num_deleted = 0;
+    LRUCacheOptions lru_opts;
+    lru_opts.capacity = kCapacity;
+    lru_opts.num_shard_bits = 0;
+    lru_opts.metadata_charge_policy = kDontChargeCacheMetadata;
+    TinyLfuAdmissionOptions opts;
+    opts.estimated_entry_charge = 1;
+    cache_ = NewTinyLfuAdmissionCache(NewLRUCache(lru_opts), opts);
+  }
+
+  TinyLfuAdmissionCache* GetAdmissionCache() {
+    return static_cast<TinyLfuAdmissionCache*>(cache_.get());
+  }
+
+  // Looks up the key, inserting it on a miss like a block cache user would.
+  // Returns whether the lookup was a hit.
+  bool Access(int k, const Cache::CacheItemHelper* helper = &kDataHelper) {
+    Cache::Handle* handle =
+        cache_->Lookup(Key(k), helper, /*create_context=*/nullptr);
+    if (handle != nullptr) {
+      cache_->Release(handle);
+      return true;
+    }
+    EXPECT_OK(cache_->Insert(Key(k), new int(k), helper, /*charge=*/1));
+    return false;
+  }
+
+  bool IsCached(int k) {
+    Cache::Handle* handle = cache_->BasicLookup(Key(k), /*stats=*/nullptr);
+    if (handle == nullptr) {
+      return false;
+    }
+    cache_->Release(handle);
+    return true;
+  }
+
+ protected:
+  std::shared_ptr<Cache> cache_;
+};
+
+TEST(FrequencySketchTest, CountsAndAges) {
+  FrequencySketch sketch(/*expected_entries=*/100);
+  ASSERT_EQ(1024U, sketch.GetWidth());
+
+  const uint64_t hash = 0x0123456789abcdefULL;
+  ASSERT_EQ(0U, sketch.Estimate(hash));
+  for (int i = 0; i < 3; ++i) {
+    sketch.Increment(hash);
+  }
+  ASSERT_EQ(3U, sketch.Estimate(hash));
+
+  // Saturates, then gets halved once the sample size (10x width) is reached
+  for (int i = 3; i < 10 * 1024 - 1; ++i) {
+    sketch.Increment(hash);
+  }
+  ASSERT_EQ(FrequencySketch::kMaxCount, sketch.Estimate(hash));
+  sketch.Increment(hash);
+  ASSERT_EQ(FrequencySketch::kMaxCount / 2, sketch.Estimate(hash));
+}
+
+TEST_F(TinyLfuAdmissionCacheTest, ScanDoesNotEvictHotSet) {
+  // Fill up the cache with a working set accessed a few times each
+  for (int round = 0; round < 4; ++round) {
+    for (int k = 0; k < static_cast<int>(kCapacity); ++k) {
+      ASSERT_EQ(round > 0, Access(k));
+    }
+  }
+  ASSERT_EQ(kCapacity, cache_->GetUsage());
+  ASSERT_EQ(0U, GetAdmissionCache()->TEST_GetNumRejected());
+
+  // A scan of keys accessed only once is not admitted
+  const int kScanBegin = 1000;
+  const int kScanLength = 500;
+  for (int k = kScanBegin; k < kScanBegin + kScanLength; ++k) {
+    ASSERT_FALSE(Access(k));
+  }
+  ASSERT_EQ(static_cast<uint64_t>(kScanLength),
+            GetAdmissionCache()->TEST_GetNumRejected());
+  ASSERT_EQ(kScanLength, num_deleted);
+  for (int k = 0; k < static_cast<int>(kCapacity); ++k) {
+    ASSERT_TRUE(IsCached(k));
+  }
+
+  // A key that becomes hotter than the working set is admitted
+  const int kNewHotKey = 5000;
+  int misses = 0;
+  while (!Access(kNewHotKey)) {
+    ++misses;
+    ASSERT_LE(misses, 8);
+  }
+  ASSERT_GT(misses, 4);
+}
+
+TEST_F(TinyLfuAdmissionCacheTest, ComparesWithNextLruVictim) {
+  for (int k = 0; k < static_cast<int>(kCapacity); ++k) {
+    ASSERT_FALSE(Access(k));
+  }
+  // All but the least recently used entry are hot, including the ones
+  // admitted last
+  for (int round = 0; round < 4; ++round) {
+    for (int k = 1; k < static_cast<int>(kCapacity); ++k) {
+      ASSERT_TRUE(Access(k));
+    }
+  }
+
+  // Hotter than the next victim, which it displaces
+  const int kNewKey = 1000;
+  ASSERT_FALSE(Access(kNewKey));
+  ASSERT_FALSE(Access(kNewKey));
+  ASSERT_TRUE(IsCached(kNewKey));
+  ASSERT_FALSE(IsCached(0));
+  ASSERT_EQ(1U, GetAdmissionCache()->TEST_GetNumRejected());
+
+  // Not hotter than the next victim
+  const int kOtherNewKey = 1001;
+  ASSERT_FALSE(Access(kOtherNewKey));
+  ASSERT_FALSE(Access(kOtherNewKey));
+  ASSERT_FALSE(IsCached(kOtherNewKey));
+  ASSERT_TRUE(IsCached(1));
+  ASSERT_EQ(3U, GetAdmissionCache()->TEST_GetNumRejected());
+}
+
+TEST_F(TinyLfuAdmissionCacheTest, SetCapacityResizesSketch) {
+  ASSERT_EQ(1024U, GetAdmissionCache()->TEST_GetSketchWidth());
+  cache_->SetCapacity(10000);
+  ASSERT_EQ(10000U, cache_->GetCapacity());
+  ASSERT_EQ(16384U, GetAdmissionCache()->TEST_GetSketchWidth());
+  cache_->SetCapacity(kCapacity);
+  ASSERT_EQ(1024U, GetAdmissionCache()->TEST_GetSketchWidth());
+
+  // Only LRU caches can be wrapped
+  HyperClockCacheOptions hcc_opts(kCapacity, /*estimated_entry_charge=*/1);
+  ASSERT_EQ(nullptr, NewTinyLfuAdmissionCache(hcc_opts.MakeSharedCache()));
+}
+
+TEST_F(TinyLfuAdmissionCacheTest, RejectedInsertWithHandle) {
+  for (int round = 0; round < 3; ++round) {
+    for (int k = 0; k < static_cast<int>(kCapacity); ++k) {
+      Access(k);
+    }
+  }
+
+  // The caller still gets a usable handle, not backed by the cache
+  const int kColdKey = 1000;
+  Cache::Handle* handle =
+      cache_->Lookup(Key(kColdKey), &kDataHelper, /*create_context=*/nullptr);
+  ASSERT_EQ(nullptr, handle);
+  ASSERT_OK(cache_->Insert(Key(kColdKey), new int(kColdKey), &kDataHelper,
+                           /*charge=*/1, &handle));
+  ASSERT_NE(nullptr, handle);
+  ASSERT_EQ(1U, GetAdmissionCache()->TEST_GetNumRejected());
+  ASSERT_EQ(kColdKey, *static_cast<int*>(cache_->Value(handle)));
+  ASSERT_FALSE(IsCached(kColdKey));
+  ASSERT_EQ(0, num_deleted);
+  cache_->Release(handle);
+  ASSERT_EQ(1, num_deleted);
+}
+
+TEST_F(TinyLfuAdmissionCacheTest, UnfilteredRolesAlwaysAdmitted) {
+  for (int round = 0; round < 3; ++round) {
+    for (int k = 0; k < static_cast<int>(kCapacity); ++k) {
+      Access(k);
+    }
+  }
+
+  const int kColdKey = 1000;
+  ASSERT_FALSE(Access(kColdKey, &kIndexHelper));
+  ASSERT_TRUE(IsCached(kColdKey));
+  ASSERT_EQ(0U, GetAdmissionCache()->TEST_GetNumRejected());
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
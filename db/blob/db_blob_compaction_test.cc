@@ -709,6 +709,183 @@ TEST_F(DBBlobCompactionTest, TrackGarbage) {
   }
 }
 
+TEST_F(DBBlobCompactionTest, BlobFileGarbageCollection) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.disable_auto_compactions = true;
+
+  Reopen(options);
+
+  // Two table+blob file pairs with interleaved keys, compacted into a single
+  // SST file referencing both blob files
+  for (int i = 0; i < 8; i += 2) {
+    ASSERT_OK(Put(Key(i), "first_value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  for (int i = 1; i < 8; i += 2) {
+    ASSERT_OK(Put(Key(i), "second_value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+
+  // Overwrite most keys of the second blob file, which is not the oldest one
+  for (int i = 1; i < 6; i += 2) {
+    ASSERT_OK(Put(Key(i), "third_value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+
+  VersionSet* const versions = dbfull()->GetVersionSet();
+  ColumnFamilyData* const cfd = versions->GetColumnFamilySet()->GetDefault();
+  std::vector<uint64_t> old_blob_files;
+  for (const auto& meta : cfd->current()->storage_info()->GetBlobFiles()) {
+    old_blob_files.push_back(meta->GetBlobFileNumber());
+  }
+  ASSERT_EQ(3, old_blob_files.size());
+  {
+    const auto& meta = cfd->current()->storage_info()->GetBlobFiles()[1];
+    ASSERT_EQ(meta->GetTotalBlobCount(), 4);
+    ASSERT_EQ(meta->GetGarbageBlobCount(), 3);
+  }
+
+  int num_blob_gc_compactions = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelCompactionPicker::PickCompaction:Return", [&](void* arg) {
+        Compaction* compaction = static_cast<Compaction*>(arg);
+        ASSERT_EQ(CompactionReason::kBlobGarbageCollection,
+                  compaction->compaction_reason());
+        ASSERT_EQ(1, compaction->start_level());
+        ASSERT_EQ(1, compaction->output_level());
+        ++num_blob_gc_compactions;
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // The oldest blob file has no garbage, so forced blob GC would not collect
+  // the second one
+  ASSERT_OK(dbfull()->SetOptions({
+      {"blob_garbage_collection_file_threshold", "0.5"},
+      {"disable_auto_compactions", "false"},
+  }));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ(1, num_blob_gc_compactions);
+
+  // Blob files without garbage are never picked, even with a zero threshold
+  ASSERT_OK(dbfull()->SetOptions(
+      {{"blob_garbage_collection_file_threshold", "0"}}));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ(1, num_blob_gc_compactions);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ("0,1", FilesPerLevel());
+
+  // The first two blob files were relocated, the third one was not
+  const auto& blob_files = cfd->current()->storage_info()->GetBlobFiles();
+  ASSERT_EQ(2, blob_files.size());
+  ASSERT_EQ(old_blob_files[2], blob_files[0]->GetBlobFileNumber());
+  ASSERT_GT(blob_files[1]->GetBlobFileNumber(), old_blob_files[2]);
+  for (const auto& meta : blob_files) {
+    ASSERT_EQ(0, meta->GetGarbageBlobCount());
+  }
+
+  for (int i = 0; i < 8; ++i) {
+    const char* prefix =
+        i % 2 == 0 ? "first_value" : (i < 6 ? "third_value" : "second_value");
+    ASSERT_EQ(prefix + std::to_string(i), Get(Key(i)));
+  }
+
+  Close();
+}
+
+TEST_F(DBBlobCompactionTest, BlobFileGarbageCollectionSeparateSsts) {
+  Options options = GetDefaultOptions();
+  options.enable_blob_files = true;
+  options.min_blob_size = 0;
+  options.disable_auto_compactions = true;
+
+  Reopen(options);
+
+  // Two SST files with disjoint key ranges, each referencing its own blob
+  // file
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_OK(Put(Key(i), "first_value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  for (int i = 10; i < 14; ++i) {
+    ASSERT_OK(Put(Key(i), "second_value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+
+  // Overwrite most keys of the second SST file, whose blob file is not the
+  // oldest one
+  for (int i = 10; i < 13; ++i) {
+    ASSERT_OK(Put(Key(i), "third_value" + std::to_string(i)));
+  }
+  ASSERT_OK(Flush());
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ("0,2", FilesPerLevel());
+
+  VersionSet* const versions = dbfull()->GetVersionSet();
+  ColumnFamilyData* const cfd = versions->GetColumnFamilySet()->GetDefault();
+  std::vector<uint64_t> old_blob_files;
+  for (const auto& meta : cfd->current()->storage_info()->GetBlobFiles()) {
+    old_blob_files.push_back(meta->GetBlobFileNumber());
+  }
+  ASSERT_EQ(3, old_blob_files.size());
+  {
+    const auto& blob_files = cfd->current()->storage_info()->GetBlobFiles();
+    ASSERT_EQ(blob_files[0]->GetGarbageBlobCount(), 0);
+    ASSERT_EQ(blob_files[1]->GetTotalBlobCount(), 4);
+    ASSERT_EQ(blob_files[1]->GetGarbageBlobCount(), 3);
+  }
+
+  int num_blob_gc_compactions = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelCompactionPicker::PickCompaction:Return", [&](void* arg) {
+        Compaction* compaction = static_cast<Compaction*>(arg);
+        ASSERT_EQ(CompactionReason::kBlobGarbageCollection,
+                  compaction->compaction_reason());
+        ++num_blob_gc_compactions;
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(dbfull()->SetOptions({
+      {"blob_garbage_collection_file_threshold", "0.5"},
+      {"disable_auto_compactions", "false"},
+  }));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // The SST file linked to the oldest blob file is rewritten once, and is
+  // then linked to a newer blob file than the collected one
+  ASSERT_EQ(2, num_blob_gc_compactions);
+  ASSERT_EQ("0,2", FilesPerLevel());
+
+  const auto& blob_files = cfd->current()->storage_info()->GetBlobFiles();
+  ASSERT_EQ(3, blob_files.size());
+  ASSERT_EQ(old_blob_files[2], blob_files[0]->GetBlobFileNumber());
+  for (const auto& meta : blob_files) {
+    ASSERT_EQ(0, meta->GetGarbageBlobCount());
+  }
+
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ("first_value" + std::to_string(i), Get(Key(i)));
+  }
+  for (int i = 10; i < 14; ++i) {
+    const char* prefix = i < 13 ? "third_value" : "second_value";
+    ASSERT_EQ(prefix + std::to_string(i), Get(Key(i)));
+  }
+
+  Close();
+}
+
 TEST_F(DBBlobCompactionTest, MergeBlobWithBase) {
   Options options = GetDefaultOptions();
   options.enable_blob_files = true;
@@ -36,6 +36,7 @@
 #include "port/port.h"
 #include "rocksdb/convenience.h"
 #include "rocksdb/table.h"
+#include "table/block_based/shared_compression_dict.h"
 #include "table/merging_iterator.h"
 #include "util/autovector.h"
 #include "util/cast_util.h"
@@ -627,6 +628,7 @@ ColumnFamilyData::ColumnFamilyData(
                           internal_stats_->GetBlobFileReadHist(), io_tracer));
     blob_source_.reset(new BlobSource(ioptions_, mutable_cf_options_, db_id,
                                       db_session_id, blob_file_cache_.get()));
+    compression_dict_reuse_registry_.reset(new CompressionDictReuseRegistry());
 
     if (ioptions_.compaction_style == kCompactionStyleLevel) {
       compaction_picker_.reset(
@@ -1521,6 +1523,13 @@ Status ColumnFamilyData::ValidateOptions(
     }
   }
 
+  if (cf_options.blob_garbage_collection_file_threshold < 0.0 ||
+      cf_options.blob_garbage_collection_file_threshold > 1.0) {
+    return Status::InvalidArgument(
+        "The garbage ratio threshold for blob file garbage collection should "
+        "be in the range [0.0, 1.0].");
+  }
+
   if (cf_options.compaction_style == kCompactionStyleFIFO &&
       db_options.max_open_files != -1 && cf_options.ttl > 0) {
     return Status::NotSupported(
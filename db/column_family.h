@@ -50,6 +50,7 @@ class InstrumentedMutexLock;
 struct SuperVersionContext;
 class BlobFileCache;
 class BlobSource;
+class CompressionDictReuseRegistry;
 
 extern const double kIncSlowdownRatio;
 // This file contains a list of data structures for managing column family
@@ -415,6 +416,9 @@ class ColumnFamilyData {
   TableCache* table_cache() const { return table_cache_.get(); }
   BlobFileCache* blob_file_cache() const { return blob_file_cache_.get(); }
   BlobSource* blob_source() const { return blob_source_.get(); }
+  CompressionDictReuseRegistry* compression_dict_reuse_registry() const {
+    return compression_dict_reuse_registry_.get();
+  }
 
   // See documentation in compaction_picker.h
   // REQUIRES: DB mutex held
@@ -642,6 +646,8 @@ class ColumnFamilyData {
   std::unique_ptr<TableCache> table_cache_;
   std::unique_ptr<BlobFileCache> blob_file_cache_;
   std::unique_ptr<BlobSource> blob_source_;
+  std::unique_ptr<CompressionDictReuseRegistry>
+      compression_dict_reuse_registry_;
 
   std::unique_ptr<InternalStats> internal_stats_;
 
@@ -288,7 +288,8 @@ Compaction::Compaction(
     const std::string& _trim_ts, double _score, bool _deletion_compaction,
     bool l0_files_might_overlap, CompactionReason _compaction_reason,
     BlobGarbageCollectionPolicy _blob_garbage_collection_policy,
-    double _blob_garbage_collection_age_cutoff)
+    double _blob_garbage_collection_age_cutoff,
+    uint64_t _blob_garbage_collection_file_number)
     : input_vstorage_(vstorage),
       start_level_(_inputs[0].level),
       output_level_(_output_level),
@@ -338,6 +339,8 @@ Compaction::Compaction(
                   _blob_garbage_collection_age_cutoff > 1
               ? mutable_cf_options().blob_garbage_collection_age_cutoff
               : _blob_garbage_collection_age_cutoff),
+      blob_garbage_collection_file_number_(
+          _blob_garbage_collection_file_number),
       proximal_level_(
           // For simplicity, we don't support the concept of "proximal level"
           // with `CompactionReason::kExternalSstIngestion` and
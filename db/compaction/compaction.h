@@ -100,7 +100,9 @@ class Compaction {
              CompactionReason compaction_reason = CompactionReason::kUnknown,
              BlobGarbageCollectionPolicy blob_garbage_collection_policy =
                  BlobGarbageCollectionPolicy::kUseDefault,
-             double blob_garbage_collection_age_cutoff = -1);
+             double blob_garbage_collection_age_cutoff = -1,
+             uint64_t blob_garbage_collection_file_number =
+                 kInvalidBlobFileNumber);
 
   // The type of the proximal level output range
   enum class ProximalOutputRangeType : int {
@@ -415,6 +417,12 @@ class Compaction {
     return blob_garbage_collection_age_cutoff_;
   }
 
+  // If valid, blob GC relocates the blobs of this blob file and of the older
+  // ones, and ignores the age cutoff.
+  uint64_t blob_garbage_collection_file_number() const {
+    return blob_garbage_collection_file_number_;
+  }
+
   // start and end are sub compact range. Null if no boundary.
   // This is used to calculate the newest_key_time table property after
   // compaction.
@@ -612,6 +620,9 @@ class Compaction {
   // Blob garbage collection age cutoff.
   double blob_garbage_collection_age_cutoff_;
 
+  // The newest blob file whose blobs are garbage collected, if valid.
+  uint64_t blob_garbage_collection_file_number_;
+
   SequenceNumber keep_in_last_level_through_seqno_ = kMaxSequenceNumber;
 
   // only set when per_key_placement feature is enabled, -1 (kInvalidLevel)
@@ -95,11 +95,17 @@ CompactionIterator::CompactionIterator(
       enforce_single_del_contracts_(enforce_single_del_contracts),
       timestamp_size_(cmp_ ? cmp_->timestamp_size() : 0),
       full_history_ts_low_(full_history_ts_low),
+      use_fast_path_(visible_at_tip_ && snapshot_checker_ == nullptr &&
+                     compaction_filter_ == nullptr && timestamp_size_ == 0),
       current_user_key_sequence_(0),
       current_user_key_snapshot_(0),
       merge_out_iter_(merge_helper_),
       blob_garbage_collection_cutoff_file_number_(
           ComputeBlobGarbageCollectionCutoffFileNumber(compaction_.get())),
+      blob_garbage_collection_file_number_(
+          compaction_ && compaction_->enable_blob_garbage_collection()
+              ? compaction_->blob_garbage_collection_file_number()
+              : kInvalidBlobFileNumber),
       blob_fetcher_(CreateBlobFetcherIfNeeded(compaction_.get())),
       prefetch_buffers_(
           CreatePrefetchBufferCollectionIfNeeded(compaction_.get())),
@@ -454,6 +460,9 @@ void CompactionIterator::NextFromInput() {
 
   while (!Valid() && input_.Valid() && !IsPausingManualCompaction() &&
          !IsShuttingDown()) {
+    if (use_fast_path_ && ProcessKeyFast()) {
+      continue;
+    }
     key_ = input_.key();
     value_ = input_.value();
     blob_value_.Reset();
@@ -1119,6 +1128,69 @@ void CompactionIterator::NextFromInput() {
   }
 }
 
+bool CompactionIterator::ProcessKeyFast() {
+  const Slice key = input_.key();
+  if (UNLIKELY(key.size() < kNumInternalBytes) || clear_and_output_next_key_ ||
+      input_.IsDeleteRangeSentinelKey()) {
+    return false;
+  }
+  const uint64_t packed =
+      DecodeFixed64(key.data() + key.size() - kNumInternalBytes);
+  const auto type = static_cast<ValueType>(packed & 0xff);
+  const Slice user_key(key.data(), key.size() - kNumInternalBytes);
+
+  const bool same_user_key =
+      has_current_user_key_ && cmp_->Equal(user_key, current_user_key_);
+  if (same_user_key) {
+    // A single deletion may need to be kept with the value it deletes, and
+    // the general path handles unknown types as corruption.
+    if (current_user_key_sequence_ == kMaxSequenceNumber ||
+        type == kTypeSingleDeletion || !IsValueType(type)) {
+      return false;
+    }
+  } else if (type != kTypeValue || !range_del_agg_->IsEmpty()) {
+    return false;
+  }
+
+  ikey_.user_key = user_key;
+  ikey_.sequence = packed >> 8;
+  ikey_.type = type;
+  value_ = input_.value();
+  iter_stats_.num_input_records++;
+  if (type == kTypeDeletion || type == kTypeDeletionWithTimestamp) {
+    iter_stats_.num_input_deletion_records++;
+  } else if (type == kTypeValuePreferredSeqno) {
+    iter_stats_.num_input_timed_put_records++;
+  }
+  iter_stats_.total_input_raw_key_bytes += key.size();
+  iter_stats_.total_input_raw_value_bytes += value_.size();
+  TEST_SYNC_POINT_CALLBACK("CompactionIterator:ProcessKV", &ikey_);
+  TEST_SYNC_POINT("CompactionIterator::ProcessKeyFast");
+
+  if (same_user_key) {
+    // With no snapshots, every version older than the first one of a user
+    // key is hidden by it (rule (A) in NextFromInput()).
+    assert(current_user_key_snapshot_ == earliest_snapshot_);
+    current_user_key_sequence_ = ikey_.sequence;
+    ++iter_stats_.num_record_drop_hidden;
+    AdvanceInputIter();
+    return true;
+  }
+
+  blob_value_.Reset();
+  is_range_del_ = false;
+  key_ = current_key_.SetInternalKey(key, &ikey_);
+  current_user_key_ = ikey_.user_key;
+  current_user_key_sequence_ = ikey_.sequence;
+  current_user_key_snapshot_ = earliest_snapshot_;
+  has_current_user_key_ = true;
+  has_outputted_key_ = false;
+  last_key_seq_zeroed_ = false;
+  current_key_committed_ = true;
+  validity_info_.SetValid(ValidContext::kNewUserKey);
+  return true;
+}
+
 bool CompactionIterator::ExtractLargeValueIfNeededImpl() {
   if (!blob_file_builder_) {
     return false;
@@ -1180,8 +1252,14 @@ void CompactionIterator::GarbageCollectBlobIfNeeded() {
       }
     }
 
-    if (blob_index.file_number() >=
-        blob_garbage_collection_cutoff_file_number_) {
+    if (blob_garbage_collection_file_number_ != kInvalidBlobFileNumber) {
+      // Relocating the blobs of older blob files too moves the link of the
+      // output forward, so that it is not marked again for the same file
+      if (blob_index.file_number() > blob_garbage_collection_file_number_) {
+        return;
+      }
+    } else if (blob_index.file_number() >=
+               blob_garbage_collection_cutoff_file_number_) {
       return;
     }
 
@@ -108,6 +108,8 @@ class CompactionIterator {
 
     virtual double blob_garbage_collection_age_cutoff() const = 0;
 
+    virtual uint64_t blob_garbage_collection_file_number() const = 0;
+
     virtual uint64_t blob_compaction_readahead_size() const = 0;
 
     virtual const Version* input_version() const = 0;
@@ -160,6 +162,10 @@ class CompactionIterator {
       return compaction_->blob_garbage_collection_age_cutoff();
     }
 
+    uint64_t blob_garbage_collection_file_number() const override {
+      return compaction_->blob_garbage_collection_file_number();
+    }
+
     uint64_t blob_compaction_readahead_size() const override {
       return compaction_->mutable_cf_options().blob_compaction_readahead_size;
     }
@@ -291,6 +297,13 @@ class CompactionIterator {
   // Return true on success, false on failures (e.g.: kIOError).
   bool InvokeFilterIfNeeded(bool* need_skip, Slice* skip_until);
 
+  // Fast path of NextFromInput() for use_fast_path_. Processes the current
+  // input key if it is either a plain value of a new user key, which is
+  // output, or an older version of the current user key, which is hidden
+  // when there are no snapshots. Returns false without any side effect for
+  // any other key, which is left to the general path.
+  bool ProcessKeyFast();
+
   // Given a sequence number, return the sequence number of the
   // earliest snapshot that this sequence number is visible in.
   // The snapshots themselves are arranged in ascending order of
@@ -374,6 +387,10 @@ class CompactionIterator {
   // If nullptr, NO GC will be performed and all history will be preserved.
   const std::string* const full_history_ts_low_;
 
+  // Whether keys can go through ProcessKeyFast(): no snapshots, no snapshot
+  // checker, no compaction filter and no user-defined timestamps.
+  const bool use_fast_path_;
+
   // State
   //
   enum ValidContext : uint8_t {
@@ -444,6 +461,7 @@ class CompactionIterator {
   PinnedIteratorsManager pinned_iters_mgr_;
 
   uint64_t blob_garbage_collection_cutoff_file_number_;
+  uint64_t blob_garbage_collection_file_number_;
 
   std::unique_ptr<BlobFetcher> blob_fetcher_;
   std::unique_ptr<PrefetchBufferCollection> prefetch_buffers_;
@@ -10,6 +10,7 @@
 
 #include "db/dbformat.h"
 #include "port/port.h"
+#include "test_util/sync_point.h"
 #include "test_util/testharness.h"
 #include "test_util/testutil.h"
 #include "util/string_util.h"
@@ -180,6 +181,10 @@ class FakeCompaction : public CompactionIterator::CompactionProxy {
 
   double blob_garbage_collection_age_cutoff() const override { return 0.0; }
 
+  uint64_t blob_garbage_collection_file_number() const override {
+    return kInvalidBlobFileNumber;
+  }
+
   uint64_t blob_compaction_readahead_size() const override { return 0; }
 
   const Version* input_version() const override { return nullptr; }
@@ -828,6 +833,47 @@ TEST_P(CompactionIteratorTest, ConvertToPutAtBottom) {
           true /*bottomost_level*/);
 }
 
+// Without snapshots, plain values of new user keys and older versions of a
+// user key take the fast path, and the other entries the general one. With
+// a snapshot checker (test param), all entries take the general path, with
+// the same result.
+TEST_P(CompactionIteratorTest, FastPathWithoutSnapshots) {
+  std::shared_ptr<MergeOperator> merge_op =
+      MergeOperators::CreateStringAppendOperator();
+  int num_fast_path_keys = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionIterator::ProcessKeyFast",
+      [&](void* /*arg*/) { num_fast_path_keys++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  RunTest({test::KeyStr("a", 9, kTypeValue),
+           test::KeyStr("a", 8, kTypeDeletion),
+           test::KeyStr("a", 7, kTypeValue),
+           test::KeyStr("b", 6, kTypeDeletion),
+           test::KeyStr("b", 5, kTypeValue), test::KeyStr("c", 12, kTypeMerge),
+           test::KeyStr("c", 11, kTypeValue),
+           test::KeyStr("c", 10, kTypeValue),
+           test::KeyStr("d", 14, kTypeSingleDeletion),
+           test::KeyStr("d", 13, kTypeValue), test::KeyStr("e", 4, kTypeValue),
+           test::KeyStr("e", 3, kTypeMerge)},
+          {"a9", "", "a7", "", "b5", "c12", "c11", "c10", "", "d13", "e4",
+           "e3"},
+          {test::KeyStr("a", 9, kTypeValue),
+           test::KeyStr("b", 6, kTypeDeletion),
+           test::KeyStr("c", 12, kTypeValue), test::KeyStr("e", 4, kTypeValue)},
+          {"a9", "", "c11,c12", "e4"},
+          kMaxSequenceNumber /*last_committed_seq*/, merge_op.get());
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+  if (GetParam()) {
+    ASSERT_EQ(0, num_fast_path_keys);
+  } else {
+    // a9, a8, a7, b5, c10, e4 and e3
+    ASSERT_EQ(7, num_fast_path_keys);
+  }
+}
+
 TEST_P(CompactionIteratorTest, ZeroSeqOfKeyAndSnapshot) {
   AddSnapshot(0);
   const std::vector<std::string> input_keys = {
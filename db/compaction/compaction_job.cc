@@ -22,6 +22,7 @@
 #include "db/blob/blob_file_builder.h"
 #include "db/builder.h"
 #include "db/compaction/clipping_iterator.h"
+#include "db/compaction/compaction_output_warmer.h"
 #include "db/compaction/compaction_state.h"
 #include "db/db_impl/db_impl.h"
 #include "db/dbformat.h"
@@ -33,6 +34,7 @@
 #include "db/range_del_aggregator.h"
 #include "db/version_edit.h"
 #include "db/version_set.h"
+#include "file/file_util.h"
 #include "file/filename.h"
 #include "file/read_write_util.h"
 #include "file/sst_file_manager_impl.h"
@@ -101,6 +103,12 @@ const char* GetCompactionReasonString(CompactionReason compaction_reason) {
       return "RoundRobinTtl";
     case CompactionReason::kRefitLevel:
       return "RefitLevel";
+    case CompactionReason::kRangeDeletions:
+      return "RangeDeletions";
+    case CompactionReason::kReadTriggered:
+      return "ReadTriggered";
+    case CompactionReason::kBlobGarbageCollection:
+      return "BlobGarbageCollection";
     case CompactionReason::kNumOfReasons:
       // fall through
     default:
@@ -632,6 +640,17 @@ void CompactionJob::GenSubcompactionBoundaries() {
     return;
   }
 
+  // With work stealing among the subcompaction threads, plan more ranges
+  // than threads
+  const uint64_t num_planned_threads = num_planned_subcompactions;
+  const uint32_t ranges_per_thread =
+      mutable_db_options_copy_.subcompaction_ranges_per_thread;
+  if (ranges_per_thread > 1 &&
+      !(c->immutable_options().compaction_pri == kRoundRobin &&
+        c->immutable_options().compaction_style == kCompactionStyleLevel)) {
+    num_planned_subcompactions *= ranges_per_thread;
+  }
+
   // Group the ranges into subcompactions
   uint64_t target_range_size = std::max(
       total_size / num_planned_subcompactions,
@@ -660,6 +679,9 @@ void CompactionJob::GenSubcompactionBoundaries() {
   }
   TEST_SYNC_POINT_CALLBACK("CompactionJob::GenSubcompactionBoundaries:1",
                            &num_actual_subcompactions);
+  if (num_actual_subcompactions > num_planned_threads) {
+    num_subcompaction_threads_ = static_cast<size_t>(num_planned_threads);
+  }
   // Shrink extra subcompactions resources when extra resrouces are acquired
   ShrinkSubcompactionResources(
       std::min((int)(num_planned_subcompactions - num_actual_subcompactions),
@@ -673,22 +695,30 @@ Status CompactionJob::Run() {
   log_buffer_->FlushBufferToLog();
   LogCompaction();
 
-  const size_t num_threads = compact_->sub_compact_states.size();
-  assert(num_threads > 0);
+  const size_t num_subcompactions = compact_->sub_compact_states.size();
+  assert(num_subcompactions > 0);
+  const size_t num_threads = num_subcompaction_threads_ > 0
+                                 ? num_subcompaction_threads_
+                                 : num_subcompactions;
+  assert(num_threads <= num_subcompactions);
   const uint64_t start_micros = db_options_.clock->NowMicros();
   compact_->compaction->GetOrInitInputTableProperties();
 
+  // Subcompactions not started by the initial threads are taken, in key
+  // order, by whichever thread finishes first
+  std::atomic<size_t> next_subcompaction{num_threads};
+
   // Launch a thread for each of subcompactions 1...num_threads-1
   std::vector<port::Thread> thread_pool;
   thread_pool.reserve(num_threads - 1);
-  for (size_t i = 1; i < compact_->sub_compact_states.size(); i++) {
-    thread_pool.emplace_back(&CompactionJob::ProcessKeyValueCompaction, this,
-                             &compact_->sub_compact_states[i]);
+  for (size_t i = 1; i < num_threads; i++) {
+    thread_pool.emplace_back(&CompactionJob::ProcessKeyValueCompactions, this,
+                             i, &next_subcompaction);
   }
 
   // Always schedule the first subcompaction (whether or not there are also
   // others) in the current thread to be efficient with resources
-  ProcessKeyValueCompaction(compact_->sub_compact_states.data());
+  ProcessKeyValueCompactions(0, &next_subcompaction);
 
   // Wait for all other threads (if there are any) to finish execution
   for (auto& thread : thread_pool) {
@@ -819,7 +849,7 @@ Status CompactionJob::Run() {
         }
       }
     };
-    for (size_t i = 1; i < compact_->sub_compact_states.size(); i++) {
+    for (size_t i = 1; i < num_threads; i++) {
       thread_pool.emplace_back(
           verify_table, std::ref(compact_->sub_compact_states[i].status));
     }
@@ -1136,6 +1166,18 @@ void CompactionJob::NotifyOnSubcompactionCompleted(
   }
 }
 
+void CompactionJob::ProcessKeyValueCompactions(size_t first,
+                                               std::atomic<size_t>* next) {
+  auto& states = compact_->sub_compact_states;
+  ProcessKeyValueCompaction(&states[first]);
+  for (size_t i = next->fetch_add(1, std::memory_order_relaxed);
+       i < states.size(); i = next->fetch_add(1, std::memory_order_relaxed)) {
+    TEST_SYNC_POINT_CALLBACK("CompactionJob::ProcessKeyValueCompactions:Steal",
+                             &i);
+    ProcessKeyValueCompaction(&states[i]);
+  }
+}
+
 void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
   assert(sub_compact);
   assert(sub_compact->compaction);
@@ -1179,6 +1221,20 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
           &cfd->internal_comparator(), existing_snapshots_,
           &full_history_ts_low_, &trim_ts_));
 
+  using PrepopulateBlockCache = BlockBasedTableOptions::PrepopulateBlockCache;
+  const auto* bbto = sub_compact->compaction->mutable_cf_options()
+                         .table_factory->GetOptions<BlockBasedTableOptions>();
+  if (bbto != nullptr && bbto->block_cache != nullptr &&
+      bbto->prepopulate_block_cache ==
+          PrepopulateBlockCache::kFlushAndHotCompaction &&
+      bbto->prepopulate_block_cache_compaction_budget > 0) {
+    // The budget is for the whole compaction
+    sub_compact->AssignOutputWarmer(std::make_unique<HotInputBlockWarmer>(
+        sub_compact->compaction, cfd->table_cache(),
+        bbto->prepopulate_block_cache_compaction_budget /
+            compact_->sub_compact_states.size()));
+  }
+
   // TODO: since we already use C++17, should use
   // std::optional<const Slice> instead.
   const std::optional<Slice> start = sub_compact->start;
@@ -1219,11 +1275,20 @@ void CompactionJob::ProcessKeyValueCompaction(SubcompactionState* sub_compact) {
     }
   }
 
+  // With an async readahead budget, every input file gets a double-buffered
+  // share of it, so that reads for all inputs are in flight while merging.
+  FileOptions input_file_options = file_options_for_read_;
+  const size_t async_readahead_size = GetAsyncReadaheadSize();
+  if (async_readahead_size > 0) {
+    read_options.async_io = true;
+    input_file_options.compaction_readahead_size = async_readahead_size;
+  }
+
   // Although the v2 aggregator is what the level iterator(s) know about,
   // the AddTombstones calls will be propagated down to the v1 aggregator.
   std::unique_ptr<InternalIterator> raw_input(versions_->MakeInputIterator(
       read_options, sub_compact->compaction, sub_compact->RangeDelAgg(),
-      file_options_for_read_, start, end));
+      input_file_options, start, end));
   InternalIterator* input = raw_input.get();
 
   IterKey start_ikey;
@@ -2077,6 +2142,9 @@ Status CompactionJob::OpenCompactionOutputFile(SubcompactionState* sub_compact,
       0 /* oldest_key_time */, current_time, db_id_, db_session_id_,
       sub_compact->compaction->max_output_file_size(), file_number,
       proximal_after_seqno_ /*last_level_inclusive_max_seqno_threshold*/);
+  tboptions.output_warmer = sub_compact->OutputWarmer();
+  tboptions.compression_dict_reuse_registry =
+      cfd->compression_dict_reuse_registry();
 
   outputs.NewBuilder(tboptions);
 
@@ -2347,6 +2415,30 @@ Env::IOPriority CompactionJob::GetRateLimiterPriority() {
   return Env::IO_LOW;
 }
 
+size_t CompactionJob::GetAsyncReadaheadSize() const {
+  const size_t budget =
+      mutable_db_options_copy_.compaction_async_readahead_budget;
+  if (budget == 0 || file_options_for_read_.use_direct_reads ||
+      !CheckFSFeatureSupport(fs_.get(), FSSupportedOps::kAsyncIO)) {
+    return 0;
+  }
+  // Each subcompaction reads every L0 input file and one file of each other
+  // input level at a time.
+  const Compaction* c = compact_->compaction;
+  size_t num_open_files = 0;
+  for (size_t i = 0; i < c->num_input_levels(); i++) {
+    if (c->level(i) == 0) {
+      num_open_files += c->num_input_files(i);
+    } else if (c->num_input_files(i) > 0) {
+      num_open_files++;
+    }
+  }
+  const size_t num_threads = num_subcompaction_threads_ > 0
+                                 ? num_subcompaction_threads_
+                                 : compact_->sub_compact_states.size();
+  return budget / std::max<size_t>(num_open_files * num_threads, 1);
+}
+
 Status CompactionJob::VerifyInputRecordCount(
     uint64_t num_input_range_del) const {
   size_t ts_sz = compact_->compaction->column_family_data()
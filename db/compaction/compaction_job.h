@@ -205,6 +205,9 @@ class CompactionJob {
 
   // Iterate through input and compact the kv-pairs.
   void ProcessKeyValueCompaction(SubcompactionState* sub_compact);
+  // Runs the subcompaction `first`, then the subcompactions not yet started,
+  // which are claimed by incrementing `next`.
+  void ProcessKeyValueCompactions(size_t first, std::atomic<size_t>* next);
 
   CompactionState* compact_;
   InternalStats::CompactionStatsFull internal_stats_;
@@ -346,6 +349,10 @@ class CompactionJob {
   bool measure_io_stats_;
   // Stores the Slices that designate the boundaries for each subcompaction
   std::vector<std::string> boundaries_;
+  // Number of threads running the subcompactions, when less than the number
+  // of subcompactions (see DBOptions::subcompaction_ranges_per_thread).
+  // Otherwise 0, for one thread per subcompaction.
+  size_t num_subcompaction_threads_ = 0;
   Env::Priority thread_pri_;
   std::string full_history_ts_low_;
   std::string trim_ts_;
@@ -386,6 +393,10 @@ class CompactionJob {
   // The Compaction Read and Write priorities are the same for different
   // scenarios, such as write stalled.
   Env::IOPriority GetRateLimiterPriority();
+  // The readahead size of each compaction input file with
+  // DBOptions::compaction_async_readahead_budget, or 0 for no async
+  // readahead.
+  size_t GetAsyncReadaheadSize() const;
 };
 
 // CompactionServiceInput is used the pass compaction information between two
@@ -0,0 +1,104 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/compaction/compaction_output_warmer.h"
+
+#include <algorithm>
+
+#include "db/column_family.h"
+#include "db/table_cache.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+HotInputBlockWarmer::HotInputBlockWarmer(const Compaction* compaction,
+                                         TableCache* table_cache,
+                                         uint64_t budget)
+    : compaction_(compaction),
+      table_cache_(table_cache),
+      budget_(budget),
+      read_options_(Env::IOActivity::kCompaction) {
+  assert(compaction_ != nullptr);
+  assert(table_cache_ != nullptr);
+}
+
+bool HotInputBlockWarmer::ShouldWarmDataBlock(const Slice& first_ikey,
+                                              const Slice& last_ikey,
+                                              size_t block_size) {
+  if (warmed_bytes_.LoadRelaxed() + block_size > budget_) {
+    return false;
+  }
+
+  const Slice first_user_key = ExtractUserKey(first_ikey);
+  const Slice last_user_key = ExtractUserKey(last_ikey);
+  const Comparator* ucmp = compaction_->column_family_data()->user_comparator();
+
+  bool hot = false;
+  for (size_t i = 0; !hot && i < compaction_->num_input_levels(); ++i) {
+    const std::vector<FileMetaData*>& files = *compaction_->inputs(i);
+    auto it = files.begin();
+    if (compaction_->level(i) != 0) {
+      // Sorted and non-overlapping; skip the files entirely before the block
+      auto ends_before = [ucmp](const FileMetaData* f, const Slice& k) {
+        return ucmp->Compare(f->largest.user_key(), k) < 0;
+      };
+      it = std::lower_bound(files.begin(), files.end(), first_user_key,
+                            ends_before);
+    }
+    for (; !hot && it != files.end(); ++it) {
+      const FileMetaData& file = **it;
+      if (ucmp->Compare(file.smallest.user_key(), last_user_key) > 0) {
+        if (compaction_->level(i) != 0) {
+          break;
+        }
+        continue;
+      }
+      if (ucmp->Compare(file.largest.user_key(), first_user_key) < 0) {
+        continue;
+      }
+      hot = IsHotInFile(file, first_user_key, last_user_key);
+    }
+  }
+  if (!hot) {
+    return false;
+  }
+
+  // Concurrent callers might have used up the budget in the meantime
+  return warmed_bytes_.FetchAddRelaxed(block_size) + block_size <= budget_;
+}
+
+bool HotInputBlockWarmer::IsHotInFile(const FileMetaData& file,
+                                      const Slice& first_user_key,
+                                      const Slice& last_user_key) {
+  const ColumnFamilyData* cfd = compaction_->column_family_data();
+  const InternalKeyComparator& icmp = cfd->internal_comparator();
+
+  std::unique_ptr<TableReader::DataBlockCacheProbe>& probe =
+      probes_[file.fd.GetNumber()];
+  if (probe == nullptr) {
+    // Retried on the next block if the file is not open yet
+    probe = table_cache_->NewDataBlockCacheProbe(
+        read_options_, file, icmp, compaction_->mutable_cf_options());
+    if (probe == nullptr) {
+      return false;
+    }
+  }
+
+  // The data blocks holding the newest entries of the first and last user
+  // keys, or the first and last data blocks of the file if the block
+  // extends beyond it
+  InternalKey first_key(first_user_key, kMaxSequenceNumber, kValueTypeForSeek);
+  if (probe->IsDataBlockCached(first_key.Encode())) {
+    return true;
+  }
+  if (icmp.user_comparator()->Compare(last_user_key,
+                                      file.largest.user_key()) < 0) {
+    InternalKey last_key(last_user_key, kMaxSequenceNumber, kValueTypeForSeek);
+    return probe->IsDataBlockCached(last_key.Encode());
+  }
+  return probe->IsDataBlockCached(file.largest.Encode());
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,54 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+
+#include "db/compaction/compaction.h"
+#include "table/table_builder.h"
+#include "table/table_reader.h"
+#include "util/atomic.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class TableCache;
+
+// Warms the output data blocks of a (sub)compaction whose key range was hot
+// in the input, for BlockBasedTableOptions::PrepopulateBlockCache::
+// kFlushAndHotCompaction. An output block is considered hot if, in any input
+// file overlapping it, the data block holding its first key or the one
+// holding its last key is resident in the block cache. That is only probed
+// for, without doing any I/O, through one index iterator per input file that
+// follows the key order of the output. Hot blocks are warmed until `budget`
+// bytes have been warmed.
+class HotInputBlockWarmer : public CompactionOutputWarmer {
+ public:
+  HotInputBlockWarmer(const Compaction* compaction, TableCache* table_cache,
+                      uint64_t budget);
+
+  bool ShouldWarmDataBlock(const Slice& first_ikey, const Slice& last_ikey,
+                           size_t block_size) override;
+
+  uint64_t GetWarmedBytes() const { return warmed_bytes_.LoadRelaxed(); }
+
+ private:
+  bool IsHotInFile(const FileMetaData& file, const Slice& first_user_key,
+                   const Slice& last_user_key);
+
+  const Compaction* const compaction_;
+  TableCache* const table_cache_;
+  const uint64_t budget_;
+  const ReadOptions read_options_;
+  RelaxedAtomic<uint64_t> warmed_bytes_{0};
+  // By file number, created on the first probe of the file
+  std::unordered_map<uint64_t,
+                     std::unique_ptr<TableReader::DataBlockCacheProbe>>
+      probes_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -1232,9 +1232,9 @@ void CompactionPicker::PickFilesMarkedForCompaction(
 bool CompactionPicker::GetOverlappingL0Files(
     VersionStorageInfo* vstorage, CompactionInputFiles* start_level_inputs,
     int output_level, int* parent_index) {
-  // Two level 0 compaction won't run at the same time, so don't need to worry
-  // about files on level 0 being compacted.
-  assert(level0_compactions_in_progress()->empty());
+  // Two level 0 compaction won't run at the same time unless L0 is sharded.
+  // Then the files of other shards may be compacted, but not the ones
+  // overlapping the picked files.
   InternalKey smallest, largest;
   GetRange(*start_level_inputs, &smallest, &largest);
   // Note that the next call will discard the file we placed in
@@ -1243,6 +1243,9 @@ bool CompactionPicker::GetOverlappingL0Files(
   start_level_inputs->files.clear();
   vstorage->GetOverlappingInputs(0, &smallest, &largest,
                                  &(start_level_inputs->files));
+  if (AreFilesInCompaction(start_level_inputs->files)) {
+    return false;
+  }
 
   // If we include more L0 files in the same compaction run it can
   // cause the 'smallest' and 'largest' key to get extended to a
@@ -9,7 +9,9 @@
 
 #include "db/compaction/compaction_picker_fifo.h"
 
+#include <algorithm>
 #include <cinttypes>
+#include <limits>
 #include <string>
 #include <vector>
 
@@ -173,7 +175,16 @@ Compaction* FIFOCompactionPicker::PickSizeCompaction(
     // total size not exceeded, try to find intra level 0 compaction if enabled
     const std::vector<FileMetaData*>& level0_files = vstorage->LevelFiles(0);
     if (mutable_cf_options.compaction_options_fifo.allow_compaction &&
-        level0_files.size() > 0) {
+        mutable_cf_options.compaction_options_fifo.time_window_seconds > 0) {
+      // Never merge files across time windows
+      Compaction* c =
+          PickTimeWindowCompaction(cf_name, mutable_cf_options,
+                                   mutable_db_options, vstorage, log_buffer);
+      if (c != nullptr) {
+        return c;
+      }
+    } else if (mutable_cf_options.compaction_options_fifo.allow_compaction &&
+               level0_files.size() > 0) {
       CompactionInputFiles comp_inputs;
       // try to prevent same files from being compacted multiple times, which
       // could produce large files that may never TTL-expire. Achieve this by
@@ -305,6 +316,112 @@ Compaction* FIFOCompactionPicker::PickSizeCompaction(
   return c;
 }
 
+Compaction* FIFOCompactionPicker::PickTimeWindowCompaction(
+    const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
+    const MutableDBOptions& mutable_db_options, VersionStorageInfo* vstorage,
+    LogBuffer* log_buffer) {
+  const uint64_t window =
+      mutable_cf_options.compaction_options_fifo.time_window_seconds;
+  assert(window > 0);
+
+  const int kLevel0 = 0;
+  const std::vector<FileMetaData*>& level_files = vstorage->LevelFiles(kLevel0);
+  if (level_files.size() < 2) {
+    return nullptr;
+  }
+
+  int64_t _current_time;
+  auto status = ioptions_.clock->GetCurrentTime(&_current_time);
+  if (!status.ok()) {
+    ROCKS_LOG_BUFFER(log_buffer,
+                     "[%s] FIFO compaction: Couldn't get current time: %s. "
+                     "Not doing compactions based on time windows. ",
+                     cf_name.c_str(), status.ToString().c_str());
+    return nullptr;
+  }
+  const uint64_t current_window = static_cast<uint64_t>(_current_time) / window;
+
+  if (!level0_compactions_in_progress_.empty()) {
+    ROCKS_LOG_BUFFER(
+        log_buffer,
+        "[%s] FIFO compaction: Already executing compaction. Parallel "
+        "compactions are not supported",
+        cf_name.c_str());
+    return nullptr;
+  }
+
+  // Walk from the oldest file, collecting runs of consecutive files of the
+  // same ended window. A file with unknown newest key time ends a run.
+  CompactionInputFiles comp_inputs;
+  comp_inputs.level = kLevel0;
+  uint64_t run_window = std::numeric_limits<uint64_t>::max();
+  uint64_t run_bytes = 0;
+  for (size_t index = level_files.size(); index >= 1; --index) {
+    FileMetaData* cur_file = level_files[index - 1];
+    FileMetaData* prev_file = index < 2 ? nullptr : level_files[index - 2];
+    if (cur_file->being_compacted) {
+      // Should not happen since we check for
+      // `level0_compactions_in_progress_` above
+      return nullptr;
+    }
+    uint64_t est_newest_key_time = cur_file->TryGetNewestKeyTime(prev_file);
+    uint64_t file_window = est_newest_key_time == kUnknownNewestKeyTime
+                               ? current_window
+                               : est_newest_key_time / window;
+    if (file_window != run_window) {
+      if (comp_inputs.files.size() >= 2) {
+        break;
+      }
+      comp_inputs.files.clear();
+      run_window = file_window;
+      run_bytes = 0;
+    }
+    if (file_window >= current_window) {
+      // This window has not ended yet and neither have the newer ones
+      comp_inputs.files.clear();
+      break;
+    }
+    if (run_bytes + cur_file->fd.file_size >
+        mutable_cf_options.max_compaction_bytes) {
+      if (comp_inputs.files.size() >= 2) {
+        // The rest of the window is picked by a later compaction
+        break;
+      }
+      // Nothing to merge before this file, e.g. a file of an earlier
+      // compaction of the window, so start the run over at this file
+      comp_inputs.files.clear();
+      run_bytes = 0;
+    }
+    run_bytes += cur_file->fd.file_size;
+    comp_inputs.files.push_back(cur_file);
+  }
+
+  if (comp_inputs.files.size() < 2) {
+    return nullptr;
+  }
+  // Back to the newest-first order of L0
+  std::reverse(comp_inputs.files.begin(), comp_inputs.files.end());
+  ROCKS_LOG_BUFFER(log_buffer,
+                   "[%s] FIFO compaction: picking %" ROCKSDB_PRIszt
+                   " files of time window %" PRIu64 " (%" PRIu64
+                   " bytes) for compaction",
+                   cf_name.c_str(), comp_inputs.files.size(),
+                   run_window * window, run_bytes);
+
+  Compaction* c = new Compaction(
+      vstorage, ioptions_, mutable_cf_options, mutable_db_options,
+      {comp_inputs}, 0, 0 /* output file size limit */,
+      0 /* max compaction bytes, not applicable */, 0 /* output path ID */,
+      mutable_cf_options.compression, mutable_cf_options.compression_opts,
+      mutable_cf_options.default_write_temperature,
+      /* max_subcompactions */ 0, {}, /* earliest_snapshot */ std::nullopt,
+      /* snapshot_checker */ nullptr, /* is manual */ false,
+      /* trim_ts */ "", vstorage->CompactionScore(0),
+      /* is deletion compaction */ false, /* l0_files_might_overlap */ true,
+      CompactionReason::kFIFOReduceNumFiles);
+  return c;
+}
+
 Compaction* FIFOCompactionPicker::PickTemperatureChangeCompaction(
     const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
     const MutableDBOptions& mutable_db_options, VersionStorageInfo* vstorage,
@@ -9,6 +9,7 @@
 
 #include "db/compaction/compaction_picker_level.h"
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
@@ -36,6 +37,15 @@ bool LevelCompactionPicker::NeedsCompaction(
   if (!vstorage->FilesMarkedForForcedBlobGC().empty()) {
     return true;
   }
+  if (!vstorage->FilesMarkedForBlobGC().empty()) {
+    return true;
+  }
+  if (!vstorage->FilesMarkedForRangeDeletionCompaction().empty()) {
+    return true;
+  }
+  if (!vstorage->FilesMarkedForReadCompaction().empty()) {
+    return true;
+  }
   for (int i = 0; i <= vstorage->MaxInputLevel(); i++) {
     if (vstorage->CompactionScore(i) >= 1) {
       return true;
@@ -61,14 +71,25 @@ class LevelCompactionBuilder {
                          LogBuffer* log_buffer,
                          const MutableCFOptions& mutable_cf_options,
                          const ImmutableOptions& ioptions,
-                         const MutableDBOptions& mutable_db_options)
+                         const MutableDBOptions& mutable_db_options,
+                         const std::vector<SequenceNumber>& existing_snapshots,
+                         const SnapshotChecker* snapshot_checker)
       : cf_name_(cf_name),
         vstorage_(vstorage),
         compaction_picker_(compaction_picker),
         log_buffer_(log_buffer),
         mutable_cf_options_(mutable_cf_options),
         ioptions_(ioptions),
-        mutable_db_options_(mutable_db_options) {}
+        mutable_db_options_(mutable_db_options) {
+    // These parameters are only passed when user-defined timestamp is not
+    // enabled.
+    if (vstorage_->user_comparator()->timestamp_size() == 0) {
+      earliest_snapshot_ = existing_snapshots.empty()
+                               ? kMaxSequenceNumber
+                               : existing_snapshots.at(0);
+      snapshot_checker_ = snapshot_checker;
+    }
+  }
 
   // Pick and return a compaction.
   Compaction* PickCompaction();
@@ -96,9 +117,22 @@ class LevelCompactionBuilder {
   // all compaction priorities except round-robin. For round-robin,
   // multiple consecutive files may be put into inputs->files.
   // If level is 0 and there is already a compaction on that level, this
-  // function will return false.
+  // function will return false, unless L0 is sharded.
   bool PickFileToCompact();
 
+  // Whether L0 is split into key-range shards whose compactions into the base
+  // level may run concurrently. See shard_level0_by_sst_partitioner.
+  bool IsLevel0Sharded() const {
+    return mutable_cf_options_.shard_level0_by_sst_partitioner &&
+           ioptions_.sst_partitioner_factory != nullptr;
+  }
+
+  // Whether L0 holds several files of the same epoch number, i.e. the
+  // non-overlapping files of a flush cut into shards. An intra-L0 compaction
+  // must not take some of them without the others, since its output gets the
+  // smallest epoch number of its inputs.
+  bool Level0HasSharedEpochNumbers() const;
+
   // Return true if a L0 trivial move is picked up.
   bool TryPickL0TrivialMove();
 
@@ -122,6 +156,14 @@ class LevelCompactionBuilder {
   // a compaction is picked.
   bool PickSizeBasedIntraL0Compaction();
 
+  // Picks a file marked for range deletion compaction together with the
+  // overlapping files of all the levels below it, to compact into the last
+  // non-empty level.
+  //
+  // Returns true iff such a compaction is picked. `start_level_inputs_`,
+  // `compaction_inputs_` and `output_level_` are updated accordingly.
+  bool PickRangeDeletionCompaction();
+
   // Return true if TrivialMove is extended. `start_index` is the index of
   // the initial file picked, which should already be in `start_level_inputs_`.
   bool TryExtendNonL0TrivialMove(int start_index,
@@ -156,6 +198,10 @@ class LevelCompactionBuilder {
   const MutableCFOptions& mutable_cf_options_;
   const ImmutableOptions& ioptions_;
   const MutableDBOptions& mutable_db_options_;
+  // Only used by range deletion compactions, so that lower level files fully
+  // covered by a standalone range tombstone are dropped without being read.
+  std::optional<SequenceNumber> earliest_snapshot_;
+  const SnapshotChecker* snapshot_checker_ = nullptr;
   // Pick a path ID to place a newly generated file, with its level
   static uint32_t GetPathId(const ImmutableCFOptions& ioptions,
                             const MutableCFOptions& mutable_cf_options,
@@ -261,6 +307,11 @@ void LevelCompactionBuilder::SetupInitialFiles() {
   // compaction
   parent_index_ = base_index_ = -1;
 
+  if (PickRangeDeletionCompaction()) {
+    compaction_reason_ = CompactionReason::kRangeDeletions;
+    return;
+  }
+
   compaction_picker_->PickFilesMarkedForCompaction(
       cf_name_, vstorage_, &start_level_, &output_level_, &start_level_inputs_,
       /*skip_marked_file*/ [](const FileMetaData* /* file */) {
@@ -271,6 +322,14 @@ void LevelCompactionBuilder::SetupInitialFiles() {
     return;
   }
 
+  // Read triggered compaction
+  PickFileToCompact(vstorage_->FilesMarkedForReadCompaction(),
+                    CompactToNextLevel::kYes);
+  if (!start_level_inputs_.empty()) {
+    compaction_reason_ = CompactionReason::kReadTriggered;
+    return;
+  }
+
   // Bottommost Files Compaction on deleting tombstones
   PickFileToCompact(vstorage_->BottommostFilesMarkedForCompaction(),
                     CompactToNextLevel::kNo);
@@ -323,6 +382,13 @@ void LevelCompactionBuilder::SetupInitialFiles() {
     compaction_reason_ = CompactionReason::kForcedBlobGC;
     return;
   }
+
+  // Blob garbage collection of a single blob file
+  PickFileToCompact(vstorage_->FilesMarkedForBlobGC(), CompactToNextLevel::kNo);
+  if (!start_level_inputs_.empty()) {
+    compaction_reason_ = CompactionReason::kBlobGarbageCollection;
+    return;
+  }
 }
 
 bool LevelCompactionBuilder::SetupOtherL0FilesIfNeeded() {
@@ -458,6 +524,11 @@ void LevelCompactionBuilder::SetupOtherFilesWithRoundRobinExpansion() {
 }
 
 bool LevelCompactionBuilder::SetupOtherInputsIfNeeded() {
+  if (compaction_reason_ == CompactionReason::kRangeDeletions) {
+    // PickRangeDeletionCompaction() already picked the files of all levels.
+    assert(!compaction_inputs_.empty());
+    return true;
+  }
   // Setup input files from output level. For output to L0, we only compact
   // spans of files that do not interact with any pending compactions, so don't
   // need to consider other levels.
@@ -547,6 +618,18 @@ Compaction* LevelCompactionBuilder::GetCompaction() {
   bool l0_files_might_overlap =
       start_level_ == 0 && !is_l0_trivial_move_ &&
       (compaction_inputs_.size() > 1 || compaction_inputs_[0].size() > 1);
+  const bool range_deletion_compaction =
+      compaction_reason_ == CompactionReason::kRangeDeletions;
+  // Blob GC relocates the blobs of the marked blob file and of older ones, so
+  // that every rewritten SST file ends up linked to a newer blob file.
+  BlobGarbageCollectionPolicy blob_gc_policy =
+      BlobGarbageCollectionPolicy::kUseDefault;
+  uint64_t blob_gc_file_number = kInvalidBlobFileNumber;
+  if (compaction_reason_ == CompactionReason::kBlobGarbageCollection) {
+    blob_gc_policy = BlobGarbageCollectionPolicy::kForce;
+    blob_gc_file_number = vstorage_->BlobFileMarkedForGC();
+    assert(blob_gc_file_number != kInvalidBlobFileNumber);
+  }
   auto c = new Compaction(
       vstorage_, ioptions_, mutable_cf_options_, mutable_db_options_,
       std::move(compaction_inputs_), output_level_,
@@ -560,10 +643,11 @@ Compaction* LevelCompactionBuilder::GetCompaction() {
       GetCompressionOptions(mutable_cf_options_, vstorage_, output_level_),
       mutable_cf_options_.default_write_temperature,
       /* max_subcompactions */ 0, std::move(grandparents_),
-      /* earliest_snapshot */ std::nullopt, /* snapshot_checker */ nullptr,
-      is_manual_,
+      range_deletion_compaction ? earliest_snapshot_ : std::nullopt,
+      range_deletion_compaction ? snapshot_checker_ : nullptr, is_manual_,
       /* trim_ts */ "", start_level_score_, false /* deletion_compaction */,
-      l0_files_might_overlap, compaction_reason_);
+      l0_files_might_overlap, compaction_reason_, blob_gc_policy,
+      /* blob_garbage_collection_age_cutoff */ -1, blob_gc_file_number);
 
   // If it's level 0 compaction, make sure we don't execute any other level 0
   // compactions in parallel
@@ -577,6 +661,64 @@ Compaction* LevelCompactionBuilder::GetCompaction() {
   return c;
 }
 
+bool LevelCompactionBuilder::PickRangeDeletionCompaction() {
+  const int last_level = vstorage_->num_non_empty_levels() - 1;
+  for (const auto& level_file :
+       vstorage_->FilesMarkedForRangeDeletionCompaction()) {
+    assert(!level_file.second->being_compacted);
+    const int start_level = level_file.first;
+    if (start_level == 0 || start_level >= last_level) {
+      continue;
+    }
+    std::vector<CompactionInputFiles> inputs(last_level - start_level + 1);
+    inputs[0].level = start_level;
+    inputs[0].files = {level_file.second};
+    if (!compaction_picker_->ExpandInputsToCleanCut(cf_name_, vstorage_,
+                                                    &inputs[0])) {
+      continue;
+    }
+    uint64_t input_bytes = TotalFileSize(inputs[0].files);
+    // Each level takes the files overlapping the range of the levels above
+    // it, so that no newer version of a key is left above the output.
+    bool picked = true;
+    for (size_t i = 1; i < inputs.size(); i++) {
+      inputs[i].level = start_level + static_cast<int>(i);
+      InternalKey smallest, largest;
+      compaction_picker_->GetRange(inputs, &smallest, &largest,
+                                   /*exclude_level=*/-1);
+      vstorage_->GetOverlappingInputs(inputs[i].level, &smallest, &largest,
+                                      &inputs[i].files);
+      if (inputs[i].empty()) {
+        continue;
+      }
+      if (!compaction_picker_->ExpandInputsToCleanCut(cf_name_, vstorage_,
+                                                      &inputs[i])) {
+        picked = false;
+        break;
+      }
+      input_bytes += TotalFileSize(inputs[i].files);
+    }
+    // The data covered by the range tombstones is dropped rather than
+    // rewritten, so it does not count against max_compaction_bytes.
+    if (!picked ||
+        input_bytes > mutable_cf_options_.max_compaction_bytes +
+                          level_file.second->compensated_range_deletion_size ||
+        compaction_picker_->FilesRangeOverlapWithCompaction(
+            inputs, last_level,
+            Compaction::EvaluateProximalLevel(vstorage_, mutable_cf_options_,
+                                              ioptions_, start_level,
+                                              last_level))) {
+      continue;
+    }
+    start_level_ = start_level;
+    output_level_ = last_level;
+    start_level_inputs_ = inputs[0];
+    compaction_inputs_ = std::move(inputs);
+    return true;
+  }
+  return false;
+}
+
 /*
  * Find the optimal path to place a file
  * Given a level, finds the path where levels up to it will fit in levels
@@ -787,13 +929,29 @@ bool LevelCompactionBuilder::TryExtendNonL0TrivialMove(int start_index,
   return false;
 }
 
+bool LevelCompactionBuilder::Level0HasSharedEpochNumbers() const {
+  const std::vector<FileMetaData*>& l0_files = vstorage_->LevelFiles(0);
+  for (size_t i = 1; i < l0_files.size(); i++) {
+    if (l0_files[i]->epoch_number != kUnknownEpochNumber &&
+        l0_files[i]->epoch_number == l0_files[i - 1]->epoch_number) {
+      return true;
+    }
+  }
+  return false;
+}
+
 bool LevelCompactionBuilder::PickFileToCompact() {
   // level 0 files are overlapping. So we cannot pick more
   // than one concurrent compactions at this level. This
   // could be made better by looking at key-ranges that are
   // being compacted at level 0.
-  if (start_level_ == 0 &&
-      !compaction_picker_->level0_compactions_in_progress()->empty()) {
+  // The exception is a sharded L0, where the L0 files of different shards
+  // don't overlap. GetOverlappingL0Files() then makes sure that the picked
+  // files don't overlap the files of the running L0 compactions.
+  const bool level0_compaction_in_progress =
+      !compaction_picker_->level0_compactions_in_progress()->empty();
+  if (start_level_ == 0 && level0_compaction_in_progress &&
+      !IsLevel0Sharded()) {
     if (PickSizeBasedIntraL0Compaction()) {
       return true;
     }
@@ -806,10 +964,11 @@ bool LevelCompactionBuilder::PickFileToCompact() {
 
   assert(start_level_ >= 0);
 
-  if (TryPickL0TrivialMove()) {
+  if (!level0_compaction_in_progress && TryPickL0TrivialMove()) {
     return true;
   }
-  if (start_level_ == 0 && PickSizeBasedIntraL0Compaction()) {
+  if (start_level_ == 0 && !level0_compaction_in_progress &&
+      PickSizeBasedIntraL0Compaction()) {
     return true;
   }
 
@@ -912,6 +1071,9 @@ bool LevelCompactionBuilder::PickIntraL0Compaction() {
     // resort to L0->L0 compaction yet.
     return false;
   }
+  if (Level0HasSharedEpochNumbers()) {
+    return false;
+  }
   return FindIntraL0Compaction(level_files, kMinFilesForIntraL0Compaction,
                                std::numeric_limits<uint64_t>::max(),
                                mutable_cf_options_.max_compaction_bytes,
@@ -928,7 +1090,7 @@ bool LevelCompactionBuilder::PickSizeBasedIntraL0Compaction() {
       vstorage_->LevelFiles(/*level=*/0);
   size_t min_num_file =
       std::max(2, mutable_cf_options_.level0_file_num_compaction_trigger);
-  if (l0_files.size() < min_num_file) {
+  if (l0_files.size() < min_num_file || Level0HasSharedEpochNumbers()) {
     return false;
   }
   uint64_t l0_size = 0;
@@ -976,12 +1138,13 @@ bool LevelCompactionBuilder::PickSizeBasedIntraL0Compaction() {
 Compaction* LevelCompactionPicker::PickCompaction(
     const std::string& cf_name, const MutableCFOptions& mutable_cf_options,
     const MutableDBOptions& mutable_db_options,
-    const std::vector<SequenceNumber>& /*existing_snapshots */,
-    const SnapshotChecker* /*snapshot_checker*/, VersionStorageInfo* vstorage,
+    const std::vector<SequenceNumber>& existing_snapshots,
+    const SnapshotChecker* snapshot_checker, VersionStorageInfo* vstorage,
     LogBuffer* log_buffer) {
   LevelCompactionBuilder builder(cf_name, vstorage, this, log_buffer,
                                  mutable_cf_options, ioptions_,
-                                 mutable_db_options);
+                                 mutable_db_options, existing_snapshots,
+                                 snapshot_checker);
   return builder.PickCompaction();
 }
 }  // namespace ROCKSDB_NAMESPACE
@@ -12,6 +12,7 @@
 #include "db/compaction/compaction_picker_level.h"
 #include "db/compaction/compaction_picker_universal.h"
 #include "db/compaction/file_pri.h"
+#include "monitoring/statistics_impl.h"
 #include "rocksdb/advanced_options.h"
 #include "table/mock_table.h"
 #include "table/unique_id_impl.h"
@@ -1172,6 +1173,103 @@ TEST_F(CompactionPickerTest, FIFOToCold1) {
   }
 }
 
+TEST_F(CompactionPickerTest, FIFOTimeWindowCompaction) {
+  NewVersionStorage(1, kCompactionStyleFIFO);
+  const uint64_t kFileSize = 100000;
+  const uint64_t kWindow = 3600;
+
+  fifo_options_.max_table_files_size = kFileSize * 100000;
+  fifo_options_.allow_compaction = true;
+  fifo_options_.time_window_seconds = kWindow;
+  mutable_cf_options_.compaction_options_fifo = fifo_options_;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 3;
+  mutable_cf_options_.max_compaction_bytes = kFileSize * 100;
+  FIFOCompactionPicker fifo_compaction_picker(ioptions_, &icmp_);
+
+  int64_t current_time = 0;
+  ASSERT_OK(Env::Default()->GetCurrentTime(&current_time));
+  const uint64_t window_start =
+      static_cast<uint64_t>(current_time) / kWindow * kWindow;
+  // The current window, which has not ended
+  Add(0, 6U, "200", "300", kFileSize, 0, 600, 699, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime,
+      static_cast<uint64_t>(current_time) /* newest_key_time */);
+  // The previous window
+  Add(0, 5U, "200", "300", kFileSize, 0, 500, 599, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime, window_start - 100);
+  Add(0, 4U, "200", "300", kFileSize, 0, 400, 499, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime, window_start - 200);
+  Add(0, 3U, "200", "300", kFileSize, 0, 300, 399, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime, window_start - 300);
+  // An older window, already compacted into a single file
+  Add(0, 2U, "200", "300", 3 * kFileSize, 0, 200, 299, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime,
+      window_start - kWindow - 100);
+  UpdateVersionStorageInfo();
+
+  ASSERT_EQ(fifo_compaction_picker.NeedsCompaction(vstorage_.get()), true);
+  std::unique_ptr<Compaction> compaction(fifo_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_,
+      /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+      vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(compaction->compaction_reason(),
+            CompactionReason::kFIFOReduceNumFiles);
+  ASSERT_EQ(3U, compaction->num_input_files(0));
+  ASSERT_EQ(5U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(4U, compaction->input(0, 1)->fd.GetNumber());
+  ASSERT_EQ(3U, compaction->input(0, 2)->fd.GetNumber());
+}
+
+TEST_F(CompactionPickerTest, FIFOTimeWindowCompactionMaxCompactionBytes) {
+  NewVersionStorage(1, kCompactionStyleFIFO);
+  const uint64_t kFileSize = 100000;
+  const uint64_t kWindow = 3600;
+
+  fifo_options_.max_table_files_size = kFileSize * 100000;
+  fifo_options_.allow_compaction = true;
+  fifo_options_.time_window_seconds = kWindow;
+  mutable_cf_options_.compaction_options_fifo = fifo_options_;
+  mutable_cf_options_.level0_file_num_compaction_trigger = 3;
+  // The previous window is larger than this
+  mutable_cf_options_.max_compaction_bytes = kFileSize * 5 / 2;
+  FIFOCompactionPicker fifo_compaction_picker(ioptions_, &icmp_);
+
+  int64_t current_time = 0;
+  ASSERT_OK(Env::Default()->GetCurrentTime(&current_time));
+  const uint64_t window_start =
+      static_cast<uint64_t>(current_time) / kWindow * kWindow;
+  // The current window, which has not ended
+  Add(0, 6U, "200", "300", kFileSize, 0, 600, 699, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime,
+      static_cast<uint64_t>(current_time) /* newest_key_time */);
+  // The previous window, whose oldest files were already compacted into a
+  // single file
+  Add(0, 5U, "200", "300", kFileSize, 0, 500, 599, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime, window_start - 100);
+  Add(0, 4U, "200", "300", kFileSize, 0, 400, 499, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime, window_start - 200);
+  Add(0, 3U, "200", "300", kFileSize, 0, 300, 399, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime, window_start - 300);
+  Add(0, 2U, "200", "300", 3 * kFileSize, 0, 200, 299, 0, false,
+      Temperature::kUnknown, kUnknownOldestAncesterTime, window_start - 400);
+  UpdateVersionStorageInfo();
+
+  // The run starts over after the large file and stops before exceeding
+  // max_compaction_bytes
+  ASSERT_EQ(fifo_compaction_picker.NeedsCompaction(vstorage_.get()), true);
+  std::unique_ptr<Compaction> compaction(fifo_compaction_picker.PickCompaction(
+      cf_name_, mutable_cf_options_, mutable_db_options_,
+      /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+      vstorage_.get(), &log_buffer_));
+  ASSERT_TRUE(compaction.get() != nullptr);
+  ASSERT_EQ(compaction->compaction_reason(),
+            CompactionReason::kFIFOReduceNumFiles);
+  ASSERT_EQ(2U, compaction->num_input_files(0));
+  ASSERT_EQ(4U, compaction->input(0, 0)->fd.GetNumber());
+  ASSERT_EQ(3U, compaction->input(0, 1)->fd.GetNumber());
+}
+
 TEST_F(CompactionPickerTest, FIFOToColdMaxCompactionSize) {
   // Test fallback behavior from newest_key_time to oldest_ancestor_time
   for (bool newestKeyTimeKnown : {false, true}) {
@@ -4655,6 +4753,134 @@ TEST_F(CompactionPickerTest, UniversalMaxReadAmpSmallDB) {
   }
 }
 
+TEST_F(CompactionPickerTest, UniversalLazyLeveling) {
+  ioptions_.compaction_style = kCompactionStyleUniversal;
+  ioptions_.num_levels = 10;
+  mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+  mutable_cf_options_.level0_file_num_compaction_trigger = 2;
+  mutable_cf_options_.write_buffer_size = 64 << 20;
+  mutable_cf_options_.compaction_options_universal
+      .lazy_leveling_runs_per_tier = 3;
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, &icmp_);
+  const uint64_t kMB = 1 << 20;
+  const uint64_t kLastRunSize = 20ull << 30;
+
+  auto pick = [&]() {
+    UpdateVersionStorageInfo();
+    EXPECT_TRUE(universal_compaction_picker.NeedsCompaction(vstorage_.get()));
+    return std::unique_ptr<Compaction>(
+        universal_compaction_picker.PickCompaction(
+            cf_name_, mutable_cf_options_, mutable_db_options_,
+            /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+            vstorage_.get(), &log_buffer_));
+  };
+
+  // Three runs of tier 0 (L0 files), and two of tier 1
+  NewVersionStorage(/*num_levels=*/10, kCompactionStyleUniversal);
+  Add(9, 1U, "100", "200", kLastRunSize, 0, 1, 1);
+  Add(8, 2U, "100", "200", 190 * kMB, 0, 2, 2);
+  Add(7, 3U, "100", "200", 200 * kMB, 0, 3, 3);
+  Add(0, 4U, "100", "200", 64 * kMB, 0, 4, 4);
+  Add(0, 5U, "100", "200", 60 * kMB, 0, 5, 5);
+  Add(0, 6U, "100", "200", 64 * kMB, 0, 6, 6);
+  std::unique_ptr<Compaction> compaction = pick();
+  ASSERT_NE(nullptr, compaction);
+  ASSERT_EQ(CompactionReason::kUniversalSizeRatio,
+            compaction->compaction_reason());
+  ASSERT_EQ(0, compaction->start_level());
+  ASSERT_EQ(3U, compaction->num_input_files(0));
+  // Above the next sorted run
+  ASSERT_EQ(6, compaction->output_level());
+
+  // Two runs of tier 0, and three of tier 1
+  compaction.reset();
+  NewVersionStorage(/*num_levels=*/10, kCompactionStyleUniversal);
+  Add(9, 1U, "100", "200", kLastRunSize, 0, 1, 1);
+  Add(8, 2U, "100", "200", 190 * kMB, 0, 2, 2);
+  Add(7, 3U, "100", "200", 200 * kMB, 0, 3, 3);
+  Add(6, 4U, "100", "200", 210 * kMB, 0, 4, 4);
+  Add(0, 5U, "100", "200", 64 * kMB, 0, 5, 5);
+  Add(0, 6U, "100", "200", 64 * kMB, 0, 6, 6);
+  compaction = pick();
+  ASSERT_NE(nullptr, compaction);
+  ASSERT_EQ(CompactionReason::kUniversalSizeRatio,
+            compaction->compaction_reason());
+  ASSERT_EQ(6, compaction->start_level());
+  ASSERT_EQ(1U, compaction->num_input_files(0));
+  ASSERT_EQ(1U, compaction->num_input_files(1));
+  ASSERT_EQ(1U, compaction->num_input_files(2));
+  // The last sorted run is left alone
+  ASSERT_EQ(8, compaction->output_level());
+
+  // No full tier. The number of sorted runs is above
+  // level0_file_num_compaction_trigger, which does not matter.
+  auto add_partial_tiers = [&]() {
+    NewVersionStorage(/*num_levels=*/10, kCompactionStyleUniversal);
+    Add(9, 1U, "100", "200", kLastRunSize, 0, 1, 1);
+    Add(8, 2U, "100", "200", 190 * kMB, 0, 2, 2);
+    Add(7, 3U, "100", "200", 200 * kMB, 0, 3, 3);
+    Add(0, 4U, "100", "200", 64 * kMB, 0, 4, 4);
+    Add(0, 5U, "100", "200", 64 * kMB, 0, 5, 5);
+  };
+  compaction.reset();
+  add_partial_tiers();
+  compaction = pick();
+  ASSERT_EQ(nullptr, compaction);
+
+  // Unless limited by max_read_amp
+  mutable_cf_options_.compaction_options_universal.max_read_amp = 4;
+  add_partial_tiers();
+  compaction = pick();
+  ASSERT_NE(nullptr, compaction);
+  ASSERT_EQ(CompactionReason::kUniversalSortedRunNum,
+            compaction->compaction_reason());
+}
+
+TEST_F(CompactionPickerTest, UniversalLazyLevelingAutoTune) {
+  ioptions_.compaction_style = kCompactionStyleUniversal;
+  ioptions_.num_levels = 10;
+  std::shared_ptr<Statistics> stats = CreateDBStatistics();
+  ioptions_.stats = stats.get();
+  mutable_cf_options_.RefreshDerivedOptions(ioptions_);
+  mutable_cf_options_.level0_file_num_compaction_trigger = 2;
+  mutable_cf_options_.write_buffer_size = 64 << 20;
+  mutable_cf_options_.compaction_options_universal
+      .lazy_leveling_runs_per_tier = 4;
+  mutable_cf_options_.compaction_options_universal.lazy_leveling_auto_tune =
+      true;
+  UniversalCompactionPicker universal_compaction_picker(ioptions_, &icmp_);
+
+  auto pick = [&]() {
+    NewVersionStorage(/*num_levels=*/10, kCompactionStyleUniversal);
+    Add(9, 1U, "100", "200", 20ull << 30, 0, 1, 1);
+    Add(0, 2U, "100", "200", 64 << 20, 0, 2, 2);
+    Add(0, 3U, "100", "200", 64 << 20, 0, 3, 3);
+    Add(0, 4U, "100", "200", 64 << 20, 0, 4, 4);
+    UpdateVersionStorageInfo();
+    return std::unique_ptr<Compaction>(
+        universal_compaction_picker.PickCompaction(
+            cf_name_, mutable_cf_options_, mutable_db_options_,
+            /*existing_snapshots=*/{}, /* snapshot_checker */ nullptr,
+            vstorage_.get(), &log_buffer_));
+  };
+
+  // Nothing observed yet: 4 runs per tier
+  ASSERT_EQ(nullptr, pick());
+
+  // Write heavy: still 4 runs per tier
+  RecordTick(stats.get(), NUMBER_KEYS_WRITTEN, 1000000);
+  RecordTick(stats.get(), NUMBER_KEYS_READ, 1000);
+  ASSERT_EQ(nullptr, pick());
+
+  // Read heavy: fewer runs per tier, merging the three L0 files
+  RecordTick(stats.get(), NUMBER_KEYS_READ, 100000000);
+  std::unique_ptr<Compaction> compaction = pick();
+  ASSERT_NE(nullptr, compaction);
+  ASSERT_EQ(CompactionReason::kUniversalSizeRatio,
+            compaction->compaction_reason());
+  ASSERT_EQ(3U, compaction->num_input_files(0));
+}
+
 }  // namespace ROCKSDB_NAMESPACE
 
 int main(int argc, char** argv) {
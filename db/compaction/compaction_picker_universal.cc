@@ -9,6 +9,7 @@
 
 #include "db/compaction/compaction_picker_universal.h"
 
+#include <cmath>
 #include <cstdint>
 #include <limits>
 #include <queue>
@@ -109,6 +110,14 @@ class UniversalCompactionBuilder {
   // Pick Universal compaction to limit space amplification.
   Compaction* PickCompactionToReduceSizeAmp();
 
+  // Pick a compaction merging the runs of a full tier, with lazy leveling
+  // (see CompactionOptionsUniversal::lazy_leveling_runs_per_tier)
+  Compaction* PickLazyLevelingCompaction();
+
+  // The number of runs per tier with lazy leveling, possibly tuned from the
+  // observed reads and writes
+  unsigned int GetLazyLevelingRunsPerTier() const;
+
   // Try to pick incremental compaction to reduce space amplification.
   // It will return null if it cannot find a fanout within the threshold.
   // Fanout is defined as
@@ -599,13 +608,29 @@ Compaction* UniversalCompactionBuilder::PickCompaction() {
       // amplification while maintaining file size ratios.
       unsigned int ratio =
           mutable_cf_options_.compaction_options_universal.size_ratio;
-
-      if ((c = PickCompactionToReduceSortedRuns(ratio, UINT_MAX)) != nullptr) {
+      const bool lazy_leveling =
+          mutable_cf_options_.compaction_options_universal
+              .lazy_leveling_runs_per_tier > 0;
+
+      if (lazy_leveling) {
+        if ((c = PickLazyLevelingCompaction()) != nullptr) {
+          ROCKS_LOG_BUFFER(log_buffer_,
+                           "[%s] Universal: compacting for lazy leveling\n",
+                           cf_name_.c_str());
+        }
+      } else if ((c = PickCompactionToReduceSortedRuns(ratio, UINT_MAX)) !=
+                 nullptr) {
         TEST_SYNC_POINT("PickCompactionToReduceSortedRunsReturnNonnullptr");
         ROCKS_LOG_BUFFER(log_buffer_,
                          "[%s] Universal: compacting for size ratio\n",
                          cf_name_.c_str());
-      } else {
+      }
+      // With lazy leveling, the number of sorted runs is only limited by an
+      // explicit max_read_amp.
+      if (c == nullptr &&
+          (!lazy_leveling ||
+           mutable_cf_options_.compaction_options_universal.max_read_amp >
+               0)) {
         // Size amplification and file size ratios are within configured limits.
         // If max read amplification exceeds configured limits, then force
         // compaction to reduce the number sorted runs without looking at file
@@ -1012,6 +1037,108 @@ Compaction* UniversalCompactionBuilder::PickCompactionToReduceSortedRuns(
                         /* l0_files_might_overlap */ true, compaction_reason);
 }
 
+unsigned int UniversalCompactionBuilder::GetLazyLevelingRunsPerTier() const {
+  const CompactionOptionsUniversal& opts =
+      mutable_cf_options_.compaction_options_universal;
+  const unsigned int max_runs_per_tier =
+      std::max(opts.lazy_leveling_runs_per_tier, 2U);
+  Statistics* stats = ioptions_.stats;
+  if (!opts.lazy_leveling_auto_tune || stats == nullptr) {
+    return max_runs_per_tier;
+  }
+  const double writes =
+      static_cast<double>(stats->getTickerCount(NUMBER_KEYS_WRITTEN));
+  const double reads =
+      static_cast<double>(stats->getTickerCount(NUMBER_KEYS_READ) +
+                          stats->getTickerCount(NUMBER_MULTIGET_KEYS_READ) +
+                          stats->getTickerCount(NUMBER_DB_SEEK));
+  if (writes + reads == 0) {
+    return max_runs_per_tier;
+  }
+
+  // Size of the data in units of the newest tier
+  uint64_t total_size = 0;
+  for (const auto& sr : sorted_runs_) {
+    total_size += sr.size;
+  }
+  const double units = std::max(
+      2.0, static_cast<double>(total_size) /
+               static_cast<double>(std::max(
+                   mutable_cf_options_.write_buffer_size, size_t{1})));
+
+  // With K runs per tier, there are about log_K(units) tiers. A written key
+  // is rewritten once per tier, and a read probes up to K - 1 runs per tier
+  // and the oldest run.
+  constexpr unsigned int kMaxTunedRunsPerTier = 256;
+  unsigned int best_runs_per_tier = 2;
+  double best_cost = std::numeric_limits<double>::max();
+  for (unsigned int k = 2;
+       k <= std::min(max_runs_per_tier, kMaxTunedRunsPerTier); ++k) {
+    const double tiers =
+        std::max(1.0, std::ceil(std::log(units) / std::log(k)));
+    const double cost = writes * tiers + reads * ((k - 1) * tiers + 1);
+    if (cost < best_cost) {
+      best_cost = cost;
+      best_runs_per_tier = k;
+    }
+  }
+  return best_runs_per_tier;
+}
+
+Compaction* UniversalCompactionBuilder::PickLazyLevelingCompaction() {
+  const unsigned int runs_per_tier = GetLazyLevelingRunsPerTier();
+  // The oldest sorted run is not part of any tier
+  if (sorted_runs_.size() < runs_per_tier + 1) {
+    return nullptr;
+  }
+  const size_t num_tiered_runs = sorted_runs_.size() - 1;
+  const double base = static_cast<double>(
+      std::max(mutable_cf_options_.write_buffer_size, size_t{1}));
+  const double log_runs_per_tier = std::log(runs_per_tier);
+  auto tier_of = [&](const SortedRun& sr) {
+    const double units = static_cast<double>(sr.size) / base;
+    if (units <= 1.0) {
+      return 0;
+    }
+    // Rounded, so that merging K runs of a tier gives a run of the next
+    // tier even if a bit smaller than their total
+    return static_cast<int>(std::log(units) / log_runs_per_tier + 0.5);
+  };
+  auto can_pick = [](const SortedRun& sr) {
+    return !sr.being_compacted && !sr.level_has_marked_standalone_rangedel;
+  };
+
+  const size_t max_merge_width = std::max(
+      mutable_cf_options_.compaction_options_universal.max_merge_width, 2U);
+  // Find the newest group of at least runs_per_tier consecutive runs of the
+  // same tier
+  size_t start_index = 0;
+  while (start_index < num_tiered_runs) {
+    if (!can_pick(sorted_runs_[start_index])) {
+      ++start_index;
+      continue;
+    }
+    const int tier = tier_of(sorted_runs_[start_index]);
+    size_t end_index = start_index + 1;
+    while (end_index < num_tiered_runs && can_pick(sorted_runs_[end_index]) &&
+           tier_of(sorted_runs_[end_index]) == tier) {
+      ++end_index;
+    }
+    if (end_index - start_index >= runs_per_tier) {
+      end_index = std::min(end_index, start_index + max_merge_width);
+      ROCKS_LOG_BUFFER(log_buffer_,
+                       "[%s] Universal: lazy leveling merging %" ROCKSDB_PRIszt
+                       " runs of tier %d, with %u runs per tier\n",
+                       cf_name_.c_str(), end_index - start_index, tier,
+                       runs_per_tier);
+      return PickCompactionWithSortedRunRange(
+          start_index, end_index - 1, CompactionReason::kUniversalSizeRatio);
+    }
+    start_index = end_index;
+  }
+  return nullptr;
+}
+
 // Look at overall size amplification. If size amplification
 // exceeds the configured value, then do a compaction
 // on longest span of candidate files without conflict with other compactions
@@ -1551,6 +1678,8 @@ Compaction* UniversalCompactionBuilder::PickCompactionWithSortedRunRange(
     } else if (compaction_reason ==
                CompactionReason::kUniversalSizeAmplification) {
       comp_reason_print_string = "size amp";
+    } else if (compaction_reason == CompactionReason::kUniversalSizeRatio) {
+      comp_reason_print_string = "lazy leveling";
     } else {
       assert(false);
       comp_reason_print_string = "unknown: ";
@@ -1568,6 +1697,9 @@ Compaction* UniversalCompactionBuilder::PickCompactionWithSortedRunRange(
   int output_level;
   if (end_index == sorted_runs_.size() - 1) {
     output_level = max_output_level;
+  } else if (sorted_runs_[end_index + 1].level == 0) {
+    // Only L0 files, followed by an older one
+    output_level = 0;
   } else {
     // if it's not including all sorted_runs, it can only output to the level
     // above the `end_index + 1` sorted_run.
@@ -90,6 +90,16 @@ class SubcompactionState {
     range_del_agg_ = std::move(range_del_agg);
   }
 
+  // Assign the warmer deciding which output data blocks to insert into the
+  // block cache, if any
+  void AssignOutputWarmer(
+      std::unique_ptr<CompactionOutputWarmer>&& output_warmer) {
+    assert(output_warmer_ == nullptr);
+    output_warmer_ = std::move(output_warmer);
+  }
+
+  CompactionOutputWarmer* OutputWarmer() const { return output_warmer_.get(); }
+
   void RemoveLastEmptyOutput() {
     compaction_outputs_.RemoveLastEmptyOutput();
     proximal_level_outputs_.RemoveLastEmptyOutput();
@@ -142,7 +152,8 @@ class SubcompactionState {
         sub_job_id(state.sub_job_id),
         compaction_outputs_(std::move(state.compaction_outputs_)),
         proximal_level_outputs_(std::move(state.proximal_level_outputs_)),
-        range_del_agg_(std::move(state.range_del_agg_)) {
+        range_del_agg_(std::move(state.range_del_agg_)),
+        output_warmer_(std::move(state.output_warmer_)) {
     current_outputs_ = state.current_outputs_ == &state.proximal_level_outputs_
                            ? &proximal_level_outputs_
                            : &compaction_outputs_;
@@ -229,6 +240,7 @@ class SubcompactionState {
   CompactionOutputs proximal_level_outputs_;
   CompactionOutputs* current_outputs_ = &compaction_outputs_;
   std::unique_ptr<CompactionRangeDelAggregator> range_del_agg_;
+  std::unique_ptr<CompactionOutputWarmer> output_warmer_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -466,6 +466,71 @@ TEST_F(DBBlockCacheTest, WarmCacheWithDataBlocksDuringFlush) {
             options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD));
 }
 
+TEST_F(DBBlockCacheTest, WarmCacheWithHotDataBlocksDuringCompaction) {
+  Options options = CurrentOptions();
+  options.create_if_missing = true;
+  options.disable_auto_compactions = true;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  table_options.cache_index_and_filter_blocks = false;
+  table_options.block_size = 4 * 1024;
+  table_options.prepopulate_block_cache =
+      BlockBasedTableOptions::PrepopulateBlockCache::kFlushAndHotCompaction;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // Two overlapping L0 files, so that compacting them is not a trivial move
+  const int kNumKeys = 200;
+  const std::string value(1000, 'a');
+  for (int parity = 0; parity < 2; ++parity) {
+    for (int i = parity; i < kNumKeys; i += 2) {
+      ASSERT_OK(Put(Key(i), value));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_GT(options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD), 0);
+
+  // Start over with an empty block cache, then read the hot range
+  table_options.block_cache = NewLRUCache(1 << 25, 0, false);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+  const int kNumHotKeys = 20;
+  for (int i = 0; i < kNumHotKeys; ++i) {
+    ASSERT_EQ(value, Get(Key(i)));
+  }
+
+  options.statistics->Reset().PermitUncheckedError();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), /*begin=*/nullptr,
+                              /*end=*/nullptr));
+  ASSERT_EQ("0,1", FilesPerLevel());
+  // Only the output blocks covering the hot range are warmed
+  const uint64_t warmed =
+      options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD);
+  ASSERT_GT(warmed, 0);
+  ASSERT_LT(warmed, kNumKeys * value.size() / table_options.block_size / 2);
+
+  options.statistics->Reset().PermitUncheckedError();
+  for (int i = 0; i < kNumHotKeys; ++i) {
+    ASSERT_EQ(value, Get(Key(i)));
+  }
+  ASSERT_EQ(0, options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+  ASSERT_EQ(value, Get(Key(kNumKeys - 1)));
+  ASSERT_EQ(1, options.statistics->getTickerCount(BLOCK_CACHE_DATA_MISS));
+
+  // Nothing is warmed without a budget
+  ASSERT_OK(dbfull()->SetOptions(
+      {{"block_based_table_factory",
+        "{prepopulate_block_cache_compaction_budget=0;}"}}));
+  ASSERT_OK(Put(Key(0), value));
+  ASSERT_OK(Flush());
+  options.statistics->Reset().PermitUncheckedError();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), /*begin=*/nullptr,
+                              /*end=*/nullptr));
+  ASSERT_EQ(0, options.statistics->getTickerCount(BLOCK_CACHE_DATA_ADD));
+}
+
 // This test cache data, index and filter blocks during flush.
 class DBBlockCacheTest1 : public DBTestBase,
                           public ::testing::WithParamInterface<uint32_t> {
@@ -656,6 +721,7 @@ class MockCache : public LRUCache {
  public:
   static uint32_t high_pri_insert_count;
   static uint32_t low_pri_insert_count;
+  static uint32_t bottom_pri_insert_count;
 
   MockCache()
       : LRUCache(LRUCacheOptions(
@@ -670,6 +736,8 @@ class MockCache : public LRUCache {
                 CompressionType type) override {
     if (priority == Priority::LOW) {
       low_pri_insert_count++;
+    } else if (priority == Priority::BOTTOM) {
+      bottom_pri_insert_count++;
     } else {
       high_pri_insert_count++;
     }
@@ -680,6 +748,7 @@ class MockCache : public LRUCache {
 
 uint32_t MockCache::high_pri_insert_count = 0;
 uint32_t MockCache::low_pri_insert_count = 0;
+uint32_t MockCache::bottom_pri_insert_count = 0;
 
 }  // anonymous namespace
 
@@ -740,6 +809,58 @@ TEST_F(DBBlockCacheTest, IndexAndFilterBlocksCachePriority) {
   }
 }
 
+TEST_F(DBBlockCacheTest, ScanDataBlocksCachePriority) {
+  for (uint32_t threshold : {0, 4}) {
+    Options options = CurrentOptions();
+    options.create_if_missing = true;
+    options.compression = kNoCompression;
+    BlockBasedTableOptions table_options;
+    table_options.block_cache.reset(new MockCache());
+    table_options.block_size = 1024;
+    table_options.scan_bottom_priority_threshold = threshold;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+
+    // One key per data block
+    Random rnd(301);
+    const int kNumKeys = 20;
+    for (int i = 0; i < kNumKeys; ++i) {
+      ASSERT_OK(Put(Key(i), rnd.RandomString(2000)));
+    }
+    ASSERT_OK(Flush());
+
+    MockCache::high_pri_insert_count = 0;
+    MockCache::low_pri_insert_count = 0;
+    MockCache::bottom_pri_insert_count = 0;
+
+    // Point lookups insert with low priority
+    ASSERT_EQ(2000U, Get(Key(0)).size());
+    ASSERT_EQ(2000U, Get(Key(10)).size());
+    ASSERT_EQ(2u, MockCache::low_pri_insert_count);
+    ASSERT_EQ(0u, MockCache::bottom_pri_insert_count);
+
+    // A scan inserts with bottom priority once past the threshold, counting
+    // blocks found in cache
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ReadOptions()));
+    int count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+      ++count;
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(kNumKeys, count);
+    if (threshold == 0) {
+      ASSERT_EQ(static_cast<uint32_t>(kNumKeys),
+                MockCache::low_pri_insert_count);
+      ASSERT_EQ(0u, MockCache::bottom_pri_insert_count);
+    } else {
+      // Blocks 2 to 4 of the scan
+      ASSERT_EQ(2u + 3u, MockCache::low_pri_insert_count);
+      ASSERT_EQ(kNumKeys - 5u, MockCache::bottom_pri_insert_count);
+    }
+    ASSERT_EQ(0u, MockCache::high_pri_insert_count);
+  }
+}
+
 namespace {
 
 // An LRUCache wrapper that can falsely report "not found" on Lookup.
@@ -1149,6 +1270,55 @@ TEST_F(DBBlockCacheTest, CacheEntryRoleStats) {
   }
 }
 
+TEST_F(DBBlockCacheTest, CacheEntryStatsPerOwner) {
+  std::shared_ptr<Cache> cache = NewLRUCache(size_t{1} << 25);
+  std::vector<Options> cf_options;
+  for (const char* name : {"owner_a", "owner_b"}) {
+    CacheOwnerOptions owner_opts;
+    owner_opts.name = std::string("CacheEntryStatsPerOwner.") + name;
+    BlockBasedTableOptions table_options;
+    table_options.block_cache = NewCacheOwnerView(cache, owner_opts);
+    table_options.cache_index_and_filter_blocks = true;
+    Options options = CurrentOptions();
+    options.create_if_missing = true;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    cf_options.push_back(options);
+  }
+  DestroyAndReopen(cf_options[0]);
+  CreateColumnFamilies({"b"}, cf_options[1]);
+  ReopenWithColumnFamilies({"default", "b"}, cf_options);
+
+  ASSERT_OK(Put(0, "foo", "value"));
+  ASSERT_OK(Flush(0));
+  ASSERT_OK(Put(1, "bar", "value"));
+  ASSERT_OK(Flush(1));
+  ClearCache(cache.get());
+
+  ASSERT_EQ("value", Get(0, "foo"));
+  ASSERT_EQ("value", Get(0, "foo"));
+  ASSERT_EQ("value", Get(1, "bar"));
+
+  std::map<std::string, std::string> values;
+  ASSERT_TRUE(
+      db_->GetMapProperty(DB::Properties::kBlockCacheEntryStats, &values));
+  for (const char* name : {"owner_a", "owner_b"}) {
+    SCOPED_TRACE(name);
+    const std::string owner = std::string("CacheEntryStatsPerOwner.") + name;
+    ASSERT_GT(
+        std::stoull(values[BlockCacheEntryStatsMapKeys::OwnerUsedBytes(owner)]),
+        0U);
+    ASSERT_GT(
+        std::stoull(values[BlockCacheEntryStatsMapKeys::OwnerMisses(owner)]),
+        0U);
+  }
+  // Only "default" read its blocks twice (a single read can hit blocks it
+  // has just inserted, e.g. the index block)
+  ASSERT_GT(std::stoull(values[BlockCacheEntryStatsMapKeys::OwnerHits(
+                "CacheEntryStatsPerOwner.owner_a")]),
+            std::stoull(values[BlockCacheEntryStatsMapKeys::OwnerHits(
+                "CacheEntryStatsPerOwner.owner_b")]));
+}
+
 namespace {
 
 void DummyFillCache(Cache& cache, size_t entry_size,
@@ -2002,6 +2172,176 @@ INSTANTIATE_TEST_CASE_P(DBBlockCacheKeyTest, DBBlockCacheKeyTest,
                         ::testing::Combine(::testing::Bool(),
                                            ::testing::Bool()));
 
+TEST_F(DBBlockCacheTest, HotPartitionPinning) {
+  const int kKeySize = 32;
+  const int kBlockSize = 128;
+  const int kNumKeys = 4096;
+  const int kNumHotKeys = 8;
+  const int kNumReads = 8192;
+
+  for (size_t budget : {size_t{1}, size_t{64} << 10}) {
+    Options options = CurrentOptions();
+    options.compression = kNoCompression;
+    options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+    BlockBasedTableOptions table_options;
+    table_options.block_cache = NewLRUCache(4 << 20 /* capacity */);
+    table_options.block_size = kBlockSize;
+    table_options.metadata_block_size = kBlockSize;
+    table_options.cache_index_and_filter_blocks = true;
+    table_options.metadata_cache_options.top_level_index_pinning =
+        PinningTier::kNone;
+    table_options.metadata_cache_options.partition_pinning =
+        PinningTier::kNone;
+    table_options.metadata_cache_options.hot_partition_pinning_budget = budget;
+    table_options.filter_policy.reset(
+        NewBloomFilterPolicy(10 /* bits_per_key */));
+    table_options.index_type =
+        BlockBasedTableOptions::IndexType::kTwoLevelIndexSearch;
+    table_options.partition_filters = true;
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+    DestroyAndReopen(options);
+    // The entry of the cache entry stats collector is pinned while the DB is
+    // open
+    const size_t base_pinned = table_options.block_cache->GetPinnedUsage();
+
+    Random rnd(301);
+    for (int i = 0; i < kNumKeys; ++i) {
+      ASSERT_OK(Put(Key(i), rnd.RandomString(kKeySize)));
+    }
+    ASSERT_OK(Flush());
+    CompactRangeOptions cro;
+    cro.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+    ASSERT_OK(db_->CompactRange(cro, nullptr, nullptr));
+    ASSERT_EQ("0,1", FilesPerLevel());
+
+    auto read_range = [&](int first_key) {
+      for (int i = 0; i < kNumReads; ++i) {
+        ASSERT_NE("NOT_FOUND", Get(Key(first_key + i % kNumHotKeys)));
+      }
+    };
+
+    // Number of index and filter misses for reading `key` after dropping all
+    // unpinned blocks from the block cache
+    auto metadata_misses = [&](int key) {
+      table_options.block_cache->EraseUnRefEntries();
+      const uint64_t misses =
+          TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS) +
+          TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS);
+      EXPECT_NE("NOT_FOUND", Get(Key(key)));
+      return TestGetTickerCount(options, BLOCK_CACHE_FILTER_MISS) +
+             TestGetTickerCount(options, BLOCK_CACHE_INDEX_MISS) - misses;
+    };
+
+    read_range(0);
+
+    if (budget == 1) {
+      // Nothing fits in the budget
+      ASSERT_EQ(table_options.block_cache->GetPinnedUsage(), base_pinned);
+      ASSERT_EQ(metadata_misses(0), 4U);
+      continue;
+    }
+
+    // The partitions of the hot keys are pinned, so only the top-level index
+    // and filter blocks miss
+    ASSERT_GT(table_options.block_cache->GetPinnedUsage(), base_pinned);
+    ASSERT_LE(table_options.block_cache->GetPinnedUsage(),
+              base_pinned + budget);
+    ASSERT_EQ(metadata_misses(0), 2U);
+    ASSERT_EQ(metadata_misses(kNumKeys - 1), 4U);
+
+    // Once the workload moves to another key range, its partitions get pinned
+    // and the ones of the previous range are released
+    read_range(kNumKeys - kNumHotKeys);
+    read_range(kNumKeys - kNumHotKeys);
+    ASSERT_LE(table_options.block_cache->GetPinnedUsage(),
+              base_pinned + budget);
+    ASSERT_EQ(metadata_misses(kNumKeys - 1), 2U);
+    ASSERT_EQ(metadata_misses(0), 4U);
+
+    Close();
+    ASSERT_EQ(table_options.block_cache->GetPinnedUsage(), 0U);
+  }
+}
+
+TEST_F(DBBlockCacheTest, MmapZeroCopyDataBlocks) {
+  const int kNumKeys = 500;
+
+  Options options = CurrentOptions();
+  options.allow_mmap_reads = true;
+  options.compression = kNoCompression;
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  table_options.block_cache = NewLRUCache(4 << 20 /* capacity */);
+  table_options.block_size = 256;
+  table_options.mmap_zero_copy_data_blocks = true;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+  // Only the entry of the cache entry stats collector
+  const size_t base_usage = table_options.block_cache->GetUsage();
+
+  std::vector<std::string> keys;
+  std::vector<std::string> values;
+  Random rnd(301);
+  for (int i = 0; i < kNumKeys; ++i) {
+    keys.push_back(Key(i));
+    // Large enough for every data block to be verified only once
+    values.push_back(rnd.RandomString(1100));
+    ASSERT_OK(Put(keys.back(), values.back()));
+  }
+  ASSERT_OK(Flush());
+
+  uint64_t prev_checksums = 0;
+  for (int pass = 0; pass < 2; ++pass) {
+    for (int i = 0; i < kNumKeys; ++i) {
+      ASSERT_EQ(Get(keys[i]), values[i]);
+    }
+    ASSERT_EQ(MultiGet(keys), values);
+
+    ReadOptions ro;
+    ro.fill_cache = false;
+    std::unique_ptr<Iterator> iter(db_->NewIterator(ro));
+    int i = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++i) {
+      ASSERT_EQ(iter->key(), keys[i]);
+      ASSERT_EQ(iter->value(), values[i]);
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(i, kNumKeys);
+    // Not even a placeholder entry is charged for the pinned data block
+    ASSERT_EQ(table_options.block_cache->GetUsage(), base_usage);
+    iter.reset();
+
+    // Checksums are only verified on the first read of each block
+    uint64_t checksums =
+        TestGetTickerCount(options, BLOCK_CHECKSUM_COMPUTE_COUNT);
+    if (pass == 0) {
+      ASSERT_GT(checksums, 0U);
+    } else {
+      ASSERT_EQ(checksums, prev_checksums);
+    }
+    prev_checksums = checksums;
+  }
+
+  // Data blocks bypass the block cache entirely
+  ASSERT_EQ(TestGetTickerCount(options, BLOCK_CACHE_DATA_MISS), 0U);
+  ASSERT_EQ(TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD), 0U);
+  ASSERT_EQ(table_options.block_cache->GetUsage(), base_usage);
+
+  // Compressed files are read through the block cache as usual
+  if (Snappy_Supported()) {
+    options.compression = kSnappyCompression;
+    DestroyAndReopen(options);
+    for (int i = 0; i < kNumKeys; ++i) {
+      ASSERT_OK(Put(keys[i], values[i]));
+    }
+    ASSERT_OK(Flush());
+    for (int i = 0; i < kNumKeys; ++i) {
+      ASSERT_EQ(Get(keys[i]), values[i]);
+    }
+    ASSERT_GT(TestGetTickerCount(options, BLOCK_CACHE_DATA_ADD), 0U);
+  }
+}
+
 class DBBlockCachePinningTest
     : public DBTestBase,
       public testing::WithParamInterface<
@@ -1189,6 +1189,92 @@ TEST_F(DBCompactionTest, CompactionSstPartitionerNonTrivial) {
   ASSERT_EQ("B", Get("bbbb1"));
 }
 
+TEST_F(DBCompactionTest, ShardLevel0BySstPartitioner) {
+  Options options = CurrentOptions();
+  options.compaction_style = kCompactionStyleLevel;
+  options.level0_file_num_compaction_trigger = 2;
+  options.max_background_compactions = 3;
+  options.disable_auto_compactions = true;
+  options.sst_partitioner_factory = NewSstPartitionerFixedPrefixFactory(4);
+  options.shard_level0_by_sst_partitioner = true;
+  options.write_buffer_size = 64 << 10;
+  auto collector = std::make_shared<FlushedFileCollector>();
+  options.listeners.push_back(collector);
+  env_->SetBackgroundThreads(3, Env::LOW);
+  DestroyAndReopen(options);
+
+  const std::vector<std::string> prefixes = {"aaaa", "bbbb", "cccc"};
+  const std::string padding(4 << 10, 'p');
+  // Each flush writes one L0 file per prefix. The files of a prefix overlap,
+  // so they cannot be trivially moved.
+  for (int i = 0; i < 4; i++) {
+    for (const std::string& prefix : prefixes) {
+      ASSERT_OK(Put(prefix + std::to_string(i), "v" + std::to_string(i)));
+      ASSERT_OK(Put(prefix + "p", padding));
+      ASSERT_OK(Put(prefix + "x", "v" + std::to_string(i)));
+    }
+    ASSERT_OK(Flush());
+  }
+  ASSERT_EQ("12", FilesPerLevel());
+  std::vector<LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+  std::set<uint64_t> epoch_numbers;
+  std::set<std::string> l0_files;
+  for (const auto& file : files) {
+    if (file.level == 0) {
+      epoch_numbers.insert(file.epoch_number);
+      l0_files.insert(file.directory + "/" + file.relative_filename);
+    }
+  }
+  ASSERT_EQ(4, epoch_numbers.size());
+  // Every shard file is reported to the listeners.
+  std::vector<std::string> flushed_files = collector->GetFlushedFiles();
+  ASSERT_EQ(l0_files,
+            std::set<std::string>(flushed_files.begin(), flushed_files.end()));
+
+  // The L0 compactions of the three shards run concurrently. Only the first
+  // three compactions wait for each other, later ones (e.g. L1 to L2) do not.
+  std::atomic<int> num_started{0};
+  std::atomic<int> num_running{0};
+  std::atomic<bool> all_shards_running{false};
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::Run():Start", [&](void* /*arg*/) {
+        num_running++;
+        if (num_started.fetch_add(1) >= 3) {
+          return;
+        }
+        for (int i = 0; i < 1000 && num_running.load() < 3; i++) {
+          env_->SleepForMicroseconds(10000);
+        }
+        if (num_running.load() == 3) {
+          all_shards_running = true;
+        }
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::Run():End", [&](void* /*arg*/) { num_running--; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(dbfull()->SetOptions({{"disable_auto_compactions", "false"}}));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_TRUE(all_shards_running);
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  for (const std::string& prefix : prefixes) {
+    for (int i = 0; i < 4; i++) {
+      ASSERT_EQ("v" + std::to_string(i), Get(prefix + std::to_string(i)));
+    }
+    ASSERT_EQ("v3", Get(prefix + "x"));
+  }
+
+  // Shards smaller than write_buffer_size / 16 are merged into the next one.
+  ASSERT_OK(Put("dddd0", "v"));
+  ASSERT_OK(Put("eeee0", "v"));
+  ASSERT_OK(Flush());
+  ASSERT_EQ(1, NumTableFilesAtLevel(0));
+}
+
 TEST_F(DBCompactionTest, ZeroSeqIdCompaction) {
   Options options = CurrentOptions();
   options.compaction_style = kCompactionStyleLevel;
@@ -4359,6 +4445,99 @@ TEST_F(DBCompactionTest, CompactBottomLevelFilesWithDeletions) {
   ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
 }
 
+TEST_F(DBCompactionTest, ReadTriggeredCompaction) {
+  // Point lookups of a key in L2 always read the L1 file first, so the L1
+  // file eventually gets compacted into L2.
+  Options options = CurrentOptions();
+  options.level_compaction_dynamic_level_bytes = false;
+  options.read_triggered_compaction_bytes_per_lookup = 16 << 10;
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Put(Key(i), "val"));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  ASSERT_OK(Put(Key(0), "new_val"));
+  ASSERT_OK(Put(Key(9), "new_val"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  ASSERT_EQ("0,1,1", FilesPerLevel());
+
+  std::atomic_int compaction_count = 0;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "LevelCompactionPicker::PickCompaction:Return", [&](void* arg) {
+        Compaction* compaction = static_cast<Compaction*>(arg);
+        if (compaction != nullptr) {
+          ASSERT_EQ(CompactionReason::kReadTriggered,
+                    compaction->compaction_reason());
+          ASSERT_EQ(1, compaction->start_level());
+          ASSERT_EQ(2, compaction->output_level());
+          compaction_count++;
+        }
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+
+  // Reads are sampled once every kFileReadSampleRate on average, and the L1
+  // file is compacted after about 100 sampled reads
+  int num_charged = 0;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "Version::ChargeWastedRead", [&](void* /*arg*/) { ++num_charged; });
+  int num_reads = 0;
+  for (; num_reads < 200 * 1024 && NumTableFilesAtLevel(1) > 0; ++num_reads) {
+    ASSERT_EQ("val", Get(Key(5)));
+  }
+  ASSERT_GE(num_charged, 100);
+  ASSERT_GE(num_reads, 50 * 1024);
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ(1, compaction_count);
+  ASSERT_EQ("0,0,1", FilesPerLevel());
+  ASSERT_EQ("new_val", Get(Key(0)));
+  ASSERT_EQ("val", Get(Key(5)));
+  ASSERT_EQ("new_val", Get(Key(9)));
+}
+
+TEST_F(DBCompactionTest, ReadTriggeredCompactionSkipsFilteredFiles) {
+  // The bloom filter of the L1 file rules out the key, so lookups of a key
+  // in L2 do not charge it
+  Options options = CurrentOptions();
+  options.level_compaction_dynamic_level_bytes = false;
+  options.read_triggered_compaction_bytes_per_lookup = 16 << 10;
+  BlockBasedTableOptions table_options;
+  table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  options.statistics = CreateDBStatistics();
+  DestroyAndReopen(options);
+
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_OK(Put(Key(i), "val"));
+  }
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  ASSERT_OK(Put(Key(0), "new_val"));
+  ASSERT_OK(Put(Key(9), "new_val"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  ASSERT_EQ("0,1,1", FilesPerLevel());
+
+  int num_charged = 0;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "Version::ChargeWastedRead", [&](void* /*arg*/) { ++num_charged; });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+  for (int i = 0; i < 20 * 1024; ++i) {
+    ASSERT_EQ("val", Get(Key(5)));
+  }
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ(20 * 1024, TestGetTickerCount(options, BLOOM_FILTER_USEFUL));
+  ASSERT_EQ(0, num_charged);
+  ASSERT_EQ("0,1,1", FilesPerLevel());
+}
+
 TEST_F(DBCompactionTest, DelayCompactBottomLevelFilesWithDeletions) {
   // bottom-level files may contain deletions due to snapshots protecting the
   // deleted keys. Once the snapshot is released and the files are old enough,
@@ -6054,6 +6233,68 @@ TEST_F(DBCompactionTest, SubcompactionEvent) {
   listener->ResetExpectedNumL0Files();
 }
 
+TEST_F(DBCompactionTest, SubcompactionWorkStealing) {
+  Options options = CurrentOptions();
+  options.disable_auto_compactions = true;
+  options.max_subcompactions = 2;
+  options.subcompaction_ranges_per_thread = 4;
+  options.target_file_size_base = 16 << 10;
+  BlockBasedTableOptions table_options;
+  table_options.num_sampled_key_anchors = 64;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  DestroyAndReopen(options);
+
+  // Most of the data is in the lower keys of one large file
+  Random rnd(301);
+  std::map<std::string, std::string> expected;
+  for (int i = 0; i < 400; i++) {
+    expected[Key(i)] = rnd.RandomString(i < 300 ? 1000 : 10);
+    ASSERT_OK(Put(Key(i), expected[Key(i)]));
+  }
+  ASSERT_OK(Flush());
+  for (int f = 1; f <= 3; f++) {
+    for (int i = f; i < 400; i += 7) {
+      expected[Key(i)] = "value" + std::to_string(f);
+      ASSERT_OK(Put(Key(i), expected[Key(i)]));
+    }
+    ASSERT_OK(Flush());
+  }
+
+  TablePropertiesCollection props;
+  ASSERT_OK(db_->GetPropertiesOfAllTables(&props));
+  ASSERT_EQ(4, props.size());
+  for (const auto& item : props) {
+    ASSERT_EQ(1, item.second->user_collected_properties.count(
+                     BlockBasedTablePropertyNames::kKeyAnchors));
+  }
+
+  uint64_t num_subcompactions = 0;
+  std::atomic<int> num_stolen{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::GenSubcompactionBoundaries:1", [&](void* arg) {
+        num_subcompactions = *static_cast<uint64_t*>(arg);
+      });
+  SyncPoint::GetInstance()->SetCallBack(
+      "CompactionJob::ProcessKeyValueCompactions:Steal",
+      [&](void* /*arg*/) { num_stolen.fetch_add(1); });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  // More ranges than the two threads, and the threads took all the ranges
+  // beyond their first
+  ASSERT_GT(num_subcompactions, 2);
+  ASSERT_LE(num_subcompactions, 8);
+  ASSERT_EQ(num_subcompactions - 2, num_stolen.load());
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+
+  for (const auto& kv : expected) {
+    ASSERT_EQ(kv.second, Get(kv.first));
+  }
+}
+
 TEST_F(DBCompactionTest, CompactFilesOutputRangeConflict) {
   // LSM setup:
   // L1:      [ba bz]
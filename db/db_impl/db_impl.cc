@@ -53,6 +53,7 @@
 #include "db/table_cache.h"
 #include "db/table_properties_collector.h"
 #include "db/transaction_log_impl.h"
+#include "db/user_key_row_cache.h"
 #include "db/version_set.h"
 #include "db/write_batch_internal.h"
 #include "db/write_callback.h"
@@ -261,6 +262,13 @@ DBImpl::DBImpl(const DBOptions& options, const std::string& dbname,
       &error_handler_, read_only));
   column_family_memtables_.reset(
       new ColumnFamilyMemTablesImpl(versions_->GetColumnFamilySet()));
+  // Not for instances whose data changes other than through their own writes,
+  // or with writes visible other than through sequence numbers
+  if (immutable_db_options_.user_key_row_cache && !read_only &&
+      !seq_per_batch) {
+    user_key_row_cache_.reset(
+        new UserKeyRowCache(immutable_db_options_.user_key_row_cache));
+  }
 
   DumpRocksDBBuildVersion(immutable_db_options_.info_log.get());
   DumpDBFileSummary(immutable_db_options_, dbname_, db_session_id_);
@@ -2358,6 +2366,34 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
     }
   }
 
+  // A hit in the user key row cache skips the memtables and SST files
+  UserKeyRowCache* row_cache = nullptr;
+  UserKeyRowCache::Key row_cache_key;
+  if (user_key_row_cache_ != nullptr &&
+      CanUseUserKeyRowCache(read_options, get_impl_options, cfd)) {
+    row_cache = user_key_row_cache_.get();
+    row_cache->MakeKey(cfd->GetID(), key, &row_cache_key);
+    const SequenceNumber snapshot =
+        read_options.snapshot != nullptr
+            ? static_cast<const SnapshotImpl*>(read_options.snapshot)->number_
+            : GetLastPublishedSequence();
+    Status s;
+    if (row_cache->Lookup(row_cache_key, snapshot, get_impl_options.value,
+                          &s)) {
+      RecordTick(stats_, USER_KEY_ROW_CACHE_HIT);
+      RecordTick(stats_, NUMBER_KEYS_READ);
+      size_t size = 0;
+      if (s.ok()) {
+        size = get_impl_options.value->size();
+        RecordTick(stats_, BYTES_READ, size);
+        PERF_COUNTER_ADD(get_read_bytes, size);
+      }
+      RecordInHistogram(stats_, BYTES_PER_READ, size);
+      return s;
+    }
+    RecordTick(stats_, USER_KEY_ROW_CACHE_MISS);
+  }
+
   if (get_impl_options.get_merge_operands_options != nullptr) {
     for (int i = 0; i < get_impl_options.get_merge_operands_options
                             ->expected_max_number_of_operands;
@@ -2523,6 +2559,9 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
         get_impl_options.get_value ? get_impl_options.is_blob_index : nullptr,
         get_impl_options.get_value);
     RecordTick(stats_, MEMTABLE_MISS);
+    if (sv->current->TakeReadCompactionRequest()) {
+      ScheduleReadTriggeredCompaction(cfd);
+    }
   }
 
   {
@@ -2614,6 +2653,12 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
       PERF_COUNTER_ADD(get_read_bytes, size);
     }
 
+    if (row_cache != nullptr && read_options.fill_cache &&
+        (s.ok() || s.IsNotFound())) {
+      const Slice value = *get_impl_options.value;
+      row_cache->Insert(row_cache_key, snapshot, s.ok() ? &value : nullptr);
+    }
+
     ReturnAndCleanupSuperVersion(cfd, sv);
 
     RecordInHistogram(stats_, BYTES_PER_READ, size);
@@ -2621,6 +2666,26 @@ Status DBImpl::GetImpl(const ReadOptions& read_options, const Slice& key,
   return s;
 }
 
+bool DBImpl::CanUseUserKeyRowCache(const ReadOptions& read_options,
+                                   const GetImplOptions& get_impl_options,
+                                   ColumnFamilyData* cfd) const {
+  // Only plain Get() of values, which see the latest data at some sequence
+  // number. Data changed by compaction filters and FIFO compaction is not
+  // tracked.
+  const ImmutableCFOptions& ioptions = cfd->ioptions();
+  return get_impl_options.get_value && get_impl_options.value != nullptr &&
+         get_impl_options.columns == nullptr &&
+         get_impl_options.callback == nullptr &&
+         get_impl_options.is_blob_index == nullptr &&
+         read_options.read_tier == kReadAllTier &&
+         !read_options.ignore_range_deletions &&
+         !read_options.merge_operand_count_threshold.has_value() &&
+         cfd->user_comparator()->timestamp_size() == 0 &&
+         ioptions.compaction_filter == nullptr &&
+         ioptions.compaction_filter_factory == nullptr &&
+         ioptions.compaction_style != kCompactionStyleFIFO;
+}
+
 template <class T, typename IterDerefFuncType>
 Status DBImpl::MultiCFSnapshot(const ReadOptions& read_options,
                                ReadCallback* callback,
@@ -4983,6 +5048,9 @@ Status DBImpl::DeleteFilesInRanges(ColumnFamilyHandle* column_family,
     if (status.ok()) {
       InstallSuperVersionAndScheduleWork(
           cfd, job_context.superversion_contexts.data());
+      if (user_key_row_cache_) {
+        user_key_row_cache_->InvalidateAll();
+      }
     }
     for (auto* deleted_file : deleted_files) {
       deleted_file->being_compacted = false;
@@ -6105,6 +6173,9 @@ Status DBImpl::IngestExternalFiles(
         }
 #endif  // !NDEBUG
       }
+      if (user_key_row_cache_) {
+        user_key_row_cache_->InvalidateAll();
+      }
     } else if (versions_->io_status().IsIOError()) {
       // Error while writing to MANIFEST.
       // In fact, versions_->io_status() can also be the result of renaming
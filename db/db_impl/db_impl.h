@@ -79,6 +79,7 @@ class MemTable;
 class PersistentStatsHistoryIterator;
 class TableCache;
 class TaskLimiterToken;
+class UserKeyRowCache;
 class Version;
 class VersionEdit;
 class VersionSet;
@@ -709,6 +710,11 @@ class DBImpl : public DB {
   virtual Status GetImpl(const ReadOptions& options, const Slice& key,
                          GetImplOptions& get_impl_options);
 
+  // Whether a GetImpl() can be answered by and fill the user key row cache
+  bool CanUseUserKeyRowCache(const ReadOptions& read_options,
+                             const GetImplOptions& get_impl_options,
+                             ColumnFamilyData* cfd) const;
+
   // If `snapshot` == kMaxSequenceNumber, set a recent one inside the file.
   ArenaWrappedDBIter* NewIteratorImpl(const ReadOptions& options,
                                       ColumnFamilyHandleImpl* cfh,
@@ -927,6 +933,11 @@ class DBImpl : public DB {
     return immutable_db_options_;
   }
 
+  // nullptr unless DBOptions::user_key_row_cache is set
+  UserKeyRowCache* user_key_row_cache() const {
+    return user_key_row_cache_.get();
+  }
+
   // Cancel all background jobs, including flush, compaction, background
   // purging, stats dumping threads, etc. If `wait` = true, wait for the
   // running jobs to abort or finish before returning. Otherwise, only
@@ -1417,6 +1428,9 @@ class DBImpl : public DB {
 
   std::unique_ptr<ColumnFamilyMemTablesImpl> column_family_memtables_;
 
+  // See DBOptions::user_key_row_cache
+  std::unique_ptr<UserKeyRowCache> user_key_row_cache_;
+
   // Increase the sequence number after writing each batch, whether memtable is
   // disabled for that or not. Otherwise the sequence number is increased after
   // writing each key into memtable. This implies that when disable_memtable is
@@ -2440,6 +2454,10 @@ class DBImpl : public DB {
   bool EnqueuePendingFlush(const FlushRequest& req);
 
   void EnqueuePendingCompaction(ColumnFamilyData* cfd);
+  // Marks the files of `cfd` that point lookups read in vain too often and
+  // schedules their compaction. Called when a Get() requests it.
+  // REQUIRES: mutex unlocked
+  void ScheduleReadTriggeredCompaction(ColumnFamilyData* cfd);
   void SchedulePendingPurge(std::string fname, std::string dir_to_sync,
                             FileType type, uint64_t number, int job_id);
   static void BGWorkCompaction(void* arg);
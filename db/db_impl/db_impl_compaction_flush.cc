@@ -373,6 +373,12 @@ Status DBImpl::FlushMemTableToOutputFile(
       // exists. Otherwise, some tests may fail.  Ignore the error in the
       // interim.
       sfm->OnAddFile(file_path).PermitUncheckedError();
+      for (const FileMetaData& shard_meta : flush_job.GetShardFileMetas()) {
+        sfm->OnAddFile(TableFileName(cfd->ioptions().cf_paths,
+                                     shard_meta.fd.GetNumber(),
+                                     shard_meta.fd.GetPathId()))
+            .PermitUncheckedError();
+      }
       if (sfm->IsMaxAllowedSpaceReached()) {
         Status new_bg_error =
             Status::SpaceLimit("Max allowed space was reached");
@@ -836,6 +842,12 @@ Status DBImpl::AtomicFlushMemTablesToOutputFiles(
         // exists. Otherwise, some tests may fail.  Ignore the error in the
         // interim.
         sfm->OnAddFile(file_path).PermitUncheckedError();
+        for (const FileMetaData& shard_meta : jobs[i]->GetShardFileMetas()) {
+          sfm->OnAddFile(TableFileName(cfds[i]->ioptions().cf_paths,
+                                       shard_meta.fd.GetNumber(),
+                                       shard_meta.fd.GetPathId()))
+              .PermitUncheckedError();
+        }
         if (sfm->IsMaxAllowedSpaceReached() &&
             error_handler_.GetBGError().ok()) {
           Status new_bg_error =
@@ -3069,6 +3081,22 @@ void DBImpl::EnqueuePendingCompaction(ColumnFamilyData* cfd) {
   }
 }
 
+void DBImpl::ScheduleReadTriggeredCompaction(ColumnFamilyData* cfd) {
+  InstrumentedMutexLock l(&mutex_);
+  if (cfd->IsDropped()) {
+    return;
+  }
+  VersionStorageInfo* vstorage = cfd->current()->storage_info();
+  vstorage->ComputeFilesMarkedForReadCompaction(
+      cfd->GetLatestMutableCFOptions()
+          .read_triggered_compaction_bytes_per_lookup,
+      vstorage->MaxOutputLevel(cfd->ioptions().allow_ingest_behind));
+  if (!vstorage->FilesMarkedForReadCompaction().empty()) {
+    EnqueuePendingCompaction(cfd);
+    MaybeScheduleFlushOrCompaction();
+  }
+}
+
 void DBImpl::SchedulePendingPurge(std::string fname, std::string dir_to_sync,
                                   FileType type, uint64_t number, int job_id) {
   mutex_.AssertHeld();
@@ -3881,17 +3909,21 @@ Status DBImpl::BackgroundCompaction(bool* made_progress,
     ThreadStatusUtil::ResetThreadStatus();
     TEST_SYNC_POINT_CALLBACK("DBImpl::BackgroundCompaction:AfterCompaction",
                              c->column_family_data());
-  } else if (!is_prepicked && c->output_level() > 0 &&
-             c->output_level() ==
-                 c->column_family_data()
-                     ->current()
-                     ->storage_info()
-                     ->MaxOutputLevel(
-                         immutable_db_options_.allow_ingest_behind) &&
+  } else if (!is_prepicked &&
+             ((c->output_level() > 0 &&
+               c->output_level() ==
+                   c->column_family_data()
+                       ->current()
+                       ->storage_info()
+                       ->MaxOutputLevel(
+                           immutable_db_options_.allow_ingest_behind)) ||
+              c->compaction_reason() ==
+                  CompactionReason::kBlobGarbageCollection) &&
              env_->GetBackgroundThreads(Env::Priority::BOTTOM) > 0) {
     // Forward compactions involving last level to the bottom pool if it exists,
     // such that compactions unlikely to contribute to write stalls can be
-    // delayed or deprioritized.
+    // delayed or deprioritized. Blob garbage collection jobs never contribute
+    // to write stalls either.
     TEST_SYNC_POINT("DBImpl::BackgroundCompaction:ForwardToBottomPriPool");
     CompactionArg* ca = new CompactionArg;
     ca->db = this;
@@ -11,6 +11,7 @@
 #include "db/db_impl/db_impl.h"
 #include "db/error_handler.h"
 #include "db/event_helpers.h"
+#include "db/user_key_row_cache.h"
 #include "logging/logging.h"
 #include "memtable/wbwi_memtable.h"
 #include "monitoring/perf_context_imp.h"
@@ -226,6 +227,10 @@ Status DBImpl::IngestWBWIAsMemtable(
   assert(assigned_seqno.upper_bound <= last_seqno_after_ingest);
   // Keys in the current memtable have seqno <= LastSequence() < keys in wbwi.
   assert(assigned_seqno.lower_bound > versions_->LastSequence());
+  if (user_key_row_cache_) {
+    // Not yet published, so recorded like any write
+    user_key_row_cache_->RecordWriteToAllKeys(assigned_seqno.upper_bound);
+  }
   autovector<ReadOnlyMemTable*> memtables;
   autovector<ColumnFamilyData*> cfds;
   InstrumentedMutexLock lock(&mutex_);
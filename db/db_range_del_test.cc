@@ -3149,6 +3149,71 @@ TEST_F(DBRangeDelTest, RangetombesoneCompensateFilesizePersistDuringReopen) {
   ASSERT_EQ(level_to_files[1][0].compensated_range_deletion_size, l2_size);
 }
 
+TEST_F(DBRangeDelTest, RangeDeletionCompactionToLastLevel) {
+  Options opts = CurrentOptions();
+  opts.disable_auto_compactions = true;
+  opts.level_compaction_dynamic_level_bytes = false;
+  DestroyAndReopen(opts);
+
+  Random rnd(301);
+  // file in L3
+  ASSERT_OK(Put("a", rnd.RandomString(1 << 10)));
+  ASSERT_OK(Put("b", rnd.RandomString(1 << 10)));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(3);
+  // file in L2
+  ASSERT_OK(Put("c", rnd.RandomString(1 << 10)));
+  ASSERT_OK(Put("d", rnd.RandomString(1 << 10)));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(2);
+  // standalone range tombstone file in L1
+  ASSERT_OK(
+      db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "a", "z"));
+  ASSERT_OK(Flush());
+  MoveFilesToLevel(1);
+  ASSERT_EQ("0,1,1,1", FilesPerLevel());
+
+  std::vector<CompactionReason> reasons;
+  SyncPoint::GetInstance()->SetCallBack(
+      "LevelCompactionPicker::PickCompaction:Return", [&](void* arg) {
+        auto* c = static_cast<Compaction*>(arg);
+        if (c != nullptr) {
+          reasons.push_back(c->compaction_reason());
+          ASSERT_EQ(1, c->start_level());
+          ASSERT_EQ(3, c->output_level());
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Nothing to compact by size
+  ASSERT_OK(dbfull()->SetOptions({{"disable_auto_compactions", "false"}}));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  ASSERT_EQ("0,1,1,1", FilesPerLevel());
+  ASSERT_TRUE(reasons.empty());
+
+  ASSERT_OK(
+      dbfull()->SetOptions({{"range_deletion_compaction_ratio", "1.0"}}));
+  ASSERT_OK(dbfull()->TEST_WaitForCompact());
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ(1, reasons.size());
+  ASSERT_EQ(CompactionReason::kRangeDeletions, reasons[0]);
+  // The covered files are dropped without being read, and the tombstone is
+  // dropped in the last level.
+  ASSERT_EQ("", FilesPerLevel());
+  const auto& comp_stats = static_cast<ColumnFamilyHandleImpl*>(
+                               dbfull()->DefaultColumnFamily())
+                               ->cfd()
+                               ->internal_stats()
+                               ->TEST_GetCompactionStats();
+  ASSERT_EQ(1, comp_stats[3].num_filtered_input_files_in_non_output_levels);
+  ASSERT_EQ(1, comp_stats[3].num_filtered_input_files_in_output_level);
+  for (const char* key : {"a", "b", "c", "d"}) {
+    ASSERT_EQ("NOT_FOUND", Get(key));
+  }
+}
+
 TEST_F(DBRangeDelTest, SingleKeyFile) {
   // Test for a bug fix where a range tombstone could be added
   // to an SST file while is not within the file's key range.
@@ -52,6 +52,7 @@
 #include "rocksdb/slice.h"
 #include "rocksdb/slice_transform.h"
 #include "rocksdb/snapshot.h"
+#include "rocksdb/sst_file_writer.h"
 #include "rocksdb/table.h"
 #include "rocksdb/table_properties.h"
 #include "rocksdb/thread_status.h"
@@ -7349,6 +7350,86 @@ TEST_F(DBTest, PinnableSliceAndRowCache) {
             1);
 }
 
+TEST_F(DBTest, UserKeyRowCache) {
+  Options options = CurrentOptions();
+  options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
+  options.user_key_row_cache = NewLRUCache(1 << 20);
+  DestroyAndReopen(options);
+
+  ASSERT_OK(Put("foo", "bar"));
+  ASSERT_OK(Put("baz", "qux"));
+  ASSERT_OK(Flush());
+
+  ASSERT_EQ(Get("foo"), "bar");
+  ASSERT_EQ(TestGetTickerCount(options, USER_KEY_ROW_CACHE_HIT), 0);
+  ASSERT_EQ(TestGetTickerCount(options, USER_KEY_ROW_CACHE_MISS), 1);
+  ASSERT_EQ(Get("foo"), "bar");
+  ASSERT_EQ(TestGetTickerCount(options, USER_KEY_ROW_CACHE_HIT), 1);
+
+  // Survives compaction, unlike the row cache
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(Get("foo"), "bar");
+  ASSERT_EQ(TestGetTickerCount(options, USER_KEY_ROW_CACHE_HIT), 2);
+
+  // Misses are cached too
+  ASSERT_EQ(Get("missing"), "NOT_FOUND");
+  ASSERT_EQ(Get("missing"), "NOT_FOUND");
+  ASSERT_EQ(TestGetTickerCount(options, USER_KEY_ROW_CACHE_HIT), 3);
+
+  // Writes invalidate, while older snapshots still read the older value
+  const Snapshot* snapshot = db_->GetSnapshot();
+  ASSERT_OK(Put("foo", "bar2"));
+  ASSERT_OK(Put("missing", "found"));
+  ASSERT_EQ(Get("foo"), "bar2");
+  ASSERT_EQ(Get("missing"), "found");
+  ASSERT_EQ(Get("foo", snapshot), "bar");
+  ASSERT_EQ(Get("missing", snapshot), "NOT_FOUND");
+  db_->ReleaseSnapshot(snapshot);
+  ASSERT_EQ(Get("foo"), "bar2");
+
+  ASSERT_OK(Delete("foo"));
+  ASSERT_EQ(Get("foo"), "NOT_FOUND");
+
+  // Range deletions invalidate all keys
+  ASSERT_EQ(Get("baz"), "qux");
+  ASSERT_EQ(Get("baz"), "qux");
+  ASSERT_OK(db_->DeleteRange(WriteOptions(), db_->DefaultColumnFamily(), "a",
+                             "z"));
+  ASSERT_EQ(Get("baz"), "NOT_FOUND");
+  ASSERT_EQ(Get("missing"), "NOT_FOUND");
+
+  // So does file ingestion
+  std::string sst_file = dbname_ + "/user_key_row_cache_ingest.sst";
+  {
+    SstFileWriter writer(EnvOptions(), options);
+    ASSERT_OK(writer.Open(sst_file));
+    ASSERT_OK(writer.Put("baz", "ingested"));
+    ASSERT_OK(writer.Finish());
+  }
+  ASSERT_OK(db_->IngestExternalFile({sst_file}, IngestExternalFileOptions()));
+  ASSERT_EQ(Get("baz"), "ingested");
+
+  // Reads that cannot use the cache bypass it
+  const uint64_t hits = TestGetTickerCount(options, USER_KEY_ROW_CACHE_HIT);
+  const uint64_t misses = TestGetTickerCount(options, USER_KEY_ROW_CACHE_MISS);
+  ReadOptions read_options;
+  read_options.read_tier = kBlockCacheTier;
+  std::string value;
+  ASSERT_OK(db_->Get(read_options, "baz", &value));
+  ASSERT_EQ(TestGetTickerCount(options, USER_KEY_ROW_CACHE_HIT), hits);
+  ASSERT_EQ(TestGetTickerCount(options, USER_KEY_ROW_CACHE_MISS), misses);
+}
+
+TEST_F(DBTest, UserKeyRowCacheIncompatibleOptions) {
+  Options options = CurrentOptions();
+  options.user_key_row_cache = NewLRUCache(1 << 20);
+  options.unordered_write = true;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+  options.unordered_write = false;
+  options.two_write_queues = true;
+  ASSERT_TRUE(TryReopen(options).IsInvalidArgument());
+}
+
 TEST_F(DBTest, ReusePinnableSlice) {
   Options options = CurrentOptions();
   options.statistics = ROCKSDB_NAMESPACE::CreateDBStatistics();
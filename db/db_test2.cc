@@ -12,6 +12,7 @@
 #include <functional>
 #include <iostream>
 #include <memory>
+#include <set>
 
 #include "db/db_test_util.h"
 #include "db/read_callback.h"
@@ -27,6 +28,7 @@
 #include "rocksdb/trace_record_result.h"
 #include "rocksdb/utilities/replayer.h"
 #include "rocksdb/wal_filter.h"
+#include "table/block_based/shared_compression_dict.h"
 #include "test_util/testutil.h"
 #include "util/defer.h"
 #include "util/random.h"
@@ -1404,6 +1406,108 @@ TEST_F(DBTest2, PresetCompressionDictLocality) {
   }
 }
 
+TEST_F(DBTest2, PresetCompressionDictReuse) {
+  if (!ZSTD_Supported()) {
+    return;
+  }
+  // Verifies that a dictionary trained for one output file is reused by the
+  // next `max_dict_reuse_files` files of the same level, and that table
+  // readers of those files share a single copy of it.
+  const int kNumEntriesPerFile = 1 << 10;  // 1KB
+  const int kNumBytesPerEntry = 1 << 10;   // 1KB
+  const int kNumFiles = 6;
+  const uint32_t kMaxDictReuseFiles = 2;
+  Options options = CurrentOptions();
+  options.compression = kZSTD;
+  options.compression_opts.max_dict_bytes = 1 << 14;        // 16KB
+  options.compression_opts.zstd_max_train_bytes = 1 << 18;  // 256KB
+  options.compression_opts.max_dict_reuse_files = kMaxDictReuseFiles;
+  options.target_file_size_base = kNumEntriesPerFile * kNumBytesPerEntry;
+  BlockBasedTableOptions table_options;
+  table_options.cache_index_and_filter_blocks = false;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  // Another DB using the same table factory publishes a dictionary for its
+  // flushes, which the flushes of this DB must not reuse
+  Random rnd(301);
+  const std::string other_dbname = dbname_ + "_other";
+  {
+    Options other_options = options;
+    other_options.create_if_missing = true;
+    std::unique_ptr<DB> other_db;
+    ASSERT_OK(DB::Open(other_options, other_dbname, &other_db));
+    for (int j = 0; j < kNumEntriesPerFile; ++j) {
+      ASSERT_OK(other_db->Put(WriteOptions(), Key(j),
+                              rnd.RandomString(kNumBytesPerEntry)));
+    }
+    ASSERT_OK(other_db->Flush(FlushOptions()));
+    ASSERT_OK(other_db->Close());
+  }
+  ASSERT_OK(DestroyDB(other_dbname, options));
+
+  int num_reused = 0;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTableBuilder::Rep:ReuseCompressionDict",
+      [&](void* /*arg*/) { ++num_reused; });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+  for (int i = 0; i < kNumFiles; ++i) {
+    for (int j = 0; j < kNumEntriesPerFile; ++j) {
+      ASSERT_OK(Put(Key(i * kNumEntriesPerFile + j),
+                    rnd.RandomString(kNumBytesPerEntry)));
+    }
+    ASSERT_OK(Flush());
+    if (i == 0) {
+      ASSERT_EQ(0, num_reused);
+    }
+    MoveFilesToLevel(1);
+    ASSERT_EQ(NumTableFilesAtLevel(1), i + 1);
+  }
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  std::vector<std::string> compression_dicts;
+  num_reused = 0;
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTableBuilder::WriteCompressionDictBlock:RawDict",
+      [&](void* arg) {
+        compression_dicts.emplace_back(static_cast<Slice*>(arg)->ToString());
+      });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTableBuilder::Rep:ReuseCompressionDict",
+      [&](void* /*arg*/) { ++num_reused; });
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->EnableProcessing();
+  CompactRangeOptions compact_range_opts;
+  compact_range_opts.bottommost_level_compaction =
+      BottommostLevelCompaction::kForceOptimized;
+  ASSERT_OK(db_->CompactRange(compact_range_opts, nullptr, nullptr));
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->DisableProcessing();
+  ROCKSDB_NAMESPACE::SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  const int num_files = NumTableFilesAtLevel(1);
+  ASSERT_GT(num_files, 1);
+  ASSERT_EQ(num_files, static_cast<int>(compression_dicts.size()));
+
+  // Every file trains a fresh dictionary only once the previous one has been
+  // reused by `kMaxDictReuseFiles` files.
+  std::set<std::string> distinct_dicts;
+  for (int i = 0; i < num_files; ++i) {
+    const int trained_by = i - i % (kMaxDictReuseFiles + 1);
+    ASSERT_EQ(compression_dicts[trained_by], compression_dicts[i]);
+    distinct_dicts.insert(compression_dicts[i]);
+  }
+  ASSERT_EQ(num_files - static_cast<int>(distinct_dicts.size()), num_reused);
+  ASSERT_GT(num_reused, 0);
+
+  // Readers of files sharing a dictionary share its in-memory copy.
+  Reopen(options);
+  for (int i = 0; i < kNumFiles * kNumEntriesPerFile; ++i) {
+    ASSERT_NE("NOT_FOUND", Get(Key(i)));
+  }
+  ASSERT_EQ(distinct_dicts.size(),
+            SharedUncompressionDicts::Instance()->TEST_Size());
+}
+
 class PresetCompressionDictTest
     : public DBTestBase,
       public testing::WithParamInterface<std::tuple<CompressionType, bool>> {
@@ -1885,6 +1989,84 @@ TEST_F(DBTest2, CompressionOptions) {
   }
 }
 
+TEST_F(DBTest2, SharedParallelCompressionPool) {
+  CompressionType compression = kNoCompression;
+  if (ZSTD_Supported()) {
+    compression = kZSTD;
+  } else if (Zlib_Supported()) {
+    compression = kZlibCompression;
+  } else if (LZ4_Supported()) {
+    compression = kLZ4HCCompression;
+  }
+
+  Options options = CurrentOptions();
+  options.compression = compression;
+  options.compression_opts.parallel_threads = 4;
+  options.compression_opts.use_shared_parallel_pool = true;
+  options.compression_opts.adaptive_parallel_level = true;
+  options.max_background_flushes = 2;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 256;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+  // Alternate between the configured and the fastest level regardless of the
+  // actual backlog, so that both are exercised in the same file.
+  std::atomic<int> num_blocks{0};
+  std::atomic<int> num_fast_blocks{0};
+  SyncPoint::GetInstance()->SetCallBack(
+      "BlockBasedTableBuilder::BGWorkSharedCompression:UseFastLevel",
+      [&](void* arg) {
+        bool* use_fast_level = static_cast<bool*>(arg);
+        *use_fast_level = (num_blocks.fetch_add(1) % 2) == 0;
+        if (*use_fast_level) {
+          num_fast_blocks.fetch_add(1);
+        }
+      });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  CreateAndReopenWithCF({"pikachu"}, options);
+
+  Random rnd(301);
+  std::map<std::string, std::string> expected[2];
+  for (int i = 0; i < 2000; i++) {
+    for (int cf = 0; cf < 2; cf++) {
+      std::string key = Key(i);
+      std::string value = rnd.RandomString(20) + std::string(40, 'x');
+      ASSERT_OK(Put(cf, key, value));
+      expected[cf][key] = value;
+    }
+  }
+  // Both column families are flushed at the same time, so their builders
+  // share the pool.
+  ASSERT_OK(dbfull()->Flush(FlushOptions(), handles_));
+  for (int cf = 0; cf < 2; cf++) {
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), handles_[cf], nullptr,
+                                nullptr));
+  }
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  if (compression != kNoCompression) {
+    ASSERT_GT(num_fast_blocks.load(), 0);
+    ASSERT_LT(num_fast_blocks.load(), num_blocks.load());
+  }
+
+  ReopenWithColumnFamilies({"default", "pikachu"}, options);
+  for (int cf = 0; cf < 2; cf++) {
+    std::unique_ptr<Iterator> iter(
+        db_->NewIterator(ReadOptions(), handles_[cf]));
+    auto it = expected[cf].begin();
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next(), ++it) {
+      ASSERT_NE(it, expected[cf].end());
+      ASSERT_EQ(iter->key(), it->first);
+      ASSERT_EQ(iter->value(), it->second);
+    }
+    ASSERT_OK(iter->status());
+    ASSERT_EQ(it, expected[cf].end());
+  }
+}
+
 class CompactionStallTestListener : public EventListener {
  public:
   CompactionStallTestListener()
@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "db/builder.h"
+#include "db/compaction/clipping_iterator.h"
 #include "db/db_iter.h"
 #include "db/dbformat.h"
 #include "db/event_helpers.h"
@@ -36,6 +37,7 @@
 #include "port/port.h"
 #include "rocksdb/db.h"
 #include "rocksdb/env.h"
+#include "rocksdb/sst_partitioner.h"
 #include "rocksdb/statistics.h"
 #include "rocksdb/status.h"
 #include "rocksdb/table.h"
@@ -639,7 +641,7 @@ Status FlushJob::MemPurge() {
         // Piggyback FlushJobInfo on the first flushed memtable.
         db_mutex_->AssertHeld();
         meta_.fd.file_size = 0;
-        mems_[0]->SetFlushJobInfo(GetFlushJobInfo());
+        mems_[0]->SetFlushJobsInfo(GetFlushJobsInfo());
         db_mutex_->Unlock();
       } else {
         s = Status::Aborted(Slice("Mempurge filled more than one memtable."));
@@ -850,6 +852,43 @@ bool FlushJob::MemPurgeDecider(double threshold) {
           threshold);
 }
 
+Status FlushJob::CollectShardBoundaries(
+    InternalIterator* iter, std::vector<InternalKey>* boundaries) {
+  SstPartitioner::Context context;
+  context.is_full_compaction = false;
+  context.is_manual_compaction = false;
+  context.output_level = 0;
+  std::unique_ptr<SstPartitioner> partitioner =
+      cfd_->ioptions().sst_partitioner_factory->CreatePartitioner(context);
+  if (partitioner == nullptr) {
+    return Status::OK();
+  }
+  const Comparator* ucmp = cfd_->user_comparator();
+  // Tiny shards would only add L0 files for the base level compactions to
+  // pick up, so boundaries are skipped until the shard is large enough.
+  const uint64_t min_shard_size = std::max<uint64_t>(
+      mutable_cf_options_.write_buffer_size / kMaxLevel0Shards, 1);
+  std::string prev_user_key;
+  uint64_t shard_size = 0;
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    const Slice user_key = ExtractUserKey(iter->key());
+    if (shard_size >= min_shard_size &&
+        boundaries->size() + 1 < kMaxLevel0Shards &&
+        ucmp->Compare(user_key, prev_user_key) != 0) {
+      const Slice prev_user_key_slice(prev_user_key);
+      if (partitioner->ShouldPartition(PartitionerRequest(
+              prev_user_key_slice, user_key, shard_size)) == kRequired) {
+        boundaries->emplace_back();
+        boundaries->back().SetMinPossibleForUserKey(user_key);
+        shard_size = 0;
+      }
+    }
+    prev_user_key.assign(user_key.data(), user_key.size());
+    shard_size += iter->key().size() + iter->value().size();
+  }
+  return iter->status();
+}
+
 Status FlushJob::WriteLevel0Table() {
   AutoThreadOperationStageUpdater stage_updater(
       ThreadStatus::STAGE_FLUSH_WRITE_L0);
@@ -986,32 +1025,87 @@ Status FlushJob::WriteLevel0Table() {
       ReadOptions read_options(Env::IOActivity::kFlush);
       read_options.rate_limiter_priority = io_priority;
       const WriteOptions write_options(io_priority, Env::IOActivity::kFlush);
-      TableBuilderOptions tboptions(
-          cfd_->ioptions(), mutable_cf_options_, read_options, write_options,
-          cfd_->internal_comparator(), cfd_->internal_tbl_prop_coll_factories(),
-          output_compression_, mutable_cf_options_.compression_opts,
-          cfd_->GetID(), cfd_->GetName(), 0 /* level */,
-          current_time /* newest_key_time */, false /* is_bottommost */,
-          TableFileCreationReason::kFlush, oldest_key_time, current_time,
-          db_id_, db_session_id_, 0 /* target_file_size */,
-          meta_.fd.GetNumber(),
-          preclude_last_level_min_seqno_ == kMaxSequenceNumber
-              ? preclude_last_level_min_seqno_
-              : std::min(earliest_snapshot_, preclude_last_level_min_seqno_));
       const SequenceNumber job_snapshot_seq =
           job_context_->GetJobSnapshotSequence();
 
-      s = BuildTable(
-          dbname_, versions_, db_options_, tboptions, file_options_,
-          cfd_->table_cache(), iter.get(), std::move(range_del_iters), &meta_,
-          &blob_file_additions, existing_snapshots_, earliest_snapshot_,
-          earliest_write_conflict_snapshot_, job_snapshot_seq,
-          snapshot_checker_, mutable_cf_options_.paranoid_file_checks,
-          cfd_->internal_stats(), &io_s, io_tracer_,
-          BlobFileCreationReason::kFlush, seqno_to_time_mapping_.get(),
-          event_logger_, job_context_->job_id, &table_properties_, write_hint,
-          full_history_ts_low, blob_callback_, base_, &num_input_entries,
-          &memtable_payload_bytes, &memtable_garbage_bytes);
+      // With a sharded L0, the output is cut at the shard boundaries. The
+      // first shard goes to meta_ and the others to new files of the same
+      // epoch number, which is fine as they don't overlap.
+      std::vector<InternalKey> shard_boundaries;
+      if (mutable_cf_options_.shard_level0_by_sst_partitioner &&
+          cfd_->ioptions().sst_partitioner_factory != nullptr &&
+          cfd_->ioptions().compaction_style == kCompactionStyleLevel &&
+          ts_sz == 0 && range_del_iters.empty()) {
+        s = CollectShardBoundaries(iter.get(), &shard_boundaries);
+      }
+      std::vector<Slice> shard_boundary_slices;
+      for (const InternalKey& boundary : shard_boundaries) {
+        shard_boundary_slices.push_back(boundary.Encode());
+      }
+
+      for (size_t shard = 0; s.ok() && shard <= shard_boundaries.size();
+           shard++) {
+        FileMetaData* meta = &meta_;
+        if (shard > 0) {
+          shard_metas_.emplace_back();
+          meta = &shard_metas_.back();
+          meta->fd = FileDescriptor(versions_->NewFileNumber(), 0, 0);
+          meta->epoch_number = meta_.epoch_number;
+          meta->temperature = meta_.temperature;
+          meta->oldest_ancester_time = meta_.oldest_ancester_time;
+          meta->file_creation_time = meta_.file_creation_time;
+          shard_table_properties_.emplace_back();
+        }
+        TableBuilderOptions tboptions(
+            cfd_->ioptions(), mutable_cf_options_, read_options,
+            write_options, cfd_->internal_comparator(),
+            cfd_->internal_tbl_prop_coll_factories(), output_compression_,
+            mutable_cf_options_.compression_opts, cfd_->GetID(),
+            cfd_->GetName(), 0 /* level */,
+            current_time /* newest_key_time */, false /* is_bottommost */,
+            TableFileCreationReason::kFlush, oldest_key_time, current_time,
+            db_id_, db_session_id_, 0 /* target_file_size */,
+            meta->fd.GetNumber(),
+            preclude_last_level_min_seqno_ == kMaxSequenceNumber
+                ? preclude_last_level_min_seqno_
+                : std::min(earliest_snapshot_,
+                           preclude_last_level_min_seqno_));
+        tboptions.compression_dict_reuse_registry =
+            cfd_->compression_dict_reuse_registry();
+
+        InternalIterator* input = iter.get();
+        std::unique_ptr<InternalIterator> clip;
+        if (!shard_boundaries.empty()) {
+          clip = std::make_unique<ClippingIterator>(
+              iter.get(),
+              shard > 0 ? &shard_boundary_slices[shard - 1] : nullptr,
+              shard < shard_boundaries.size() ? &shard_boundary_slices[shard]
+                                              : nullptr,
+              &cfd_->internal_comparator());
+          input = clip.get();
+        }
+
+        uint64_t shard_num_input_entries = 0;
+        uint64_t shard_payload_bytes = 0;
+        uint64_t shard_garbage_bytes = 0;
+        s = BuildTable(
+            dbname_, versions_, db_options_, tboptions, file_options_,
+            cfd_->table_cache(), input, std::move(range_del_iters), meta,
+            &blob_file_additions, existing_snapshots_, earliest_snapshot_,
+            earliest_write_conflict_snapshot_, job_snapshot_seq,
+            snapshot_checker_, mutable_cf_options_.paranoid_file_checks,
+            cfd_->internal_stats(), &io_s, io_tracer_,
+            BlobFileCreationReason::kFlush, seqno_to_time_mapping_.get(),
+            event_logger_, job_context_->job_id,
+            shard == 0 ? &table_properties_ : &shard_table_properties_.back(),
+            write_hint,
+            full_history_ts_low, blob_callback_, base_,
+            &shard_num_input_entries, &shard_payload_bytes,
+            &shard_garbage_bytes);
+        num_input_entries += shard_num_input_entries;
+        memtable_payload_bytes += shard_payload_bytes;
+        memtable_garbage_bytes += shard_garbage_bytes;
+      }
       TEST_SYNC_POINT_CALLBACK("FlushJob::WriteLevel0Table:s", &s);
       // TODO: Cleanup io_status in BuildTable and table builders
       assert(!s.ok() || io_s.ok());
@@ -1027,13 +1121,11 @@ Status FlushJob::WriteLevel0Table() {
           s = Status::Corruption(msg);
         }
       }
-      if (tboptions.reason == TableFileCreationReason::kFlush) {
-        TEST_SYNC_POINT("DBImpl::FlushJob:Flush");
-        RecordTick(stats_, MEMTABLE_PAYLOAD_BYTES_AT_FLUSH,
-                   memtable_payload_bytes);
-        RecordTick(stats_, MEMTABLE_GARBAGE_BYTES_AT_FLUSH,
-                   memtable_garbage_bytes);
-      }
+      TEST_SYNC_POINT("DBImpl::FlushJob:Flush");
+      RecordTick(stats_, MEMTABLE_PAYLOAD_BYTES_AT_FLUSH,
+                 memtable_payload_bytes);
+      RecordTick(stats_, MEMTABLE_GARBAGE_BYTES_AT_FLUSH,
+                 memtable_garbage_bytes);
       LogFlush(db_options_.info_log);
     }
     ROCKS_LOG_BUFFER(log_buffer_,
@@ -1049,6 +1141,13 @@ Status FlushJob::WriteLevel0Table() {
                            "won't be kept in the DB"
                          : "",
                      meta_.marked_for_compaction ? " (needs compaction)" : "");
+    for (const FileMetaData& shard_meta : shard_metas_) {
+      ROCKS_LOG_BUFFER(log_buffer_,
+                       "[%s] [JOB %d] Level-0 flush shard table #%" PRIu64
+                       ": %" PRIu64 " bytes",
+                       cfd_->GetName().c_str(), job_context_->job_id,
+                       shard_meta.fd.GetNumber(), shard_meta.fd.GetFileSize());
+    }
 
     if (s.ok() && output_file_directory_ != nullptr && sync_output_directory_) {
       s = output_file_directory_->FsyncWithDirOptions(
@@ -1062,7 +1161,19 @@ Status FlushJob::WriteLevel0Table() {
 
   // Note that if file_size is zero, the file has been deleted and
   // should not be added to the manifest.
-  const bool has_output = meta_.fd.GetFileSize() > 0;
+  std::vector<const FileMetaData*> outputs;
+  uint64_t output_bytes = 0;
+  if (meta_.fd.GetFileSize() > 0) {
+    outputs.push_back(&meta_);
+    output_bytes += meta_.fd.GetFileSize();
+  }
+  for (const FileMetaData& shard_meta : shard_metas_) {
+    if (shard_meta.fd.GetFileSize() > 0) {
+      outputs.push_back(&shard_meta);
+      output_bytes += shard_meta.fd.GetFileSize();
+    }
+  }
+  const bool has_output = !outputs.empty();
 
   if (s.ok() && has_output) {
     TEST_SYNC_POINT("DBImpl::FlushJob:SSTFileCreated");
@@ -1071,19 +1182,21 @@ Status FlushJob::WriteLevel0Table() {
     // threads could be concurrently producing compacted files for
     // that key range.
     // Add file to L0
-    edit_->AddFile(0 /* level */, meta_.fd.GetNumber(), meta_.fd.GetPathId(),
-                   meta_.fd.GetFileSize(), meta_.smallest, meta_.largest,
-                   meta_.fd.smallest_seqno, meta_.fd.largest_seqno,
-                   meta_.marked_for_compaction, meta_.temperature,
-                   meta_.oldest_blob_file_number, meta_.oldest_ancester_time,
-                   meta_.file_creation_time, meta_.epoch_number,
-                   meta_.file_checksum, meta_.file_checksum_func_name,
-                   meta_.unique_id, meta_.compensated_range_deletion_size,
-                   meta_.tail_size, meta_.user_defined_timestamps_persisted);
+    for (const FileMetaData* meta : outputs) {
+      edit_->AddFile(0 /* level */, meta->fd.GetNumber(), meta->fd.GetPathId(),
+                     meta->fd.GetFileSize(), meta->smallest, meta->largest,
+                     meta->fd.smallest_seqno, meta->fd.largest_seqno,
+                     meta->marked_for_compaction, meta->temperature,
+                     meta->oldest_blob_file_number, meta->oldest_ancester_time,
+                     meta->file_creation_time, meta->epoch_number,
+                     meta->file_checksum, meta->file_checksum_func_name,
+                     meta->unique_id, meta->compensated_range_deletion_size,
+                     meta->tail_size, meta->user_defined_timestamps_persisted);
+    }
     edit_->SetBlobFileAdditions(std::move(blob_file_additions));
   }
   // Piggyback FlushJobInfo on the first first flushed memtable.
-  mems_[0]->SetFlushJobInfo(GetFlushJobInfo());
+  mems_[0]->SetFlushJobsInfo(GetFlushJobsInfo());
 
   // Note that here we treat flush as level 0 compaction in internal stats
   InternalStats::CompactionStats stats(CompactionReason::kFlush, 1);
@@ -1099,8 +1212,8 @@ Status FlushJob::WriteLevel0Table() {
                  cpu_micros);
 
   if (has_output) {
-    stats.bytes_written = meta_.fd.GetFileSize();
-    stats.num_output_files = 1;
+    stats.bytes_written = output_bytes;
+    stats.num_output_files = static_cast<int>(outputs.size());
   }
 
   const auto& blobs = edit_->GetBlobFileAdditions();
@@ -1133,9 +1246,12 @@ Env::IOPriority FlushJob::GetRateLimiterPriority() {
   return Env::IO_HIGH;
 }
 
-std::unique_ptr<FlushJobInfo> FlushJob::GetFlushJobInfo() const {
+std::vector<std::unique_ptr<FlushJobInfo>> FlushJob::GetFlushJobsInfo()
+    const {
   db_mutex_->AssertHeld();
-  std::unique_ptr<FlushJobInfo> info(new FlushJobInfo{});
+  std::vector<std::unique_ptr<FlushJobInfo>> infos;
+  infos.emplace_back(new FlushJobInfo{});
+  FlushJobInfo* info = infos.back().get();
   info->cf_id = cfd_->GetID();
   info->cf_name = cfd_->GetName();
 
@@ -1162,7 +1278,25 @@ std::unique_ptr<FlushJobInfo> FlushJob::GetFlushJobInfo() const {
     info->blob_file_addition_infos.emplace_back(
         std::move(blob_file_addition_info));
   }
-  return info;
+
+  // The shard files share the job and the blob files of the first one.
+  for (size_t i = 0; i < shard_metas_.size(); i++) {
+    const FileMetaData& shard_meta = shard_metas_[i];
+    if (shard_meta.fd.GetFileSize() == 0) {
+      continue;
+    }
+    infos.emplace_back(new FlushJobInfo(*info));
+    FlushJobInfo* shard_info = infos.back().get();
+    shard_info->file_path =
+        TableFileName(cfd_->ioptions().cf_paths, shard_meta.fd.GetNumber(),
+                      shard_meta.fd.GetPathId());
+    shard_info->file_number = shard_meta.fd.GetNumber();
+    shard_info->oldest_blob_file_number = shard_meta.oldest_blob_file_number;
+    shard_info->smallest_seqno = shard_meta.fd.smallest_seqno;
+    shard_info->largest_seqno = shard_meta.fd.largest_seqno;
+    shard_info->table_properties = shard_table_properties_[i];
+  }
+  return infos;
 }
 
 void FlushJob::GetEffectiveCutoffUDTForPickedMemTables() {
@@ -97,6 +97,12 @@ class FlushJob {
     return &committed_flush_jobs_info_;
   }
 
+  // The L0 files written besides the one returned by Run() when the output
+  // is cut into shards. See shard_level0_by_sst_partitioner.
+  const std::vector<FileMetaData>& GetShardFileMetas() const {
+    return shard_metas_;
+  }
+
  private:
   friend class FlushJobTest_GetRateLimiterPriorityForWrite_Test;
 
@@ -104,6 +110,13 @@ class FlushJob {
   static void ReportFlushInputSize(const autovector<ReadOnlyMemTable*>& mems);
   void RecordFlushIOStats();
   Status WriteLevel0Table();
+  // Collects the boundaries where the sst partitioner cuts the output of the
+  // flush into L0 shards, as the smallest internal keys of the shards after
+  // the first one. A shard is only cut once it holds write_buffer_size /
+  // kMaxLevel0Shards bytes, and at most kMaxLevel0Shards shards are cut.
+  Status CollectShardBoundaries(InternalIterator* iter,
+                                std::vector<InternalKey>* boundaries);
+  static constexpr size_t kMaxLevel0Shards = 16;
 
   // Memtable Garbage Collection algorithm: a MemPurge takes the list
   // of immutable memtables and filters out (or "purge") the outdated bytes
@@ -129,7 +142,9 @@ class FlushJob {
   bool MemPurgeDecider(double threshold);
   // The rate limiter priority (io_priority) is determined dynamically here.
   Env::IOPriority GetRateLimiterPriority();
-  std::unique_ptr<FlushJobInfo> GetFlushJobInfo() const;
+  // One FlushJobInfo per L0 file written by this job, the first one for
+  // meta_ and then one per non-empty shard file.
+  std::vector<std::unique_ptr<FlushJobInfo>> GetFlushJobsInfo() const;
 
   // Require db_mutex held.
   // Called only when UDT feature is enabled and
@@ -205,6 +220,10 @@ class FlushJob {
 
   // Variables below are set by PickMemTable():
   FileMetaData meta_;
+  // The files of the shards after the first one, set by WriteLevel0Table()
+  std::vector<FileMetaData> shard_metas_;
+  // The table properties of the files in shard_metas_
+  std::vector<TableProperties> shard_table_properties_;
   // Memtables to be flushed by this job.
   // Ordered by increasing memtable id, i.e., oldest memtable first.
   autovector<ReadOnlyMemTable*> mems_;
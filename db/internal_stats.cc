@@ -22,6 +22,7 @@
 
 #include "cache/cache_entry_roles.h"
 #include "cache/cache_entry_stats.h"
+#include "cache/cache_owner.h"
 #include "db/column_family.h"
 #include "db/db_impl/db_impl.h"
 #include "db/write_stall_stats.h"
@@ -698,6 +699,14 @@ InternalStats::CacheEntryRoleStats::GetEntryCallback() {
         static_cast<size_t>(helper ? helper->role : CacheEntryRole::kMisc);
     entry_counts[role_idx]++;
     total_charges[role_idx] += charge;
+    if (helper != nullptr && helper->owner != nullptr) {
+      const CacheOwner& owner = *helper->owner;
+      OwnerStats& stats = owner_stats[owner.name()];
+      stats.entry_count++;
+      stats.total_charge += charge;
+      stats.hits = owner.GetHits();
+      stats.misses = owner.GetMisses();
+    }
   };
 }
 
@@ -755,6 +764,15 @@ std::string InternalStats::CacheEntryRoleStats::ToString(
     }
   }
   str << "\n";
+  if (!owner_stats.empty()) {
+    str << "Block cache owner stats(count,size,hits,misses):";
+    for (const auto& [name, stats] : owner_stats) {
+      str << " " << name << "(" << stats.entry_count << ","
+          << BytesToHumanString(stats.total_charge) << "," << stats.hits << ","
+          << stats.misses << ")";
+    }
+    str << "\n";
+  }
   return str.str();
 }
 
@@ -778,6 +796,14 @@ void InternalStats::CacheEntryRoleStats::ToMap(
     v[BlockCacheEntryStatsMapKeys::UsedPercent(role)] =
         std::to_string(100.0 * total_charges[i] / cache_capacity);
   }
+  for (const auto& [name, stats] : owner_stats) {
+    v[BlockCacheEntryStatsMapKeys::OwnerUsedBytes(name)] =
+        std::to_string(stats.total_charge);
+    v[BlockCacheEntryStatsMapKeys::OwnerHits(name)] =
+        std::to_string(stats.hits);
+    v[BlockCacheEntryStatsMapKeys::OwnerMisses(name)] =
+        std::to_string(stats.misses);
+  }
 }
 
 bool InternalStats::HandleBlockCacheEntryStatsInternal(std::string* value,
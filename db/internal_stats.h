@@ -510,6 +510,15 @@ class InternalStats {
     uint64_t last_end_time_micros_ = 0;
     uint32_t hash_seed = 0;
 
+    struct OwnerStats {
+      size_t entry_count = 0;
+      uint64_t total_charge = 0;
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+    };
+    // For entries charged to owners (see NewCacheOwnerView()), by owner name
+    std::map<std::string, OwnerStats> owner_stats;
+
     void Clear() {
       // Wipe everything except collection_count
       uint32_t saved_collection_count = collection_count;
@@ -11,6 +11,7 @@
 #include <atomic>
 #include <deque>
 #include <functional>
+#include <list>
 #include <memory>
 #include <string>
 #include <unordered_set>
@@ -378,12 +379,17 @@ class ReadOnlyMemTable {
     flush_in_progress_ = in_progress;
   }
 
-  void SetFlushJobInfo(std::unique_ptr<FlushJobInfo>&& info) {
-    flush_job_info_ = std::move(info);
+  void SetFlushJobsInfo(std::vector<std::unique_ptr<FlushJobInfo>>&& infos) {
+    flush_jobs_info_ = std::move(infos);
   }
 
-  std::unique_ptr<FlushJobInfo> ReleaseFlushJobInfo() {
-    return std::move(flush_job_info_);
+  // Moves the flush job info of the files written for this memtable to the
+  // back of `infos`.
+  void ReleaseFlushJobsInfo(std::list<std::unique_ptr<FlushJobInfo>>* infos) {
+    for (auto& info : flush_jobs_info_) {
+      infos->push_back(std::move(info));
+    }
+    flush_jobs_info_.clear();
   }
 
   static void HandleTypeValue(
@@ -527,8 +533,8 @@ class ReadOnlyMemTable {
   // writes with sequence number smaller than seq are flushed.
   SequenceNumber atomic_flush_seqno_{kMaxSequenceNumber};
 
-  // Flush job info of the current memtable.
-  std::unique_ptr<FlushJobInfo> flush_job_info_;
+  // Flush job info of the current memtable, one per L0 file written for it.
+  std::vector<std::unique_ptr<FlushJobInfo>> flush_jobs_info_;
 
   RelaxedAtomic<bool> marked_for_flush_{false};
 };
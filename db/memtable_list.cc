@@ -595,10 +595,7 @@ Status MemTableList::TryInstallMemtableFlushResults(
         }
 
         edit_list.push_back(&m->edit_);
-        std::unique_ptr<FlushJobInfo> info = m->ReleaseFlushJobInfo();
-        if (info != nullptr) {
-          committed_flush_jobs_info->push_back(std::move(info));
-        }
+        m->ReleaseFlushJobsInfo(committed_flush_jobs_info);
       }
       memtables_to_flush.push_back(m);
     }
@@ -898,9 +895,7 @@ Status InstallMemtableAtomicFlushResults(
     if (committed_flush_jobs_info[k]) {
       assert(!mems_list[k]->empty());
       assert((*mems_list[k])[0]);
-      std::unique_ptr<FlushJobInfo> flush_job_info =
-          (*mems_list[k])[0]->ReleaseFlushJobInfo();
-      committed_flush_jobs_info[k]->push_back(std::move(flush_job_info));
+      (*mems_list[k])[0]->ReleaseFlushJobsInfo(committed_flush_jobs_info[k]);
     }
   }
 
@@ -698,6 +698,39 @@ uint64_t TableCache::ApproximateOffsetOf(
   return result;
 }
 
+std::unique_ptr<TableReader::DataBlockCacheProbe>
+TableCache::NewDataBlockCacheProbe(
+    const ReadOptions& read_options, const FileMetaData& file_meta,
+    const InternalKeyComparator& internal_comparator,
+    const MutableCFOptions& mutable_cf_options) {
+  std::unique_ptr<TableReader::DataBlockCacheProbe> result;
+  TableReader* table_reader = file_meta.fd.table_reader;
+  TypedHandle* table_handle = nullptr;
+  if (table_reader == nullptr) {
+    Status s =
+        FindTable(read_options, file_options_, internal_comparator, file_meta,
+                  &table_handle, mutable_cf_options, true /* no_io */);
+    if (s.ok()) {
+      table_reader = cache_.Value(table_handle);
+    } else {
+      s.PermitUncheckedError();
+    }
+  }
+
+  if (table_reader != nullptr) {
+    result = table_reader->NewDataBlockCacheProbe(read_options);
+  }
+  if (table_handle != nullptr) {
+    if (result != nullptr) {
+      cache_.RegisterReleaseAsCleanup(table_handle, *result);
+    } else {
+      cache_.Release(table_handle);
+    }
+  }
+
+  return result;
+}
+
 uint64_t TableCache::ApproximateSize(
     const ReadOptions& read_options, const Slice& start, const Slice& end,
     const FileMetaData& file_meta, TableReaderCaller caller,
@@ -221,6 +221,14 @@ class TableCache {
                                const InternalKeyComparator& internal_comparator,
                                const MutableCFOptions& mutable_cf_options);
 
+  // Returns a probe of which data blocks of the file are in the block cache,
+  // which keeps the table open while it is alive. Never does any I/O, so
+  // nullptr is also returned if the file is not open in the table cache.
+  std::unique_ptr<TableReader::DataBlockCacheProbe> NewDataBlockCacheProbe(
+      const ReadOptions& read_options, const FileMetaData& file_meta,
+      const InternalKeyComparator& internal_comparator,
+      const MutableCFOptions& mutable_cf_options);
+
   // Returns approximated data size between start and end keys in a file
   // represented by fd (the start key must not be greater than the end key).
   uint64_t ApproximateSize(const ReadOptions& read_options, const Slice& start,
@@ -0,0 +1,112 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "db/user_key_row_cache.h"
+
+#include "rocksdb/slice.h"
+#include "util/coding.h"
+#include "util/hash.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Entry format: valid-from sequence number (fixed64), found (one byte) and
+// the value if found
+constexpr size_t kEntryHeaderSize = sizeof(uint64_t) + 1;
+}  // namespace
+
+UserKeyRowCache::UserKeyRowCache(std::shared_ptr<RowCache> cache)
+    : cache_(cache.get()),
+      cache_ref_(std::move(cache)),
+      stripes_(new RelaxedAtomic<SequenceNumber>[kNumStripes]) {
+  PutVarint64(&cache_id_, cache_ref_->NewId());
+}
+
+uint64_t UserKeyRowCache::HashKey(uint32_t cf_id, const Slice& user_key) {
+  return GetSliceNPHash64(user_key, cf_id);
+}
+
+void UserKeyRowCache::MakeKey(uint32_t cf_id, const Slice& user_key,
+                              Key* key) const {
+  key->cache_key.reserve(cache_id_.size() + 2 * kMaxVarint64Length +
+                         user_key.size());
+  key->cache_key.assign(cache_id_);
+  PutVarint64(&key->cache_key, generation_.Load());
+  PutVarint32(&key->cache_key, cf_id);
+  key->cache_key.append(user_key.data(), user_key.size());
+  key->stripe = HashKey(cf_id, user_key) & (kNumStripes - 1);
+}
+
+void UserKeyRowCache::RecordMax(RelaxedAtomic<SequenceNumber>& latest,
+                                SequenceNumber seq) {
+  SequenceNumber cur = latest.LoadRelaxed();
+  while (cur < seq && !latest.CasWeakRelaxed(cur, seq)) {
+  }
+}
+
+void UserKeyRowCache::RecordWrite(uint32_t cf_id, const Slice& user_key,
+                                  SequenceNumber seq) {
+  RecordMax(stripes_[HashKey(cf_id, user_key) & (kNumStripes - 1)], seq);
+}
+
+void UserKeyRowCache::RecordWriteToAllKeys(SequenceNumber seq) {
+  RecordMax(all_keys_written_, seq);
+}
+
+bool UserKeyRowCache::Lookup(const Key& key, SequenceNumber snapshot,
+                             PinnableSlice* value, Status* status) {
+  auto handle = cache_.Lookup(key.cache_key);
+  if (handle == nullptr) {
+    return false;
+  }
+  const std::string& entry = *cache_.Value(handle);
+  assert(entry.size() >= kEntryHeaderSize);
+  const SequenceNumber valid_from = DecodeFixed64(entry.data());
+  if (LatestWrite(key.stripe) > valid_from) {
+    // Possibly written since, no longer usable
+    cache_.ReleaseAndEraseIfLastRef(handle);
+    return false;
+  }
+  if (snapshot < valid_from) {
+    // Too old a snapshot
+    cache_.Release(handle);
+    return false;
+  }
+  if (entry[sizeof(uint64_t)] != 0) {
+    value->PinSlice(Slice(entry.data() + kEntryHeaderSize,
+                          entry.size() - kEntryHeaderSize),
+                    nullptr);
+    cache_.RegisterReleaseAsCleanup(handle, *value);
+    *status = Status::OK();
+  } else {
+    cache_.Release(handle);
+    *status = Status::NotFound();
+  }
+  return true;
+}
+
+void UserKeyRowCache::Insert(const Key& key, SequenceNumber snapshot,
+                             const Slice* value) {
+  if (LatestWrite(key.stripe) > snapshot) {
+    // Would not be usable
+    return;
+  }
+  auto entry = new std::string();
+  entry->reserve(kEntryHeaderSize + (value ? value->size() : 0));
+  PutFixed64(entry, snapshot);
+  entry->push_back(value != nullptr ? 1 : 0);
+  if (value != nullptr) {
+    entry->append(value->data(), value->size());
+  }
+  const size_t charge =
+      entry->capacity() + sizeof(std::string) + key.cache_key.size();
+  Status s = cache_.Insert(key.cache_key, entry, charge);
+  if (!s.ok()) {
+    // Fine to go without caching, but we keep ownership of the entry
+    delete entry;
+  }
+}
+
+}  // namespace ROCKSDB_NAMESPACE
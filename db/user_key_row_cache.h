@@ -0,0 +1,110 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "cache/typed_cache.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/slice.h"
+#include "rocksdb/status.h"
+#include "rocksdb/types.h"
+#include "util/atomic.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class PinnableSlice;
+
+// The results of point lookups (Get()) by column family and user key, above
+// the LSM tree (see DBOptions::user_key_row_cache). Unlike the row cache of
+// TableCache, entries do not depend on the files holding the key, so they
+// are not lost to compactions.
+//
+// Each entry holds the result of a read at some sequence number S (its
+// "valid from" sequence number), and answers reads at any snapshot >= S
+// until the key is written again. Rather than erasing entries on writes, the
+// write path records the sequence number of the latest write to each of a
+// fixed number of stripes of keys, and an entry is only used while no key of
+// its stripe was written after S. Writes must be recorded before they are
+// published (visible to new reads), which makes the scheme free of races
+// between a read filling the cache and a concurrent write: the entry of a
+// read that missed a write is never used by reads that can see the write.
+//
+// Writes not of individual keys (range deletions) are recorded the same way
+// for all keys at once. Other changes (file ingestion, deletion of files) are
+// handled by InvalidateAll() once visible, which moves all following reads
+// to a new generation of cache keys.
+class UserKeyRowCache {
+ public:
+  // Identifies a key in the cache. To be created before reading the key from
+  // the DB, and used both for looking it up and for inserting the result of
+  // the read.
+  struct Key {
+    std::string cache_key;
+    size_t stripe = 0;
+  };
+
+  explicit UserKeyRowCache(std::shared_ptr<RowCache> cache);
+
+  void MakeKey(uint32_t cf_id, const Slice& user_key, Key* key) const;
+
+  // Records a write of `user_key` with sequence number `seq`, which must not
+  // yet be published
+  void RecordWrite(uint32_t cf_id, const Slice& user_key, SequenceNumber seq);
+
+  // Like RecordWrite() for all keys, e.g. for a range deletion
+  void RecordWriteToAllKeys(SequenceNumber seq);
+
+  // Makes all existing entries unusable, for changes that are not writes.
+  // Must happen after the change is visible to new reads (e.g. after the new
+  // SuperVersion is installed), and before the operation making the change
+  // returns.
+  void InvalidateAll() { generation_.FetchAdd(1); }
+
+  // Returns true on a hit for a read at sequence number `snapshot`, setting
+  // `*status` to OK with the value in `value`, or to NotFound
+  bool Lookup(const Key& key, SequenceNumber snapshot, PinnableSlice* value,
+              Status* status);
+
+  // Caches the result of a read at sequence number `snapshot`: `value` if
+  // found, or nullptr if not found
+  void Insert(const Key& key, SequenceNumber snapshot, const Slice* value);
+
+ private:
+  using CacheInterface =
+      BasicTypedCacheInterface<std::string, CacheEntryRole::kMisc>;
+
+  static constexpr size_t kNumStripes = size_t{1} << 14;
+
+  static uint64_t HashKey(uint32_t cf_id, const Slice& user_key);
+  static void RecordMax(RelaxedAtomic<SequenceNumber>& latest,
+                        SequenceNumber seq);
+
+  // Sequence number of the latest write that could affect the entry for a
+  // key of `stripe`
+  SequenceNumber LatestWrite(size_t stripe) const {
+    return std::max(stripes_[stripe].LoadRelaxed(),
+                    all_keys_written_.LoadRelaxed());
+  }
+
+  CacheInterface cache_;
+  // Keeps the cache alive
+  std::shared_ptr<RowCache> cache_ref_;
+  // Distinguishes the keys of this DB from others sharing the cache
+  std::string cache_id_;
+  // Acquire/release so that reads of a new generation see the change that
+  // bumped it
+  AcqRelAtomic<uint64_t> generation_{0};
+  // Sequence number of the latest write to all keys
+  RelaxedAtomic<SequenceNumber> all_keys_written_{0};
+  // Sequence number of the latest write to a key of each stripe
+  std::unique_ptr<RelaxedAtomic<SequenceNumber>[]> stripes_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -164,15 +164,19 @@ struct FileDescriptor {
 };
 
 struct FileSampledStats {
-  FileSampledStats() : num_reads_sampled(0) {}
+  FileSampledStats() : num_reads_sampled(0), num_wasted_reads_sampled(0) {}
   FileSampledStats(const FileSampledStats& other) { *this = other; }
   FileSampledStats& operator=(const FileSampledStats& other) {
     num_reads_sampled = other.num_reads_sampled.load();
+    num_wasted_reads_sampled = other.num_wasted_reads_sampled.load();
     return *this;
   }
 
   // number of user reads to this file.
   mutable std::atomic<uint64_t> num_reads_sampled;
+  // number of user point lookups that read this file first and then had to
+  // read other files for the same key.
+  mutable std::atomic<uint64_t> num_wasted_reads_sampled;
 };
 
 struct FileMetaData {
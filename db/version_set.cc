@@ -95,6 +95,18 @@ namespace ROCKSDB_NAMESPACE {
 
 namespace {
 
+// Number of wasted reads allowed for a file before it is compacted, in the
+// unit of num_wasted_reads_sampled (kFileReadSampleRate per sampled read). At
+// least 100 sampled reads are required, so that a file is not compacted on
+// the strength of a few samples. See
+// read_triggered_compaction_bytes_per_lookup.
+uint64_t AllowedWastedReads(const FileMetaData& file_meta,
+                            uint64_t bytes_per_lookup) {
+  assert(bytes_per_lookup > 0);
+  return std::max<uint64_t>(uint64_t{100} * kFileReadSampleRate,
+                            file_meta.fd.GetFileSize() / bytes_per_lookup);
+}
+
 // Find File in LevelFilesBrief data structure
 // Within an index range defined by left and right
 int FindFileInRange(const InternalKeyComparator& icmp,
@@ -2459,6 +2471,14 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
                 &storage_info_.file_indexer_, user_comparator(),
                 internal_comparator());
   FdWithKeyRange* f = fp.GetNextFile();
+  // The first file in which a sampled lookup searched a data block, charged
+  // when the lookup has to search a data block of another file. Files whose
+  // filter rejected the key are not charged, nor do they count as the other
+  // file.
+  FileMetaData* first_sampled_file = nullptr;
+  bool wasted_read_charged =
+      !get_context.sample() ||
+      mutable_cf_options_.read_triggered_compaction_bytes_per_lookup == 0;
 
   while (f != nullptr) {
     if (*max_covering_tombstone_seq > 0) {
@@ -2469,6 +2489,8 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
     if (get_context.sample()) {
       sample_file_read_inc(f->file_metadata);
     }
+    const uint64_t prev_data_blocks_searched =
+        get_context.get_context_stats_.num_data_blocks_searched;
 
     bool timer_enabled =
         GetPerfLevel() >= PerfLevel::kEnableTimeExceptForMutex &&
@@ -2493,6 +2515,17 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
       return;
     }
 
+    if (!wasted_read_charged &&
+        get_context.get_context_stats_.num_data_blocks_searched >
+            prev_data_blocks_searched) {
+      if (first_sampled_file == nullptr) {
+        first_sampled_file = f->file_metadata;
+      } else {
+        ChargeWastedRead(first_sampled_file);
+        wasted_read_charged = true;
+      }
+    }
+
     // report the counters before returning
     if (get_context.State() != GetContext::kNotFound &&
         get_context.State() != GetContext::kMerge &&
@@ -2606,6 +2639,17 @@ void Version::Get(const ReadOptions& read_options, const LookupKey& k,
   }
 }
 
+void Version::ChargeWastedRead(FileMetaData* file_meta) {
+  const uint64_t allowed = AllowedWastedReads(
+      *file_meta,
+      mutable_cf_options_.read_triggered_compaction_bytes_per_lookup);
+  const uint64_t prev = sample_file_wasted_read_inc(file_meta);
+  TEST_SYNC_POINT_CALLBACK("Version::ChargeWastedRead", file_meta);
+  if (prev < allowed && prev + kFileReadSampleRate >= allowed) {
+    read_compaction_requested_.store(true, std::memory_order_relaxed);
+  }
+}
+
 void Version::MultiGet(const ReadOptions& read_options, MultiGetRange* range,
                        ReadCallback* callback) {
   PinnedIteratorsManager pinned_iters_mgr;
@@ -3483,11 +3527,18 @@ void VersionStorageInfo::ComputeCompactionScore(
       // overwrites/deletions).
       int num_sorted_runs = 0;
       uint64_t total_size = 0;
+      uint64_t last_epoch_number = kUnknownEpochNumber;
       for (auto* f : files_[level]) {
         total_downcompact_bytes += static_cast<double>(f->fd.GetFileSize());
         if (!f->being_compacted) {
           total_size += f->compensated_file_size;
-          num_sorted_runs++;
+          // The files of a flush cut into shards share an epoch number and
+          // count as one sorted run.
+          if (f->epoch_number == kUnknownEpochNumber ||
+              f->epoch_number != last_epoch_number) {
+            num_sorted_runs++;
+          }
+          last_epoch_number = f->epoch_number;
         }
       }
       if (compaction_style_ == kCompactionStyleUniversal) {
@@ -3655,6 +3706,13 @@ void VersionStorageInfo::ComputeCompactionScore(
       mutable_cf_options.blob_garbage_collection_age_cutoff,
       mutable_cf_options.blob_garbage_collection_force_threshold,
       mutable_cf_options.enable_blob_garbage_collection);
+  ComputeFilesMarkedForBlobGC(
+      mutable_cf_options.blob_garbage_collection_file_threshold);
+  ComputeFilesMarkedForRangeDeletionCompaction(
+      mutable_cf_options.range_deletion_compaction_ratio, max_output_level);
+  ComputeFilesMarkedForReadCompaction(
+      mutable_cf_options.read_triggered_compaction_bytes_per_lookup,
+      max_output_level);
 
   EstimateCompactionBytesNeeded(mutable_cf_options);
 }
@@ -3688,6 +3746,74 @@ void VersionStorageInfo::ComputeFilesMarkedForCompaction(int last_level) {
   }
 }
 
+void VersionStorageInfo::ComputeFilesMarkedForRangeDeletionCompaction(
+    double range_deletion_compaction_ratio, int last_level) {
+  files_marked_for_range_deletion_compaction_.clear();
+  if (range_deletion_compaction_ratio <= 0 ||
+      compaction_style_ != CompactionStyle::kCompactionStyleLevel) {
+    return;
+  }
+
+  // L0 files are left to the L0 compactions, and files in the last level with
+  // data have nothing below them to drop.
+  int last_qualify_level = 0;
+  for (int level = last_level; level >= 1; level--) {
+    if (!files_[level].empty()) {
+      last_qualify_level = level - 1;
+      break;
+    }
+  }
+
+  for (int level = 1; level <= last_qualify_level; level++) {
+    for (auto* f : files_[level]) {
+      if (!f->being_compacted && f->num_range_deletions > 0 &&
+          f->compensated_range_deletion_size > 0 &&
+          static_cast<double>(f->compensated_range_deletion_size) >=
+              range_deletion_compaction_ratio *
+                  static_cast<double>(f->fd.GetFileSize())) {
+        files_marked_for_range_deletion_compaction_.emplace_back(level, f);
+      }
+    }
+  }
+  std::sort(files_marked_for_range_deletion_compaction_.begin(),
+            files_marked_for_range_deletion_compaction_.end(),
+            [](const std::pair<int, FileMetaData*>& a,
+               const std::pair<int, FileMetaData*>& b) {
+              return a.second->compensated_range_deletion_size >
+                     b.second->compensated_range_deletion_size;
+            });
+}
+
+void VersionStorageInfo::ComputeFilesMarkedForReadCompaction(
+    uint64_t read_triggered_compaction_bytes_per_lookup, int last_level) {
+  files_marked_for_read_compaction_.clear();
+  if (read_triggered_compaction_bytes_per_lookup == 0 ||
+      compaction_style_ != CompactionStyle::kCompactionStyleLevel) {
+    return;
+  }
+
+  // Do not include files from the last level with data, their reads are never
+  // wasted on a deeper file.
+  int last_qualify_level = -1;
+  for (int level = last_level; level >= 1; level--) {
+    if (!files_[level].empty()) {
+      last_qualify_level = level - 1;
+      break;
+    }
+  }
+
+  for (int level = 0; level <= last_qualify_level; level++) {
+    for (auto* f : files_[level]) {
+      if (!f->being_compacted &&
+          f->stats.num_wasted_reads_sampled.load(std::memory_order_relaxed) >=
+              AllowedWastedReads(*f,
+                                 read_triggered_compaction_bytes_per_lookup)) {
+        files_marked_for_read_compaction_.emplace_back(level, f);
+      }
+    }
+  }
+}
+
 void VersionStorageInfo::ComputeExpiredTtlFiles(
     const ImmutableOptions& ioptions, const uint64_t ttl) {
   expired_ttl_files_.clear();
@@ -3878,6 +4004,61 @@ void VersionStorageInfo::ComputeFilesMarkedForForcedBlobGC(
   }
 }
 
+void VersionStorageInfo::ComputeFilesMarkedForBlobGC(
+    double blob_garbage_collection_file_threshold) {
+  files_marked_for_blob_gc_.clear();
+  blob_file_marked_for_gc_ = kInvalidBlobFileNumber;
+  if (blob_garbage_collection_file_threshold >= 1.0 ||
+      compaction_style_ != CompactionStyle::kCompactionStyleLevel) {
+    return;
+  }
+
+  // Unlike forced blob GC, which looks at the garbage ratio of the oldest
+  // batch of blob files, pick the oldest blob file that has enough garbage by
+  // itself. An SST file references no blob file older than the one it is
+  // linked to, so the SST files linked to this blob file or to an older one
+  // are all those that may reference it. Rewriting them while relocating the
+  // blobs of this blob file and of the older ones makes it obsolete, and
+  // links each rewritten SST file to a newer blob file.
+  size_t count = 0;
+  for (; count < blob_files_.size(); ++count) {
+    const auto& meta = blob_files_[count];
+    assert(meta);
+
+    // A blob file without garbage is never marked, even with a threshold of
+    // 0, since rewriting it would not make it obsolete.
+    if (meta->GetGarbageBlobBytes() > 0 &&
+        meta->GetGarbageBlobBytes() >=
+            blob_garbage_collection_file_threshold *
+                meta->GetTotalBlobBytes()) {
+      break;
+    }
+  }
+  if (count == blob_files_.size()) {
+    return;
+  }
+  blob_file_marked_for_gc_ = blob_files_[count]->GetBlobFileNumber();
+
+  for (size_t i = 0; i <= count; ++i) {
+    for (uint64_t sst_file_number : blob_files_[i]->GetLinkedSsts()) {
+      const FileLocation location = GetFileLocation(sst_file_number);
+      assert(location.IsValid());
+
+      const int level = location.GetLevel();
+      assert(level >= 0);
+
+      FileMetaData* const sst_meta = files_[level][location.GetPosition()];
+      assert(sst_meta);
+
+      if (sst_meta->being_compacted) {
+        continue;
+      }
+
+      files_marked_for_blob_gc_.emplace_back(level, sst_meta);
+    }
+  }
+}
+
 namespace {
 
 // used to sort files by size
@@ -4716,7 +4897,14 @@ void VersionStorageInfo::CalculateBaseBytes(const ImmutableOptions& ioptions,
                                             const MutableCFOptions& options) {
   // Special logic to set number of sorted runs.
   // It is to match the previous behavior when all files are in L0.
-  int num_l0_count = static_cast<int>(files_[0].size());
+  int num_l0_count = 0;
+  for (size_t i = 0; i < files_[0].size(); i++) {
+    // The files of a flush cut into shards count as one.
+    if (i == 0 || files_[0][i]->epoch_number == kUnknownEpochNumber ||
+        files_[0][i]->epoch_number != files_[0][i - 1]->epoch_number) {
+      num_l0_count++;
+    }
+  }
   if (compaction_style_ == kCompactionStyleUniversal) {
     // For universal compaction, we use level0 score to indicate
     // compaction score for the whole DB. Adding other levels as if
@@ -242,6 +242,39 @@ class VersionStorageInfo {
       double blob_garbage_collection_force_threshold,
       bool enable_blob_garbage_collection);
 
+  // This computes blob_file_marked_for_gc_ and files_marked_for_blob_gc_ and
+  // is called by ComputeCompactionScore()
+  //
+  // Marks the oldest blob file with garbage whose garbage ratio is at least
+  // `blob_garbage_collection_file_threshold`, along with the SST files that
+  // may reference it, i.e. the ones linked to it or to an older blob file.
+  //
+  // REQUIRES: DB mutex held
+  void ComputeFilesMarkedForBlobGC(
+      double blob_garbage_collection_file_threshold);
+
+  // This computes files_marked_for_range_deletion_compaction_ and is called
+  // by ComputeCompactionScore()
+  //
+  // Marks the files in levels 1 to the one above the last non-empty level
+  // whose range tombstones cover at least `range_deletion_compaction_ratio`
+  // times their size in the lower levels, as estimated by
+  // FileMetaData::compensated_range_deletion_size.
+  void ComputeFilesMarkedForRangeDeletionCompaction(
+      double range_deletion_compaction_ratio, int last_level);
+
+  // This computes files_marked_for_read_compaction_ and is called by
+  // ComputeCompactionScore() or when a Get() requests a read triggered
+  // compaction.
+  //
+  // Marks the files above the last non-empty level that point lookups read in
+  // vain more often than allowed by
+  // `read_triggered_compaction_bytes_per_lookup`.
+  //
+  // REQUIRES: DB mutex held
+  void ComputeFilesMarkedForReadCompaction(
+      uint64_t read_triggered_compaction_bytes_per_lookup, int last_level);
+
   bool level0_non_overlapping() const { return level0_non_overlapping_; }
 
   // Updates the oldest snapshot and related internal state, like the bottommost
@@ -520,6 +553,39 @@ class VersionStorageInfo {
     return files_marked_for_forced_blob_gc_;
   }
 
+  // REQUIRES: ComputeCompactionScore has been called
+  // REQUIRES: DB mutex held during access
+  const autovector<std::pair<int, FileMetaData*>>& FilesMarkedForBlobGC()
+      const {
+    assert(finalized_);
+    return files_marked_for_blob_gc_;
+  }
+
+  // The blob file FilesMarkedForBlobGC() are marked for, or
+  // kInvalidBlobFileNumber if none.
+  // REQUIRES: ComputeCompactionScore has been called
+  // REQUIRES: DB mutex held during access
+  uint64_t BlobFileMarkedForGC() const {
+    assert(finalized_);
+    return blob_file_marked_for_gc_;
+  }
+
+  // REQUIRES: ComputeCompactionScore has been called
+  // REQUIRES: DB mutex held during access
+  const autovector<std::pair<int, FileMetaData*>>&
+  FilesMarkedForRangeDeletionCompaction() const {
+    assert(finalized_);
+    return files_marked_for_range_deletion_compaction_;
+  }
+
+  // REQUIRES: ComputeCompactionScore has been called
+  // REQUIRES: DB mutex held during access
+  const autovector<std::pair<int, FileMetaData*>>&
+  FilesMarkedForReadCompaction() const {
+    assert(finalized_);
+    return files_marked_for_read_compaction_;
+  }
+
   int base_level() const { return base_level_; }
   double level_multiplier() const { return level_multiplier_; }
 
@@ -726,6 +792,16 @@ class VersionStorageInfo {
 
   autovector<std::pair<int, FileMetaData*>> files_marked_for_forced_blob_gc_;
 
+  autovector<std::pair<int, FileMetaData*>> files_marked_for_blob_gc_;
+  uint64_t blob_file_marked_for_gc_ = kInvalidBlobFileNumber;
+
+  // Sorted by the estimated size of the data covered by their range
+  // tombstones, largest first.
+  autovector<std::pair<int, FileMetaData*>>
+      files_marked_for_range_deletion_compaction_;
+
+  autovector<std::pair<int, FileMetaData*>> files_marked_for_read_compaction_;
+
   // Threshold for needing to mark another bottommost file. Maintain it so we
   // can quickly check when releasing a snapshot whether more bottommost files
   // became eligible for compaction. It's defined as the min of the max nonzero
@@ -927,6 +1003,16 @@ class Version {
   void MultiGet(const ReadOptions&, MultiGetRange* range,
                 ReadCallback* callback = nullptr);
 
+  // Returns true, once, if a Get() charged a file enough wasted reads for it
+  // to be compacted. See read_triggered_compaction_bytes_per_lookup. The
+  // caller should then call
+  // VersionStorageInfo::ComputeFilesMarkedForReadCompaction() on the current
+  // version and schedule the compaction.
+  bool TakeReadCompactionRequest() {
+    return read_compaction_requested_.load(std::memory_order_relaxed) &&
+           read_compaction_requested_.exchange(false);
+  }
+
   // Interprets blob_index_slice as a blob reference, and (assuming the
   // corresponding blob file is part of this Version) retrieves the blob and
   // saves it in *value.
@@ -1079,6 +1165,10 @@ class Version {
   // that it eventually expires from the cache.
   bool IsFilterSkipped(int level, bool is_file_last_in_level = false);
 
+  // Charges a file that a sampled Get() searched a data block of before
+  // having to search a data block of another file for the same key.
+  void ChargeWastedRead(FileMetaData* file_meta);
+
   // The helper function of UpdateAccumulatedStats, which may fill the missing
   // fields of file_meta from its associated TableProperties.
   // Returns true if it does initialize FileMetaData.
@@ -1141,6 +1231,7 @@ class Version {
   uint64_t version_number_;
   std::shared_ptr<IOTracer> io_tracer_;
   bool use_async_io_;
+  std::atomic<bool> read_compaction_requested_{false};
 
   Version(ColumnFamilyData* cfd, VersionSet* vset, const FileOptions& file_opt,
           const MutableCFOptions& mutable_cf_options,
@@ -57,6 +57,7 @@
 #include "db/merge_context.h"
 #include "db/snapshot_impl.h"
 #include "db/trim_history_scheduler.h"
+#include "db/user_key_row_cache.h"
 #include "db/wide/wide_column_serialization.h"
 #include "db/wide/wide_columns_helper.h"
 #include "db/write_batch_internal.h"
@@ -2075,6 +2076,22 @@ class MemTableInserter : public WriteBatch::Handler {
     prot_info_ = nullptr;
   }
 
+  // Keeps the user key row cache from returning what was read before this
+  // write (see UserKeyRowCache)
+  void RecordWriteInRowCache(uint32_t column_family_id, const Slice& key,
+                             ValueType value_type) {
+    UserKeyRowCache* row_cache =
+        db_ != nullptr ? db_->user_key_row_cache() : nullptr;
+    if (row_cache == nullptr) {
+      return;
+    }
+    if (value_type == kTypeRangeDeletion) {
+      row_cache->RecordWriteToAllKeys(sequence_);
+    } else {
+      row_cache->RecordWrite(column_family_id, key, sequence_);
+    }
+  }
+
  protected:
   Handler::OptionState WriteBeforePrepare() const override {
     return write_before_prepare_ ? Handler::OptionState::kEnabled
@@ -2258,6 +2275,7 @@ class MemTableInserter : public WriteBatch::Handler {
       return ret_status;
     }
     assert(ret_status.ok());
+    RecordWriteInRowCache(column_family_id, key, value_type);
 
     MemTable* mem = cf_mems_->GetMemTable();
     auto* moptions = mem->GetImmutableMemTableOptions();
@@ -2480,10 +2498,11 @@ class MemTableInserter : public WriteBatch::Handler {
     return s;
   }
 
-  Status DeleteImpl(uint32_t /*column_family_id*/, const Slice& key,
+  Status DeleteImpl(uint32_t column_family_id, const Slice& key,
                     const Slice& value, ValueType delete_type,
                     const ProtectionInfoKVOS64* kv_prot_info) {
     Status ret_status;
+    RecordWriteInRowCache(column_family_id, key, delete_type);
     MemTable* mem = cf_mems_->GetMemTable();
     ret_status =
         mem->Add(sequence_, delete_type, key, value, kv_prot_info,
@@ -2743,6 +2762,7 @@ class MemTableInserter : public WriteBatch::Handler {
       return ret_status;
     }
     assert(ret_status.ok());
+    RecordWriteInRowCache(column_family_id, key, kTypeMerge);
 
     MemTable* mem = cf_mems_->GetMemTable();
     auto* moptions = mem->GetImmutableMemTableOptions();
@@ -775,12 +775,8 @@ bool FilePrefetchBuffer::TryReadFromCache(const IOOptions& opts,
 bool FilePrefetchBuffer::TryReadFromCacheUntracked(
     const IOOptions& opts, RandomAccessFileReader* reader, uint64_t offset,
     size_t n, Slice* result, Status* status, bool for_compaction) {
-  // We disallow async IO for compaction reads since they are performed in
-  // the background anyways and are less latency sensitive compared to
-  // user-initiated reads
-  (void)for_compaction;
-  assert(!for_compaction || num_buffers_ == 1);
-
+  // Compaction reads use async IO (num_buffers_ > 1) only with
+  // DBOptions::compaction_async_readahead_budget.
   if (track_min_offset_ && offset < min_offset_read_) {
     min_offset_read_ = static_cast<size_t>(offset);
   }
@@ -2063,6 +2063,110 @@ TEST_P(PrefetchTest, DBIterAsyncIONoIOUring) {
   enable_io_uring = true;
 }
 
+TEST_F(PrefetchTest, CompactionAsyncReadahead) {
+  if (mem_env_ || encrypted_env_) {
+    ROCKSDB_GTEST_SKIP("Test requires non-mem or non-encrypted environment");
+    return;
+  }
+
+  // Reports async IO support, with the default ReadAsync() reading
+  // synchronously, so that the test does not depend on io_uring.
+  class AsyncReadFS : public FileSystemWrapper {
+   public:
+    explicit AsyncReadFS(const std::shared_ptr<FileSystem>& _target)
+        : FileSystemWrapper(_target) {}
+    const char* Name() const override { return "AsyncReadFS"; }
+
+    IOStatus NewRandomAccessFile(const std::string& fname,
+                                 const FileOptions& opts,
+                                 std::unique_ptr<FSRandomAccessFile>* result,
+                                 IODebugContext* dbg) override {
+      class AsyncReadFile : public FSRandomAccessFileOwnerWrapper {
+       public:
+        explicit AsyncReadFile(std::unique_ptr<FSRandomAccessFile>& file)
+            : FSRandomAccessFileOwnerWrapper(std::move(file)) {}
+
+        IOStatus ReadAsync(FSReadRequest& req, const IOOptions& opts,
+                           std::function<void(FSReadRequest&, void*)> cb,
+                           void* cb_arg, void** io_handle,
+                           IOHandleDeleter* del_fn,
+                           IODebugContext* dbg) override {
+          return FSRandomAccessFile::ReadAsync(req, opts, cb, cb_arg,
+                                               io_handle, del_fn, dbg);
+        }
+      };
+
+      std::unique_ptr<FSRandomAccessFile> file;
+      IOStatus s = target()->NewRandomAccessFile(fname, opts, &file, dbg);
+      if (s.ok()) {
+        result->reset(new AsyncReadFile(file));
+      }
+      return s;
+    }
+
+    void SupportedOps(int64_t& supported_ops) override {
+      supported_ops = 1 << FSSupportedOps::kAsyncIO;
+    }
+  };
+
+  const int kNumKeys = 1000;
+  std::shared_ptr<FileSystem> fs =
+      std::make_shared<AsyncReadFS>(FileSystem::Default());
+  std::unique_ptr<Env> env(new CompositeEnvWrapper(env_, fs));
+
+  Options options;
+  SetGenericOptions(env.get(), /*use_direct_io=*/false, options);
+  options.statistics = CreateDBStatistics();
+  BlockBasedTableOptions table_options;
+  SetBlockBasedTableOptions(table_options);
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  Reopen(options);
+
+  Random rnd(309);
+  std::vector<std::string> values;
+  auto write_files = [&]() {
+    for (int j = 0; j < 5; j++) {
+      WriteBatch batch;
+      for (int i = j * kNumKeys; i < (j + 1) * kNumKeys; i++) {
+        if (values.size() <= static_cast<size_t>(i)) {
+          values.resize(i + 1);
+        }
+        values[i] = rnd.RandomString(1000);
+        ASSERT_OK(batch.Put(BuildKey(i), values[i]));
+      }
+      ASSERT_OK(db_->Write(WriteOptions(), &batch));
+      ASSERT_OK(Flush());
+    }
+  };
+
+  int num_read_async = 0;
+  SyncPoint::GetInstance()->SetCallBack(
+      "FilePrefetchBuffer::ReadAsync", [&](void*) { num_read_async++; });
+  SyncPoint::GetInstance()->EnableProcessing();
+
+  // Without a budget, compactions read synchronously.
+  write_files();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_EQ(0, num_read_async);
+
+  // With a budget, the next blocks of the input files are read
+  // asynchronously.
+  ASSERT_OK(db_->SetDBOptions(
+      {{"compaction_async_readahead_budget", std::to_string(1 << 20)}}));
+  write_files();
+  ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  ASSERT_GT(num_read_async, 0);
+
+  SyncPoint::GetInstance()->DisableProcessing();
+  SyncPoint::GetInstance()->ClearAllCallBacks();
+
+  ASSERT_EQ(0, NumTableFilesAtLevel(0));
+  for (int i = 0; i < 5 * kNumKeys; i++) {
+    ASSERT_EQ(values[i], Get(BuildKey(i)));
+  }
+  Close();
+}
+
 class PrefetchTest1 : public DBTestBase,
                       public ::testing::WithParamInterface<bool> {
  public:
@@ -21,6 +21,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class CacheOwner;
 class Logger;
 class SecondaryCacheResultHandle;
 class Statistics;
@@ -147,6 +148,10 @@ class Cache : public Customizable {
     // primary cache without removal from the secondary cache can be prevented
     // from attempting re-insertion into secondary cache (for efficiency).
     const CacheItemHelper* without_secondary_compat;
+    // The tenant charged for entries inserted with this helper, for per-owner
+    // usage and quotas in a shared cache (see NewCacheOwnerView()). Only set
+    // on the owner-tagged copies of helpers made by such views.
+    CacheOwner* owner = nullptr;
 
     CacheItemHelper() : CacheItemHelper(CacheEntryRole::kMisc) {}
 
@@ -83,6 +83,21 @@ struct CompactionOptionsFIFO {
   // Default: false;
   bool allow_compaction = false;
 
+  // EXPERIMENTAL
+  // When not 0 and `allow_compaction` is true, the intra-L0 compaction only
+  // merges files of the same time window of this many seconds, and only once
+  // the window has ended. A file belongs to the window of its (estimated)
+  // newest key time. The files of an ended window are merged into files of
+  // up to `max_compaction_bytes` each, one compaction at a time, so a window
+  // that fits ends up as a single file. Files never mix data of different
+  // windows, so TTL (see `ttl`) or size-based deletion drops whole windows
+  // without rewriting them. Files of windows that have not ended yet are left
+  // alone. Picking still starts once L0 has
+  // `level0_file_num_compaction_trigger` files.
+  //
+  // Default: 0 (disabled)
+  uint64_t time_window_seconds = 0;
+
   // DEPRECATED
   // When not 0, if the data in the file is older than this threshold, RocksDB
   // will soon move the file to warm temperature.
@@ -953,6 +968,29 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API
   double blob_garbage_collection_force_threshold = 1.0;
 
+  // If the ratio of garbage in any single blob file reaches this threshold,
+  // regardless of the age of the file, a blob garbage collection job is
+  // scheduled for it. The job rewrites in place, one at a time, the SST files
+  // that may reference the blob file, i.e. those whose oldest referenced blob
+  // file is not newer than it, and relocates their blobs from that file and
+  // any older one to new blob files. This rewrites the blobs of the older
+  // blob files too, even if they have little garbage, but is what keeps a
+  // rewritten SST file from being picked again for the same blob file.
+  // Unlike regular compactions, these SST files are not merged into the next
+  // level, and the blob file is dropped once all of them are rewritten. Blob
+  // files without any garbage are never picked. The jobs
+  // run in the BOTTOM priority thread pool when it has threads (see
+  // Env::SetBackgroundThreads()), and like other compactions their writes go
+  // through the rate limiter. This option does not require
+  // enable_blob_garbage_collection and is currently only supported with
+  // leveled compactions. The compaction reason in LOG for these jobs is
+  // "BlobGarbageCollection".
+  //
+  // Default: 1.0 (disabled)
+  //
+  // Dynamically changeable through the SetOptions() API
+  double blob_garbage_collection_file_threshold = 1.0;
+
   // Compaction readahead for blob files.
   //
   // Default: 0
@@ -1089,6 +1127,57 @@ struct AdvancedColumnFamilyOptions {
   // Dynamically changeable through the SetOptions() API.
   uint32_t bottommost_file_compaction_delay = 0;
 
+  // For leveled compaction, a file with range tombstones in a level above the
+  // last non-empty level is picked for compaction when the estimated size of
+  // the data its range tombstones cover in the lower levels is at least this
+  // ratio of the file size. Such a compaction takes the file together with
+  // the overlapping files of all the lower levels and outputs into the last
+  // non-empty level, so the covered data is dropped in one compaction rather
+  // than level by level. Lower level files fully covered by a range tombstone
+  // of a file containing only that range tombstone are dropped without being
+  // read. These compactions are picked before the other compactions marked
+  // for compaction. The compaction reason in LOG for this kind of compactions
+  // is "RangeDeletions".
+  //
+  // Default: 0 (disabled)
+  // Dynamically changeable through the SetOptions() API.
+  double range_deletion_compaction_ratio = 0;
+
+  // For leveled compaction, compacts the files that point lookups keep
+  // reading in vain. When a Get() searches a data block of a file without
+  // finishing the lookup and has to search a data block of another file for
+  // the same key, the first file is charged, based on sampled reads (one in
+  // 1024). Files whose filter rules out the key are not charged. A file
+  // charged about file_size / read_triggered_compaction_bytes_per_lookup
+  // times (and in at least 100 sampled reads, i.e. about 100K reads) is
+  // compacted into the next level, so that hot key ranges spread over many
+  // files and levels are merged sooner. A value around 16KB roughly matches
+  // the cost of a lookup reading an extra file to the cost of compacting that
+  // many bytes. The compaction reason in LOG for this kind
+  // of compactions is "ReadTriggered".
+  //
+  // Default: 0 (disabled)
+  // Dynamically changeable through the SetOptions() API.
+  uint64_t read_triggered_compaction_bytes_per_lookup = 0;
+
+  // For leveled compaction with an `sst_partitioner_factory`, splits L0 into
+  // key-range shards at the partitioner boundaries. A flush cuts its output
+  // into one L0 file per shard, and the L0 files of different shards are
+  // compacted into the base level by concurrent compactions, so that L0 is no
+  // longer drained by a single compaction at a time. A boundary is skipped
+  // while the shard before it holds less than write_buffer_size / 16 bytes,
+  // so a flush writes at most 16 files. The files of one flush
+  // count as a single file for level0_file_num_compaction_trigger and the
+  // write stall triggers. Intra-L0 compactions are not picked while L0 holds
+  // such files. The partitioner is asked for the boundaries with
+  // SstPartitioner::Context::output_level = 0 and empty smallest and largest
+  // keys. Flushes of memtables with range deletions and column families with
+  // user-defined timestamps are not split.
+  //
+  // Default: false
+  // Dynamically changeable through the SetOptions() API.
+  bool shard_level0_by_sst_partitioner = false;
+
   // Enables additional integrity checks during reads/scans.
   // Specifically, for skiplist-based memtables, we verify that keys visited
   // are in order. This is helpful to detect corrupted memtable keys during
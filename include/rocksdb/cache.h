@@ -15,6 +15,7 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "rocksdb/compression_type.h"
 #include "rocksdb/data_structure.h"
@@ -24,6 +25,7 @@ namespace ROCKSDB_NAMESPACE {
 
 class Cache;  // defined in advanced_cache.h
 struct ConfigOptions;
+class FileSystem;
 class SecondaryCache;
 
 // These definitions begin source compatibility for a future change in which
@@ -107,6 +109,11 @@ struct BlockCacheEntryStatsMapKeys {
   static std::string EntryCount(CacheEntryRole);
   static std::string UsedBytes(CacheEntryRole);
   static std::string UsedPercent(CacheEntryRole);
+
+  // For block cache owners, see NewCacheOwnerView()
+  static std::string OwnerUsedBytes(const std::string& owner_name);
+  static std::string OwnerHits(const std::string& owner_name);
+  static std::string OwnerMisses(const std::string& owner_name);
 };
 
 extern const bool kDefaultToAdaptiveMutex;
@@ -313,6 +320,35 @@ struct CompressedSecondaryCacheOptions : LRUCacheOptions {
   // (Filter blocks are essentially non-compressible but others usually are.)
   CacheEntryRoleSet do_not_compress_roles = {CacheEntryRole::kFilterBlock};
 
+  // The compression method for cold entries, if different from
+  // compression_type. An entry is hot if it was hit in the primary cache
+  // before its eviction (as known from the TieredAdmissionPolicy), or if it
+  // was hit in this cache before going back to the primary cache. Other
+  // entries are cold, and less likely to be read again, so a slower method
+  // with a better ratio (e.g. kZSTD) makes room for more of them while hot
+  // entries keep the faster compression_type (e.g. kLZ4Compression). With
+  // compression_type kNoCompression, only cold entries are compressed.
+  // kDisableCompressionOption, or a method not supported by this build,
+  // means compression_type for all entries. Ignored with
+  // enable_custom_split_merge.
+  //
+  // Regardless of this option, entries that do not compress below
+  // compression_opts.max_compressed_bytes_per_kb are stored uncompressed
+  // (except with enable_custom_split_merge), and entries already
+  // compressed (see SecondaryCache::InsertSaved()) are stored as is.
+  CompressionType cold_compression_type = kDisableCompressionOption;
+
+  // If > 0, entries evicted from the primary cache are compressed by this
+  // many background threads rather than by the evicting thread, which only
+  // copies the entry. An entry can only be found in this cache once
+  // compressed.
+  int compression_threads = 0;
+
+  // With compression_threads > 0, the max total size of the entries waiting
+  // to be compressed. Beyond it, entries are compressed by the evicting
+  // thread.
+  size_t max_pending_compression_bytes = 8 << 20;
+
   CompressedSecondaryCacheOptions() {}
   CompressedSecondaryCacheOptions(
       size_t _capacity, int _num_shard_bits, bool _strict_capacity_limit,
@@ -371,6 +407,76 @@ inline std::shared_ptr<SecondaryCache> NewCompressedSecondaryCache(
   return opts.MakeSharedSecondaryCache();
 }
 
+// Statistics of a CompressedSecondaryCache, about the entries inserted since
+// its creation, by the compression method they are stored with
+// (kNoCompression for entries stored uncompressed). The counters are
+// cumulative: they are not decreased when entries are evicted or erased.
+struct CompressedSecondaryCacheCodecStats {
+  CompressionType type = kNoCompression;
+  uint64_t num_inserted_entries = 0;
+  // Total size of the inserted entries before and after compression
+  uint64_t inserted_uncompressed_bytes = 0;
+  uint64_t inserted_stored_bytes = 0;
+  // The part of the cache capacity these entries would take if the cache
+  // held the compression methods in the proportions they were inserted with
+  // (of inserted_stored_bytes), times their compression ratio: an estimate
+  // of how much uncompressed data that part holds.
+  uint64_t effective_capacity = 0;
+};
+
+struct CompressedSecondaryCacheStats {
+  size_t capacity = 0;
+  // Sum of effective_capacity over the compression methods
+  uint64_t effective_capacity = 0;
+  // Entries waiting for a background thread to compress them
+  uint64_t pending_compression_entries = 0;
+  uint64_t pending_compression_bytes = 0;
+  std::vector<CompressedSecondaryCacheCodecStats> codecs;
+};
+
+// Fills `*stats` for a SecondaryCache created from
+// CompressedSecondaryCacheOptions, or returns InvalidArgument for other
+// secondary caches.
+Status GetCompressedSecondaryCacheStats(const SecondaryCache& secondary_cache,
+                                        CompressedSecondaryCacheStats* stats);
+
+// EXPERIMENTAL
+// Options for NewNvmSecondaryCache()
+struct NvmSecondaryCacheOptions {
+  // Path of the file holding the cached blocks, normally on local flash.
+  // Any existing file at this path is overwritten; the cache contents do not
+  // survive reopening.
+  std::string path;
+
+  // Size of the cache file, in bytes. Must be at least `region_size`.
+  size_t capacity = 0;
+
+  // The file is written as a log of regions of this size. A region is filled
+  // in memory and then written out with a single sequential write. Once the
+  // file is full, the oldest region is reused, evicting all the blocks in it.
+  // Blocks larger than a region are not cached.
+  size_t region_size = 16 << 20;
+
+  // File system holding the cache file, or nullptr for FileSystem::Default().
+  // Lookups without waiting are issued with FSRandomAccessFile::ReadAsync()
+  // (io_uring in the default file system, when available), so that lookups
+  // of several blocks, e.g. for a MultiGet, are served in parallel. As
+  // io_uring queues are per thread, the handles returned by such a lookup
+  // must be waited on by the thread that made it.
+  std::shared_ptr<FileSystem> fs;
+};
+
+// EXPERIMENTAL
+// Creates a SecondaryCache on local flash (or other non-volatile storage
+// with low latency), with the on-disk layout described above and an
+// in-memory index of the cached blocks. It admits the blocks evicted from
+// the primary cache when used as LRUCacheOptions::secondary_cache, or the
+// blocks read from SST files when used as TieredCacheOptions::nvm_sec_cache.
+// This is most useful when the SST files are on slower storage, such as
+// HDDs or network attached storage.
+Status NewNvmSecondaryCache(const NvmSecondaryCacheOptions& opts,
+                            std::shared_ptr<SecondaryCache>* result);
+
 // HyperClockCache - A lock-free Cache alternative for RocksDB block cache
 // that offers much improved CPU efficiency vs. LRUCache under high parallel
 // load or high contention, with some caveats:
@@ -576,4 +682,57 @@ Status UpdateTieredCache(
     const std::shared_ptr<Cache>& cache, int64_t total_capacity = -1,
     double compressed_secondary_ratio = std::numeric_limits<double>::max(),
     TieredAdmissionPolicy adm_policy = TieredAdmissionPolicy::kAdmPolicyMax);
+
+// EXPERIMENTAL
+// Options for NewTinyLfuAdmissionCache()
+struct TinyLfuAdmissionOptions {
+  // Expected average charge of the entries subject to admission filtering.
+  // Together with the capacity of the wrapped cache, this sizes the sketch of
+  // access frequencies, which takes about 4 bytes per expected entry.
+  size_t estimated_entry_charge = 8 * 1024;
+  // Roles of the entries subject to admission filtering. Other entries,
+  // including cache reservations, are always inserted.
+  CacheEntryRoleSet filtered_roles = {CacheEntryRole::kDataBlock};
+};
+
+// EXPERIMENTAL
+// Returns a cache that wraps `target` and filters the insertion of new
+// entries in the style of TinyLFU. Accesses are recorded in a compact
+// count-min sketch of key frequencies (aged by periodic halving), and once
+// `target` is full, a new entry is admitted only if its key is estimated to
+// be hotter than the entries it would displace. This keeps one-off accesses,
+// such as a large scan with fill_cache=true, from evicting a long-lived hot
+// working set. Inserts that are not admitted still succeed, as if the entry
+// were evicted right away. `target` must be an LRU cache (see NewLRUCache());
+// returns nullptr otherwise.
+std::shared_ptr<Cache> NewTinyLfuAdmissionCache(
+    std::shared_ptr<Cache> target,
+    const TinyLfuAdmissionOptions& opts = TinyLfuAdmissionOptions());
+
+// EXPERIMENTAL
+// Options for NewCacheOwnerView()
+struct CacheOwnerOptions {
+  // Identifies the owner (tenant) in block cache entry stats. Owners are
+  // scoped to the cache the view is attached to: views of the same cache
+  // with the same name share the owner, and must have the same quotas.
+  std::string name;
+  // Once the owner uses more than this, its new entries are inserted with
+  // the lowest priority, so that they are the first to be evicted and other
+  // owners keep their working sets. 0 for no soft quota.
+  size_t soft_quota = 0;
+  // Entries that would take the owner over this are not kept in the cache,
+  // as if they were evicted right away. 0 for no hard quota.
+  size_t hard_quota = 0;
+};
+
+// EXPERIMENTAL
+// Returns a view of the shared `cache` that charges the block entries
+// inserted through it to one owner, such as a column family or a tenant
+// whose column families use the view as their `block_cache`. The usage of
+// each owner is tracked by the LRU and HyperClock caches, and reported with
+// its hits and misses in the block cache entry stats. Cache reservations and
+// other non-block entries are not charged to owners. Returns nullptr if a
+// live view of `cache` with the same name has other quotas.
+std::shared_ptr<Cache> NewCacheOwnerView(std::shared_ptr<Cache> cache,
+                                         const CacheOwnerOptions& opts);
 }  // namespace ROCKSDB_NAMESPACE
@@ -168,6 +168,38 @@ struct CompressionOptions {
   // decompression.
   bool checksum = false;
 
+  // Only relevant when parallel compression is enabled (parallel_threads > 1).
+  // If true, data blocks are compressed on a process-wide thread pool shared
+  // by all table builders (sized to the number of CPU cores), instead of on
+  // `parallel_threads` threads owned by each builder. This avoids
+  // oversubscribing the CPU when many flushes and compactions run at the same
+  // time, and lets idle threads pick up blocks of whichever builder has work.
+  // `parallel_threads` still bounds the number of blocks of a single file that
+  // can be in flight. Block order within each file is preserved.
+  bool use_shared_parallel_pool = false;
+
+  // Only relevant when `use_shared_parallel_pool` is true, and only for
+  // compression types with a notion of level (zlib, LZ4HC and ZSTD).
+  // If true, a data block picked up while the shared pool has a backlog of
+  // more pending blocks than threads is compressed at the fastest level
+  // instead of `level`, so that compression keeps up with the rate at which
+  // blocks are produced. Files may end up somewhat larger as a result.
+  bool adaptive_parallel_level = false;
+
+  // Only relevant when dictionary compression is enabled (`max_dict_bytes > 0`)
+  // and only for BlockBasedTable. If nonzero, a dictionary trained for an
+  // output file is reused by up to this many subsequent output files of the
+  // same column family and LSM level (written through the same table
+  // factory), which then skip buffering their data and training a dictionary
+  // of their own. Once the budget is used up, the next file trains a fresh
+  // dictionary, so the dictionary keeps following the data.
+  //
+  // Each file still stores the dictionary it was compressed with. Table
+  // readers of files that share a dictionary also share a single in-memory
+  // copy of it, unless the dictionary is kept in the block cache (see
+  // `BlockBasedTableOptions::cache_index_and_filter_blocks`).
+  uint32_t max_dict_reuse_files = 0;
+
   // A convenience function for setting max_compressed_bytes_per_kb based on a
   // minimum acceptable compression ratio (uncompressed size over compressed
   // size).
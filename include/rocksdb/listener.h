@@ -157,6 +157,15 @@ enum class CompactionReason : int {
   // [InternalOnly] DBImpl::ReFitLevel treated as a compaction,
   // Used only for internal conflict checking with other compactions
   kRefitLevel,
+  // Compaction pushing range tombstones covering much data to the last level.
+  // See AdvancedColumnFamilyOptions::range_deletion_compaction_ratio.
+  kRangeDeletions,
+  // Compaction of files that point lookups often read in vain.
+  // See AdvancedColumnFamilyOptions::read_triggered_compaction_bytes_per_lookup
+  kReadTriggered,
+  // Rewrite of the files referencing a blob file with much garbage.
+  // See AdvancedColumnFamilyOptions::blob_garbage_collection_file_threshold
+  kBlobGarbageCollection,
   // total number of compaction reasons, new reasons must be added above this.
   kNumOfReasons,
 };
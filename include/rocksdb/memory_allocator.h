@@ -84,4 +84,73 @@ Status NewJemallocNodumpAllocator(
     const JemallocAllocatorOptions& options,
     std::shared_ptr<MemoryAllocator>* memory_allocator);
 
+struct HugePageAllocatorOptions {
+  static const char* kName() { return "HugePageAllocatorOptions"; }
+  // Size of the huge pages to back allocations with, typically 2MB or 1GB.
+  // Pages of the size must be reserved in the system (e.g. through
+  // /sys/kernel/mm/hugepages/hugepages-<size>kB/nr_hugepages). Must be a
+  // power of two.
+  size_t huge_page_size = 2 << 20;
+
+  // Memory is mapped from the system in regions of this size, rounded up to
+  // a multiple of huge_page_size. Regions are carved into slabs, each serving
+  // allocations of one size class.
+  size_t region_size = 64 << 20;
+
+  // Allocations larger than this are not served from the regions but by
+  // malloc, as are all allocations once the regions cannot grow.
+  size_t max_slab_allocation_size = 256 << 10;
+
+  // Limit on the total size of the regions, or 0 for no limit. Memory of the
+  // regions is only returned to the system when the allocator is destroyed,
+  // and a slab only serves allocations of its size class.
+  size_t max_region_bytes = 0;
+
+  // Keep a small per-core list of freed blocks of each size class, so that
+  // most allocations and deallocations take no shared lock.
+  bool per_core_cache = true;
+
+  // When huge pages of huge_page_size cannot be mapped (none reserved, or not
+  // supported by the platform), map regular pages for the regions, aligned
+  // and advised for transparent huge pages where supported. If false, or if
+  // that fails too, allocations fall back to malloc.
+  bool fallback_to_regular_pages = true;
+};
+
+struct HugePageAllocatorStats {
+  // Size of the regions mapped from the system
+  size_t mapped_bytes = 0;
+  // Of which mapped with huge pages (rather than regular pages)
+  size_t huge_page_bytes = 0;
+  // Size of the slabs carved out of the regions
+  size_t slab_bytes = 0;
+  // Size of the slab slots of live allocations (including a small header)
+  size_t allocated_bytes = 0;
+  // Sizes requested by live allocations served from slabs
+  size_t requested_bytes = 0;
+  // Live allocations served by malloc, and their total size
+  size_t fallback_allocations = 0;
+  size_t fallback_bytes = 0;
+
+  // Share of the slab memory not holding requested bytes, from rounding up
+  // to size classes (internal fragmentation) and from slots that are free or
+  // not yet used (external fragmentation)
+  double FragmentationRatio() const {
+    return slab_bytes == 0
+               ? 0.0
+               : 1.0 - static_cast<double>(requested_bytes) / slab_bytes;
+  }
+};
+
+// Generate a memory allocator that serves allocations (e.g. of block cache
+// entries) from size-classed slabs in regions of huge pages, reducing TLB
+// misses in large caches. See HugePageAllocatorOptions.
+Status NewHugePageAllocator(const HugePageAllocatorOptions& options,
+                            std::shared_ptr<MemoryAllocator>* memory_allocator);
+
+// Fills `*stats` for an allocator created by NewHugePageAllocator(), or
+// returns InvalidArgument for other allocators.
+Status GetHugePageAllocatorStats(const MemoryAllocator& memory_allocator,
+                                 HugePageAllocatorStats* stats);
+
 }  // namespace ROCKSDB_NAMESPACE
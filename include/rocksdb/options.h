@@ -878,6 +878,22 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   uint32_t max_subcompactions = 1;
 
+  // EXPERIMENTAL
+  // When a compaction is split into subcompactions (see
+  // `max_subcompactions`), split it into up to this many key ranges per
+  // subcompaction thread. Each thread compacts one range and, when done,
+  // takes over the next range not yet started, so threads that finish early
+  // pick up work that would otherwise be left to the slowest one. Ranges are
+  // no smaller than the target file size of the output level, and output
+  // files are cut at range boundaries. Not applied with the kRoundRobin
+  // compaction priority, which already plans one subcompaction per input
+  // file.
+  //
+  // Default: 1 (one range per thread)
+  //
+  // Dynamically changeable through SetDBOptions() API.
+  uint32_t subcompaction_ranges_per_thread = 1;
+
   // DEPRECATED: RocksDB automatically decides this based on the
   // value of max_background_jobs. For backwards compatibility we will set
   // `max_background_jobs = max_background_compactions + max_background_flushes`
@@ -1084,6 +1100,23 @@ struct DBOptions {
   // Dynamically changeable through SetDBOptions() API.
   size_t compaction_readahead_size = 2 * 1024 * 1024;
 
+  // EXPERIMENTAL
+  // If non-zero, and the file system supports asynchronous reads (see
+  // FSSupportedOps::kAsyncIO, e.g. the POSIX file system with io_uring),
+  // compactions read ahead of every input file asynchronously, so that the
+  // next blocks of all input files are in flight while the compaction merges
+  // the current ones. This is the total readahead memory of a compaction: it
+  // is divided evenly between the input files read at the same time by each
+  // subcompaction (every L0 file and one file per other input level), and
+  // overrides `compaction_readahead_size` for those files. Each file reads
+  // half of its share synchronously and the other half asynchronously,
+  // double-buffered. Not applied with direct reads.
+  //
+  // Default: 0 (disabled)
+  //
+  // Dynamically changeable through SetDBOptions() API.
+  size_t compaction_async_readahead_budget = 0;
+
   // This is the maximum buffer size that is used by WritableFileWriter.
   // With direct IO, we need to maintain an aligned buffer for writes.
   // We allow the buffer to grow until it's size hits the limit in buffered
@@ -1303,6 +1336,21 @@ struct DBOptions {
   // Default: nullptr (disabled)
   std::shared_ptr<RowCache> row_cache = nullptr;
 
+  // EXPERIMENTAL
+  // A global cache for the results of Get() by column family and user key,
+  // consulted before the memtables and SST files. Unlike `row_cache`, its
+  // entries do not depend on the SST files holding the keys, so they survive
+  // compactions. Entries are invalidated by writes to their keys, while
+  // range deletions, file ingestion and file deletion invalidate all
+  // entries. Reads with user-defined timestamps, a read tier other than
+  // kReadAllTier, or from transactions, and column families with a
+  // compaction filter or FIFO compaction, bypass the cache.
+  // Not compatible with unordered_write or two_write_queues, and ignored by
+  // read-only and secondary instances and by WritePrepared and
+  // WriteUnprepared TransactionDBs.
+  // Default: nullptr (disabled)
+  std::shared_ptr<RowCache> user_key_row_cache = nullptr;
+
   // A filter object supplied to be invoked while processing write-ahead-logs
   // (WALs) during recovery. The filter provides a way to inspect log
   // records, ignoring a particular record or skipping replay.
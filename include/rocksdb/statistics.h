@@ -535,6 +535,20 @@ enum Tickers : uint32_t {
   FILE_READ_CORRUPTION_RETRY_COUNT,
   FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT,
 
+  // Decisions of the memory tuner (see MemoryTunerOptions): number of tuning
+  // rounds, and bytes of budget moved into and out of each consumer
+  MEMORY_TUNER_ROUNDS,
+  MEMORY_TUNER_BLOCK_CACHE_GROWN_BYTES,
+  MEMORY_TUNER_BLOCK_CACHE_SHRUNK_BYTES,
+  MEMORY_TUNER_WRITE_BUFFER_GROWN_BYTES,
+  MEMORY_TUNER_WRITE_BUFFER_SHRUNK_BYTES,
+  MEMORY_TUNER_SECONDARY_CACHE_GROWN_BYTES,
+  MEMORY_TUNER_SECONDARY_CACHE_SHRUNK_BYTES,
+
+  // Get() hits and misses in DBOptions::user_key_row_cache
+  USER_KEY_ROW_CACHE_HIT,
+  USER_KEY_ROW_CACHE_MISS,
+
   TICKER_ENUM_MAX
 };
 
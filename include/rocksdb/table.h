@@ -106,6 +106,18 @@ struct MetadataCacheOptions {
   // any effect. Otherwise the unpartitioned meta-blocks would be held in table
   // reader memory, outside the block cache.
   PinningTier unpartitioned_pinning = PinningTier::kFallback;
+
+  // If non-zero, index and filter partitions of tables that are not pinned
+  // according to `partition_pinning` are pinned adaptively, based on how
+  // frequently they are accessed. The most frequently accessed partitions are
+  // kept pinned in the block cache as long as the total charge of adaptively
+  // pinned partitions, across all tables opened through the same table
+  // factory, stays within this many bytes. Partitions are unpinned again when
+  // they become cold, so the set of pinned partitions follows the workload.
+  //
+  // Only takes effect with a block cache and with partitioned indexes
+  // (`kTwoLevelIndexSearch`) and/or partitioned filters.
+  size_t hot_partition_pinning_budget = 0;
 };
 
 struct CacheEntryRoleOptions {
@@ -180,6 +192,16 @@ struct BlockBasedTableOptions {
   // to be evicted than data blocks.
   bool cache_index_and_filter_blocks_with_high_priority = true;
 
+  // If positive, a user iterator that has read this many consecutive data
+  // blocks of a file (a sequential scan) inserts the data blocks it reads
+  // next into the block cache with Cache::Priority::BOTTOM rather than LOW,
+  // so that long scans do not evict blocks of point lookups, while blocks
+  // referenced again are retained as usual. With HyperClockCache, such
+  // blocks are evicted first unless referenced again; with LRUCache, they
+  // are only distinguished from other data blocks with low_pri_pool_ratio >
+  // 0. Reads with fill_cache=false are unaffected (not inserted).
+  uint32_t scan_bottom_priority_threshold = 0;
+
   // DEPRECATED: This option will be removed in a future version. For now, this
   // option still takes effect by updating each of the following variables that
   // has the default value, `PinningTier::kFallback`:
@@ -536,6 +558,18 @@ struct BlockBasedTableOptions {
   // Default: 0 (disabled)
   uint32_t read_amp_bytes_per_bit = 0;
 
+  // If non-zero, the table builder samples between this many and twice as
+  // many keys that divide the file into ranges of similar size (in key and
+  // value bytes), and stores them in the table properties. Compactions then
+  // use these anchors, instead of the data block boundaries read from the
+  // index, to split the input into subcompactions of equal work. This gives
+  // more balanced subcompactions with skewed key distributions and when the
+  // input is dominated by one large file. Files written without anchors
+  // still use the index. See also `DBOptions::subcompaction_ranges_per_thread`.
+  //
+  // Default: 0 (disabled)
+  uint32_t num_sampled_key_anchors = 0;
+
   // We currently have these format versions:
   // 0 - 1 -- Unsupported for writing new files and quietly sanitized to 2.
   // Read support is deprecated and could be removed in the future.
@@ -578,6 +612,23 @@ struct BlockBasedTableOptions {
   // Align data blocks on lesser of page size and block size
   bool block_align = false;
 
+  // If true, data blocks of files that contain no compressed blocks and are
+  // read through memory mapping (DBOptions::allow_mmap_reads) are served
+  // directly out of the mapping. They are neither looked up in nor inserted
+  // into the block cache, and are not charged to it, so the OS page cache
+  // holds the only copy of the data. The checksum of a data block of 1KB or
+  // more is verified (if ReadOptions::verify_checksums) only on the first
+  // read of that block through a given table reader, rather than on every
+  // read. It is not verified again when the OS evicts the block's pages and
+  // reads them back in, so corruption introduced by the storage after the
+  // first read goes undetected. Smaller data blocks are verified on every
+  // read. Tracking takes one bit of memory per 1KB of file.
+  //
+  // Files with compression, and files that turn out not to be memory mapped,
+  // are read as usual. Values are still only pinned (see PinnableSlice)
+  // without copying for immortal tables, as with any other unowned block.
+  bool mmap_zero_copy_data_blocks = false;
+
   // This enum allows trading off increased index size for improved iterator
   // seek performance in some situations, particularly when block cache is
   // disabled (ReadOptions::fill_cache = false) and direct IO is
@@ -647,11 +698,26 @@ struct BlockBasedTableOptions {
     kDisable,
     // Prepopulate blocks during flush only.
     kFlushOnly,
+    // Prepopulate blocks during flush, like kFlushOnly. In addition, during
+    // compaction, prepopulate the output data blocks whose key range was hot
+    // in the input, i.e. covered by input data blocks that are resident in
+    // the block cache, up to `prepopulate_block_cache_compaction_budget`
+    // bytes per compaction. This avoids a burst of cache misses on hot keys
+    // after they get compacted into new files.
+    kFlushAndHotCompaction,
   };
 
   PrepopulateBlockCache prepopulate_block_cache =
       PrepopulateBlockCache::kDisable;
 
+  // Only relevant with `prepopulate_block_cache = kFlushAndHotCompaction`.
+  // Upper bound on the (uncompressed) bytes of output data blocks inserted
+  // into the block cache by a single compaction. Zero disables warming on
+  // compaction.
+  //
+  // Default: 64 MB
+  uint64_t prepopulate_block_cache_compaction_budget = 64 << 20;
+
   // RocksDB does auto-readahead for iterators on noticing more than two reads
   // for a table file if user doesn't provide readahead_size. The readahead size
   // starts at initial_auto_readahead_size and doubles on every additional read
@@ -708,6 +774,11 @@ struct BlockBasedTablePropertyNames {
   // filter+index partitioning is ever developed; that optimization/assumption
   // would be disabled when this is set.
   static const std::string kDecoupledPartitionedFilters;
+  // Keys sampled by the table builder with `num_sampled_key_anchors`. Value
+  // is the number of anchors (varint32), then for each anchor its user key
+  // (length prefixed) and the key and value bytes of the range ending at
+  // that key (varint64), in key order.
+  static const std::string kKeyAnchors;
 };
 
 // Create default block based table factory.
@@ -111,6 +111,38 @@ class CompactionOptionsUniversal {
   // Default: false
   bool incremental;
 
+  // EXPERIMENTAL
+  // If > 0, use "lazy leveling" instead of the size ratio rule (size_ratio,
+  // stop_style and min_merge_width) to pick compactions reducing the number
+  // of sorted runs. Sorted runs other than the oldest one are grouped into
+  // tiers by size: tier i holds runs of about write_buffer_size * K^i bytes,
+  // where K is this option. Once a tier holds K consecutive runs, they are
+  // merged into one run of the next tier, so each byte is rewritten about
+  // once per tier. The oldest sorted run is kept as a single run, which the
+  // others are merged into once their size reaches
+  // max_size_amplification_percent of it (see above), as in leveled
+  // compaction with a size ratio of 100 / max_size_amplification_percent.
+  // This gives a write amplification close to that of the default universal
+  // compaction with a read amplification of at most about K - 1 runs per
+  // tier, most of the data being in the oldest run.
+  //
+  // level0_file_num_compaction_trigger should be at most K, as it is also
+  // the number of sorted runs from which compactions are considered. The
+  // max_read_amp limit only applies when set to N > 0.
+  //
+  // Default: 0 (disabled)
+  unsigned int lazy_leveling_runs_per_tier;
+
+  // EXPERIMENTAL
+  // With lazy_leveling_runs_per_tier > 0 and DBOptions::statistics set, the
+  // number of runs per tier is chosen between 2 and
+  // lazy_leveling_runs_per_tier by a cost model, from the numbers of keys
+  // written and read (including seeks) so far: more runs per tier for write
+  // heavy workloads, and fewer for read heavy ones.
+  //
+  // Default: false
+  bool lazy_leveling_auto_tune;
+
   // Default set of parameters
   CompactionOptionsUniversal()
       : size_ratio(1),
@@ -121,7 +153,9 @@ class CompactionOptionsUniversal {
         max_read_amp(-1),
         stop_style(kCompactionStopStyleTotalSize),
         allow_trivial_move(false),
-        incremental(false) {}
+        incremental(false),
+        lazy_leveling_runs_per_tier(0),
+        lazy_leveling_auto_tune(false) {}
 
 #if __cplusplus >= 202002L
   bool operator==(const CompactionOptionsUniversal& rhs) const = default;
@@ -0,0 +1,101 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "rocksdb/env.h"
+#include "rocksdb/options.h"
+#include "rocksdb/status.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// NOTE that: this is EXPERIMENTAL! May be changed in the future!
+// Options for a CompactionService that runs the compactions of a DB in
+// worker processes on the same host, e.g. to limit their CPU and memory
+// with cgroups separately from the DB process.
+//
+// Each compaction job gets a directory under `work_dir` holding its
+// serialized input. The service starts a worker process for the job with
+//
+//   <worker_command...> --db=<db name> --job_dir=<job directory>
+//
+// and waits for it to exit. The worker (see
+// LocalCompactionServiceWorkerMain()) runs DB::OpenAndCompact() with the
+// output directory in the job directory and writes the serialized result
+// next to the input. The DB then installs the output files by renaming them,
+// so `work_dir` must be on the same file system as the DB. A job whose
+// worker fails is retried with a new worker, up to `max_attempts` times.
+// The job directory is removed once the result is installed. Job directories
+// left by an earlier run of the DB, e.g. one that crashed, are removed when
+// the reopened DB schedules its first compaction.
+//
+// Only available on POSIX platforms. Elsewhere, all compactions run locally.
+struct LocalCompactionServiceOptions {
+  // Required: the worker executable, resolved through PATH if it contains no
+  // slash, followed by any arguments. This can be a wrapper putting the
+  // worker in a cgroup, e.g. {"cgexec", "-g", "cpu,memory:compaction",
+  // "/path/to/compaction_service_worker"}.
+  std::vector<std::string> worker_command;
+
+  // The directory for the job directories, created if missing. When empty,
+  // a "local_compaction_jobs" directory in the DB directory is used. It must
+  // not be shared with DBs that use another compaction service, since the
+  // directories of their jobs would be taken as stale.
+  std::string work_dir;
+
+  // Maximum number of worker processes running at a time. Compactions wait
+  // for a free worker beyond that.
+  int max_workers = 4;
+
+  // Number of times a job is started before giving up on it
+  int max_attempts = 2;
+
+  // What to do with a job that failed `max_attempts` times: run the
+  // compaction in the DB process if true, or else fail the compaction.
+  bool fallback_to_local = true;
+
+  // Optional: only jobs for which this returns true are sent to workers,
+  // e.g. to offload only compactions into the last levels. The others run in
+  // the DB process.
+  std::function<bool(const CompactionServiceJobInfo&)> offload_filter;
+
+  Env* env = Env::Default();
+};
+
+// Creates a CompactionService for DBOptions::compaction_service, sending the
+// compactions of the DB to local worker processes. See
+// LocalCompactionServiceOptions.
+std::shared_ptr<CompactionService> NewLocalCompactionService(
+    const LocalCompactionServiceOptions& options);
+
+// Runs the compaction job in `job_dir` of the DB `db_name`, as a worker of a
+// local compaction service, and stores the result in the job directory.
+// Options that cannot be serialized in `override_options.options_map`, when
+// left empty (the comparator when left as the bytewise comparator), are
+// created from the OPTIONS file of the DB, which requires custom objects to
+// be registered in the ObjectRegistry. This includes the compaction filter
+// factory, but not a compaction filter set as `compaction_filter`, which
+// must be set in `override_options` if needed. Returns the status of the
+// compaction, which is also part of the result.
+Status RunLocalCompactionServiceJob(
+    const std::string& db_name, const std::string& job_dir,
+    CompactionServiceOptionsOverride override_options);
+
+// The main() of a worker process for a local compaction service, parsing the
+// --db= and --job_dir= arguments given by the service and running the job
+// with `override_options`. Returns the exit code of the process. A custom
+// worker, e.g. one registering custom objects or setting a compaction
+// filter, can call this from its own main().
+int LocalCompactionServiceWorkerMain(
+    int argc, char** argv,
+    const CompactionServiceOptionsOverride& override_options =
+        CompactionServiceOptionsOverride());
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,90 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+
+#include "rocksdb/secondary_cache.h"
+#include "rocksdb/statistics.h"
+#include "rocksdb/status.h"
+#include "rocksdb/system_clock.h"
+#include "rocksdb/utilities/sim_cache.h"
+#include "rocksdb/write_buffer_manager.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// NOTE that: this is EXPERIMENTAL! May be changed in the future!
+// Options for a MemoryTuner, which keeps the combined size of the block
+// cache, the memtables (through a WriteBufferManager) and a secondary cache
+// within a fixed total, periodically moving budget between them:
+//
+// * When writes were stalled in the last period, budget moves from the cache
+//   expected to lose the fewest hits to the memtables.
+// * Otherwise, when memtables used under half of their budget, budget moves
+//   from the memtables to the cache expected to gain the most hits.
+// * Otherwise, budget moves from one cache to the other when the expected
+//   gain clearly exceeds the expected loss.
+//
+// The expected hits of the block cache for one more `step_size` are measured
+// with a ghost cache: the block cache must be a SimCache whose simulated
+// capacity is kept at its capacity plus `step_size` by the tuner. Those of
+// the secondary cache are estimated from its recent hits, assuming they are
+// spread evenly over its capacity.
+struct MemoryTunerOptions {
+  // The fixed total shared by the consumers. Any part of it not used by their
+  // sizes when the tuner is created is given to the block cache.
+  size_t total_budget = 0;
+
+  // Required, see above
+  std::shared_ptr<SimCache> block_cache;
+
+  // Optional. Must be enabled (non-zero buffer size) when provided.
+  std::shared_ptr<WriteBufferManager> write_buffer_manager;
+
+  // Optional, e.g. a CompressedSecondaryCache
+  std::shared_ptr<SecondaryCache> secondary_cache;
+
+  // Required: the Statistics of the DB(s) using these consumers. Block cache
+  // hits, secondary cache hits and write stall time are read from it, and
+  // the decisions of the tuner are recorded in it (MEMORY_TUNER_* tickers).
+  std::shared_ptr<Statistics> statistics;
+
+  // Amount of budget moved by one decision
+  size_t step_size = 64 << 20;
+
+  // Each consumer keeps at least this fraction of the total budget
+  double min_fraction = 0.1;
+
+  // Run a tuning round every this many seconds. 0 to only tune on calls to
+  // MemoryTuner::TuneOnce().
+  uint64_t tune_period_sec = 60;
+
+  // For scheduling the tuning rounds. nullptr for SystemClock::Default().
+  std::shared_ptr<SystemClock> clock;
+};
+
+// NOTE that: this class is EXPERIMENTAL! May be changed in the future!
+// See MemoryTunerOptions. The tuning rounds stop when the tuner is destroyed.
+class MemoryTuner {
+ public:
+  virtual ~MemoryTuner() = default;
+
+  // Runs a tuning round now, based on what happened since the last round
+  virtual void TuneOnce() = 0;
+
+  // The current budget of each consumer (0 when not provided)
+  virtual size_t GetBlockCacheBudget() const = 0;
+  virtual size_t GetWriteBufferBudget() const = 0;
+  virtual size_t GetSecondaryCacheBudget() const = 0;
+};
+
+// Creates a MemoryTuner, starting its periodic tuning rounds
+Status NewMemoryTuner(const MemoryTunerOptions& options,
+                      std::unique_ptr<MemoryTuner>* tuner);
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -5273,6 +5273,24 @@ class TickerTypeJni {
         return -0x56;
       case ROCKSDB_NAMESPACE::Tickers::FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT:
         return -0x57;
+      case ROCKSDB_NAMESPACE::Tickers::MEMORY_TUNER_ROUNDS:
+        return -0x58;
+      case ROCKSDB_NAMESPACE::Tickers::MEMORY_TUNER_BLOCK_CACHE_GROWN_BYTES:
+        return -0x59;
+      case ROCKSDB_NAMESPACE::Tickers::MEMORY_TUNER_BLOCK_CACHE_SHRUNK_BYTES:
+        return -0x5A;
+      case ROCKSDB_NAMESPACE::Tickers::MEMORY_TUNER_WRITE_BUFFER_GROWN_BYTES:
+        return -0x5B;
+      case ROCKSDB_NAMESPACE::Tickers::MEMORY_TUNER_WRITE_BUFFER_SHRUNK_BYTES:
+        return -0x5C;
+      case ROCKSDB_NAMESPACE::Tickers::MEMORY_TUNER_SECONDARY_CACHE_GROWN_BYTES:
+        return -0x5D;
+      case ROCKSDB_NAMESPACE::Tickers::MEMORY_TUNER_SECONDARY_CACHE_SHRUNK_BYTES:
+        return -0x5E;
+      case ROCKSDB_NAMESPACE::Tickers::USER_KEY_ROW_CACHE_HIT:
+        return -0x5F;
+      case ROCKSDB_NAMESPACE::Tickers::USER_KEY_ROW_CACHE_MISS:
+        return -0x60;
       case ROCKSDB_NAMESPACE::Tickers::TICKER_ENUM_MAX:
         // -0x54 is the max value at this time. Since these values are exposed
         // directly to Java clients, we'll keep the value the same till the next
@@ -5735,6 +5753,29 @@ class TickerTypeJni {
       case -0x57:
         return ROCKSDB_NAMESPACE::Tickers::
             FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT;
+      case -0x58:
+        return ROCKSDB_NAMESPACE::Tickers::MEMORY_TUNER_ROUNDS;
+      case -0x59:
+        return ROCKSDB_NAMESPACE::Tickers::MEMORY_TUNER_BLOCK_CACHE_GROWN_BYTES;
+      case -0x5A:
+        return ROCKSDB_NAMESPACE::Tickers::
+            MEMORY_TUNER_BLOCK_CACHE_SHRUNK_BYTES;
+      case -0x5B:
+        return ROCKSDB_NAMESPACE::Tickers::
+            MEMORY_TUNER_WRITE_BUFFER_GROWN_BYTES;
+      case -0x5C:
+        return ROCKSDB_NAMESPACE::Tickers::
+            MEMORY_TUNER_WRITE_BUFFER_SHRUNK_BYTES;
+      case -0x5D:
+        return ROCKSDB_NAMESPACE::Tickers::
+            MEMORY_TUNER_SECONDARY_CACHE_GROWN_BYTES;
+      case -0x5E:
+        return ROCKSDB_NAMESPACE::Tickers::
+            MEMORY_TUNER_SECONDARY_CACHE_SHRUNK_BYTES;
+      case -0x5F:
+        return ROCKSDB_NAMESPACE::Tickers::USER_KEY_ROW_CACHE_HIT;
+      case -0x60:
+        return ROCKSDB_NAMESPACE::Tickers::USER_KEY_ROW_CACHE_MISS;
       case -0x54:
         // -0x54 is the max value at this time. Since these values are exposed
         // directly to Java clients, we'll keep the value the same till the next
@@ -7467,6 +7508,12 @@ class CompactionReasonJni {
         return 0x12;
       case ROCKSDB_NAMESPACE::CompactionReason::kRefitLevel:
         return 0x13;
+      case ROCKSDB_NAMESPACE::CompactionReason::kRangeDeletions:
+        return 0x14;
+      case ROCKSDB_NAMESPACE::CompactionReason::kReadTriggered:
+        return 0x15;
+      case ROCKSDB_NAMESPACE::CompactionReason::kBlobGarbageCollection:
+        return 0x16;
       default:
         return 0x7F;  // undefined
     }
@@ -7517,6 +7564,12 @@ class CompactionReasonJni {
         return ROCKSDB_NAMESPACE::CompactionReason::kRoundRobinTtl;
       case 0x13:
         return ROCKSDB_NAMESPACE::CompactionReason::kRefitLevel;
+      case 0x14:
+        return ROCKSDB_NAMESPACE::CompactionReason::kRangeDeletions;
+      case 0x15:
+        return ROCKSDB_NAMESPACE::CompactionReason::kReadTriggered;
+      case 0x16:
+        return ROCKSDB_NAMESPACE::CompactionReason::kBlobGarbageCollection;
       default:
         // undefined/default
         return ROCKSDB_NAMESPACE::CompactionReason::kUnknown;
@@ -104,7 +104,22 @@ public enum CompactionReason {
   /**
    * Compaction by calling DBImpl::ReFitLevel
    */
-  kRefitLevel((byte) 0x13);
+  kRefitLevel((byte) 0x13),
+
+  /**
+   * Compaction pushing range tombstones covering much data to the last level
+   */
+  kRangeDeletions((byte) 0x14),
+
+  /**
+   * Compaction of files that point lookups often read in vain
+   */
+  kReadTriggered((byte) 0x15),
+
+  /**
+   * Rewrite of the files referencing a blob file with much garbage
+   */
+  kBlobGarbageCollection((byte) 0x16);
 
   private final byte value;
 
@@ -882,6 +882,24 @@ public enum TickerType {
 
     FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT((byte) -0x57),
 
+    MEMORY_TUNER_ROUNDS((byte) -0x58),
+
+    MEMORY_TUNER_BLOCK_CACHE_GROWN_BYTES((byte) -0x59),
+
+    MEMORY_TUNER_BLOCK_CACHE_SHRUNK_BYTES((byte) -0x5A),
+
+    MEMORY_TUNER_WRITE_BUFFER_GROWN_BYTES((byte) -0x5B),
+
+    MEMORY_TUNER_WRITE_BUFFER_SHRUNK_BYTES((byte) -0x5C),
+
+    MEMORY_TUNER_SECONDARY_CACHE_GROWN_BYTES((byte) -0x5D),
+
+    MEMORY_TUNER_SECONDARY_CACHE_SHRUNK_BYTES((byte) -0x5E),
+
+    USER_KEY_ROW_CACHE_HIT((byte) -0x5F),
+
+    USER_KEY_ROW_CACHE_MISS((byte) -0x60),
+
     TICKER_ENUM_MAX((byte) -0x54);
 
     private final byte value;
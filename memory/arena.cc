@@ -73,7 +73,7 @@ char* Arena::AllocateFallback(size_t bytes, bool aligned) {
   char* block_head = nullptr;
   if (MemMapping::kHugePageSupported && hugetlb_size_ > 0) {
     size = hugetlb_size_;
-    block_head = AllocateFromHugePage(size);
+    block_head = AllocateFromHugePage(size, hugetlb_size_);
   }
   if (!block_head) {
     size = kBlockSize;
@@ -92,8 +92,8 @@ char* Arena::AllocateFallback(size_t bytes, bool aligned) {
   }
 }
 
-char* Arena::AllocateFromHugePage(size_t bytes) {
-  MemMapping mm = MemMapping::AllocateHuge(bytes);
+char* Arena::AllocateFromHugePage(size_t bytes, size_t huge_page_size) {
+  MemMapping mm = MemMapping::AllocateHuge(bytes, huge_page_size);
   auto addr = static_cast<char*>(mm.Get());
   if (addr) {
     huge_blocks_.push_back(std::move(mm));
@@ -114,7 +114,7 @@ char* Arena::AllocateAligned(size_t bytes, size_t huge_page_size,
         ((bytes - 1U) / huge_page_size + 1U) * huge_page_size;
     assert(reserved_size >= bytes);
 
-    char* addr = AllocateFromHugePage(reserved_size);
+    char* addr = AllocateFromHugePage(reserved_size, huge_page_size);
     if (addr == nullptr) {
       ROCKS_LOG_WARN(logger,
                      "AllocateAligned fail to allocate huge TLB pages: %s",
@@ -109,7 +109,8 @@ class Arena : public Allocator {
 
   size_t hugetlb_size_ = 0;
 
-  char* AllocateFromHugePage(size_t bytes);
+  // Prefers huge pages of size `huge_page_size` (see MemMapping::AllocateHuge)
+  char* AllocateFromHugePage(size_t bytes, size_t huge_page_size);
   char* AllocateFallback(size_t bytes, bool aligned);
   char* AllocateNewBlock(size_t block_bytes);
 
@@ -0,0 +1,336 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "memory/huge_page_allocator.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "rocksdb/convenience.h"
+#include "rocksdb/utilities/options_type.h"
+#include "util/math.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Smallest size class, including the header
+constexpr size_t kMinSlotSize = 64;
+// Slabs are at least this large
+constexpr size_t kMinSlabSize = size_t{1} << 20;
+// Bytes of each size class kept in each per-core free list
+constexpr size_t kCoreCacheBytesPerClass = size_t{128} << 10;
+
+std::unordered_map<std::string, OptionTypeInfo> huge_page_allocator_type_info =
+    {
+        {"huge_page_size",
+         {offsetof(struct HugePageAllocatorOptions, huge_page_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"region_size",
+         {offsetof(struct HugePageAllocatorOptions, region_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"max_slab_allocation_size",
+         {offsetof(struct HugePageAllocatorOptions, max_slab_allocation_size),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"max_region_bytes",
+         {offsetof(struct HugePageAllocatorOptions, max_region_bytes),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"per_core_cache",
+         {offsetof(struct HugePageAllocatorOptions, per_core_cache),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+        {"fallback_to_regular_pages",
+         {offsetof(struct HugePageAllocatorOptions, fallback_to_regular_pages),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kNone}},
+};
+
+size_t RoundUp(size_t n, size_t alignment) {
+  return (n + alignment - 1) / alignment * alignment;
+}
+}  // namespace
+
+HugePageAllocator::HugePageAllocator(const HugePageAllocatorOptions& options)
+    : options_(options) {
+  RegisterOptions(&options_, &huge_page_allocator_type_info);
+}
+
+Status HugePageAllocator::PrepareOptions(const ConfigOptions& config_options) {
+  if (init_) {
+    // Already prepared
+    return Status::OK();
+  }
+  if (options_.huge_page_size == 0 ||
+      (options_.huge_page_size & (options_.huge_page_size - 1)) != 0) {
+    return Status::InvalidArgument("huge_page_size must be a power of two");
+  }
+  if (options_.max_slab_allocation_size == 0 ||
+      options_.max_slab_allocation_size > (size_t{1} << 30)) {
+    return Status::InvalidArgument(
+        "max_slab_allocation_size must be positive and at most 1GB");
+  }
+  Status s = MemoryAllocator::PrepareOptions(config_options);
+  if (!s.ok()) {
+    return s;
+  }
+
+  // Four size classes per power of two, in multiples of 16 bytes
+  const size_t max_slot_size =
+      options_.max_slab_allocation_size + sizeof(Header);
+  for (size_t base = kMinSlotSize;; base *= 2) {
+    for (size_t quarter = 4; quarter < 8; ++quarter) {
+      class_sizes_.push_back(base / 4 * quarter);
+      if (class_sizes_.back() >= max_slot_size) {
+        break;
+      }
+    }
+    if (class_sizes_.back() >= max_slot_size) {
+      break;
+    }
+  }
+  for (size_t class_size : class_sizes_) {
+    core_cache_limits_.push_back(static_cast<uint32_t>(
+        std::max(size_t{1}, kCoreCacheBytesPerClass / class_size)));
+  }
+  size_classes_.reset(new SizeClass[class_sizes_.size()]);
+  if (options_.per_core_cache) {
+    for (size_t i = 0; i < per_core_.Size(); ++i) {
+      CoreCache* core = per_core_.AccessAtCore(i);
+      core->free_lists.assign(class_sizes_.size(), nullptr);
+      core->counts.assign(class_sizes_.size(), 0);
+    }
+  }
+
+  // At least four slots of the largest size class per slab, and whole slabs
+  // and huge pages per region
+  slab_size_ = std::max(kMinSlabSize,
+                        size_t{4} << FloorLog2(class_sizes_.back() * 2 - 1));
+  region_size_ = RoundUp(std::max(options_.region_size, slab_size_),
+                         std::max(slab_size_, options_.huge_page_size));
+  init_ = true;
+  return Status::OK();
+}
+
+void* HugePageAllocator::Allocate(size_t size) {
+  assert(init_);
+  const size_t total = size + sizeof(Header);
+  CoreCache* core = per_core_.Access();
+  Header* header = nullptr;
+  if (total <= class_sizes_.back()) {
+    const size_t size_class = static_cast<size_t>(
+        std::lower_bound(class_sizes_.begin(), class_sizes_.end(), total) -
+        class_sizes_.begin());
+    header = reinterpret_cast<Header*>(AllocateSlot(size_class));
+    if (header != nullptr) {
+      header->size_class = size_class;
+      core->allocated_bytes.FetchAddRelaxed(
+          static_cast<int64_t>(class_sizes_[size_class]));
+      core->requested_bytes.FetchAddRelaxed(static_cast<int64_t>(size));
+    }
+  }
+  if (header == nullptr) {
+    header = reinterpret_cast<Header*>(new char[total]);
+    header->size_class = kFallbackClass;
+    core->fallback_allocations.FetchAddRelaxed(1);
+    core->fallback_bytes.FetchAddRelaxed(static_cast<int64_t>(total));
+  }
+  header->requested = size;
+  return header + 1;
+}
+
+void HugePageAllocator::Deallocate(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+  Header* header = static_cast<Header*>(p) - 1;
+  CoreCache* core = per_core_.Access();
+  const size_t requested = static_cast<size_t>(header->requested);
+  if (header->size_class == kFallbackClass) {
+    core->fallback_allocations.FetchSubRelaxed(1);
+    core->fallback_bytes.FetchSubRelaxed(
+        static_cast<int64_t>(requested + sizeof(Header)));
+    delete[] reinterpret_cast<char*>(header);
+    return;
+  }
+  const size_t size_class = static_cast<size_t>(header->size_class);
+  assert(size_class < class_sizes_.size());
+  core->allocated_bytes.FetchSubRelaxed(
+      static_cast<int64_t>(class_sizes_[size_class]));
+  core->requested_bytes.FetchSubRelaxed(static_cast<int64_t>(requested));
+
+  FreeSlot* slot = reinterpret_cast<FreeSlot*>(header);
+  if (options_.per_core_cache) {
+    std::lock_guard<SpinMutex> lock(core->mutex);
+    if (core->counts[size_class] < core_cache_limits_[size_class]) {
+      slot->next = core->free_lists[size_class];
+      core->free_lists[size_class] = slot;
+      ++core->counts[size_class];
+      return;
+    }
+  }
+  SizeClass& sc = size_classes_[size_class];
+  MutexLock lock(&sc.mutex);
+  slot->next = sc.free_list;
+  sc.free_list = slot;
+}
+
+size_t HugePageAllocator::UsableSize(void* p,
+                                     size_t /*allocation_size*/) const {
+  const Header* header = static_cast<const Header*>(p) - 1;
+  if (header->size_class == kFallbackClass) {
+    return static_cast<size_t>(header->requested);
+  }
+  return class_sizes_[static_cast<size_t>(header->size_class)] -
+         sizeof(Header);
+}
+
+HugePageAllocator::FreeSlot* HugePageAllocator::AllocateSlot(
+    size_t size_class) {
+  FreeSlot* slot = nullptr;
+  if (options_.per_core_cache) {
+    CoreCache* core = per_core_.Access();
+    std::lock_guard<SpinMutex> lock(core->mutex);
+    slot = core->free_lists[size_class];
+    if (slot != nullptr) {
+      core->free_lists[size_class] = slot->next;
+      --core->counts[size_class];
+      return slot;
+    }
+  }
+  SizeClass& sc = size_classes_[size_class];
+  const size_t class_size = class_sizes_[size_class];
+  MutexLock lock(&sc.mutex);
+  slot = sc.free_list;
+  if (slot != nullptr) {
+    sc.free_list = slot->next;
+    return slot;
+  }
+  if (sc.slab_end - sc.slab_next < static_cast<ptrdiff_t>(class_size)) {
+    char* slab = NewSlab();
+    if (slab == nullptr) {
+      return nullptr;
+    }
+    sc.slab_next = slab;
+    sc.slab_end = slab + slab_size_;
+  }
+  slot = reinterpret_cast<FreeSlot*>(sc.slab_next);
+  sc.slab_next += class_size;
+  return slot;
+}
+
+char* HugePageAllocator::NewSlab() {
+  MutexLock lock(&regions_mutex_);
+  if (region_end_ - region_next_ < static_cast<ptrdiff_t>(slab_size_) &&
+      !MapRegion()) {
+    return nullptr;
+  }
+  char* slab = region_next_;
+  region_next_ += slab_size_;
+  slab_bytes_.FetchAddRelaxed(slab_size_);
+  return slab;
+}
+
+bool HugePageAllocator::MapRegion() {
+  regions_mutex_.AssertHeld();
+  if (regions_exhausted_) {
+    return false;
+  }
+  if (options_.max_region_bytes > 0 &&
+      mapped_bytes_.LoadRelaxed() + region_size_ > options_.max_region_bytes) {
+    regions_exhausted_ = true;
+    return false;
+  }
+  bool huge = true;
+  MemMapping mapping =
+      MemMapping::AllocateHuge(region_size_, options_.huge_page_size);
+  char* base = static_cast<char*>(mapping.Get());
+  if (!MemMapping::kHugePageSupported || base == nullptr) {
+    huge = false;
+    base = nullptr;
+    if (options_.fallback_to_regular_pages) {
+      // Aligned to a huge page for transparent huge pages
+      mapping = MemMapping::AllocateLazyZeroed(region_size_ +
+                                               options_.huge_page_size);
+      if (mapping.Get() != nullptr) {
+        base = reinterpret_cast<char*>(
+            RoundUp(reinterpret_cast<uintptr_t>(mapping.Get()),
+                    options_.huge_page_size));
+#ifdef MADV_HUGEPAGE
+        // Only advice, so failure is fine
+        (void)madvise(base, region_size_, MADV_HUGEPAGE);
+#endif  // MADV_HUGEPAGE
+      }
+    }
+  }
+  if (base == nullptr) {
+    // Not retried on every new slab
+    regions_exhausted_ = true;
+    return false;
+  }
+  regions_.push_back(std::move(mapping));
+  region_next_ = base;
+  region_end_ = base + region_size_;
+  mapped_bytes_.FetchAddRelaxed(region_size_);
+  if (huge) {
+    huge_page_bytes_.FetchAddRelaxed(region_size_);
+  }
+  return true;
+}
+
+void HugePageAllocator::GetStats(HugePageAllocatorStats* stats) const {
+  *stats = HugePageAllocatorStats();
+  stats->mapped_bytes = mapped_bytes_.LoadRelaxed();
+  stats->huge_page_bytes = huge_page_bytes_.LoadRelaxed();
+  stats->slab_bytes = slab_bytes_.LoadRelaxed();
+  int64_t allocated_bytes = 0;
+  int64_t requested_bytes = 0;
+  int64_t fallback_allocations = 0;
+  int64_t fallback_bytes = 0;
+  for (size_t i = 0; i < per_core_.Size(); ++i) {
+    const CoreCache* core = per_core_.AccessAtCore(i);
+    allocated_bytes += core->allocated_bytes.LoadRelaxed();
+    requested_bytes += core->requested_bytes.LoadRelaxed();
+    fallback_allocations += core->fallback_allocations.LoadRelaxed();
+    fallback_bytes += core->fallback_bytes.LoadRelaxed();
+  }
+  // Can be briefly negative with concurrent allocations and deallocations
+  stats->allocated_bytes =
+      static_cast<size_t>(std::max(allocated_bytes, int64_t{0}));
+  stats->requested_bytes =
+      static_cast<size_t>(std::max(requested_bytes, int64_t{0}));
+  stats->fallback_allocations =
+      static_cast<size_t>(std::max(fallback_allocations, int64_t{0}));
+  stats->fallback_bytes =
+      static_cast<size_t>(std::max(fallback_bytes, int64_t{0}));
+}
+
+Status NewHugePageAllocator(
+    const HugePageAllocatorOptions& options,
+    std::shared_ptr<MemoryAllocator>* memory_allocator) {
+  if (memory_allocator == nullptr) {
+    return Status::InvalidArgument("memory_allocator must be non-null.");
+  }
+  std::unique_ptr<MemoryAllocator> allocator(new HugePageAllocator(options));
+  Status s = allocator->PrepareOptions(ConfigOptions());
+  if (s.ok()) {
+    memory_allocator->reset(allocator.release());
+  }
+  return s;
+}
+
+Status GetHugePageAllocatorStats(const MemoryAllocator& memory_allocator,
+                                 HugePageAllocatorStats* stats) {
+  const auto* allocator = memory_allocator.CheckedCast<HugePageAllocator>();
+  if (allocator == nullptr) {
+    return Status::InvalidArgument("Not a HugePageAllocator");
+  }
+  allocator->GetStats(stats);
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
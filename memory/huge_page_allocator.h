@@ -0,0 +1,111 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "port/mmap.h"
+#include "port/port.h"
+#include "rocksdb/memory_allocator.h"
+#include "util/atomic.h"
+#include "util/core_local.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// Serves allocations from slabs carved out of regions of huge pages (see
+// HugePageAllocatorOptions). Each slab holds slots of one size class, with
+// four size classes per power of two. Each allocation is preceded by a small
+// header recording its size class, so that it can be freed without looking
+// up its slab. Freed slots go to a per-core free list of their size class
+// (up to a limit), or to the shared free list of the size class.
+class HugePageAllocator : public MemoryAllocator {
+ public:
+  explicit HugePageAllocator(const HugePageAllocatorOptions& options);
+
+  static const char* kClassName() { return "HugePageAllocator"; }
+  const char* Name() const override { return kClassName(); }
+
+  Status PrepareOptions(const ConfigOptions& config_options) override;
+
+  void* Allocate(size_t size) override;
+  void Deallocate(void* p) override;
+  size_t UsableSize(void* p, size_t allocation_size) const override;
+
+  void GetStats(HugePageAllocatorStats* stats) const;
+
+  // Size of the slabs, and of the largest size class
+  size_t TEST_GetSlabSize() const { return slab_size_; }
+  size_t TEST_GetMaxSlotSize() const { return class_sizes_.back(); }
+
+ private:
+  struct Header {
+    uint64_t size_class;
+    uint64_t requested;
+  };
+  static_assert(sizeof(Header) == 16, "Keeps allocations 16-byte aligned");
+
+  // For allocations served by malloc
+  static constexpr uint64_t kFallbackClass = UINT64_MAX;
+
+  struct FreeSlot {
+    FreeSlot* next;
+  };
+
+  struct SizeClass {
+    port::Mutex mutex;
+    FreeSlot* free_list = nullptr;
+    // Not yet used part of the latest slab
+    char* slab_next = nullptr;
+    char* slab_end = nullptr;
+  };
+
+  struct ALIGN_AS(CACHE_LINE_SIZE) CoreCache {
+    SpinMutex mutex;
+    std::vector<FreeSlot*> free_lists;
+    std::vector<uint32_t> counts;
+    // Changes by the allocations and deallocations on this core, which can
+    // be negative
+    RelaxedAtomic<int64_t> allocated_bytes{0};
+    RelaxedAtomic<int64_t> requested_bytes{0};
+    RelaxedAtomic<int64_t> fallback_allocations{0};
+    RelaxedAtomic<int64_t> fallback_bytes{0};
+  };
+
+  // Returns a free slot of the size class, or nullptr if out of memory in
+  // the regions
+  FreeSlot* AllocateSlot(size_t size_class);
+  // Returns a new slab, or nullptr if the regions cannot grow
+  char* NewSlab();
+  bool MapRegion();
+
+  HugePageAllocatorOptions options_;
+  bool init_ = false;
+
+  // Set up by PrepareOptions()
+  std::vector<size_t> class_sizes_;
+  // Max number of slots of each size class in a per-core free list
+  std::vector<uint32_t> core_cache_limits_;
+  std::unique_ptr<SizeClass[]> size_classes_;
+  size_t slab_size_ = 0;
+  size_t region_size_ = 0;
+  CoreLocalArray<CoreCache> per_core_;
+
+  port::Mutex regions_mutex_;
+  std::vector<MemMapping> regions_;
+  // Not yet used part of the latest region
+  char* region_next_ = nullptr;
+  char* region_end_ = nullptr;
+  // Once true, no more regions are mapped
+  bool regions_exhausted_ = false;
+  RelaxedAtomic<size_t> mapped_bytes_{0};
+  RelaxedAtomic<size_t> huge_page_bytes_{0};
+  RelaxedAtomic<size_t> slab_bytes_{0};
+};
+
+}  // namespace ROCKSDB_NAMESPACE
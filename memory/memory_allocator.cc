@@ -5,6 +5,7 @@
 
 #include "rocksdb/memory_allocator.h"
 
+#include "memory/huge_page_allocator.h"
 #include "memory/jemalloc_nodump_allocator.h"
 #include "memory/memkind_kmem_allocator.h"
 #include "rocksdb/utilities/customizable_util.h"
@@ -46,6 +47,13 @@ static int RegisterBuiltinAllocators(ObjectLibrary& library,
         }
         return guard->get();
       });
+  library.AddFactory<MemoryAllocator>(
+      HugePageAllocator::kClassName(),
+      [](const std::string& /*uri*/, std::unique_ptr<MemoryAllocator>* guard,
+         std::string* /*errmsg*/) {
+        guard->reset(new HugePageAllocator(HugePageAllocatorOptions()));
+        return guard->get();
+      });
   library.AddFactory<MemoryAllocator>(
       MemkindKmemAllocator::kClassName(),
       [](const std::string& /*uri*/, std::unique_ptr<MemoryAllocator>* guard,
@@ -6,6 +6,7 @@
 
 #include <cstdio>
 
+#include "memory/huge_page_allocator.h"
 #include "memory/jemalloc_nodump_allocator.h"
 #include "memory/memkind_kmem_allocator.h"
 #include "rocksdb/cache.h"
@@ -14,6 +15,7 @@
 #include "rocksdb/options.h"
 #include "table/block_based/block_based_table_factory.h"
 #include "test_util/testharness.h"
+#include "util/random.h"
 #include "utilities/memory_allocators.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -209,6 +211,175 @@ TEST_F(CreateMemoryAllocatorTest, NewJemallocNodumpAllocator) {
   ASSERT_EQ(opts->limit_tcache_size, jopts.limit_tcache_size);
 }
 
+TEST_F(CreateMemoryAllocatorTest, HugePageAllocatorOptionsTest) {
+  std::shared_ptr<MemoryAllocator> allocator;
+  std::string id = std::string("id=") + HugePageAllocator::kClassName();
+  ASSERT_OK(MemoryAllocator::CreateFromString(
+      config_options_,
+      id + "; huge_page_size=1G; region_size=4M; per_core_cache=false",
+      &allocator));
+  auto opts = allocator->GetOptions<HugePageAllocatorOptions>();
+  ASSERT_NE(opts, nullptr);
+  ASSERT_EQ(opts->huge_page_size, size_t{1} << 30);
+  ASSERT_EQ(opts->region_size, size_t{4} << 20);
+  ASSERT_FALSE(opts->per_core_cache);
+  ASSERT_TRUE(opts->fallback_to_regular_pages);
+
+  ASSERT_NOK(MemoryAllocator::CreateFromString(
+      config_options_, id + "; huge_page_size=3M", &allocator));
+  HugePageAllocatorOptions hopts;
+  hopts.max_slab_allocation_size = 0;
+  ASSERT_NOK(NewHugePageAllocator(hopts, &allocator));
+  ASSERT_NOK(NewHugePageAllocator(HugePageAllocatorOptions(), nullptr));
+
+  HugePageAllocatorStats stats;
+  ASSERT_TRUE(GetHugePageAllocatorStats(DefaultMemoryAllocator(), &stats)
+                  .IsInvalidArgument());
+}
+
+class HugePageAllocatorTest : public testing::Test,
+                              public testing::WithParamInterface<bool> {
+ public:
+  HugePageAllocatorTest() {
+    // Small regions of regular pages, as huge pages are usually not
+    // reserved in test environments
+    options_.huge_page_size = 4096;
+    options_.region_size = 4 << 20;
+    options_.per_core_cache = GetParam();
+  }
+
+  HugePageAllocatorStats GetStats() {
+    HugePageAllocatorStats stats;
+    EXPECT_OK(GetHugePageAllocatorStats(*allocator_, &stats));
+    return stats;
+  }
+
+  HugePageAllocatorOptions options_;
+  std::shared_ptr<MemoryAllocator> allocator_;
+};
+
+TEST_P(HugePageAllocatorTest, AllocateAndReuse) {
+  // Each of the size classes below takes a slab of its own, all of which fit
+  // in the first region
+  options_.region_size = 16 << 20;
+  ASSERT_OK(NewHugePageAllocator(options_, &allocator_));
+  ASSERT_EQ(GetStats().mapped_bytes, 0U);
+
+  std::vector<char*> blocks;
+  for (size_t size : {1, 100, 4096, 5000, 16384, 100000}) {
+    char* p = static_cast<char*>(allocator_->Allocate(size));
+    ASSERT_NE(p, nullptr);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(p) % 16, 0U);
+    size_t usable = allocator_->UsableSize(p, size);
+    ASSERT_GE(usable, size);
+    // Size classes are at most 25% larger than needed
+    ASSERT_LE(usable, std::max(size_t{64}, size * 5 / 4 + 16));
+    memset(p, 0xab, usable);
+    blocks.push_back(p);
+  }
+  HugePageAllocatorStats stats = GetStats();
+  ASSERT_EQ(stats.mapped_bytes, options_.region_size);
+  ASSERT_EQ(stats.requested_bytes, 1U + 100 + 4096 + 5000 + 16384 + 100000);
+  ASSERT_GT(stats.allocated_bytes, stats.requested_bytes);
+  ASSERT_GE(stats.slab_bytes, stats.allocated_bytes);
+  ASSERT_GT(stats.FragmentationRatio(), 0.0);
+  ASSERT_LT(stats.FragmentationRatio(), 1.0);
+  ASSERT_EQ(stats.fallback_allocations, 0U);
+
+  // Freed slots are reused by allocations of the same size class
+  char* freed = blocks[3];
+  allocator_->Deallocate(freed);
+  blocks[3] = static_cast<char*>(allocator_->Allocate(4999));
+  ASSERT_EQ(blocks[3], freed);
+
+  for (char* p : blocks) {
+    allocator_->Deallocate(p);
+  }
+  stats = GetStats();
+  ASSERT_EQ(stats.allocated_bytes, 0U);
+  ASSERT_EQ(stats.requested_bytes, 0U);
+  ASSERT_EQ(stats.mapped_bytes, options_.region_size);
+  ASSERT_DOUBLE_EQ(stats.FragmentationRatio(), 1.0);
+}
+
+TEST_P(HugePageAllocatorTest, Fallback) {
+  options_.max_slab_allocation_size = 8192;
+  options_.max_region_bytes = options_.region_size;
+  ASSERT_OK(NewHugePageAllocator(options_, &allocator_));
+  auto* allocator = allocator_->CheckedCast<HugePageAllocator>();
+  ASSERT_NE(allocator, nullptr);
+
+  // Too large for slabs
+  void* large = allocator_->Allocate(20000);
+  ASSERT_NE(large, nullptr);
+  ASSERT_EQ(allocator_->UsableSize(large, 20000), 20000U);
+  HugePageAllocatorStats stats = GetStats();
+  ASSERT_EQ(stats.fallback_allocations, 1U);
+  ASSERT_EQ(stats.mapped_bytes, 0U);
+  allocator_->Deallocate(large);
+  ASSERT_EQ(GetStats().fallback_allocations, 0U);
+
+  // Exhaust the regions with allocations of the largest size class
+  const size_t num_slabs =
+      options_.region_size / allocator->TEST_GetSlabSize();
+  const size_t slot_size = allocator->TEST_GetMaxSlotSize();
+  std::vector<void*> blocks;
+  for (size_t i = 0;
+       i < num_slabs * (allocator->TEST_GetSlabSize() / slot_size) + 1; ++i) {
+    blocks.push_back(allocator_->Allocate(8192));
+  }
+  stats = GetStats();
+  ASSERT_EQ(stats.mapped_bytes, options_.region_size);
+  ASSERT_EQ(stats.fallback_allocations, 1U);
+  for (void* p : blocks) {
+    allocator_->Deallocate(p);
+  }
+  stats = GetStats();
+  ASSERT_EQ(stats.fallback_allocations, 0U);
+  ASSERT_EQ(stats.allocated_bytes, 0U);
+}
+
+TEST_P(HugePageAllocatorTest, ConcurrentAllocations) {
+  ASSERT_OK(NewHugePageAllocator(options_, &allocator_));
+  std::vector<port::Thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&, t]() {
+      Random rnd(301 + t);
+      std::vector<std::pair<char*, char>> blocks;
+      for (int i = 0; i < 10000; ++i) {
+        if (!blocks.empty() && rnd.OneIn(2)) {
+          size_t j = rnd.Uniform(static_cast<int>(blocks.size()));
+          ASSERT_EQ(blocks[j].first[0], blocks[j].second);
+          allocator_->Deallocate(blocks[j].first);
+          blocks[j] = blocks.back();
+          blocks.pop_back();
+        } else {
+          char* p = static_cast<char*>(
+              allocator_->Allocate(1 + rnd.Uniform(20000)));
+          p[0] = static_cast<char>(i);
+          blocks.emplace_back(p, static_cast<char>(i));
+        }
+      }
+      for (auto& block : blocks) {
+        allocator_->Deallocate(block.first);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  HugePageAllocatorStats stats = GetStats();
+  ASSERT_EQ(stats.allocated_bytes, 0U);
+  ASSERT_EQ(stats.requested_bytes, 0U);
+}
+
+INSTANTIATE_TEST_CASE_P(HugePageAllocatorTest, HugePageAllocatorTest,
+                        ::testing::Bool());
+
+INSTANTIATE_TEST_CASE_P(
+    HugePageAllocator, MemoryAllocatorTest,
+    ::testing::Values(std::make_tuple(HugePageAllocator::kClassName(), true)));
+
 INSTANTIATE_TEST_CASE_P(DefaultMemoryAllocator, MemoryAllocatorTest,
                         ::testing::Values(std::make_tuple(
                             DefaultMemoryAllocator::kClassName(), true)));
@@ -11,6 +11,7 @@ namespace ROCKSDB_NAMESPACE {
 static const uint32_t kFileReadSampleRate = 1024;
 bool should_sample_file_read();
 void sample_file_read_inc(FileMetaData*);
+uint64_t sample_file_wasted_read_inc(FileMetaData*);
 
 inline bool should_sample_file_read() {
   return (Random::GetTLSInstance()->Next() % kFileReadSampleRate == 307);
@@ -20,4 +21,10 @@ inline void sample_file_read_inc(FileMetaData* meta) {
   meta->stats.num_reads_sampled.fetch_add(kFileReadSampleRate,
                                           std::memory_order_relaxed);
 }
+
+// Returns the previous count
+inline uint64_t sample_file_wasted_read_inc(FileMetaData* meta) {
+  return meta->stats.num_wasted_reads_sampled.fetch_add(
+      kFileReadSampleRate, std::memory_order_relaxed);
+}
 }  // namespace ROCKSDB_NAMESPACE
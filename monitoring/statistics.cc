@@ -270,6 +270,21 @@ const std::vector<std::pair<Tickers, std::string>> TickersNameMap = {
      "rocksdb.file.read.corruption.retry.count"},
     {FILE_READ_CORRUPTION_RETRY_SUCCESS_COUNT,
      "rocksdb.file.read.corruption.retry.success.count"},
+    {MEMORY_TUNER_ROUNDS, "rocksdb.memory.tuner.rounds"},
+    {MEMORY_TUNER_BLOCK_CACHE_GROWN_BYTES,
+     "rocksdb.memory.tuner.block.cache.grown.bytes"},
+    {MEMORY_TUNER_BLOCK_CACHE_SHRUNK_BYTES,
+     "rocksdb.memory.tuner.block.cache.shrunk.bytes"},
+    {MEMORY_TUNER_WRITE_BUFFER_GROWN_BYTES,
+     "rocksdb.memory.tuner.write.buffer.grown.bytes"},
+    {MEMORY_TUNER_WRITE_BUFFER_SHRUNK_BYTES,
+     "rocksdb.memory.tuner.write.buffer.shrunk.bytes"},
+    {MEMORY_TUNER_SECONDARY_CACHE_GROWN_BYTES,
+     "rocksdb.memory.tuner.secondary.cache.grown.bytes"},
+    {MEMORY_TUNER_SECONDARY_CACHE_SHRUNK_BYTES,
+     "rocksdb.memory.tuner.secondary.cache.shrunk.bytes"},
+    {USER_KEY_ROW_CACHE_HIT, "rocksdb.user.key.row.cache.hit"},
+    {USER_KEY_ROW_CACHE_MISS, "rocksdb.user.key.row.cache.miss"},
 };
 
 const std::vector<std::pair<Histograms, std::string>> HistogramsNameMap = {
@@ -263,6 +263,18 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"checksum",
          {offsetof(struct CompressionOptions, checksum), OptionType::kBoolean,
           OptionVerificationType::kNormal, OptionTypeFlags::kMutable}},
+        {"use_shared_parallel_pool",
+         {offsetof(struct CompressionOptions, use_shared_parallel_pool),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"adaptive_parallel_level",
+         {offsetof(struct CompressionOptions, adaptive_parallel_level),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"max_dict_reuse_files",
+         {offsetof(struct CompressionOptions, max_dict_reuse_files),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
 };
 
 static std::unordered_map<std::string, OptionTypeInfo>
@@ -293,6 +305,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct CompactionOptionsFIFO, allow_compaction),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"time_window_seconds",
+         {offsetof(struct CompactionOptionsFIFO, time_window_seconds),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"file_temperature_age_thresholds",
          OptionTypeInfo::Vector<struct FileTemperatureAge>(
              offsetof(struct CompactionOptionsFIFO,
@@ -340,6 +356,15 @@ static std::unordered_map<std::string, OptionTypeInfo>
           OptionTypeFlags::kMutable}},
         {"allow_trivial_move",
          {offsetof(class CompactionOptionsUniversal, allow_trivial_move),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"lazy_leveling_runs_per_tier",
+         {offsetof(class CompactionOptionsUniversal,
+                   lazy_leveling_runs_per_tier),
+          OptionType::kUInt, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"lazy_leveling_auto_tune",
+         {offsetof(class CompactionOptionsUniversal, lazy_leveling_auto_tune),
           OptionType::kBoolean, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}}};
 
@@ -600,6 +625,11 @@ static std::unordered_map<std::string, OptionTypeInfo>
                    blob_garbage_collection_force_threshold),
           OptionType::kDouble, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"blob_garbage_collection_file_threshold",
+         {offsetof(struct MutableCFOptions,
+                   blob_garbage_collection_file_threshold),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"blob_compaction_readahead_size",
          {offsetof(struct MutableCFOptions, blob_compaction_readahead_size),
           OptionType::kUInt64T, OptionVerificationType::kNormal,
@@ -637,6 +667,19 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableCFOptions, bottommost_file_compaction_delay),
           OptionType::kUInt32T, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"range_deletion_compaction_ratio",
+         {offsetof(struct MutableCFOptions, range_deletion_compaction_ratio),
+          OptionType::kDouble, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"read_triggered_compaction_bytes_per_lookup",
+         {offsetof(struct MutableCFOptions,
+                   read_triggered_compaction_bytes_per_lookup),
+          OptionType::kUInt64T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
+        {"shard_level0_by_sst_partitioner",
+         {offsetof(struct MutableCFOptions, shard_level0_by_sst_partitioner),
+          OptionType::kBoolean, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"uncache_aggressiveness",
          {offsetof(struct MutableCFOptions, uncache_aggressiveness),
           OptionType::kUInt32T, OptionVerificationType::kNormal,
@@ -1177,6 +1220,13 @@ void MutableCFOptions::Dump(Logger* log) const {
                  experimental_mempurge_threshold);
   ROCKS_LOG_INFO(log, "         bottommost_file_compaction_delay: %" PRIu32,
                  bottommost_file_compaction_delay);
+  ROCKS_LOG_INFO(log, "          range_deletion_compaction_ratio: %f",
+                 range_deletion_compaction_ratio);
+  ROCKS_LOG_INFO(log,
+                 "read_triggered_compaction_bytes_per_lookup: %" PRIu64,
+                 read_triggered_compaction_bytes_per_lookup);
+  ROCKS_LOG_INFO(log, "          shard_level0_by_sst_partitioner: %d",
+                 shard_level0_by_sst_partitioner);
   ROCKS_LOG_INFO(log, "                   uncache_aggressiveness: %" PRIu32,
                  uncache_aggressiveness);
   ROCKS_LOG_INFO(log, "             memtable_op_scan_flush_trigger: %" PRIu32,
@@ -1204,12 +1254,21 @@ void MutableCFOptions::Dump(Logger* log) const {
       static_cast<int>(compaction_options_universal.allow_trivial_move));
   ROCKS_LOG_INFO(log, "compaction_options_universal.incremental        : %d",
                  static_cast<int>(compaction_options_universal.incremental));
+  ROCKS_LOG_INFO(
+      log, "compaction_options_universal.lazy_leveling_runs_per_tier : %u",
+      compaction_options_universal.lazy_leveling_runs_per_tier);
+  ROCKS_LOG_INFO(
+      log, "compaction_options_universal.lazy_leveling_auto_tune : %d",
+      static_cast<int>(compaction_options_universal.lazy_leveling_auto_tune));
 
   // FIFO Compaction Options
   ROCKS_LOG_INFO(log, "compaction_options_fifo.max_table_files_size : %" PRIu64,
                  compaction_options_fifo.max_table_files_size);
   ROCKS_LOG_INFO(log, "compaction_options_fifo.allow_compaction : %d",
                  compaction_options_fifo.allow_compaction);
+  ROCKS_LOG_INFO(log,
+                 "compaction_options_fifo.time_window_seconds : %" PRIu64,
+                 compaction_options_fifo.time_window_seconds);
 
   // Blob file related options
   ROCKS_LOG_INFO(log, "                        enable_blob_files: %s",
@@ -1226,6 +1285,8 @@ void MutableCFOptions::Dump(Logger* log) const {
                  blob_garbage_collection_age_cutoff);
   ROCKS_LOG_INFO(log, "  blob_garbage_collection_force_threshold: %f",
                  blob_garbage_collection_force_threshold);
+  ROCKS_LOG_INFO(log, "   blob_garbage_collection_file_threshold: %f",
+                 blob_garbage_collection_file_threshold);
   ROCKS_LOG_INFO(log, "           blob_compaction_readahead_size: %" PRIu64,
                  blob_compaction_readahead_size);
   ROCKS_LOG_INFO(log, "                 blob_file_starting_level: %d",
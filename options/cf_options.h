@@ -150,6 +150,8 @@ struct MutableCFOptions {
             options.blob_garbage_collection_age_cutoff),
         blob_garbage_collection_force_threshold(
             options.blob_garbage_collection_force_threshold),
+        blob_garbage_collection_file_threshold(
+            options.blob_garbage_collection_file_threshold),
         blob_compaction_readahead_size(options.blob_compaction_readahead_size),
         blob_file_starting_level(options.blob_file_starting_level),
         prepopulate_blob_cache(options.prepopulate_blob_cache),
@@ -173,6 +175,12 @@ struct MutableCFOptions {
         memtable_max_range_deletions(options.memtable_max_range_deletions),
         bottommost_file_compaction_delay(
             options.bottommost_file_compaction_delay),
+        range_deletion_compaction_ratio(
+            options.range_deletion_compaction_ratio),
+        read_triggered_compaction_bytes_per_lookup(
+            options.read_triggered_compaction_bytes_per_lookup),
+        shard_level0_by_sst_partitioner(
+            options.shard_level0_by_sst_partitioner),
         uncache_aggressiveness(options.uncache_aggressiveness),
         memtable_op_scan_flush_trigger(options.memtable_op_scan_flush_trigger) {
     RefreshDerivedOptions(options.num_levels, options.compaction_style);
@@ -213,6 +221,7 @@ struct MutableCFOptions {
         enable_blob_garbage_collection(false),
         blob_garbage_collection_age_cutoff(0.0),
         blob_garbage_collection_force_threshold(0.0),
+        blob_garbage_collection_file_threshold(0.0),
         blob_compaction_readahead_size(0),
         blob_file_starting_level(0),
         prepopulate_blob_cache(PrepopulateBlobCache::kDisable),
@@ -229,6 +238,9 @@ struct MutableCFOptions {
         sample_for_compression(0),
         memtable_max_range_deletions(0),
         bottommost_file_compaction_delay(0),
+        range_deletion_compaction_ratio(0),
+        read_triggered_compaction_bytes_per_lookup(0),
+        shard_level0_by_sst_partitioner(false),
         uncache_aggressiveness(0),
         memtable_op_scan_flush_trigger(0) {}
 
@@ -315,6 +327,7 @@ struct MutableCFOptions {
   bool enable_blob_garbage_collection;
   double blob_garbage_collection_age_cutoff;
   double blob_garbage_collection_force_threshold;
+  double blob_garbage_collection_file_threshold;
   uint64_t blob_compaction_readahead_size;
   int blob_file_starting_level;
   PrepopulateBlobCache prepopulate_blob_cache;
@@ -337,6 +350,9 @@ struct MutableCFOptions {
   std::vector<CompressionType> compression_per_level;
   uint32_t memtable_max_range_deletions;
   uint32_t bottommost_file_compaction_delay;
+  double range_deletion_compaction_ratio;
+  uint64_t read_triggered_compaction_bytes_per_lookup;
+  bool shard_level0_by_sst_partitioner;
   uint32_t uncache_aggressiveness;
   uint32_t memtable_op_scan_flush_trigger;
 
@@ -68,6 +68,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableDBOptions, max_subcompactions),
           OptionType::kUInt32T, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"subcompaction_ranges_per_thread",
+         {offsetof(struct MutableDBOptions, subcompaction_ranges_per_thread),
+          OptionType::kUInt32T, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"avoid_flush_during_shutdown",
          {offsetof(struct MutableDBOptions, avoid_flush_during_shutdown),
           OptionType::kBoolean, OptionVerificationType::kNormal,
@@ -120,6 +124,10 @@ static std::unordered_map<std::string, OptionTypeInfo>
          {offsetof(struct MutableDBOptions, compaction_readahead_size),
           OptionType::kSizeT, OptionVerificationType::kNormal,
           OptionTypeFlags::kMutable}},
+        {"compaction_async_readahead_budget",
+         {offsetof(struct MutableDBOptions, compaction_async_readahead_budget),
+          OptionType::kSizeT, OptionVerificationType::kNormal,
+          OptionTypeFlags::kMutable}},
         {"max_background_flushes",
          {offsetof(struct MutableDBOptions, max_background_flushes),
           OptionType::kInt, OptionVerificationType::kNormal,
@@ -135,6 +143,7 @@ static std::unordered_map<std::string, OptionTypeInfo>
         /*
          // not yet supported
           std::shared_ptr<Cache> row_cache;
+          std::shared_ptr<Cache> user_key_row_cache;
           std::shared_ptr<DeleteScheduler> delete_scheduler;
           std::shared_ptr<Logger> info_log;
           std::shared_ptr<RateLimiter> rate_limiter;
@@ -770,6 +779,7 @@ ImmutableDBOptions::ImmutableDBOptions(const DBOptions& options)
       wal_recovery_mode(options.wal_recovery_mode),
       allow_2pc(options.allow_2pc),
       row_cache(options.row_cache),
+      user_key_row_cache(options.user_key_row_cache),
       wal_filter(options.wal_filter),
       dump_malloc_stats(options.dump_malloc_stats),
       avoid_flush_during_recovery(options.avoid_flush_during_recovery),
@@ -938,6 +948,15 @@ void ImmutableDBOptions::Dump(Logger* log) const {
     ROCKS_LOG_HEADER(log,
                      "                              Options.row_cache: None");
   }
+  if (user_key_row_cache) {
+    ROCKS_LOG_HEADER(
+        log,
+        "                     Options.user_key_row_cache: %" ROCKSDB_PRIszt,
+        user_key_row_cache->GetCapacity());
+  } else {
+    ROCKS_LOG_HEADER(log,
+                     "                     Options.user_key_row_cache: None");
+  }
   ROCKS_LOG_HEADER(log, "                             Options.wal_filter: %s",
                    wal_filter ? wal_filter->Name() : "None");
 
@@ -1029,6 +1048,7 @@ MutableDBOptions::MutableDBOptions()
     : max_background_jobs(2),
       max_background_compactions(-1),
       max_subcompactions(0),
+      subcompaction_ranges_per_thread(1),
       avoid_flush_during_shutdown(false),
       writable_file_max_buffer_size(1024 * 1024),
       delayed_write_rate(2 * 1024U * 1024U),
@@ -1042,12 +1062,14 @@ MutableDBOptions::MutableDBOptions()
       wal_bytes_per_sync(0),
       strict_bytes_per_sync(false),
       compaction_readahead_size(0),
+      compaction_async_readahead_budget(0),
       max_background_flushes(-1) {}
 
 MutableDBOptions::MutableDBOptions(const DBOptions& options)
     : max_background_jobs(options.max_background_jobs),
       max_background_compactions(options.max_background_compactions),
       max_subcompactions(options.max_subcompactions),
+      subcompaction_ranges_per_thread(options.subcompaction_ranges_per_thread),
       avoid_flush_during_shutdown(options.avoid_flush_during_shutdown),
       writable_file_max_buffer_size(options.writable_file_max_buffer_size),
       delayed_write_rate(options.delayed_write_rate),
@@ -1062,6 +1084,8 @@ MutableDBOptions::MutableDBOptions(const DBOptions& options)
       wal_bytes_per_sync(options.wal_bytes_per_sync),
       strict_bytes_per_sync(options.strict_bytes_per_sync),
       compaction_readahead_size(options.compaction_readahead_size),
+      compaction_async_readahead_budget(
+          options.compaction_async_readahead_budget),
       max_background_flushes(options.max_background_flushes),
       daily_offpeak_time_utc(options.daily_offpeak_time_utc) {}
 
@@ -1072,6 +1096,9 @@ void MutableDBOptions::Dump(Logger* log) const {
                    max_background_compactions);
   ROCKS_LOG_HEADER(log, "            Options.max_subcompactions: %" PRIu32,
                    max_subcompactions);
+  ROCKS_LOG_HEADER(log,
+                   "       Options.subcompaction_ranges_per_thread: %" PRIu32,
+                   subcompaction_ranges_per_thread);
   ROCKS_LOG_HEADER(log, "            Options.avoid_flush_during_shutdown: %d",
                    avoid_flush_during_shutdown);
   ROCKS_LOG_HEADER(
@@ -1105,6 +1132,9 @@ void MutableDBOptions::Dump(Logger* log) const {
   ROCKS_LOG_HEADER(log,
                    "      Options.compaction_readahead_size: %" ROCKSDB_PRIszt,
                    compaction_readahead_size);
+  ROCKS_LOG_HEADER(
+      log, "      Options.compaction_async_readahead_budget: %" ROCKSDB_PRIszt,
+      compaction_async_readahead_budget);
   ROCKS_LOG_HEADER(log, "                 Options.max_background_flushes: %d",
                    max_background_flushes);
   ROCKS_LOG_HEADER(log, "Options.daily_offpeak_time_utc: %s",
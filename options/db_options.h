@@ -76,6 +76,7 @@ struct ImmutableDBOptions {
   WALRecoveryMode wal_recovery_mode;
   bool allow_2pc;
   std::shared_ptr<Cache> row_cache;
+  std::shared_ptr<Cache> user_key_row_cache;
   WalFilter* wal_filter;
   bool dump_malloc_stats;
   bool avoid_flush_during_recovery;
@@ -132,6 +133,7 @@ struct MutableDBOptions {
   int max_background_jobs;
   int max_background_compactions;
   uint32_t max_subcompactions;
+  uint32_t subcompaction_ranges_per_thread;
   bool avoid_flush_during_shutdown;
   size_t writable_file_max_buffer_size;
   uint64_t delayed_write_rate;
@@ -145,6 +147,7 @@ struct MutableDBOptions {
   uint64_t wal_bytes_per_sync;
   bool strict_bytes_per_sync;
   size_t compaction_readahead_size;
+  size_t compaction_async_readahead_budget;
   int max_background_flushes;
   std::string daily_offpeak_time_utc;
 };
@@ -107,11 +107,17 @@ AdvancedColumnFamilyOptions::AdvancedColumnFamilyOptions(const Options& options)
           options.blob_garbage_collection_age_cutoff),
       blob_garbage_collection_force_threshold(
           options.blob_garbage_collection_force_threshold),
+      blob_garbage_collection_file_threshold(
+          options.blob_garbage_collection_file_threshold),
       blob_compaction_readahead_size(options.blob_compaction_readahead_size),
       blob_file_starting_level(options.blob_file_starting_level),
       blob_cache(options.blob_cache),
       prepopulate_blob_cache(options.prepopulate_blob_cache),
       persist_user_defined_timestamps(options.persist_user_defined_timestamps),
+      range_deletion_compaction_ratio(options.range_deletion_compaction_ratio),
+      read_triggered_compaction_bytes_per_lookup(
+          options.read_triggered_compaction_bytes_per_lookup),
+      shard_level0_by_sst_partitioner(options.shard_level0_by_sst_partitioner),
       memtable_op_scan_flush_trigger(options.memtable_op_scan_flush_trigger) {
   assert(memtable_factory.get() != nullptr);
   if (max_bytes_for_level_multiplier_additional.size() <
@@ -290,6 +296,13 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
   ROCKS_LOG_HEADER(log,
                    "                   Options.max_compaction_bytes: %" PRIu64,
                    max_compaction_bytes);
+  ROCKS_LOG_HEADER(log, "        Options.range_deletion_compaction_ratio: %f",
+                   range_deletion_compaction_ratio);
+  ROCKS_LOG_HEADER(
+      log, "Options.read_triggered_compaction_bytes_per_lookup: %" PRIu64,
+      read_triggered_compaction_bytes_per_lookup);
+  ROCKS_LOG_HEADER(log, "        Options.shard_level0_by_sst_partitioner: %d",
+                   shard_level0_by_sst_partitioner);
   ROCKS_LOG_HEADER(
       log, "                       Options.arena_block_size: %" ROCKSDB_PRIszt,
       arena_block_size);
@@ -353,11 +366,21 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                    str_compaction_stop_style.c_str());
   ROCKS_LOG_HEADER(log, "Options.compaction_options_universal.max_read_amp: %d",
                    compaction_options_universal.max_read_amp);
+  ROCKS_LOG_HEADER(
+      log,
+      "Options.compaction_options_universal.lazy_leveling_runs_per_tier: %u",
+      compaction_options_universal.lazy_leveling_runs_per_tier);
+  ROCKS_LOG_HEADER(
+      log, "Options.compaction_options_universal.lazy_leveling_auto_tune: %d",
+      static_cast<int>(compaction_options_universal.lazy_leveling_auto_tune));
   ROCKS_LOG_HEADER(
       log, "Options.compaction_options_fifo.max_table_files_size: %" PRIu64,
       compaction_options_fifo.max_table_files_size);
   ROCKS_LOG_HEADER(log, "Options.compaction_options_fifo.allow_compaction: %d",
                    compaction_options_fifo.allow_compaction);
+  ROCKS_LOG_HEADER(
+      log, "Options.compaction_options_fifo.time_window_seconds: %" PRIu64,
+      compaction_options_fifo.time_window_seconds);
   std::ostringstream collector_info;
   for (const auto& collector_factory : table_properties_collector_factories) {
     collector_info << collector_factory->ToString() << ';';
@@ -434,6 +457,8 @@ void ColumnFamilyOptions::Dump(Logger* log) const {
                    blob_garbage_collection_age_cutoff);
   ROCKS_LOG_HEADER(log, "Options.blob_garbage_collection_force_threshold: %f",
                    blob_garbage_collection_force_threshold);
+  ROCKS_LOG_HEADER(log, " Options.blob_garbage_collection_file_threshold: %f",
+                   blob_garbage_collection_file_threshold);
   ROCKS_LOG_HEADER(log,
                    "         Options.blob_compaction_readahead_size: %" PRIu64,
                    blob_compaction_readahead_size);
@@ -94,6 +94,8 @@ void BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.max_background_compactions =
       mutable_db_options.max_background_compactions;
   options.max_subcompactions = mutable_db_options.max_subcompactions;
+  options.subcompaction_ranges_per_thread =
+      mutable_db_options.subcompaction_ranges_per_thread;
   options.max_background_flushes = mutable_db_options.max_background_flushes;
   options.max_log_file_size = immutable_db_options.max_log_file_size;
   options.log_file_time_to_roll = immutable_db_options.log_file_time_to_roll;
@@ -124,6 +126,8 @@ void BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.write_buffer_manager = immutable_db_options.write_buffer_manager;
   options.compaction_readahead_size =
       mutable_db_options.compaction_readahead_size;
+  options.compaction_async_readahead_budget =
+      mutable_db_options.compaction_async_readahead_budget;
   options.writable_file_max_buffer_size =
       mutable_db_options.writable_file_max_buffer_size;
   options.use_adaptive_mutex = immutable_db_options.use_adaptive_mutex;
@@ -152,6 +156,7 @@ void BuildDBOptions(const ImmutableDBOptions& immutable_db_options,
   options.wal_recovery_mode = immutable_db_options.wal_recovery_mode;
   options.allow_2pc = immutable_db_options.allow_2pc;
   options.row_cache = immutable_db_options.row_cache;
+  options.user_key_row_cache = immutable_db_options.user_key_row_cache;
   options.wal_filter = immutable_db_options.wal_filter;
   options.dump_malloc_stats = immutable_db_options.dump_malloc_stats;
   options.avoid_flush_during_recovery =
@@ -234,6 +239,12 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
   cf_opts->paranoid_memory_checks = moptions.paranoid_memory_checks;
   cf_opts->bottommost_file_compaction_delay =
       moptions.bottommost_file_compaction_delay;
+  cf_opts->range_deletion_compaction_ratio =
+      moptions.range_deletion_compaction_ratio;
+  cf_opts->read_triggered_compaction_bytes_per_lookup =
+      moptions.read_triggered_compaction_bytes_per_lookup;
+  cf_opts->shard_level0_by_sst_partitioner =
+      moptions.shard_level0_by_sst_partitioner;
 
   // Compaction related options
   cf_opts->disable_auto_compactions = moptions.disable_auto_compactions;
@@ -279,6 +290,8 @@ void UpdateColumnFamilyOptions(const MutableCFOptions& moptions,
       moptions.blob_garbage_collection_age_cutoff;
   cf_opts->blob_garbage_collection_force_threshold =
       moptions.blob_garbage_collection_force_threshold;
+  cf_opts->blob_garbage_collection_file_threshold =
+      moptions.blob_garbage_collection_file_threshold;
   cf_opts->blob_compaction_readahead_size =
       moptions.blob_compaction_readahead_size;
   cf_opts->blob_file_starting_level = moptions.blob_file_starting_level;
@@ -121,6 +121,14 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
   const OffsetGap kBbtoExcluded = {
       {offsetof(struct BlockBasedTableOptions, flush_block_policy_factory),
        sizeof(std::shared_ptr<FlushBlockPolicyFactory>)},
+      // Padding before MetadataCacheOptions::hot_partition_pinning_budget,
+      // which is copied with the struct but not set by parsing its fields
+      {offsetof(struct BlockBasedTableOptions, metadata_cache_options) +
+           offsetof(struct MetadataCacheOptions, unpartitioned_pinning) +
+           sizeof(PinningTier),
+       offsetof(struct MetadataCacheOptions, hot_partition_pinning_budget) -
+           offsetof(struct MetadataCacheOptions, unpartitioned_pinning) -
+           sizeof(PinningTier)},
       {offsetof(struct BlockBasedTableOptions, block_cache),
        sizeof(std::shared_ptr<Cache>)},
       {offsetof(struct BlockBasedTableOptions, persistent_cache),
@@ -174,9 +182,11 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       config_options, *bbto,
       "cache_index_and_filter_blocks=1;"
       "cache_index_and_filter_blocks_with_high_priority=true;"
+      "scan_bottom_priority_threshold=8;"
       "metadata_cache_options={top_level_index_pinning=kFallback;"
       "partition_pinning=kAll;"
-      "unpartitioned_pinning=kFlushedAndSimilar;};"
+      "unpartitioned_pinning=kFlushedAndSimilar;"
+      "hot_partition_pinning_budget=1048576;};"
       "pin_l0_filter_and_index_blocks_in_cache=1;"
       "pin_top_level_index_and_filter=1;"
       "index_type=kHashSearch;"
@@ -196,10 +206,13 @@ TEST_F(OptionsSettableTest, BlockBasedTableOptionsAllFieldsSettable) {
       "construct_corruption=false;"
       "format_version=1;"
       "verify_compression=true;read_amp_bytes_per_bit=0;"
+      "num_sampled_key_anchors=128;"
       "enable_index_compression=false;"
       "block_align=true;"
+      "mmap_zero_copy_data_blocks=true;"
       "max_auto_readahead_size=0;"
       "prepopulate_block_cache=kDisable;"
+      "prepopulate_block_cache_compaction_budget=1048576;"
       "initial_auto_readahead_size=0;"
       "num_file_reads_for_auto_readahead=0",
       new_bbto));
@@ -333,6 +346,8 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
       {offsetof(struct DBOptions, listeners),
        sizeof(std::vector<std::shared_ptr<EventListener>>)},
       {offsetof(struct DBOptions, row_cache), sizeof(std::shared_ptr<Cache>)},
+      {offsetof(struct DBOptions, user_key_row_cache),
+       sizeof(std::shared_ptr<Cache>)},
       {offsetof(struct DBOptions, wal_filter), sizeof(const WalFilter*)},
       {offsetof(struct DBOptions, file_checksum_gen_factory),
        sizeof(std::shared_ptr<FileChecksumGenFactory>)},
@@ -389,6 +404,7 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "wal_dir=path/to/wal_dir;"
                              "db_write_buffer_size=2587;"
                              "max_subcompactions=64330;"
+                             "subcompaction_ranges_per_thread=4;"
                              "table_cache_numshardbits=28;"
                              "max_open_files=72;"
                              "max_file_opening_threads=35;"
@@ -398,6 +414,7 @@ TEST_F(OptionsSettableTest, DBOptionsAllFieldsSettable) {
                              "use_adaptive_mutex=false;"
                              "max_total_wal_size=4295005604;"
                              "compaction_readahead_size=0;"
+                             "compaction_async_readahead_budget=8388608;"
                              "keep_log_file_num=4890;"
                              "skip_stats_update_on_db_open=false;"
                              "skip_checking_sst_file_sizes_on_db_open=false;"
@@ -510,6 +527,16 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       {offsetof(struct ColumnFamilyOptions,
                 max_bytes_for_level_multiplier_additional),
        sizeof(std::vector<int>)},
+      // Padding before
+      // CompactionOptionsUniversal::lazy_leveling_runs_per_tier, which is
+      // copied with the struct but not set by parsing its fields
+      {offsetof(struct ColumnFamilyOptions, compaction_options_universal) +
+           offsetof(struct CompactionOptionsUniversal, incremental) +
+           sizeof(bool),
+       offsetof(struct CompactionOptionsUniversal,
+                lazy_leveling_runs_per_tier) -
+           offsetof(struct CompactionOptionsUniversal, incremental) -
+           sizeof(bool)},
       {offsetof(struct ColumnFamilyOptions, compaction_options_fifo),
        sizeof(struct CompactionOptionsFIFO)},
       {offsetof(struct ColumnFamilyOptions, memtable_factory),
@@ -613,11 +640,13 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "compression_opts={max_dict_buffer_bytes=5;use_zstd_dict_trainer=true;"
       "enabled=false;parallel_threads=6;zstd_max_train_bytes=7;strategy=8;max_"
       "dict_bytes=9;level=10;window_bits=11;max_compressed_bytes_per_kb=987;"
-      "checksum=true};"
+      "checksum=true;use_shared_parallel_pool=true;adaptive_parallel_level="
+      "true;max_dict_reuse_files=3};"
       "bottommost_compression_opts={max_dict_buffer_bytes=4;use_zstd_dict_"
       "trainer=true;enabled=true;parallel_threads=5;zstd_max_train_bytes=6;"
       "strategy=7;max_dict_bytes=8;level=9;window_bits=10;max_compressed_bytes_"
-      "per_kb=876;checksum=true};"
+      "per_kb=876;checksum=true;use_shared_parallel_pool=true;adaptive_"
+      "parallel_level=true;max_dict_reuse_files=2};"
       "bottommost_compression=kDisableCompressionOption;"
       "level0_stop_writes_trigger=33;"
       "num_levels=99;"
@@ -655,6 +684,7 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "enable_blob_garbage_collection=true;"
       "blob_garbage_collection_age_cutoff=0.5;"
       "blob_garbage_collection_force_threshold=0.75;"
+      "blob_garbage_collection_file_threshold=0.5;"
       "blob_compaction_readahead_size=262144;"
       "blob_file_starting_level=1;"
       "prepopulate_blob_cache=kDisable;"
@@ -665,7 +695,8 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "preclude_last_level_data_seconds=86400;"
       "preserve_internal_time_seconds=86400;"
       "compaction_options_fifo={max_table_files_size=3;allow_"
-      "compaction=true;age_for_warm=0;file_temperature_age_thresholds={{"
+      "compaction=true;age_for_warm=0;time_window_seconds=3600;"
+      "file_temperature_age_thresholds={{"
       "temperature=kCold;age=12345}};};"
       "blob_cache=1M;"
       "memtable_protection_bytes_per_key=2;"
@@ -673,6 +704,9 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
       "block_protection_bytes_per_key=1;"
       "memtable_max_range_deletions=999999;"
       "bottommost_file_compaction_delay=7200;"
+      "range_deletion_compaction_ratio=0.5;"
+      "read_triggered_compaction_bytes_per_lookup=16384;"
+      "shard_level0_by_sst_partitioner=true;"
       "uncache_aggressiveness=1234;"
       "paranoid_memory_checks=1;"
       "memtable_op_scan_flush_trigger=123;",
@@ -688,6 +722,7 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
   // kColumnFamilyOptionsExcluded
   ASSERT_EQ(new_options->compaction_options_fifo.max_table_files_size, 3);
   ASSERT_EQ(new_options->compaction_options_fifo.allow_compaction, true);
+  ASSERT_EQ(new_options->compaction_options_fifo.time_window_seconds, 3600);
   ASSERT_EQ(new_options->compaction_options_fifo.file_temperature_age_thresholds
                 .size(),
             1);
@@ -718,6 +753,15 @@ TEST_F(OptionsSettableTest, ColumnFamilyOptionsAllFieldsSettable) {
        sizeof(std::vector<int>)},
       {offsetof(struct MutableCFOptions, compaction_options_fifo),
        sizeof(struct CompactionOptionsFIFO)},
+      // Padding before
+      // CompactionOptionsUniversal::lazy_leveling_runs_per_tier
+      {offsetof(struct MutableCFOptions, compaction_options_universal) +
+           offsetof(struct CompactionOptionsUniversal, incremental) +
+           sizeof(bool),
+       offsetof(struct CompactionOptionsUniversal,
+                lazy_leveling_runs_per_tier) -
+           offsetof(struct CompactionOptionsUniversal, incremental) -
+           sizeof(bool)},
       {offsetof(struct MutableCFOptions, compression_per_level),
        sizeof(std::vector<CompressionType>)},
       {offsetof(struct MutableCFOptions, max_file_size),
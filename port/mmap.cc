@@ -12,6 +12,7 @@
 #include <utility>
 
 #include "util/hash.h"
+#include "util/math.h"
 
 namespace ROCKSDB_NAMESPACE {
 
@@ -48,7 +49,8 @@ MemMapping& MemMapping::operator=(MemMapping&& other) noexcept {
   return *this;
 }
 
-MemMapping MemMapping::AllocateAnonymous(size_t length, bool huge) {
+MemMapping MemMapping::AllocateAnonymous(size_t length, bool huge,
+                                         size_t huge_page_size) {
   MemMapping mm;
   mm.length_ = length;
   assert(mm.addr_ == nullptr);
@@ -57,6 +59,7 @@ MemMapping MemMapping::AllocateAnonymous(size_t length, bool huge) {
     return mm;
   }
   int huge_flag = 0;
+  (void)huge_page_size;
 #ifdef OS_WIN
   if (huge) {
 #ifdef FILE_MAP_LARGE_PAGES
@@ -78,6 +81,19 @@ MemMapping MemMapping::AllocateAnonymous(size_t length, bool huge) {
     huge_flag = MAP_HUGETLB;
 #endif  // MAP_HUGE_TLB
   }
+#ifdef MAP_HUGE_SHIFT
+  if (huge_flag != 0 && huge_page_size > 0 &&
+      (huge_page_size & (huge_page_size - 1)) == 0) {
+    // Request the specific huge page size, falling back on the default size
+    mm.addr_ = mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | huge_flag |
+                        (FloorLog2(huge_page_size) << MAP_HUGE_SHIFT),
+                    -1, 0);
+    if (mm.addr_ != MAP_FAILED) {
+      return mm;
+    }
+  }
+#endif  // MAP_HUGE_SHIFT
   mm.addr_ = mmap(nullptr, length, PROT_READ | PROT_WRITE,
                   MAP_PRIVATE | MAP_ANONYMOUS | huge_flag, -1, 0);
   if (mm.addr_ == MAP_FAILED) {
@@ -87,8 +103,8 @@ MemMapping MemMapping::AllocateAnonymous(size_t length, bool huge) {
   return mm;
 }
 
-MemMapping MemMapping::AllocateHuge(size_t length) {
-  return AllocateAnonymous(length, /*huge*/ true);
+MemMapping MemMapping::AllocateHuge(size_t length, size_t huge_page_size) {
+  return AllocateAnonymous(length, /*huge*/ true, huge_page_size);
 }
 
 MemMapping MemMapping::AllocateLazyZeroed(size_t length) {
@@ -30,8 +30,10 @@ class MemMapping {
       false;
 #endif
 
-  // Allocate memory requesting to be backed by huge pages
-  static MemMapping AllocateHuge(size_t length);
+  // Allocate memory requesting to be backed by huge pages, of size
+  // `huge_page_size` if non-zero and supported by the platform (e.g. 1GB
+  // rather than the default size), otherwise of the default huge page size
+  static MemMapping AllocateHuge(size_t length, size_t huge_page_size = 0);
 
   // Allocate memory that is only lazily mapped to resident memory and
   // guaranteed to be zero-initialized. Note that some platforms like
@@ -65,7 +67,8 @@ class MemMapping {
   HANDLE page_file_handle_ = NULL;
 #endif  // OS_WIN
 
-  static MemMapping AllocateAnonymous(size_t length, bool huge);
+  static MemMapping AllocateAnonymous(size_t length, bool huge,
+                                      size_t huge_page_size = 0);
 };
 
 // Simple MemMapping wrapper that presents the memory as an array of T.
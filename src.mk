@@ -2,17 +2,20 @@
 LIB_SOURCES =                                                   \
   cache/cache.cc                                                \
   cache/cache_entry_roles.cc                                    \
+  cache/cache_owner.cc                                          \
   cache/cache_key.cc                                            \
   cache/cache_helpers.cc                                        \
   cache/cache_reservation_manager.cc                            \
   cache/charged_cache.cc                                        \
   cache/clock_cache.cc                                          \
   cache/lru_cache.cc                                            \
+  cache/nvm_secondary_cache.cc                                  \
   cache/compressed_secondary_cache.cc                           \
   cache/secondary_cache.cc                                      \
   cache/secondary_cache_adapter.cc                              \
   cache/sharded_cache.cc                                        \
   cache/tiered_secondary_cache.cc                               \
+  cache/tiny_lfu_admission_cache.cc                             \
   db/arena_wrapped_db_iter.cc                                   \
   db/attribute_group_iterator_impl.cc                           \
   db/blob/blob_contents.cc                                      \
@@ -43,6 +46,7 @@ LIB_SOURCES =                                                   \
   db/compaction/compaction_service_job.cc                       \
   db/compaction/compaction_state.cc                             \
   db/compaction/compaction_outputs.cc                           \
+  db/compaction/compaction_output_warmer.cc                     \
   db/compaction/sst_partitioner.cc                              \
   db/compaction/subcompaction_state.cc                          \
   db/convenience.cc                                             \
@@ -88,6 +92,7 @@ LIB_SOURCES =                                                   \
   db/seqno_to_time_mapping.cc                                   \
   db/snapshot_impl.cc                                           \
   db/table_cache.cc                                             \
+  db/user_key_row_cache.cc                                      \
   db/table_properties_collector.cc                              \
   db/transaction_log_impl.cc                                    \
   db/trim_history_scheduler.cc                                  \
@@ -135,6 +140,7 @@ LIB_SOURCES =                                                   \
   memory/arena.cc                                               \
   memory/concurrent_arena.cc                                    \
   memory/jemalloc_nodump_allocator.cc                           \
+  memory/huge_page_allocator.cc                                 \
   memory/memkind_kmem_allocator.cc                              \
   memory/memory_allocator.cc                                    \
   memtable/alloc_tracker.cc                                     \
@@ -193,6 +199,7 @@ LIB_SOURCES =                                                   \
   table/block_based/flush_block_policy.cc                       \
   table/block_based/full_filter_block.cc                        \
   table/block_based/hash_index_reader.cc                        \
+  table/block_based/hot_partition_pinner.cc                     \
   table/block_based/index_builder.cc                            \
   table/block_based/index_reader_common.cc                      \
   table/block_based/parsed_full_filter_block.cc                 \
@@ -200,6 +207,7 @@ LIB_SOURCES =                                                   \
   table/block_based/partitioned_index_iterator.cc               \
   table/block_based/partitioned_index_reader.cc                 \
   table/block_based/reader_common.cc                            \
+  table/block_based/shared_compression_dict.cc                  \
   table/block_based/uncompression_dict_reader.cc                \
   table/block_fetcher.cc                                        \
   table/cuckoo/cuckoo_table_builder.cc                          \
@@ -272,6 +280,7 @@ LIB_SOURCES =                                                   \
   utilities/blob_db/blob_db_impl_filesnapshot.cc                \
   utilities/blob_db/blob_file.cc                                \
   utilities/cache_dump_load.cc                                  \
+  utilities/block_cache_snapshot.cc                             \
   utilities/cache_dump_load_impl.cc                             \
   utilities/cassandra/cassandra_compaction_filter.cc            \
   utilities/cassandra/format.cc                                 \
@@ -309,6 +318,8 @@ LIB_SOURCES =                                                   \
   utilities/secondary_index/simple_secondary_index.cc           \
   utilities/simulator_cache/cache_simulator.cc                  \
   utilities/simulator_cache/sim_cache.cc                        \
+  utilities/memory_tuner/memory_tuner.cc                        \
+  utilities/local_compaction_service/local_compaction_service.cc \
   utilities/table_properties_collectors/compact_for_tiering_collector.cc \
   utilities/table_properties_collectors/compact_on_deletion_collector.cc \
   utilities/trace/file_trace_reader_writer.cc                   \
@@ -431,6 +442,7 @@ FOLLY_SOURCES =                                                 \
 TOOLS_MAIN_SOURCES =                                                    \
   db_stress_tool/db_stress.cc                                           \
   tools/blob_dump.cc                                                    \
+  tools/compaction_service_worker.cc                                    \
   tools/block_cache_analyzer/block_cache_trace_analyzer_tool.cc         \
   tools/db_repl_stress.cc                                               \
   tools/db_sanity_test.cc                                               \
@@ -457,7 +469,9 @@ TEST_MAIN_SOURCES =                                                     \
   cache/cache_reservation_manager_test.cc                               \
   cache/compressed_secondary_cache_test.cc                              \
   cache/lru_cache_test.cc                                               \
+  cache/nvm_secondary_cache_test.cc                                     \
   cache/tiered_secondary_cache_test.cc					                        \
+  cache/tiny_lfu_admission_cache_test.cc                                \
   db/blob/blob_counting_iterator_test.cc                                \
   db/blob/blob_file_addition_test.cc                                    \
   db/blob/blob_file_builder_test.cc                                     \
@@ -643,6 +657,8 @@ TEST_MAIN_SOURCES =                                                     \
   utilities/persistent_cache/persistent_cache_test.cc                   \
   utilities/simulator_cache/cache_simulator_test.cc                     \
   utilities/simulator_cache/sim_cache_test.cc                           \
+  utilities/memory_tuner/memory_tuner_test.cc                           \
+  utilities/local_compaction_service/local_compaction_service_test.cc   \
   utilities/table_properties_collectors/compact_for_tiering_collector_test.cc \
   utilities/table_properties_collectors/compact_on_deletion_collector_test.cc  \
   utilities/transactions/optimistic_transaction_test.cc                 \
@@ -17,6 +17,7 @@
 #include <memory>
 #include <numeric>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 
@@ -37,6 +38,7 @@
 #include "rocksdb/flush_block_policy.h"
 #include "rocksdb/merge_operator.h"
 #include "rocksdb/table.h"
+#include "rocksdb/threadpool.h"
 #include "rocksdb/types.h"
 #include "table/block_based/block.h"
 #include "table/block_based/block_based_table_factory.h"
@@ -46,6 +48,7 @@
 #include "table/block_based/filter_policy_internal.h"
 #include "table/block_based/full_filter_block.h"
 #include "table/block_based/partitioned_filter_block.h"
+#include "table/block_based/shared_compression_dict.h"
 #include "table/format.h"
 #include "table/meta_blocks.h"
 #include "table/table_builder.h"
@@ -115,6 +118,25 @@ bool GoodCompressionRatio(size_t compressed_size, size_t uncomp_size,
          10;
 }
 
+// Level used for the blocks that are compressed while the shared parallel
+// compression pool is backlogged. See
+// CompressionOptions::adaptive_parallel_level.
+constexpr int kAdaptiveParallelFastLevel = 1;
+
+bool CompressionTypeHasLevel(CompressionType type) {
+  return type == kZlibCompression || type == kLZ4HCCompression ||
+         type == kZSTD;
+}
+
+// Process-wide pool for CompressionOptions::use_shared_parallel_pool. It is
+// intentionally leaked so that it can never be destroyed before a builder
+// that uses it.
+ThreadPool* GetSharedParallelCompressionPool() {
+  static ThreadPool* const pool = NewThreadPool(
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+  return pool;
+}
+
 }  // namespace
 
 // format_version is the block format as defined in include/rocksdb/table.h
@@ -214,16 +236,42 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
  public:
   explicit BlockBasedTablePropertiesCollector(
       BlockBasedTableOptions::IndexType index_type, bool whole_key_filtering,
-      bool prefix_filtering, bool decoupled_partitioned_filters)
+      bool prefix_filtering, bool decoupled_partitioned_filters,
+      uint32_t num_key_anchors)
       : index_type_(index_type),
         whole_key_filtering_(whole_key_filtering),
         prefix_filtering_(prefix_filtering),
-        decoupled_partitioned_filters_(decoupled_partitioned_filters) {}
+        decoupled_partitioned_filters_(decoupled_partitioned_filters),
+        num_key_anchors_(num_key_anchors) {}
 
-  Status InternalAdd(const Slice& /*key*/, const Slice& /*value*/,
+  Status InternalAdd(const Slice& key, const Slice& value,
                      uint64_t /*file_size*/) override {
-    // Intentionally left blank. Have no interest in collecting stats for
-    // individual key/value pairs.
+    // Only interested in key/value pairs for sampling key anchors. Range
+    // tombstones are added out of key order, so they are not sampled.
+    if (num_key_anchors_ == 0 || ExtractValueType(key) == kTypeRangeDeletion) {
+      return Status::OK();
+    }
+    Slice user_key = ExtractUserKey(key);
+    range_bytes_ += key.size() + value.size();
+    if (range_bytes_ < anchor_interval_) {
+      last_user_key_.assign(user_key.data(), user_key.size());
+      return Status::OK();
+    }
+    anchors_.emplace_back(user_key.ToString(), range_bytes_);
+    range_bytes_ = 0;
+    last_user_key_.clear();
+    if (anchors_.size() >= 2 * size_t{num_key_anchors_}) {
+      assert(anchors_.size() % 2 == 0);
+      // Merge pairs of adjacent ranges and sample half as often from now on
+      size_t merged = 0;
+      for (size_t i = 0; i + 1 < anchors_.size(); i += 2) {
+        anchors_[merged].first = std::move(anchors_[i + 1].first);
+        anchors_[merged].second = anchors_[i].second + anchors_[i + 1].second;
+        ++merged;
+      }
+      anchors_.resize(merged);
+      anchor_interval_ *= 2;
+    }
     return Status::OK();
   }
 
@@ -247,6 +295,20 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
           {BlockBasedTablePropertyNames::kDecoupledPartitionedFilters,
            kPropTrue});
     }
+    if (num_key_anchors_ > 0) {
+      if (range_bytes_ > 0) {
+        // The rest of the file
+        anchors_.emplace_back(std::move(last_user_key_), range_bytes_);
+      }
+      std::string encoded;
+      PutVarint32(&encoded, static_cast<uint32_t>(anchors_.size()));
+      for (const auto& anchor : anchors_) {
+        PutLengthPrefixedSlice(&encoded, anchor.first);
+        PutVarint64(&encoded, anchor.second);
+      }
+      properties->insert(
+          {BlockBasedTablePropertyNames::kKeyAnchors, std::move(encoded)});
+    }
     return Status::OK();
   }
 
@@ -265,6 +327,13 @@ class BlockBasedTableBuilder::BlockBasedTablePropertiesCollector
   bool whole_key_filtering_;
   bool prefix_filtering_;
   bool decoupled_partitioned_filters_;
+  uint32_t num_key_anchors_;
+  // Sampled keys with the key and value bytes of the range ending at each
+  std::vector<std::pair<std::string, uint64_t>> anchors_;
+  // Key and value bytes between consecutive anchors
+  uint64_t anchor_interval_ = 1;
+  uint64_t range_bytes_ = 0;
+  std::string last_user_key_;
 };
 
 struct BlockBasedTableBuilder::Rep {
@@ -318,6 +387,16 @@ struct BlockBasedTableBuilder::Rep {
   std::vector<std::unique_ptr<CompressionContext>> compression_ctxs;
   std::vector<std::unique_ptr<UncompressionContext>> verify_ctxs;
   std::unique_ptr<UncompressionDict> verify_dict;
+  // Only set when compression dictionaries may be reused across files (see
+  // CompressionOptions::max_dict_reuse_files), for publishing the dictionary
+  // trained for this file.
+  CompressionDictReuseRegistry* dict_reuse_registry = nullptr;
+  const uint32_t column_family_id;
+  const int level_at_creation;
+  // Only set when compression_opts.adaptive_parallel_level is in effect;
+  // same as compression_opts / compression_ctxs, but at the fastest level.
+  std::unique_ptr<CompressionOptions> fast_compression_opts;
+  std::vector<std::unique_ptr<CompressionContext>> fast_compression_ctxs;
 
   size_t data_begin_offset = 0;
 
@@ -356,6 +435,8 @@ struct BlockBasedTableBuilder::Rep {
   std::unique_ptr<FilterBlockBuilder> filter_builder;
   OffsetableCacheKey base_cache_key;
   const TableFileCreationReason reason;
+  // Only set for compaction outputs that may warm the block cache
+  CompactionOutputWarmer* const output_warmer;
 
   BlockHandle pending_handle;  // Handle to add to index block
 
@@ -381,6 +462,11 @@ struct BlockBasedTableBuilder::Rep {
     return compression_opts.parallel_threads > 1;
   }
 
+  bool UseSharedParallelPool() const {
+    return IsParallelCompressionEnabled() &&
+           compression_opts.use_shared_parallel_pool;
+  }
+
   Status GetStatus() {
     // We need to make modifications of status visible when status_ok is set
     // to false, and this is ensured by status_mutex, so no special memory
@@ -489,6 +575,8 @@ struct BlockBasedTableBuilder::Rep {
         compression_ctxs(tbo.compression_opts.parallel_threads),
         verify_ctxs(tbo.compression_opts.parallel_threads),
         verify_dict(),
+        column_family_id(tbo.column_family_id),
+        level_at_creation(tbo.level_at_creation),
         state((tbo.compression_opts.max_dict_bytes > 0 &&
                tbo.compression_type != kNoCompression)
                   ? State::kBuffered
@@ -496,6 +584,7 @@ struct BlockBasedTableBuilder::Rep {
         use_delta_encoding_for_index_values(table_opt.format_version >= 4 &&
                                             !table_opt.block_align),
         reason(tbo.reason),
+        output_warmer(tbo.output_warmer),
         flush_block_policy(
             table_options.flush_block_policy_factory->NewFlushBlockPolicy(
                 table_options, data_block)),
@@ -540,6 +629,37 @@ struct BlockBasedTableBuilder::Rep {
       compression_ctxs[i].reset(
           new CompressionContext(compression_type, compression_opts));
     }
+    if (UseSharedParallelPool() && compression_opts.adaptive_parallel_level &&
+        CompressionTypeHasLevel(compression_type) &&
+        compression_opts.level > kAdaptiveParallelFastLevel) {
+      fast_compression_opts.reset(new CompressionOptions(compression_opts));
+      fast_compression_opts->level = kAdaptiveParallelFastLevel;
+      fast_compression_ctxs.resize(compression_opts.parallel_threads);
+      for (uint32_t i = 0; i < compression_opts.parallel_threads; i++) {
+        fast_compression_ctxs[i].reset(
+            new CompressionContext(compression_type, *fast_compression_opts));
+      }
+    }
+    if (state == State::kBuffered &&
+        tbo.compression_dict_reuse_registry != nullptr &&
+        compression_opts.max_dict_reuse_files > 0 &&
+        reason != TableFileCreationReason::kMisc && level_at_creation >= 0) {
+      dict_reuse_registry = tbo.compression_dict_reuse_registry;
+      std::shared_ptr<const std::string> dict = dict_reuse_registry->TryReuse(
+          level_at_creation, compression_type,
+          compression_opts.max_dict_bytes);
+      if (dict) {
+        // Skip buffering and compress with the dictionary right away
+        TEST_SYNC_POINT("BlockBasedTableBuilder::Rep:ReuseCompressionDict");
+        if (table_options.verify_compression) {
+          verify_dict.reset(new UncompressionDict(std::string(*dict),
+                                                  compression_type == kZSTD));
+        }
+        compression_dict.reset(new CompressionDict(
+            std::string(*dict), compression_type, compression_opts.level));
+        state = State::kUnbuffered;
+      }
+    }
     if (table_options.index_type ==
         BlockBasedTableOptions::kTwoLevelIndexSearch) {
       p_index_builder_ = PartitionedIndexBuilder::CreateIndexBuilder(
@@ -602,7 +722,8 @@ struct BlockBasedTableBuilder::Rep {
         new BlockBasedTablePropertiesCollector(
             table_options.index_type, table_options.whole_key_filtering,
             prefix_extractor != nullptr,
-            table_options.decouple_partitioned_filters));
+            table_options.decouple_partitioned_filters,
+            table_options.num_sampled_key_anchors));
     if (ts_sz > 0 && persist_user_defined_timestamps) {
       table_properties_collectors.emplace_back(
           new TimestampTablePropertiesCollector(
@@ -751,6 +872,20 @@ struct BlockBasedTableBuilder::ParallelCompressionRep {
   CompressQueue compress_queue;
   std::vector<port::Thread> compress_thread_pool;
 
+  // With CompressionOptions::use_shared_parallel_pool, there are no
+  // compression threads owned by the builder. Instead, one job is submitted
+  // to the shared pool for each block pushed to compress_queue, and the job
+  // borrows one of the builder's compression contexts (identified by index)
+  // for the duration of the compression. Since there are as many contexts as
+  // there are BlockReps, a job never has to wait for a context.
+  ThreadPool* shared_pool = nullptr;
+  std::function<void()> shared_compression_job;
+  WorkQueue<uint32_t> free_ctx_indexes;
+  // Number of submitted jobs that have not completed yet
+  uint32_t shared_jobs_inflight = 0;
+  std::mutex shared_jobs_mutex;
+  std::condition_variable shared_jobs_cond;
+
   // Write queue will pass references to BlockRep::slot in block_rep_buf,
   // and those references are always valid before the corresponding
   // BlockRep::slot is destructed, which is before the destruction of
@@ -874,6 +1009,7 @@ struct BlockBasedTableBuilder::ParallelCompressionRep {
         block_rep_buf(parallel_threads),
         block_rep_pool(parallel_threads),
         compress_queue(parallel_threads),
+        free_ctx_indexes(parallel_threads),
         write_queue(parallel_threads),
         first_block_processed(false) {
     for (uint32_t i = 0; i < parallel_threads; i++) {
@@ -931,6 +1067,13 @@ struct BlockBasedTableBuilder::ParallelCompressionRep {
     if (!compress_queue.push(block_rep)) {
       return;
     }
+    if (shared_pool != nullptr) {
+      {
+        std::lock_guard<std::mutex> lock(shared_jobs_mutex);
+        ++shared_jobs_inflight;
+      }
+      shared_pool->SubmitJob(shared_compression_job);
+    }
 
     if (!first_block_processed.load(std::memory_order_relaxed)) {
       std::unique_lock<std::mutex> lock(first_block_mutex);
@@ -940,6 +1083,20 @@ struct BlockBasedTableBuilder::ParallelCompressionRep {
     }
   }
 
+  // Called by a shared pool job once it is done with its block
+  void FinishSharedJob() {
+    std::lock_guard<std::mutex> lock(shared_jobs_mutex);
+    assert(shared_jobs_inflight > 0);
+    if (--shared_jobs_inflight == 0) {
+      shared_jobs_cond.notify_all();
+    }
+  }
+
+  void WaitForSharedJobs() {
+    std::unique_lock<std::mutex> lock(shared_jobs_mutex);
+    shared_jobs_cond.wait(lock, [this] { return shared_jobs_inflight == 0; });
+  }
+
   // Reap a block from compression thread
   void ReapBlock(BlockRep* block_rep) {
     assert(block_rep != nullptr);
@@ -1225,11 +1382,51 @@ void BlockBasedTableBuilder::BGWorkCompression(
   }
 }
 
+void BlockBasedTableBuilder::BGWorkSharedCompression() {
+  Rep* r = rep_;
+  ParallelCompressionRep* pc_rep = r->pc_rep.get();
+  ParallelCompressionRep::BlockRep* block_rep = nullptr;
+  // Exactly one job is submitted per block pushed to compress_queue, and
+  // the queue is only finished after all jobs completed.
+  bool popped = pc_rep->compress_queue.pop(block_rep);
+  assert(popped);
+  (void)popped;
+  assert(block_rep != nullptr);
+
+  uint32_t ctx_index = 0;
+  pc_rep->free_ctx_indexes.pop(ctx_index);
+
+  // Jobs queued up beyond the number of threads mean that blocks are produced
+  // faster than they can be compressed.
+  bool use_fast_level = false;
+  if (r->fast_compression_opts != nullptr) {
+    ThreadPool* pool = pc_rep->shared_pool;
+    use_fast_level = pool->GetQueueLen() >=
+                     static_cast<unsigned int>(pool->GetBackgroundThreads());
+    TEST_SYNC_POINT_CALLBACK(
+        "BlockBasedTableBuilder::BGWorkSharedCompression:UseFastLevel",
+        &use_fast_level);
+  }
+  const CompressionContext& compression_ctx =
+      use_fast_level ? *r->fast_compression_ctxs[ctx_index]
+                     : *r->compression_ctxs[ctx_index];
+  CompressAndVerifyBlock(block_rep->contents, true, /* is_data_block*/
+                         compression_ctx, r->verify_ctxs[ctx_index].get(),
+                         block_rep->compressed_data.get(),
+                         &block_rep->compressed_contents,
+                         &(block_rep->compression_type), &block_rep->status,
+                         use_fast_level);
+
+  pc_rep->free_ctx_indexes.push(ctx_index);
+  block_rep->slot->Fill(block_rep);
+  pc_rep->FinishSharedJob();
+}
+
 void BlockBasedTableBuilder::CompressAndVerifyBlock(
     const Slice& uncompressed_block_data, bool is_data_block,
     const CompressionContext& compression_ctx, UncompressionContext* verify_ctx,
     std::string* compressed_output, Slice* block_contents,
-    CompressionType* type, Status* out_status) {
+    CompressionType* type, Status* out_status, bool use_fast_level) {
   Rep* r = rep_;
   bool is_status_ok = ok();
   if (!r->IsParallelCompressionEnabled()) {
@@ -1266,8 +1463,10 @@ void BlockBasedTableBuilder::CompressAndVerifyBlock(
       compression_dict = r->compression_dict.get();
     }
     assert(compression_dict != nullptr);
-    CompressionInfo compression_info(r->compression_opts, compression_ctx,
-                                     *compression_dict, *type);
+    assert(!use_fast_level || r->fast_compression_opts != nullptr);
+    CompressionInfo compression_info(
+        use_fast_level ? *r->fast_compression_opts : r->compression_opts,
+        compression_ctx, *compression_dict, *type);
 
     std::string sampled_output_fast;
     std::string sampled_output_slow;
@@ -1435,6 +1634,15 @@ void BlockBasedTableBuilder::WriteMaybeCompressedBlock(
       case BlockBasedTableOptions::PrepopulateBlockCache::kFlushOnly:
         warm_cache = (r->reason == TableFileCreationReason::kFlush);
         break;
+      case BlockBasedTableOptions::PrepopulateBlockCache::
+          kFlushAndHotCompaction:
+        if (r->reason == TableFileCreationReason::kFlush) {
+          warm_cache = true;
+        } else {
+          warm_cache = is_data_block && r->output_warmer != nullptr &&
+                       IsHotCompactionOutputBlock(*uncompressed_block_data);
+        }
+        break;
       case BlockBasedTableOptions::PrepopulateBlockCache::kDisable:
         warm_cache = false;
         break;
@@ -1546,13 +1754,23 @@ void BlockBasedTableBuilder::BGWorkWriteMaybeCompressedBlock() {
 void BlockBasedTableBuilder::StartParallelCompression() {
   rep_->pc_rep.reset(
       new ParallelCompressionRep(rep_->compression_opts.parallel_threads));
-  rep_->pc_rep->compress_thread_pool.reserve(
-      rep_->compression_opts.parallel_threads);
-  for (uint32_t i = 0; i < rep_->compression_opts.parallel_threads; i++) {
-    rep_->pc_rep->compress_thread_pool.emplace_back([this, i] {
-      BGWorkCompression(*(rep_->compression_ctxs[i]),
-                        rep_->verify_ctxs[i].get());
-    });
+  if (rep_->UseSharedParallelPool()) {
+    rep_->pc_rep->shared_pool = GetSharedParallelCompressionPool();
+    rep_->pc_rep->shared_compression_job = [this] {
+      BGWorkSharedCompression();
+    };
+    for (uint32_t i = 0; i < rep_->compression_opts.parallel_threads; i++) {
+      rep_->pc_rep->free_ctx_indexes.push(i);
+    }
+  } else {
+    rep_->pc_rep->compress_thread_pool.reserve(
+        rep_->compression_opts.parallel_threads);
+    for (uint32_t i = 0; i < rep_->compression_opts.parallel_threads; i++) {
+      rep_->pc_rep->compress_thread_pool.emplace_back([this, i] {
+        BGWorkCompression(*(rep_->compression_ctxs[i]),
+                          rep_->verify_ctxs[i].get());
+      });
+    }
   }
   rep_->pc_rep->write_thread.reset(
       new port::Thread([this] { BGWorkWriteMaybeCompressedBlock(); }));
@@ -1563,6 +1781,9 @@ void BlockBasedTableBuilder::StopParallelCompression() {
   for (auto& thread : rep_->pc_rep->compress_thread_pool) {
     thread.join();
   }
+  if (rep_->pc_rep->shared_pool != nullptr) {
+    rep_->pc_rep->WaitForSharedJobs();
+  }
   rep_->pc_rep->write_queue.finish();
   rep_->pc_rep->write_thread->join();
 }
@@ -1573,6 +1794,32 @@ IOStatus BlockBasedTableBuilder::io_status() const {
   return rep_->GetIOStatus();
 }
 
+bool BlockBasedTableBuilder::IsHotCompactionOutputBlock(
+    const Slice& block_contents) {
+  Rep* r = rep_;
+  assert(r->output_warmer != nullptr);
+
+  // Keys are only available in encoded form at this point
+  Block block{BlockContents(block_contents)};
+  std::unique_ptr<DataBlockIter> iter(block.NewDataIterator(
+      r->internal_comparator.user_comparator(), kDisableGlobalSequenceNumber,
+      /*iter=*/nullptr, /*stats=*/nullptr, /*block_contents_pinned=*/false,
+      r->persist_user_defined_timestamps));
+  iter->SeekToFirst();
+  if (!iter->Valid()) {
+    iter->status().PermitUncheckedError();
+    return false;
+  }
+  const std::string first_ikey = iter->key().ToString();
+  iter->SeekToLast();
+  if (!iter->Valid()) {
+    iter->status().PermitUncheckedError();
+    return false;
+  }
+  return r->output_warmer->ShouldWarmDataBlock(first_ikey, iter->key(),
+                                               block_contents.size());
+}
+
 Status BlockBasedTableBuilder::InsertBlockInCacheHelper(
     const Slice& block_contents, const BlockHandle* handle,
     BlockType block_type) {
@@ -1968,6 +2215,12 @@ void BlockBasedTableBuilder::EnterUnbuffered() {
     // dictionary."
     dict = std::move(compression_dict_samples);
   }
+  if (r->dict_reuse_registry != nullptr && !dict.empty()) {
+    r->dict_reuse_registry->Publish(
+        r->level_at_creation, r->compression_type,
+        r->compression_opts.max_dict_bytes,
+        r->compression_opts.max_dict_reuse_files, std::string(dict));
+  }
   if (r->table_options.verify_compression) {
     r->verify_dict.reset(
         new UncompressionDict(std::string(dict), r->compression_type == kZSTD));
@@ -142,6 +142,10 @@ class BlockBasedTableBuilder : public TableBuilder {
                                   const BlockHandle* handle,
                                   BlockType block_type);
 
+  // Asks the compaction output warmer whether to warm the given uncompressed
+  // data block
+  bool IsHotCompactionOutputBlock(const Slice& block_contents);
+
   Status InsertBlockInCompressedCache(const Slice& block_contents,
                                       const CompressionType type,
                                       const BlockHandle* handle);
@@ -178,8 +182,15 @@ class BlockBasedTableBuilder : public TableBuilder {
   void BGWorkCompression(const CompressionContext& compression_ctx,
                          UncompressionContext* verify_ctx);
 
+  // Compress a single block from the compression queue and pass it to the
+  // write thread. Runs on the process-wide pool used with
+  // CompressionOptions::use_shared_parallel_pool.
+  void BGWorkSharedCompression();
+
   // Given uncompressed block content, try to compress it and return result and
-  // compression type
+  // compression type. With `use_fast_level`, the block is compressed at the
+  // fastest level (see CompressionOptions::adaptive_parallel_level) and
+  // `compression_ctx` must be one of the matching contexts.
   void CompressAndVerifyBlock(const Slice& uncompressed_block_data,
                               bool is_data_block,
                               const CompressionContext& compression_ctx,
@@ -187,7 +198,7 @@ class BlockBasedTableBuilder : public TableBuilder {
                               std::string* compressed_output,
                               Slice* result_block_contents,
                               CompressionType* result_compression_type,
-                              Status* out_status);
+                              Status* out_status, bool use_fast_level = false);
 
   // Get compressed blocks from BGWorkCompression and write them into SST
   void BGWorkWriteMaybeCompressedBlock();
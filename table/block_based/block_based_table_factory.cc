@@ -214,14 +214,20 @@ static std::unordered_map<std::string, OptionTypeInfo>
         {"unpartitioned_pinning",
          OptionTypeInfo::Enum<PinningTier>(
              offsetof(struct MetadataCacheOptions, unpartitioned_pinning),
-             &pinning_tier_type_string_map)}};
+             &pinning_tier_type_string_map)},
+        {"hot_partition_pinning_budget",
+         {offsetof(struct MetadataCacheOptions, hot_partition_pinning_budget),
+          OptionType::kSizeT, OptionVerificationType::kNormal}}};
 
 static std::unordered_map<std::string,
                           BlockBasedTableOptions::PrepopulateBlockCache>
     block_base_table_prepopulate_block_cache_string_map = {
         {"kDisable", BlockBasedTableOptions::PrepopulateBlockCache::kDisable},
         {"kFlushOnly",
-         BlockBasedTableOptions::PrepopulateBlockCache::kFlushOnly}};
+         BlockBasedTableOptions::PrepopulateBlockCache::kFlushOnly},
+        {"kFlushAndHotCompaction",
+         BlockBasedTableOptions::PrepopulateBlockCache::
+             kFlushAndHotCompaction}};
 
 static struct BlockBasedTableTypeInfo {
   std::unordered_map<std::string, OptionTypeInfo> info;
@@ -252,6 +258,10 @@ static struct BlockBasedTableTypeInfo {
          {offsetof(struct BlockBasedTableOptions,
                    cache_index_and_filter_blocks_with_high_priority),
           OptionType::kBoolean, OptionVerificationType::kNormal}},
+        {"scan_bottom_priority_threshold",
+         {offsetof(struct BlockBasedTableOptions,
+                   scan_bottom_priority_threshold),
+          OptionType::kUInt32T, OptionVerificationType::kNormal}},
         {"pin_l0_filter_and_index_blocks_in_cache",
          {offsetof(struct BlockBasedTableOptions,
                    pin_l0_filter_and_index_blocks_in_cache),
@@ -351,12 +361,18 @@ static struct BlockBasedTableTypeInfo {
                 static_cast<uint32_t>(read_amp_bytes_per_bit);
             return Status::OK();
           }}},
+        {"num_sampled_key_anchors",
+         {offsetof(struct BlockBasedTableOptions, num_sampled_key_anchors),
+          OptionType::kUInt32T, OptionVerificationType::kNormal}},
         {"enable_index_compression",
          {offsetof(struct BlockBasedTableOptions, enable_index_compression),
           OptionType::kBoolean, OptionVerificationType::kNormal}},
         {"block_align",
          {offsetof(struct BlockBasedTableOptions, block_align),
           OptionType::kBoolean, OptionVerificationType::kNormal}},
+        {"mmap_zero_copy_data_blocks",
+         {offsetof(struct BlockBasedTableOptions, mmap_zero_copy_data_blocks),
+          OptionType::kBoolean, OptionVerificationType::kNormal}},
         {"pin_top_level_index_and_filter",
          {offsetof(struct BlockBasedTableOptions,
                    pin_top_level_index_and_filter),
@@ -385,6 +401,10 @@ static struct BlockBasedTableTypeInfo {
          OptionTypeInfo::Enum<BlockBasedTableOptions::PrepopulateBlockCache>(
              offsetof(struct BlockBasedTableOptions, prepopulate_block_cache),
              &block_base_table_prepopulate_block_cache_string_map)},
+        {"prepopulate_block_cache_compaction_budget",
+         {offsetof(struct BlockBasedTableOptions,
+                   prepopulate_block_cache_compaction_budget),
+          OptionType::kUInt64T, OptionVerificationType::kNormal}},
         {"initial_auto_readahead_size",
          {offsetof(struct BlockBasedTableOptions, initial_auto_readahead_size),
           OptionType::kSizeT, OptionVerificationType::kNormal}},
@@ -417,6 +437,13 @@ BlockBasedTableFactory::BlockBasedTableFactory(
                 CacheEntryRole::kBlockBasedTableReader>>(
                 table_options_.block_cache));
   }
+
+  if (table_options_.block_cache &&
+      table_options_.metadata_cache_options.hot_partition_pinning_budget > 0) {
+    shared_state_->hot_partition_pinning_budget =
+        std::make_unique<HotPartitionPinningBudget>(
+            table_options_.metadata_cache_options.hot_partition_pinning_budget);
+  }
 }
 
 void BlockBasedTableFactory::InitializeOptions() {
@@ -578,7 +605,8 @@ Status BlockBasedTableFactory::NewTableReader(
       table_reader_options.max_file_size_for_l0_meta_pin,
       table_reader_options.cur_db_session_id, table_reader_options.cur_file_num,
       table_reader_options.unique_id,
-      table_reader_options.user_defined_timestamps_persisted);
+      table_reader_options.user_defined_timestamps_persisted,
+      shared_state_->hot_partition_pinning_budget.get());
 }
 
 TableBuilder* BlockBasedTableFactory::NewTableBuilder(
@@ -749,6 +777,9 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
            "  cache_index_and_filter_blocks_with_high_priority: %d\n",
            table_options_.cache_index_and_filter_blocks_with_high_priority);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  scan_bottom_priority_threshold: %u\n",
+           table_options_.scan_bottom_priority_threshold);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize,
            "  pin_l0_filter_and_index_blocks_in_cache: %d\n",
            table_options_.pin_l0_filter_and_index_blocks_in_cache);
@@ -829,6 +860,9 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  read_amp_bytes_per_bit: %d\n",
            table_options_.read_amp_bytes_per_bit);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  num_sampled_key_anchors: %" PRIu32 "\n",
+           table_options_.num_sampled_key_anchors);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize, "  format_version: %d\n",
            table_options_.format_version);
   ret.append(buffer);
@@ -838,6 +872,9 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  block_align: %d\n",
            table_options_.block_align);
   ret.append(buffer);
+  snprintf(buffer, kBufferSize, "  mmap_zero_copy_data_blocks: %d\n",
+           table_options_.mmap_zero_copy_data_blocks);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize,
            "  max_auto_readahead_size: %" ROCKSDB_PRIszt "\n",
            table_options_.max_auto_readahead_size);
@@ -845,6 +882,10 @@ std::string BlockBasedTableFactory::GetPrintableOptions() const {
   snprintf(buffer, kBufferSize, "  prepopulate_block_cache: %d\n",
            static_cast<int>(table_options_.prepopulate_block_cache));
   ret.append(buffer);
+  snprintf(buffer, kBufferSize,
+           "  prepopulate_block_cache_compaction_budget: %" PRIu64 "\n",
+           table_options_.prepopulate_block_cache_compaction_budget);
+  ret.append(buffer);
   snprintf(buffer, kBufferSize,
            "  initial_auto_readahead_size: %" ROCKSDB_PRIszt "\n",
            table_options_.initial_auto_readahead_size);
@@ -977,6 +1018,8 @@ const std::string BlockBasedTablePropertyNames::kPrefixFiltering =
     "rocksdb.block.based.table.prefix.filtering";
 const std::string BlockBasedTablePropertyNames::kDecoupledPartitionedFilters =
     "rocksdb.block.based.table.decoupled.partitioned.filters";
+const std::string BlockBasedTablePropertyNames::kKeyAnchors =
+    "rocksdb.block.based.table.key.anchors";
 const std::string kHashIndexPrefixesBlock = "rocksdb.hashindex.prefixes";
 const std::string kHashIndexPrefixesMetadataBlock =
     "rocksdb.hashindex.metadata";
@@ -17,6 +17,7 @@
 #include "port/port.h"
 #include "rocksdb/flush_block_policy.h"
 #include "rocksdb/table.h"
+#include "table/block_based/hot_partition_pinner.h"
 
 namespace ROCKSDB_NAMESPACE {
 struct ColumnFamilyOptions;
@@ -107,6 +108,7 @@ class BlockBasedTableFactory : public TableFactory {
   struct SharedState {
     std::shared_ptr<CacheReservationManager> table_reader_cache_res_mgr;
     TailPrefetchStats tail_prefetch_stats;
+    std::unique_ptr<HotPartitionPinningBudget> hot_partition_pinning_budget;
   };
   std::shared_ptr<SharedState> shared_state_;
 };
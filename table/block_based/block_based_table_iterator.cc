@@ -13,7 +13,10 @@ namespace ROCKSDB_NAMESPACE {
 void BlockBasedTableIterator::SeekToFirst() { SeekImpl(nullptr, false); }
 
 void BlockBasedTableIterator::Seek(const Slice& target) {
-  SeekImpl(&target, true);
+  // Compaction input iterators do not retry a seek returning TryAgain, so
+  // with async IO they only prefetch asynchronously after the first block.
+  SeekImpl(&target,
+           lookup_context_.caller != TableReaderCaller::kCompaction);
 }
 
 void BlockBasedTableIterator::SeekSecondPass(const Slice* target) {
@@ -366,6 +369,7 @@ void BlockBasedTableIterator::InitDataBlock() {
 
     bool is_for_compaction =
         lookup_context_.caller == TableReaderCaller::kCompaction;
+    TrackSequentialScan(data_block_handle);
 
     // Initialize Data Block From CacheableEntry.
     if (is_in_cache) {
@@ -457,6 +461,7 @@ void BlockBasedTableIterator::AsyncInitDataBlock(bool is_first_pass) {
           rep, data_block_handle, read_options_.readahead_size,
           is_for_compaction, /*no_sequential_checking=*/read_options_.async_io,
           read_options_, readaheadsize_cb, read_options_.async_io);
+      TrackSequentialScan(data_block_handle);
 
       Status s;
       table_->NewDataBlockIterator<DataBlockIter>(
@@ -513,6 +518,23 @@ void BlockBasedTableIterator::AsyncInitDataBlock(bool is_first_pass) {
   async_read_in_progress_ = false;
 }
 
+void BlockBasedTableIterator::TrackSequentialScan(const BlockHandle& handle) {
+  const uint32_t threshold =
+      table_->get_rep()->table_options.scan_bottom_priority_threshold;
+  if (threshold == 0 ||
+      lookup_context_.caller != TableReaderCaller::kUserIterator) {
+    return;
+  }
+  if (handle.offset() == sequential_scan_end_offset_) {
+    ++num_sequential_blocks_;
+  } else {
+    num_sequential_blocks_ = 1;
+  }
+  sequential_scan_end_offset_ =
+      handle.offset() + BlockBasedTable::BlockSizeWithTrailer(handle);
+  lookup_context_.in_sequential_scan = num_sequential_blocks_ > threshold;
+}
+
 bool BlockBasedTableIterator::MaterializeCurrentBlock() {
   assert(is_at_first_key_from_index_);
   assert(!block_iter_points_to_real_block_);
@@ -305,6 +305,10 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
   const SliceTransform* prefix_extractor_;
   uint64_t prev_block_offset_ = std::numeric_limits<uint64_t>::max();
   BlockCacheLookupContext lookup_context_;
+  // End offset of the latest data block read, and the number of consecutive
+  // data blocks read up to it
+  uint64_t sequential_scan_end_offset_ = std::numeric_limits<uint64_t>::max();
+  uint32_t num_sequential_blocks_ = 0;
 
   BlockPrefetcher block_prefetcher_;
 
@@ -365,6 +369,10 @@ class BlockBasedTableIterator : public InternalIteratorBase<Slice> {
 
   void InitDataBlock();
   void AsyncInitDataBlock(bool is_first_pass);
+  // Detects sequential scans for
+  // BlockBasedTableOptions::scan_bottom_priority_threshold, before reading
+  // the data block at `handle`
+  void TrackSequentialScan(const BlockHandle& handle);
   bool MaterializeCurrentBlock();
   void FindKeyForward();
   void FindBlockForward();
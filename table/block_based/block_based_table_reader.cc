@@ -144,6 +144,13 @@ BlockBasedTable::~BlockBasedTable() {
   // mmap reads with block cache is weird, so it's not a concerning loss.
   if (ua > 0 && rep_->table_options.block_cache &&
       !rep_->ioptions.allow_mmap_reads) {
+    // Release adaptively pinned partitions so they can be erased below
+    if (rep_->filter_partition_pinner) {
+      rep_->filter_partition_pinner->UnpinAll();
+    }
+    if (rep_->index_partition_pinner) {
+      rep_->index_partition_pinner->UnpinAll();
+    }
     if (rep_->filter) {
       rep_->filter->EraseFromCacheBeforeDestruction(ua);
     }
@@ -636,7 +643,8 @@ Status BlockBasedTable::Open(
     BlockCacheTracer* const block_cache_tracer,
     size_t max_file_size_for_l0_meta_pin, const std::string& cur_db_session_id,
     uint64_t cur_file_num, UniqueId64x2 expected_unique_id,
-    const bool user_defined_timestamps_persisted) {
+    const bool user_defined_timestamps_persisted,
+    HotPartitionPinningBudget* hot_partition_pinning_budget) {
   table_reader->reset();
 
   Status s;
@@ -707,6 +715,7 @@ Status BlockBasedTable::Open(
       file_size, level, immortal_table, user_defined_timestamps_persisted);
   rep->file = std::move(file);
   rep->footer = footer;
+  rep->hot_partition_pinning_budget = hot_partition_pinning_budget;
 
   // For fully portable/stable cache keys, we need to read the properties
   // block before setting up cache keys. TODO: consider setting up a bootstrap
@@ -748,6 +757,25 @@ Status BlockBasedTable::Open(
       rep->internal_comparator.user_comparator(), rep->index_value_is_full,
       rep->index_has_first_key);
 
+  if (table_options.mmap_zero_copy_data_blocks && ioptions.allow_mmap_reads &&
+      !rep->blocks_maybe_compressed) {
+    // The file is actually memory mapped iff reads return data outside of
+    // the provided scratch buffer.
+    char probe = 0;
+    Slice result;
+    if (rep->file
+            ->Read(opts, /*offset=*/0, /*n=*/1, &result, &probe,
+                   /*aligned_buf=*/nullptr)
+            .ok() &&
+        result.size() == 1 && result.data() != &probe) {
+      const uint64_t bits = file_size / Rep::kZeroCopyVerifyGranularity + 1;
+      rep->zero_copy_verified_blocks_words =
+          static_cast<size_t>((bits + 63) / 64);
+      rep->zero_copy_verified_blocks.reset(
+          new RelaxedAtomic<uint64_t>[rep->zero_copy_verified_blocks_words]);
+    }
+  }
+
   // Check expected unique id if provided
   if (expected_unique_id != kNullUniqueId64x2) {
     auto props = rep->table_properties;
@@ -1212,6 +1240,18 @@ Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
     return s;
   }
 
+  // Partitions that are not pinned statically may be pinned based on their
+  // hotness
+  const bool pin_hot_partitions = !pin_partition &&
+                                  rep_->hot_partition_pinning_budget &&
+                                  table_options.block_cache;
+  if (pin_hot_partitions &&
+      index_type == BlockBasedTableOptions::kTwoLevelIndexSearch) {
+    rep_->index_partition_pinner =
+        std::make_unique<HotPartitionPinner<Block_kIndex>>(
+            this, rep_->hot_partition_pinning_budget);
+  }
+
   // pin the first level of filter
   const bool pin_filter =
       rep_->filter_type == Rep::FilterType::kPartitionedFilter
@@ -1235,6 +1275,12 @@ Status BlockBasedTable::PrefetchIndexAndFilterBlocks(
           return s;
         }
       }
+      if (pin_hot_partitions &&
+          rep_->filter_type == Rep::FilterType::kPartitionedFilter) {
+        rep_->filter_partition_pinner =
+            std::make_unique<HotPartitionPinner<ParsedFullFilterBlock>>(
+                this, rep_->hot_partition_pinning_budget);
+      }
       rep_->filter = std::move(filter);
     }
   }
@@ -1388,7 +1434,8 @@ WithBlocklikeCheck<Status, TBlocklike> BlockBasedTable::PutDataBlockToCache(
     BlockContents&& uncompressed_block_contents,
     BlockContents&& compressed_block_contents, CompressionType block_comp_type,
     const UncompressionDict& uncompression_dict,
-    MemoryAllocator* memory_allocator, GetContext* get_context) const {
+    MemoryAllocator* memory_allocator, GetContext* get_context,
+    Cache::Priority priority) const {
   const ImmutableOptions& ioptions = rep_->ioptions;
   const uint32_t format_version = rep_->table_options.format_version;
   assert(out_parsed_block);
@@ -1420,7 +1467,7 @@ WithBlocklikeCheck<Status, TBlocklike> BlockBasedTable::PutDataBlockToCache(
     size_t charge = block_holder->ApproximateMemoryUsage();
     BlockCacheTypedHandle<TBlocklike>* cache_handle = nullptr;
     s = block_cache.InsertFull(cache_key, block_holder.get(), charge,
-                               &cache_handle, GetCachePriority<TBlocklike>(),
+                               &cache_handle, priority,
                                rep_->ioptions.lowest_used_cache_tier,
                                compressed_block_contents.data, block_comp_type);
 
@@ -1624,6 +1671,11 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
         out_parsed_block->GetCacheHandle() == nullptr && !no_io &&
         ro.fill_cache) {
       Statistics* statistics = rep_->ioptions.stats;
+      Cache::Priority insert_priority = GetCachePriority<TBlocklike>();
+      if (TBlocklike::kBlockType == BlockType::kData &&
+          lookup_context != nullptr && lookup_context->in_sequential_scan) {
+        insert_priority = Cache::Priority::BOTTOM;
+      }
       const bool maybe_compressed =
           TBlocklike::kBlockType != BlockType::kFilter &&
           TBlocklike::kBlockType != BlockType::kCompressionDictionary &&
@@ -1700,7 +1752,8 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
           s = PutDataBlockToCache(
               key, block_cache, out_parsed_block, std::move(uncomp_contents),
               std::move(comp_contents), contents_comp_type, uncompression_dict,
-              GetMemoryAllocator(rep_->table_options), get_context);
+              GetMemoryAllocator(rep_->table_options), get_context,
+              insert_priority);
         }
       } else {
         contents_comp_type = GetBlockCompressionType(*contents);
@@ -1716,7 +1769,8 @@ BlockBasedTable::MaybeReadBlockAndLoadToCache(
           s = PutDataBlockToCache(
               key, block_cache, out_parsed_block, std::move(uncomp_contents),
               std::move(comp_contents), contents_comp_type, uncompression_dict,
-              GetMemoryAllocator(rep_->table_options), get_context);
+              GetMemoryAllocator(rep_->table_options), get_context,
+              insert_priority);
         }
       }
     }
@@ -1837,6 +1891,13 @@ WithBlocklikeCheck<Status, TBlocklike> BlockBasedTable::RetrieveBlock(
   assert(out_parsed_block);
   assert(out_parsed_block->IsEmpty());
 
+  if constexpr (TBlocklike::kBlockType == BlockType::kData) {
+    if (rep_->UsesZeroCopyDataBlocks()) {
+      return RetrieveZeroCopyDataBlock(ro, handle, for_compaction,
+                                       out_parsed_block);
+    }
+  }
+
   Status s;
   if (use_cache) {
     s = MaybeReadBlockAndLoadToCache(
@@ -1903,6 +1964,74 @@ WithBlocklikeCheck<Status, TBlocklike> BlockBasedTable::RetrieveBlock(
   return s;
 }
 
+Status BlockBasedTable::RetrieveZeroCopyDataBlock(
+    const ReadOptions& ro, const BlockHandle& handle, bool for_compaction,
+    CachableEntry<Block_kData>* block_entry) const {
+  assert(rep_->UsesZeroCopyDataBlocks());
+  assert(block_entry->IsEmpty());
+
+  if (ro.read_tier == kBlockCacheTier) {
+    return Status::Incomplete("no blocking io");
+  }
+
+  StopWatch sw(rep_->ioptions.clock, rep_->ioptions.stats,
+               for_compaction ? READ_BLOCK_COMPACTION_MICROS
+                              : READ_BLOCK_GET_MICROS);
+
+  const size_t block_size = static_cast<size_t>(handle.size());
+  const size_t block_size_with_trailer = block_size + kBlockTrailerSize;
+  Slice data;
+  IOOptions opts;
+  IOStatus io_s = rep_->file->PrepareIOOptions(ro, opts);
+  if (io_s.ok()) {
+    PERF_TIMER_GUARD(block_read_time);
+    // No scratch buffer needed, the result points into the mapping
+    io_s = rep_->file->Read(opts, handle.offset(), block_size_with_trailer,
+                            &data, /*scratch=*/nullptr,
+                            /*aligned_buf=*/nullptr);
+    PERF_COUNTER_ADD(block_read_count, 1);
+    PERF_COUNTER_ADD(block_read_byte, block_size_with_trailer);
+  }
+  if (io_s.ok() && data.size() != block_size_with_trailer) {
+    io_s = IOStatus::Corruption(
+        "truncated block read from " + rep_->file->file_name() + " offset " +
+        std::to_string(handle.offset()) + ", expected " +
+        std::to_string(block_size_with_trailer) + " bytes, got " +
+        std::to_string(data.size()));
+  }
+  if (!io_s.ok()) {
+    return io_s;
+  }
+
+  const bool tracked =
+      block_size_with_trailer >= Rep::kZeroCopyVerifyGranularity;
+  if (ro.verify_checksums &&
+      !(tracked && rep_->IsZeroCopyDataBlockVerified(handle.offset()))) {
+    Status s = VerifyBlockChecksum(rep_->footer, data.data(), block_size,
+                                   rep_->file->file_name(), handle.offset());
+    RecordTick(rep_->ioptions.stats, BLOCK_CHECKSUM_COMPUTE_COUNT);
+    if (!s.ok()) {
+      RecordTick(rep_->ioptions.stats, BLOCK_CHECKSUM_MISMATCH_COUNT);
+      return s;
+    }
+    if (tracked) {
+      rep_->MarkZeroCopyDataBlockVerified(handle.offset());
+    }
+  }
+  if (GetBlockCompressionType(data.data(), block_size) != kNoCompression) {
+    return Status::Corruption("Compressed data block in file " +
+                              rep_->file->file_name() +
+                              " without compression at offset " +
+                              std::to_string(handle.offset()));
+  }
+
+  std::unique_ptr<Block_kData> block;
+  rep_->create_context.Create(&block,
+                              BlockContents(Slice(data.data(), block_size)));
+  block_entry->SetOwnedValue(std::move(block));
+  return Status::OK();
+}
+
 BlockBasedTable::PartitionedIndexIteratorState::PartitionedIndexIteratorState(
     const BlockBasedTable* table,
     UnorderedMap<uint64_t, CachableEntry<Block>>* block_map)
@@ -2157,6 +2286,9 @@ void BlockBasedTable::FullFilterKeysMayMatch(
 
 Status BlockBasedTable::ApproximateKeyAnchors(const ReadOptions& read_options,
                                               std::vector<Anchor>& anchors) {
+  if (GetSampledKeyAnchors(anchors)) {
+    return Status::OK();
+  }
   // We iterator the whole index block here. More efficient implementation
   // is possible if we push this operation into IndexReader. For example, we
   // can directly sample from restart block entries in the index block and
@@ -2216,6 +2348,49 @@ Status BlockBasedTable::ApproximateKeyAnchors(const ReadOptions& read_options,
   return Status::OK();
 }
 
+bool BlockBasedTable::GetSampledKeyAnchors(std::vector<Anchor>& anchors) {
+  const auto& props = GetTableProperties();
+  if (props == nullptr) {
+    return false;
+  }
+  auto pos = props->user_collected_properties.find(
+      BlockBasedTablePropertyNames::kKeyAnchors);
+  if (pos == props->user_collected_properties.end()) {
+    return false;
+  }
+  Slice input = pos->second;
+  uint32_t num_anchors = 0;
+  if (!GetVarint32(&input, &num_anchors) || num_anchors == 0) {
+    return false;
+  }
+  std::vector<std::pair<Slice, uint64_t>> sampled;
+  sampled.reserve(num_anchors);
+  uint64_t total_bytes = 0;
+  for (uint32_t i = 0; i < num_anchors; ++i) {
+    Slice user_key;
+    uint64_t range_bytes = 0;
+    if (!GetLengthPrefixedSlice(&input, &user_key) ||
+        !GetVarint64(&input, &range_bytes)) {
+      ROCKS_LOG_WARN(rep_->ioptions.logger,
+                     "Corrupted key anchors property in %s",
+                     rep_->file->file_name().c_str());
+      return false;
+    }
+    sampled.emplace_back(user_key, range_bytes);
+    total_bytes += range_bytes;
+  }
+  // The anchors from the index measure ranges in file bytes, so scale to
+  // those, for comparing with files without sampled anchors
+  const double scale =
+      total_bytes > 0 ? static_cast<double>(props->data_size) / total_bytes
+                      : 0.0;
+  for (const auto& anchor : sampled) {
+    anchors.emplace_back(anchor.first,
+                         static_cast<size_t>(anchor.second * scale));
+  }
+  return true;
+}
+
 bool BlockBasedTable::TimestampMayMatch(const ReadOptions& read_options) const {
   if (read_options.timestamp != nullptr && !rep_->min_timestamp.empty()) {
     RecordTick(rep_->ioptions.stats, TIMESTAMP_FILTER_TABLE_CHECKED);
@@ -2322,6 +2497,7 @@ Status BlockBasedTable::Get(const ReadOptions& read_options, const Slice& key,
         s = biter.status();
         break;
       }
+      ++get_context->get_context_stats_.num_data_blocks_searched;
 
       bool may_exist = biter.SeekForGet(key);
       // If user-specified timestamp is supported, we cannot end the search
@@ -2681,6 +2857,85 @@ bool BlockBasedTable::EraseFromCache(const BlockHandle& handle) const {
   return cache->Release(cache_handle, /*erase_if_last_ref=*/true);
 }
 
+namespace {
+class BlockBasedDataBlockCacheProbe : public TableReader::DataBlockCacheProbe {
+ public:
+  BlockBasedDataBlockCacheProbe(
+      Cache* cache, const OffsetableCacheKey& base_cache_key,
+      const Comparator* ucmp,
+      std::unique_ptr<InternalIteratorBase<IndexValue>>&& index_iter)
+      : cache_(cache),
+        base_cache_key_(base_cache_key),
+        ucmp_(ucmp),
+        index_iter_(std::move(index_iter)) {}
+
+  ~BlockBasedDataBlockCacheProbe() override {
+    index_iter_->status().PermitUncheckedError();
+  }
+
+  bool IsDataBlockCached(const Slice& key) override {
+    const Slice user_key = ExtractUserKey(key);
+    // The index entry the iterator is on is kept if it still covers the key,
+    // or else the next one is tried before seeking from scratch.
+    if (!positioned_ || ucmp_->Compare(user_key, last_user_key_) < 0) {
+      index_iter_->Seek(key);
+    } else if (index_iter_->Valid() &&
+               ucmp_->Compare(user_key, index_iter_->user_key()) > 0) {
+      index_iter_->Next();
+      if (index_iter_->Valid() &&
+          ucmp_->Compare(user_key, index_iter_->user_key()) > 0) {
+        index_iter_->Seek(key);
+      }
+    }
+    last_user_key_.assign(user_key.data(), user_key.size());
+    // Past the end of the file, or index not available without I/O. Seeks
+    // again next time, as the index partition might have been read by then.
+    positioned_ = index_iter_->Valid();
+    if (!positioned_) {
+      index_iter_->status().PermitUncheckedError();
+      return false;
+    }
+
+    CacheKey cache_key = BlockBasedTable::GetCacheKey(
+        base_cache_key_, index_iter_->value().handle);
+    Cache::Handle* const cache_handle = cache_->Lookup(cache_key.AsSlice());
+    if (cache_handle == nullptr) {
+      return false;
+    }
+    // Not a use of the block. HyperClockCache then leaves it as if it had
+    // not been looked up, but LRUCache has no such probe and still moves it
+    // to the most recently used end.
+    cache_->Release(cache_handle, /*useful=*/false,
+                    /*erase_if_last_ref=*/false);
+    return true;
+  }
+
+ private:
+  Cache* const cache_;
+  const OffsetableCacheKey& base_cache_key_;
+  const Comparator* const ucmp_;
+  std::unique_ptr<InternalIteratorBase<IndexValue>> index_iter_;
+  bool positioned_ = false;
+  std::string last_user_key_;
+};
+}  // namespace
+
+std::unique_ptr<TableReader::DataBlockCacheProbe>
+BlockBasedTable::NewDataBlockCacheProbe(const ReadOptions& read_options) {
+  if (rep_->table_options.block_cache == nullptr) {
+    return nullptr;
+  }
+
+  ReadOptions ro = read_options;
+  ro.read_tier = kBlockCacheTier;
+  std::unique_ptr<InternalIteratorBase<IndexValue>> iiter(NewIndexIterator(
+      ro, /*need_upper_bound_check=*/false, /*input_iter=*/nullptr,
+      /*get_context=*/nullptr, /*lookup_context=*/nullptr));
+  return std::make_unique<BlockBasedDataBlockCacheProbe>(
+      rep_->table_options.block_cache.get(), rep_->base_cache_key,
+      rep_->internal_comparator.user_comparator(), std::move(iiter));
+}
+
 bool BlockBasedTable::TEST_BlockInCache(const BlockHandle& handle) const {
   assert(rep_ != nullptr);
 
@@ -114,7 +114,8 @@ class BlockBasedTable : public TableReader {
       size_t max_file_size_for_l0_meta_pin = 0,
       const std::string& cur_db_session_id = "", uint64_t cur_file_num = 0,
       UniqueId64x2 expected_unique_id = {},
-      const bool user_defined_timestamps_persisted = true);
+      const bool user_defined_timestamps_persisted = true,
+      HotPartitionPinningBudget* hot_partition_pinning_budget = nullptr);
 
   bool PrefixRangeMayMatch(const Slice& internal_key,
                            const ReadOptions& read_options,
@@ -181,9 +182,14 @@ class BlockBasedTable : public TableReader {
   uint64_t ApproximateSize(const ReadOptions& read_options, const Slice& start,
                            const Slice& end, TableReaderCaller caller) override;
 
+  // Uses the key anchors sampled by the table builder
+  // (`num_sampled_key_anchors`) when present, or else the index.
   Status ApproximateKeyAnchors(const ReadOptions& read_options,
                                std::vector<Anchor>& anchors) override;
 
+  std::unique_ptr<DataBlockCacheProbe> NewDataBlockCacheProbe(
+      const ReadOptions& read_options) override;
+
   bool EraseFromCache(const BlockHandle& handle) const;
 
   bool TEST_BlockInCache(const BlockHandle& handle) const;
@@ -324,6 +330,8 @@ class BlockBasedTable : public TableReader {
   friend class FilterBlockReaderCommon;
 
   friend class PartitionIndexReader;
+  template <typename TBlocklike>
+  friend class HotPartitionPinner;
 
   friend class UncompressionDictReader;
 
@@ -381,6 +389,13 @@ class BlockBasedTable : public TableReader {
       BlockCacheLookupContext* lookup_context, bool for_compaction,
       bool use_cache, bool async_read, bool use_block_cache_for_lookup) const;
 
+  // Reads a data block directly out of the memory mapped file, see
+  // BlockBasedTableOptions::mmap_zero_copy_data_blocks.
+  // REQUIRES: rep_->UsesZeroCopyDataBlocks()
+  Status RetrieveZeroCopyDataBlock(
+      const ReadOptions& ro, const BlockHandle& handle, bool for_compaction,
+      CachableEntry<Block_kData>* block_entry) const;
+
   template <typename TBlocklike>
   WithBlocklikeCheck<void, TBlocklike> SaveLookupContextOrTraceRecord(
       const Slice& block_key, bool is_cache_hit, const ReadOptions& ro,
@@ -441,6 +456,7 @@ class BlockBasedTable : public TableReader {
   // PutDataBlockToCache(). After the call, the object will be invalid.
   // @param uncompression_dict Data for presetting the compression library's
   //    dictionary.
+  // @param priority Priority to insert the block into block cache with.
   template <typename TBlocklike>
   WithBlocklikeCheck<Status, TBlocklike> PutDataBlockToCache(
       const Slice& cache_key, BlockCacheInterface<TBlocklike> block_cache,
@@ -449,7 +465,8 @@ class BlockBasedTable : public TableReader {
       BlockContents&& compressed_block_contents,
       CompressionType block_comp_type,
       const UncompressionDict& uncompression_dict,
-      MemoryAllocator* memory_allocator, GetContext* get_context) const;
+      MemoryAllocator* memory_allocator, GetContext* get_context,
+      Cache::Priority priority) const;
 
   // Calls (*handle_result)(arg, ...) repeatedly, starting with the entry found
   // after a call to Seek(key), until handle_result returns false.
@@ -543,6 +560,10 @@ class BlockBasedTable : public TableReader {
 
   bool TimestampMayMatch(const ReadOptions& read_options) const;
 
+  // Appends the key anchors stored in the table properties, if any, and
+  // returns whether there were.
+  bool GetSampledKeyAnchors(std::vector<Anchor>& anchors);
+
   // A cumulative data block file read in MultiGet lower than this size will
   // use a stack buffer
   static constexpr size_t kMultiGetReadStackBufSize = 8192;
@@ -686,6 +707,46 @@ struct BlockBasedTable::Rep {
   std::unique_ptr<CacheReservationManager::CacheReservationHandle>
       table_reader_cache_res_handle = nullptr;
 
+  // Budget shared with the other tables of the same table factory, if hot
+  // partition pinning is enabled (see
+  // MetadataCacheOptions::hot_partition_pinning_budget).
+  HotPartitionPinningBudget* hot_partition_pinning_budget = nullptr;
+  // Set up if hot partition pinning is enabled and the index (resp. filter)
+  // partitions of this table are not pinned statically.
+  std::unique_ptr<HotPartitionPinner<Block_kIndex>> index_partition_pinner;
+  std::unique_ptr<HotPartitionPinner<ParsedFullFilterBlock>>
+      filter_partition_pinner;
+
+  // Data blocks (with trailer) of at least this size are tracked in
+  // zero_copy_verified_blocks. No two of them start within the same
+  // kZeroCopyVerifyGranularity bytes of a file. Smaller ones are cheap to
+  // verify on every read.
+  static constexpr uint64_t kZeroCopyVerifyGranularity = 1024;
+  // Set up if data blocks are read zero-copy out of the memory mapped file
+  // (see BlockBasedTableOptions::mmap_zero_copy_data_blocks). Holds one bit
+  // per kZeroCopyVerifyGranularity bytes of file, which is set once the
+  // checksum of the tracked data block starting there has been verified.
+  std::unique_ptr<RelaxedAtomic<uint64_t>[]> zero_copy_verified_blocks;
+  size_t zero_copy_verified_blocks_words = 0;
+
+  bool UsesZeroCopyDataBlocks() const {
+    return zero_copy_verified_blocks != nullptr;
+  }
+
+  bool IsZeroCopyDataBlockVerified(uint64_t offset) const {
+    const uint64_t bit = offset / kZeroCopyVerifyGranularity;
+    assert(bit / 64 < zero_copy_verified_blocks_words);
+    return (zero_copy_verified_blocks[bit / 64].LoadRelaxed() >> (bit % 64)) &
+           1;
+  }
+
+  void MarkZeroCopyDataBlockVerified(uint64_t offset) {
+    const uint64_t bit = offset / kZeroCopyVerifyGranularity;
+    assert(bit / 64 < zero_copy_verified_blocks_words);
+    zero_copy_verified_blocks[bit / 64].FetchOrRelaxed(uint64_t{1}
+                                                       << (bit % 64));
+  }
+
   SequenceNumber get_global_seqno(BlockType block_type) const {
     return (block_type == BlockType::kFilterPartitionIndex ||
             block_type == BlockType::kCompressionDictionary)
@@ -738,6 +799,7 @@ struct BlockBasedTable::Rep {
 #else
     usage += sizeof(*this);
 #endif  // ROCKSDB_MALLOC_USABLE_SIZE
+    usage += zero_copy_verified_blocks_words * sizeof(uint64_t);
     return usage;
   }
 };
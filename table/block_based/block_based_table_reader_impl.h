@@ -116,7 +116,9 @@ TBlockIter* BlockBasedTable::NewDataBlockIterator(
                                        block_contents_pinned);
 
   if (!block.IsCached()) {
-    if (!ro.fill_cache) {
+    // Zero-copy data blocks are deliberately not charged to the block cache
+    if (!ro.fill_cache &&
+        !(block_type == BlockType::kData && rep_->UsesZeroCopyDataBlocks())) {
       IterPlaceholderCacheInterface block_cache{
           rep_->table_options.block_cache.get()};
       if (block_cache) {
@@ -176,7 +178,8 @@ TBlockIter* BlockBasedTable::NewDataBlockIterator(const ReadOptions& ro,
                                        iter, block_contents_pinned);
 
   if (!block.IsCached()) {
-    if (!ro.fill_cache) {
+    // Zero-copy data blocks are deliberately not charged to the block cache
+    if (!ro.fill_cache && !rep_->UsesZeroCopyDataBlocks()) {
       IterPlaceholderCacheInterface block_cache{
           rep_->table_options.block_cache.get()};
       if (block_cache) {
@@ -433,7 +433,10 @@ DEFINE_SYNC_AND_ASYNC(void, BlockBasedTable::MultiGet)
 
       {
         using BCI = BlockCacheInterface<Block_kData>;
-        BCI block_cache{rep_->table_options.block_cache.get()};
+        // Zero-copy data blocks are never in the block cache
+        BCI block_cache{rep_->UsesZeroCopyDataBlocks()
+                            ? nullptr
+                            : rep_->table_options.block_cache.get()};
         std::array<BCI::TypedAsyncLookupHandle, MultiGetContext::MAX_BATCH_SIZE>
             async_handles;
         BlockCreateContext create_ctx = rep_->create_context;
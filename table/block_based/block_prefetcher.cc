@@ -32,7 +32,11 @@ void BlockPrefetcher::PrefetchIfNeeded(
   const size_t len = BlockBasedTable::BlockSizeWithTrailer(handle);
   const size_t offset = handle.offset();
   if (is_for_compaction) {
-    if (!rep->file->use_direct_io() && compaction_readahead_size_ > 0) {
+    // With async IO (see DBOptions::compaction_async_readahead_budget), the
+    // internal prefetch buffer is used so that the next part of the file is
+    // read asynchronously while the current one is consumed.
+    if (!rep->file->use_direct_io() && compaction_readahead_size_ > 0 &&
+        !is_async_io_prefetch) {
       // If FS supports prefetching (readahead_limit_ will be non zero in that
       // case) and current block exists in prefetch buffer then return.
       if (offset + len <= readahead_limit_) {
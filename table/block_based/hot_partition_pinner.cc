@@ -0,0 +1,190 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/hot_partition_pinner.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "table/block_based/block_based_table_reader.h"
+#include "table/block_based/block_cache.h"
+#include "table/block_based/parsed_full_filter_block.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+template <typename TBlocklike>
+HotPartitionPinner<TBlocklike>::~HotPartitionPinner() {
+  UnpinAll();
+}
+
+template <typename TBlocklike>
+void HotPartitionPinner<TBlocklike>::RecordSampledAccess(
+    const BlockHandle& handle) {
+  sampled_since_rebalance_.FetchAddRelaxed(1);
+  // Dropping the sample is cheaper than waiting. A rebalance that is due is
+  // left to the next sample that gets the mutex.
+  if (!mutex_.TryLock()) {
+    return;
+  }
+
+  Partition& partition = partitions_[handle.offset()];
+  partition.handle = handle;
+  ++partition.count;
+
+  if (sampled_since_rebalance_.LoadRelaxed() >= kRebalancePeriod) {
+    sampled_since_rebalance_.StoreRelaxed(0);
+    Rebalance();
+  }
+
+  mutex_.Unlock();
+}
+
+template <typename TBlocklike>
+void HotPartitionPinner<TBlocklike>::Rebalance() {
+  mutex_.AssertHeld();
+
+  std::vector<Partition*> ranked;
+  ranked.reserve(partitions_.size());
+  for (auto& e : partitions_) {
+    ranked.push_back(&e.second);
+  }
+  // Hottest first
+  std::sort(ranked.begin(), ranked.end(),
+            [](const Partition* lhs, const Partition* rhs) {
+              return lhs->count > rhs->count;
+            });
+
+  for (Partition* partition : ranked) {
+    if (partition->count < kMinHotCount && !partition->pinned.IsEmpty()) {
+      Unpin(partition);
+    }
+  }
+
+  // Pinned partitions colder than the candidate can be displaced; they are
+  // found by walking the ranking from the cold end.
+  size_t coldest = ranked.size();
+  for (size_t i = 0; i < ranked.size(); ++i) {
+    Partition* partition = ranked[i];
+    if (partition->count < kMinHotCount) {
+      break;
+    }
+    if (!partition->pinned.IsEmpty()) {
+      continue;
+    }
+    while (TryPin(partition) == PinResult::kOverBudget) {
+      while (coldest > i + 1 && ranked[coldest - 1]->pinned.IsEmpty()) {
+        --coldest;
+      }
+      if (coldest <= i + 1 || ranked[coldest - 1]->count >= partition->count) {
+        break;
+      }
+      Unpin(ranked[--coldest]);
+    }
+  }
+
+  // Age the access counts so that the ranking follows workload shifts, and
+  // forget about partitions that went completely cold.
+  for (auto it = partitions_.begin(); it != partitions_.end();) {
+    Partition& partition = it->second;
+    partition.count /= 2;
+    if (partition.count == 0 && partition.pinned.IsEmpty()) {
+      it = partitions_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+template <typename TBlocklike>
+void HotPartitionPinner<TBlocklike>::Unpin(Partition* partition) {
+  mutex_.AssertHeld();
+  assert(!partition->pinned.IsEmpty());
+
+  partition->pinned.Reset();
+  budget_->Release(partition->charge);
+}
+
+template <typename TBlocklike>
+typename HotPartitionPinner<TBlocklike>::PinResult
+HotPartitionPinner<TBlocklike>::TryPin(Partition* partition) {
+  mutex_.AssertHeld();
+  assert(partition->pinned.IsEmpty());
+
+  if (partition->charge != 0) {
+    // Charge is known from an earlier attempt, so there is no need to look
+    // up the block cache if the budget is exhausted anyway.
+    if (!budget_->TryCharge(partition->charge)) {
+      return PinResult::kOverBudget;
+    }
+    budget_->Release(partition->charge);
+  }
+
+  // Only pin partitions that are already in the block cache. Partitions that
+  // are not will be loaded by the next access and considered again at the
+  // next rebalance.
+  ReadOptions ro;
+  ro.read_tier = kBlockCacheTier;
+  ro.fill_cache = false;
+  BlockCacheLookupContext lookup_context{TableReaderCaller::kPrefetch};
+  CachableEntry<TBlocklike> entry;
+  Status s = table_->RetrieveBlock(
+      /*prefetch_buffer=*/nullptr, ro, partition->handle,
+      UncompressionDict::GetEmptyDict(), &entry, /*get_context=*/nullptr,
+      &lookup_context, /*for_compaction=*/false, /*use_cache=*/true,
+      /*async_read=*/false, /*use_block_cache_for_lookup=*/true);
+  s.PermitUncheckedError();
+  if (!s.ok() || !entry.IsCached()) {
+    return PinResult::kNotInCache;
+  }
+
+  partition->charge = entry.GetCache()->GetCharge(entry.GetCacheHandle());
+  if (!budget_->TryCharge(partition->charge)) {
+    return PinResult::kOverBudget;
+  }
+  partition->pinned = std::move(entry);
+  return PinResult::kPinned;
+}
+
+template <typename TBlocklike>
+void HotPartitionPinner<TBlocklike>::UnpinAll() {
+  MutexLock l(&mutex_);
+
+  for (auto& e : partitions_) {
+    if (!e.second.pinned.IsEmpty()) {
+      Unpin(&e.second);
+    }
+  }
+}
+
+template <typename TBlocklike>
+size_t HotPartitionPinner<TBlocklike>::GetNumPinned() const {
+  MutexLock l(&mutex_);
+
+  size_t num_pinned = 0;
+  for (const auto& e : partitions_) {
+    if (!e.second.pinned.IsEmpty()) {
+      ++num_pinned;
+    }
+  }
+  return num_pinned;
+}
+
+template <typename TBlocklike>
+size_t HotPartitionPinner<TBlocklike>::GetPinnedBytes() const {
+  MutexLock l(&mutex_);
+
+  size_t pinned_bytes = 0;
+  for (const auto& e : partitions_) {
+    if (!e.second.pinned.IsEmpty()) {
+      pinned_bytes += e.second.charge;
+    }
+  }
+  return pinned_bytes;
+}
+
+template class HotPartitionPinner<Block_kIndex>;
+template class HotPartitionPinner<ParsedFullFilterBlock>;
+
+}  // namespace ROCKSDB_NAMESPACE
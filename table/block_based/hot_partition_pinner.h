@@ -0,0 +1,137 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <cstdint>
+
+#include "port/port.h"
+#include "table/block_based/cachable_entry.h"
+#include "table/format.h"
+#include "util/atomic.h"
+#include "util/hash_containers.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class BlockBasedTable;
+
+// Memory budget for adaptively pinned index and filter partitions, shared by
+// all the tables opened through the same BlockBasedTableFactory. See
+// MetadataCacheOptions::hot_partition_pinning_budget.
+class HotPartitionPinningBudget {
+ public:
+  explicit HotPartitionPinningBudget(size_t capacity) : capacity_(capacity) {}
+
+  // Returns true and charges `bytes` to the budget if that fits within the
+  // capacity, otherwise returns false and leaves the budget unchanged.
+  bool TryCharge(size_t bytes) {
+    size_t usage = usage_.LoadRelaxed();
+    do {
+      if (bytes > capacity_ - usage) {
+        return false;
+      }
+    } while (!usage_.CasWeakRelaxed(usage, usage + bytes));
+    return true;
+  }
+
+  void Release(size_t bytes) {
+    assert(usage_.LoadRelaxed() >= bytes);
+    usage_.FetchSubRelaxed(bytes);
+  }
+
+  size_t GetCapacity() const { return capacity_; }
+  size_t GetUsage() const { return usage_.LoadRelaxed(); }
+
+ private:
+  const size_t capacity_;
+  RelaxedAtomic<size_t> usage_{0};
+};
+
+// Tracks how frequently the partitions of a partitioned index or filter are
+// accessed and keeps the hottest ones pinned in the block cache, within the
+// limits of a shared HotPartitionPinningBudget. This is used for tables whose
+// partitions are not pinned statically (see MetadataCacheOptions).
+//
+// Pinning is done by holding a reference to the partition's block cache
+// entry, so lookups keep going through the block cache; the difference is
+// that a pinned partition cannot be evicted and hence always hits.
+//
+// Accesses are sampled to keep the overhead on the read path low, and reads
+// never wait for the pinner: a sampled access that finds it busy, e.g.
+// rebalancing on another thread, is not counted. Every kRebalancePeriod
+// sampled accesses, the partitions are re-ranked: partitions
+// that are no longer hot are unpinned, the hottest unpinned partitions are
+// pinned if they are in the block cache and the budget allows (possibly
+// displacing colder pinned partitions of the same table), and all access
+// counts are halved so that the ranking follows shifts in the workload.
+template <typename TBlocklike>
+class HotPartitionPinner {
+ public:
+  // Only every kSampleInterval-th access is counted.
+  static constexpr uint32_t kSampleInterval = 8;
+  // Number of sampled accesses between two rebalances.
+  static constexpr uint32_t kRebalancePeriod = 64;
+  // Minimum (decayed) sampled access count for a partition to be pinned.
+  static constexpr uint32_t kMinHotCount = 4;
+
+  HotPartitionPinner(const BlockBasedTable* table,
+                     HotPartitionPinningBudget* budget)
+      : table_(table), budget_(budget) {
+    assert(table_);
+    assert(budget_);
+  }
+
+  ~HotPartitionPinner();
+
+  // No copying allowed
+  HotPartitionPinner(const HotPartitionPinner&) = delete;
+  HotPartitionPinner& operator=(const HotPartitionPinner&) = delete;
+
+  // Records an access to the partition identified by `handle`.
+  void RecordAccess(const BlockHandle& handle) {
+    if (num_accesses_.FetchAddRelaxed(1) % kSampleInterval != 0) {
+      return;
+    }
+    RecordSampledAccess(handle);
+  }
+
+  // Unpins all partitions and releases their budget charge.
+  void UnpinAll();
+
+  size_t GetNumPinned() const;
+  size_t GetPinnedBytes() const;
+
+ private:
+  struct Partition {
+    BlockHandle handle;
+    uint32_t count = 0;
+    size_t charge = 0;
+    CachableEntry<TBlocklike> pinned;
+  };
+
+  enum class PinResult { kPinned, kNotInCache, kOverBudget };
+
+  void RecordSampledAccess(const BlockHandle& handle);
+
+  // REQUIRES: mutex_ held
+  void Rebalance();
+  // REQUIRES: mutex_ held
+  void Unpin(Partition* partition);
+  // REQUIRES: mutex_ held
+  PinResult TryPin(Partition* partition);
+
+  const BlockBasedTable* const table_;
+  HotPartitionPinningBudget* const budget_;
+  RelaxedAtomic<uint64_t> num_accesses_{0};
+
+  // Sampled accesses, counted or not, since the last rebalance
+  RelaxedAtomic<uint32_t> sampled_since_rebalance_{0};
+
+  mutable port::Mutex mutex_;
+  // Keyed by partition offset
+  UnorderedMap<uint64_t, Partition> partitions_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
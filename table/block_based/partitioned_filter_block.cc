@@ -411,6 +411,11 @@ Status PartitionedFilterBlockReader::GetFilterPartitionBlock(
     }
   }
 
+  auto* pinner = table()->get_rep()->filter_partition_pinner.get();
+  if (pinner) {
+    pinner->RecordAccess(fltr_blk_handle);
+  }
+
   const Status s = table()->RetrieveBlock(
       prefetch_buffer, read_options, fltr_blk_handle,
       UncompressionDict::GetEmptyDict(), filter_block, get_context,
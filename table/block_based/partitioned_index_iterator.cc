@@ -84,6 +84,9 @@ void PartitionedIndexIterator::InitPartitionedIndexBlock() {
     auto* rep = table_->get_rep();
     bool is_for_compaction =
         lookup_context_.caller == TableReaderCaller::kCompaction;
+    if (rep->index_partition_pinner && !is_for_compaction) {
+      rep->index_partition_pinner->RecordAccess(partitioned_index_handle);
+    }
     // Prefetch additional data for range scans (iterators).
     // Implicit auto readahead:
     //   Enabled after 2 sequential IOs when ReadOptions.readahead_size == 0.
@@ -0,0 +1,109 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "table/block_based/shared_compression_dict.h"
+
+#include <vector>
+
+#include "util/compression.h"
+#include "util/hash.h"
+#include "util/mutexlock.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+std::shared_ptr<const std::string> CompressionDictReuseRegistry::TryReuse(
+    int level, CompressionType type, uint32_t max_dict_bytes) {
+  MutexLock l(&mutex_);
+
+  auto it = entries_.find(level);
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+  Entry& entry = it->second;
+  if (entry.type != type || entry.max_dict_bytes != max_dict_bytes ||
+      entry.remaining_reuses == 0) {
+    return nullptr;
+  }
+  --entry.remaining_reuses;
+  return entry.dict;
+}
+
+void CompressionDictReuseRegistry::Publish(int level, CompressionType type,
+                                           uint32_t max_dict_bytes,
+                                           uint32_t max_reuses,
+                                           std::string dict) {
+  auto shared_dict = std::make_shared<const std::string>(std::move(dict));
+
+  MutexLock l(&mutex_);
+
+  Entry& entry = entries_[level];
+  entry.type = type;
+  entry.max_dict_bytes = max_dict_bytes;
+  entry.remaining_reuses = max_reuses;
+  entry.dict = std::move(shared_dict);
+}
+
+SharedUncompressionDicts* SharedUncompressionDicts::Instance() {
+  // Intentionally leaked, so that it outlives all the dictionaries it hands
+  // out, which refer back to it on destruction.
+  static SharedUncompressionDicts* const instance =
+      new SharedUncompressionDicts();
+  return instance;
+}
+
+std::shared_ptr<UncompressionDict> SharedUncompressionDicts::GetOrCreate(
+    const Slice& raw_dict, bool using_zstd) {
+  const uint64_t hash = GetSliceHash64(raw_dict);
+
+  // Releasing a reference may destroy the dictionary, which then removes
+  // itself from dicts_, so this must not happen while holding mutex_.
+  std::vector<std::shared_ptr<UncompressionDict>> mismatches;
+  std::shared_ptr<UncompressionDict> result;
+
+  MutexLock l(&mutex_);
+
+  auto range = dicts_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    std::shared_ptr<UncompressionDict> dict = it->second.dict.lock();
+    if (!dict) {
+      // Expired; the entry is removed by the deleter of the dictionary
+      continue;
+    }
+    if (dict->GetRawDict() == raw_dict) {
+      result = std::move(dict);
+      return result;
+    }
+    mismatches.push_back(std::move(dict));
+  }
+
+  result.reset(new UncompressionDict(raw_dict.ToString(), using_zstd),
+               [this, hash](UncompressionDict* d) {
+                 Remove(hash, d);
+                 delete d;
+               });
+  dicts_.emplace(hash, Entry{result.get(), result});
+  return result;
+}
+
+void SharedUncompressionDicts::Remove(uint64_t hash,
+                                      const UncompressionDict* raw_ptr) {
+  MutexLock l(&mutex_);
+
+  auto range = dicts_.equal_range(hash);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.raw_ptr == raw_ptr) {
+      dicts_.erase(it);
+      return;
+    }
+  }
+  assert(false);
+}
+
+size_t SharedUncompressionDicts::TEST_Size() {
+  MutexLock l(&mutex_);
+  return dicts_.size();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
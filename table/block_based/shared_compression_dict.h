@@ -0,0 +1,86 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "port/port.h"
+#include "rocksdb/compression_type.h"
+#include "rocksdb/slice.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+struct UncompressionDict;
+
+// Compression dictionaries trained by the table builders of one column family
+// of one DB, kept per level so that subsequent output files of the same level
+// can reuse them instead of buffering data and training a dictionary of their
+// own. See CompressionOptions::max_dict_reuse_files. Owned by the
+// ColumnFamilyData, so that dictionaries never cross DBs or column families
+// and are released with the column family.
+//
+// Each file still stores the dictionary it was compressed with, so that it
+// remains self-contained.
+class CompressionDictReuseRegistry {
+ public:
+  // Returns the dictionary most recently published for the given level, if it
+  // was trained with the same compression type and dictionary size limit and
+  // can be reused by at least one more file. Otherwise returns nullptr.
+  std::shared_ptr<const std::string> TryReuse(int level, CompressionType type,
+                                              uint32_t max_dict_bytes);
+
+  // Makes `dict` available to the next `max_reuses` files of the given level,
+  // replacing any previously published dictionary.
+  void Publish(int level, CompressionType type, uint32_t max_dict_bytes,
+               uint32_t max_reuses, std::string dict);
+
+ private:
+  struct Entry {
+    CompressionType type = kNoCompression;
+    uint32_t max_dict_bytes = 0;
+    uint32_t remaining_reuses = 0;
+    std::shared_ptr<const std::string> dict;
+  };
+
+  port::Mutex mutex_;
+  std::map<int, Entry> entries_;
+};
+
+// Process-wide set of digested uncompression dictionaries, keyed by content,
+// so that table readers of files that were compressed with the same
+// dictionary (see CompressionDictReuseRegistry) share a single copy of it.
+// Dictionaries are dropped from the set once the last reader referencing
+// them goes away.
+class SharedUncompressionDicts {
+ public:
+  static SharedUncompressionDicts* Instance();
+
+  // Returns the shared dictionary with the given contents, creating it (from
+  // a copy of `raw_dict`) if there is none yet.
+  std::shared_ptr<UncompressionDict> GetOrCreate(const Slice& raw_dict,
+                                                 bool using_zstd);
+
+  size_t TEST_Size();
+
+ private:
+  struct Entry {
+    // For identifying the entry after `dict` has expired
+    const UncompressionDict* raw_ptr;
+    std::weak_ptr<UncompressionDict> dict;
+  };
+
+  void Remove(uint64_t hash, const UncompressionDict* raw_ptr);
+
+  port::Mutex mutex_;
+  // Keyed by hash of the dictionary contents
+  std::unordered_multimap<uint64_t, Entry> dicts_;
+};
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -9,6 +9,7 @@
 #include "logging/logging.h"
 #include "monitoring/perf_context_imp.h"
 #include "table/block_based/block_based_table_reader.h"
+#include "table/block_based/shared_compression_dict.h"
 #include "util/compression.h"
 
 namespace ROCKSDB_NAMESPACE {
@@ -24,6 +25,7 @@ Status UncompressionDictReader::Create(
   assert(uncompression_dict_reader);
 
   CachableEntry<UncompressionDict> uncompression_dict;
+  std::shared_ptr<UncompressionDict> shared_dict;
   if (prefetch || !use_cache) {
     const Status s = ReadUncompressionDictionary(
         table, prefetch_buffer, ro, use_cache, nullptr /* get_context */,
@@ -34,11 +36,20 @@ Status UncompressionDictReader::Create(
 
     if (use_cache && !pin) {
       uncompression_dict.Reset();
+    } else if (!use_cache) {
+      // Files compressed with the same dictionary (see
+      // CompressionOptions::max_dict_reuse_files) share a single copy of it.
+      assert(uncompression_dict.GetValue());
+      shared_dict = SharedUncompressionDicts::Instance()->GetOrCreate(
+          uncompression_dict.GetValue()->GetRawDict(),
+          table->get_rep()->create_context.using_zstd);
+      uncompression_dict.Reset();
+      uncompression_dict.SetUnownedValue(shared_dict.get());
     }
   }
 
-  uncompression_dict_reader->reset(
-      new UncompressionDictReader(table, std::move(uncompression_dict)));
+  uncompression_dict_reader->reset(new UncompressionDictReader(
+      table, std::move(uncompression_dict), std::move(shared_dict)));
 
   return Status::OK();
 }
@@ -98,6 +109,11 @@ size_t UncompressionDictReader::ApproximateMemoryUsage() const {
   size_t usage = uncompression_dict_.GetOwnValue()
                      ? uncompression_dict_.GetValue()->ApproximateMemoryUsage()
                      : 0;
+  if (shared_dict_) {
+    // Split evenly among the readers sharing the dictionary
+    usage += shared_dict_->ApproximateMemoryUsage() /
+             static_cast<size_t>(shared_dict_.use_count());
+  }
 
 #ifdef ROCKSDB_MALLOC_USABLE_SIZE
   usage += malloc_usable_size(const_cast<UncompressionDictReader*>(this));
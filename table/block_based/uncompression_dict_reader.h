@@ -7,6 +7,7 @@
 #pragma once
 
 #include <cassert>
+#include <memory>
 
 #include "table/block_based/cachable_entry.h"
 #include "table/format.h"
@@ -40,9 +41,14 @@ class UncompressionDictReader {
 
  private:
   UncompressionDictReader(const BlockBasedTable* t,
-                          CachableEntry<UncompressionDict>&& uncompression_dict)
-      : table_(t), uncompression_dict_(std::move(uncompression_dict)) {
+                          CachableEntry<UncompressionDict>&& uncompression_dict,
+                          std::shared_ptr<UncompressionDict>&& shared_dict)
+      : table_(t),
+        uncompression_dict_(std::move(uncompression_dict)),
+        shared_dict_(std::move(shared_dict)) {
     assert(table_);
+    assert(!shared_dict_ || uncompression_dict_.GetValue() ==
+                                shared_dict_.get());
   }
 
   bool cache_dictionary_blocks() const;
@@ -55,6 +61,10 @@ class UncompressionDictReader {
 
   const BlockBasedTable* table_;
   CachableEntry<UncompressionDict> uncompression_dict_;
+  // Set when the dictionary is owned by the reader rather than the block
+  // cache; shared with the readers of other files compressed with the same
+  // dictionary (see SharedUncompressionDicts).
+  std::shared_ptr<UncompressionDict> shared_dict_;
 };
 
 }  // namespace ROCKSDB_NAMESPACE
@@ -55,6 +55,8 @@ struct GetContextStats {
   uint64_t num_filter_read = 0;
   uint64_t num_index_read = 0;
   uint64_t num_sst_read = 0;
+  // Data blocks searched for the key by Get(), cached or not
+  uint64_t num_data_blocks_searched = 0;
 };
 
 // A class to hold context about a point lookup, such as pointer to value
@@ -27,6 +27,7 @@
 
 namespace ROCKSDB_NAMESPACE {
 
+class CompressionDictReuseRegistry;
 class Slice;
 class Status;
 
@@ -99,6 +100,21 @@ struct TableReaderOptions {
   bool user_defined_timestamps_persisted;
 };
 
+// Decides, on behalf of a compaction, which of the data blocks of its output
+// files are worth inserting into the block cache as they are written (see
+// BlockBasedTableOptions::PrepopulateBlockCache::kFlushAndHotCompaction).
+// Might be called concurrently by the builders of different output files.
+class CompactionOutputWarmer {
+ public:
+  virtual ~CompactionOutputWarmer() {}
+
+  // Returns true if the data block with the given first and last internal
+  // keys and uncompressed size should be inserted into the block cache.
+  virtual bool ShouldWarmDataBlock(const Slice& first_ikey,
+                                   const Slice& last_ikey,
+                                   size_t block_size) = 0;
+};
+
 struct TableBuilderOptions : public TablePropertiesCollectorFactory::Context {
   TableBuilderOptions(
       const ImmutableOptions& _ioptions, const MutableCFOptions& _moptions,
@@ -163,6 +179,15 @@ struct TableBuilderOptions : public TablePropertiesCollectorFactory::Context {
   // in the table options of the ioptions.table_factory
   bool skip_filters = false;
   const uint64_t cur_file_num;
+
+  // Only set for compaction outputs that may warm the block cache with some
+  // of their data blocks. Not owned.
+  CompactionOutputWarmer* output_warmer = nullptr;
+
+  // The compression dictionaries of the column family, for files of flushes
+  // and compactions that may reuse the dictionaries of previous files (see
+  // CompressionOptions::max_dict_reuse_files). Not owned.
+  CompressionDictReuseRegistry* compression_dict_reuse_registry = nullptr;
 };
 
 // TableBuilder provides the interface used to build a Table
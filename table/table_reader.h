@@ -95,6 +95,27 @@ class TableReader {
                                    const Slice& start, const Slice& end,
                                    TableReaderCaller caller) = 0;
 
+  // Probes whether the data blocks that would hold a series of internal keys
+  // are resident in the block cache. Keeps its position in the index, so
+  // probing keys in increasing order only moves it forward.
+  class DataBlockCacheProbe : public Cleanable {
+   public:
+    virtual ~DataBlockCacheProbe() {}
+
+    // Returns true if the data block that would hold the given internal key
+    // is in the block cache. Never does any I/O, so it returns false if that
+    // cannot be determined from memory. The probe does not count as a use of
+    // the block, though with LRUCache it still refreshes the block's
+    // position in the LRU list.
+    virtual bool IsDataBlockCached(const Slice& key) = 0;
+  };
+
+  // Returns nullptr if the table cannot tell which blocks are cached.
+  virtual std::unique_ptr<DataBlockCacheProbe> NewDataBlockCacheProbe(
+      const ReadOptions& /*read_options*/) {
+    return nullptr;
+  }
+
   struct Anchor {
     Anchor(const Slice& _user_key, size_t _range_size)
         : user_key(_user_key.ToStringView()), range_size(_range_size) {}
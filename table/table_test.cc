@@ -4831,6 +4831,61 @@ TEST_F(GeneralTableTest, ApproximateKeyAnchors) {
   c.ResetTableReader();
 }
 
+TEST_F(GeneralTableTest, SampledKeyAnchors) {
+  Random rnd(301);
+  TableConstructor c(BytewiseComparator(), true /* convert_to_internal_key_ */);
+  // The values of the upper half of the keys are ten times larger
+  for (int i = 1000; i < 9000; i++) {
+    c.Add(std::to_string(i), rnd.RandomString(i < 5000 ? 200 : 2000));
+  }
+  std::vector<std::string> keys;
+  stl_wrappers::KVMap kvmap;
+  Options options;
+  InternalKeyComparator ikc(options.comparator);
+  options.compression = kNoCompression;
+  BlockBasedTableOptions table_options;
+  table_options.block_size = 4096;
+  table_options.num_sampled_key_anchors = 16;
+  options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+  const ImmutableOptions ioptions(options);
+  const MutableCFOptions moptions(options);
+  c.Finish(options, ioptions, moptions, table_options, ikc, &keys, &kvmap);
+
+  auto props = c.GetTableReader()->GetTableProperties();
+  ASSERT_EQ(1, props->user_collected_properties.count(
+                   BlockBasedTablePropertyNames::kKeyAnchors));
+
+  std::vector<TableReader::Anchor> anchors;
+  ASSERT_OK(c.GetTableReader()->ApproximateKeyAnchors(ReadOptions(), anchors));
+  // Between 16 and 32 anchors, plus one for the rest of the file
+  ASSERT_GE(anchors.size(), 16);
+  ASSERT_LE(anchors.size(), 33);
+  ASSERT_EQ("8999", anchors.back().user_key);
+
+  // The ranges are of equal size, so most anchors are in the upper half
+  size_t num_upper = 0;
+  uint64_t total_size = 0;
+  for (size_t i = 0; i < anchors.size(); i++) {
+    total_size += anchors[i].range_size;
+    if (i > 0) {
+      ASSERT_LT(anchors[i - 1].user_key, anchors[i].user_key);
+    }
+    if (i + 1 < anchors.size()) {
+      ASSERT_GT(anchors[i].range_size, anchors[0].range_size * 4 / 5);
+      ASSERT_LT(anchors[i].range_size, anchors[0].range_size * 5 / 4);
+    }
+    if (anchors[i].user_key >= "5000") {
+      num_upper++;
+    }
+  }
+  ASSERT_GT(num_upper, 4 * (anchors.size() - num_upper));
+  // Scaled to the size of the data blocks
+  ASSERT_GT(total_size, props->data_size * 99 / 100);
+  ASSERT_LE(total_size, props->data_size);
+
+  c.ResetTableReader();
+}
+
 #if !defined(ROCKSDB_VALGRIND_RUN) || defined(ROCKSDB_FULL_VALGRIND_RUN)
 TEST_P(ParameterizedHarnessTest, RandomizedHarnessTest) {
   Random rnd(test::RandomSeed() + 5);
@@ -379,6 +379,8 @@ void RandomInitCFOptions(ColumnFamilyOptions* cf_opt, DBOptions& db_options,
   cf_opt->blob_garbage_collection_age_cutoff = rnd->Uniform(10000) / 10000.0;
   cf_opt->blob_garbage_collection_force_threshold =
       rnd->Uniform(10000) / 10000.0;
+  cf_opt->blob_garbage_collection_file_threshold =
+      rnd->Uniform(10000) / 10000.0;
 
   // int options
   cf_opt->level0_file_num_compaction_trigger = rnd->Uniform(100);
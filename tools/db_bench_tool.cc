@@ -60,6 +60,7 @@
 #include "rocksdb/secondary_cache.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/slice_transform.h"
+#include "rocksdb/sst_partitioner.h"
 #include "rocksdb/stats_history.h"
 #include "rocksdb/table.h"
 #include "rocksdb/tool_hooks.h"
@@ -503,6 +504,11 @@ DEFINE_uint64(subcompactions, 1,
 static const bool FLAGS_subcompactions_dummy __attribute__((__unused__)) =
     RegisterFlagValidator(&FLAGS_subcompactions, &ValidateUint32Range);
 
+DEFINE_uint32(subcompaction_ranges_per_thread,
+              ROCKSDB_NAMESPACE::Options().subcompaction_ranges_per_thread,
+              "Number of key ranges per subcompaction thread, taken over by "
+              "threads that finish early");
+
 DEFINE_int32(max_background_flushes,
              ROCKSDB_NAMESPACE::Options().max_background_flushes,
              "The maximum number of concurrent background flushes"
@@ -546,6 +552,14 @@ DEFINE_bool(universal_allow_trivial_move, false,
 DEFINE_bool(universal_incremental, false,
             "Enable incremental compactions in universal compaction.");
 
+DEFINE_uint32(universal_lazy_leveling_runs_per_tier, 0,
+              "Number of sorted runs per tier with lazy leveling in universal "
+              "compaction. 0 disables lazy leveling.");
+
+DEFINE_bool(universal_lazy_leveling_auto_tune, false,
+            "Tune the number of sorted runs per tier of lazy leveling from "
+            "the read/write mix.");
+
 DEFINE_int32(
     universal_stop_style,
     (int32_t)ROCKSDB_NAMESPACE::CompactionOptionsUniversal().stop_style,
@@ -610,6 +624,15 @@ DEFINE_uint32(
     "compress_format_version == 2 -- decompressed size is included"
     " in the block header in varint32 format.");
 
+DEFINE_string(compressed_secondary_cache_cold_compression_type, "",
+              "If not empty, the compression algorithm for the entries of "
+              "CompressedSecondaryCache not hit before their eviction from "
+              "the primary cache.");
+
+DEFINE_int32(compressed_secondary_cache_compression_threads, 0,
+             "If > 0, the number of background threads compressing the "
+             "entries inserted into CompressedSecondaryCache.");
+
 DEFINE_bool(use_tiered_cache, false,
             "If use_compressed_secondary_cache is true and "
             "use_tiered_volatile_cache is true, then allocate a tiered cache "
@@ -634,6 +657,21 @@ DEFINE_bool(use_cache_jemalloc_no_dump_allocator, false,
 DEFINE_bool(use_cache_memkind_kmem_allocator, false,
             "Use memkind kmem allocator for block/blob cache.");
 
+DEFINE_uint32(scan_bottom_priority_threshold,
+              ROCKSDB_NAMESPACE::BlockBasedTableOptions()
+                  .scan_bottom_priority_threshold,
+              "Number of consecutive data blocks read by an iterator after "
+              "which it inserts data blocks into block cache with bottom "
+              "priority. 0 disables.");
+
+DEFINE_bool(use_cache_huge_page_allocator, false,
+            "Use HugePageAllocator for block/blob cache.");
+
+DEFINE_uint64(cache_huge_page_size,
+              ROCKSDB_NAMESPACE::HugePageAllocatorOptions().huge_page_size,
+              "Size of the huge pages of HugePageAllocator, with "
+              "--use_cache_huge_page_allocator");
+
 DEFINE_bool(
     decouple_partitioned_filters,
     ROCKSDB_NAMESPACE::BlockBasedTableOptions().decouple_partitioned_filters,
@@ -697,6 +735,11 @@ DEFINE_int32(read_amp_bytes_per_bit,
              ROCKSDB_NAMESPACE::BlockBasedTableOptions().read_amp_bytes_per_bit,
              "Number of bytes per bit to be used in block read-amp bitmap");
 
+DEFINE_uint32(
+    num_sampled_key_anchors,
+    ROCKSDB_NAMESPACE::BlockBasedTableOptions().num_sampled_key_anchors,
+    "Number of keys sampled per SST file for subcompaction boundaries");
+
 DEFINE_bool(
     enable_index_compression,
     ROCKSDB_NAMESPACE::BlockBasedTableOptions().enable_index_compression,
@@ -707,8 +750,9 @@ DEFINE_bool(block_align,
             "Align data blocks on page size");
 
 DEFINE_int64(prepopulate_block_cache, 0,
-             "Pre-populate hot/warm blocks in block cache. 0 to disable and 1 "
-             "to insert during flush");
+             "Pre-populate hot/warm blocks in block cache. 0 to disable, 1 "
+             "to insert during flush and 2 to insert during flush and the "
+             "hot blocks of compactions");
 
 DEFINE_uint32(uncache_aggressiveness,
               ROCKSDB_NAMESPACE::ColumnFamilyOptions().uncache_aggressiveness,
@@ -746,6 +790,11 @@ DEFINE_uint64(compaction_readahead_size,
               ROCKSDB_NAMESPACE::Options().compaction_readahead_size,
               "Compaction readahead size");
 
+DEFINE_uint64(
+    compaction_async_readahead_budget,
+    ROCKSDB_NAMESPACE::Options().compaction_async_readahead_budget,
+    "Total memory for asynchronous readahead of compaction input files");
+
 DEFINE_int32(log_readahead_size, 0, "WAL and manifest readahead size");
 
 DEFINE_int32(writable_file_max_buffer_size, 1024 * 1024,
@@ -1008,6 +1057,10 @@ DEFINE_uint64(fifo_compaction_ttl, 0, "TTL for the SST Files in seconds.");
 
 DEFINE_uint64(fifo_age_for_warm, 0, "age_for_warm for FIFO compaction.");
 
+DEFINE_uint64(fifo_compaction_time_window_seconds, 0,
+              "Only compact FIFO files within ended time windows of this many "
+              "seconds.");
+
 // Stacked BlobDB Options
 DEFINE_bool(use_blob_db, false, "[Stacked BlobDB] Open a BlobDB instance.");
 
@@ -1095,6 +1148,12 @@ DEFINE_double(blob_garbage_collection_force_threshold,
               "[Integrated BlobDB] The threshold for the ratio of garbage in "
               "the eligible blob files for forcing garbage collection.");
 
+DEFINE_double(blob_garbage_collection_file_threshold,
+              ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions()
+                  .blob_garbage_collection_file_threshold,
+              "[Integrated BlobDB] The threshold for the ratio of garbage in "
+              "a single blob file for scheduling its garbage collection job.");
+
 DEFINE_uint64(blob_compaction_readahead_size,
               ROCKSDB_NAMESPACE::AdvancedColumnFamilyOptions()
                   .blob_compaction_readahead_size,
@@ -1596,6 +1655,27 @@ DEFINE_uint64(max_compaction_bytes,
               ROCKSDB_NAMESPACE::Options().max_compaction_bytes,
               "Max bytes allowed in one compaction");
 
+DEFINE_double(range_deletion_compaction_ratio,
+              ROCKSDB_NAMESPACE::Options().range_deletion_compaction_ratio,
+              "Pick compactions pushing range tombstones to the last level "
+              "when they cover at least this ratio of their file size. 0 "
+              "disables it.");
+
+DEFINE_uint64(read_triggered_compaction_bytes_per_lookup,
+              ROCKSDB_NAMESPACE::Options()
+                  .read_triggered_compaction_bytes_per_lookup,
+              "Compact a file once point lookups read it in vain about its "
+              "size divided by this value times. 0 disables it.");
+
+DEFINE_uint64(sst_partitioner_fixed_prefix_len, 0,
+              "If non-zero, partition SST files by key prefixes of this "
+              "length with a fixed prefix SstPartitionerFactory.");
+
+DEFINE_bool(shard_level0_by_sst_partitioner,
+            ROCKSDB_NAMESPACE::Options().shard_level0_by_sst_partitioner,
+            "Split L0 into shards at the SST partitioner boundaries, with "
+            "concurrent L0 compactions of different shards.");
+
 DEFINE_bool(readonly, false, "Run read only benchmarks.");
 
 DEFINE_bool(print_malloc_stats, false,
@@ -3074,6 +3154,15 @@ class Benchmark {
         fprintf(stderr, "JemallocNodumpAllocator not supported.\n");
         exit(1);
       }
+    } else if (FLAGS_use_cache_huge_page_allocator) {
+      HugePageAllocatorOptions huge_page_options;
+      huge_page_options.huge_page_size =
+          static_cast<size_t>(FLAGS_cache_huge_page_size);
+      Status s = NewHugePageAllocator(huge_page_options, &allocator);
+      if (!s.ok()) {
+        fprintf(stderr, "NewHugePageAllocator: %s\n", s.ToString().c_str());
+        exit(1);
+      }
     } else if (FLAGS_use_cache_memkind_kmem_allocator) {
 #ifdef MEMKIND
       allocator = std::make_shared<MemkindKmemAllocator>();
@@ -3112,6 +3201,12 @@ class Benchmark {
           FLAGS_compressed_secondary_cache_compression_level;
       secondary_cache_opts.compress_format_version =
           FLAGS_compressed_secondary_cache_compress_format_version;
+      if (!FLAGS_compressed_secondary_cache_cold_compression_type.empty()) {
+        secondary_cache_opts.cold_compression_type = StringToCompressionType(
+            FLAGS_compressed_secondary_cache_cold_compression_type.c_str());
+      }
+      secondary_cache_opts.compression_threads =
+          FLAGS_compressed_secondary_cache_compression_threads;
       if (FLAGS_use_tiered_cache) {
         use_tiered_cache = true;
         adm_policy = StringToAdmissionPolicy(FLAGS_tiered_adm_policy.c_str());
@@ -4265,6 +4360,8 @@ class Benchmark {
     options.max_background_jobs = FLAGS_max_background_jobs;
     options.max_background_compactions = FLAGS_max_background_compactions;
     options.max_subcompactions = static_cast<uint32_t>(FLAGS_subcompactions);
+    options.subcompaction_ranges_per_thread =
+        FLAGS_subcompaction_ranges_per_thread;
     options.max_background_flushes = FLAGS_max_background_flushes;
     options.compaction_style = FLAGS_compaction_style_e;
     options.compaction_pri = FLAGS_compaction_pri_e;
@@ -4280,6 +4377,8 @@ class Benchmark {
         FLAGS_fifo_compaction_max_table_files_size_mb * 1024 * 1024,
         FLAGS_fifo_compaction_allow_compaction);
     options.compaction_options_fifo.age_for_warm = FLAGS_fifo_age_for_warm;
+    options.compaction_options_fifo.time_window_seconds =
+        FLAGS_fifo_compaction_time_window_seconds;
     options.prefix_extractor = prefix_extractor_;
     if (FLAGS_use_uint64_comparator) {
       options.comparator = test::Uint64Comparator();
@@ -4302,6 +4401,8 @@ class Benchmark {
     options.bloom_locality = FLAGS_bloom_locality;
     options.max_file_opening_threads = FLAGS_file_opening_threads;
     options.compaction_readahead_size = FLAGS_compaction_readahead_size;
+    options.compaction_async_readahead_budget =
+        FLAGS_compaction_async_readahead_budget;
     options.log_readahead_size = FLAGS_log_readahead_size;
     options.writable_file_max_buffer_size = FLAGS_writable_file_max_buffer_size;
     options.use_fsync = FLAGS_use_fsync;
@@ -4429,6 +4530,8 @@ class Benchmark {
           FLAGS_pin_l0_filter_and_index_blocks_in_cache;
       block_based_options.pin_top_level_index_and_filter =
           FLAGS_pin_top_level_index_and_filter;
+      block_based_options.scan_bottom_priority_threshold =
+          FLAGS_scan_bottom_priority_threshold;
       if (FLAGS_cache_high_pri_pool_ratio > 1e-6) {  // > 0.0 + eps
         block_based_options.cache_index_and_filter_blocks_with_high_priority =
             true;
@@ -4472,6 +4575,8 @@ class Benchmark {
       block_based_options.format_version =
           static_cast<uint32_t>(FLAGS_format_version);
       block_based_options.read_amp_bytes_per_bit = FLAGS_read_amp_bytes_per_bit;
+      block_based_options.num_sampled_key_anchors =
+          FLAGS_num_sampled_key_anchors;
       block_based_options.enable_index_compression =
           FLAGS_enable_index_compression;
       block_based_options.block_align = FLAGS_block_align;
@@ -4493,6 +4598,10 @@ class Benchmark {
           prepopulate_block_cache =
               BlockBasedTableOptions::PrepopulateBlockCache::kFlushOnly;
           break;
+        case 2:
+          prepopulate_block_cache = BlockBasedTableOptions::
+              PrepopulateBlockCache::kFlushAndHotCompaction;
+          break;
         default:
           fprintf(stderr, "Unknown prepopulate block cache mode\n");
       }
@@ -4648,6 +4757,16 @@ class Benchmark {
     options.write_thread_slow_yield_usec = FLAGS_write_thread_slow_yield_usec;
     options.table_cache_numshardbits = FLAGS_table_cache_numshardbits;
     options.max_compaction_bytes = FLAGS_max_compaction_bytes;
+    options.range_deletion_compaction_ratio =
+        FLAGS_range_deletion_compaction_ratio;
+    options.read_triggered_compaction_bytes_per_lookup =
+        FLAGS_read_triggered_compaction_bytes_per_lookup;
+    if (FLAGS_sst_partitioner_fixed_prefix_len > 0) {
+      options.sst_partitioner_factory = NewSstPartitionerFixedPrefixFactory(
+          static_cast<size_t>(FLAGS_sst_partitioner_fixed_prefix_len));
+    }
+    options.shard_level0_by_sst_partitioner =
+        FLAGS_shard_level0_by_sst_partitioner;
     options.disable_auto_compactions = FLAGS_disable_auto_compactions;
     options.optimize_filters_for_hits = FLAGS_optimize_filters_for_hits;
     options.paranoid_checks = FLAGS_paranoid_checks;
@@ -4701,6 +4820,10 @@ class Benchmark {
         FLAGS_universal_allow_trivial_move;
     options.compaction_options_universal.incremental =
         FLAGS_universal_incremental;
+    options.compaction_options_universal.lazy_leveling_runs_per_tier =
+        FLAGS_universal_lazy_leveling_runs_per_tier;
+    options.compaction_options_universal.lazy_leveling_auto_tune =
+        FLAGS_universal_lazy_leveling_auto_tune;
     options.compaction_options_universal.stop_style =
         static_cast<CompactionStopStyle>(FLAGS_universal_stop_style);
     if (FLAGS_thread_status_per_interval > 0) {
@@ -4732,6 +4855,8 @@ class Benchmark {
         FLAGS_blob_garbage_collection_age_cutoff;
     options.blob_garbage_collection_force_threshold =
         FLAGS_blob_garbage_collection_force_threshold;
+    options.blob_garbage_collection_file_threshold =
+        FLAGS_blob_garbage_collection_file_threshold;
     options.blob_compaction_readahead_size =
         FLAGS_blob_compaction_readahead_size;
     options.blob_file_starting_level = FLAGS_blob_file_starting_level;
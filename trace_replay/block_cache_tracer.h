@@ -89,6 +89,10 @@ struct BlockCacheLookupContext {
   uint64_t get_id = 0;
   std::string referenced_key;
   bool get_from_user_specified_snapshot = false;
+  // Set by iterators in a sequential scan, to insert the data blocks they
+  // read into block cache with bottom priority (see
+  // BlockBasedTableOptions::scan_bottom_priority_threshold)
+  bool in_sequential_scan = false;
 
   void FillLookupContext(bool _is_cache_hit, bool _no_insert,
                          TraceType _block_type, uint64_t _block_size,
@@ -0,0 +1,467 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+// SaveBlockCacheSnapshot and LoadBlockCacheSnapshot. A snapshot is a set of
+// shard files, each holding a header followed by one record per block:
+//
+//   checksum (fixed32, masked crc32c of everything after it in the record)
+//   key size (fixed32)
+//   block size (fixed32)
+//   unit type (1 byte, a CacheDumpUnitType)
+//   cache key (file unique ID and offset of the block)
+//   block contents, as saved by the cache item helper
+//
+// Blocks are assigned to shards by the hash of their key, and the shards are
+// written and loaded by one thread each.
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "cache/cache_key.h"
+#include "file/sequence_file_reader.h"
+#include "file/writable_file_writer.h"
+#include "port/port.h"
+#include "rocksdb/db.h"
+#include "rocksdb/utilities/cache_dump_load.h"
+#include "table/block_based/block_based_table_reader.h"
+#include "table/block_based/block_cache.h"
+#include "util/coding.h"
+#include "util/crc32c.h"
+#include "util/hash.h"
+#include "utilities/cache_dump_load_impl.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+const std::string kSnapshotFilePrefix = "block_cache_snapshot.";
+const std::string kTempFileSuffix = ".tmp";
+constexpr uint64_t kSnapshotMagic = 0x52dbcac4e5a9b0f1ULL;
+constexpr uint32_t kSnapshotFormatVersion = 1;
+constexpr size_t kHeaderSize = 12;
+constexpr size_t kRecordHeaderSize = 13;
+
+std::string SnapshotFileName(const std::string& dir, int shard) {
+  return dir + "/" + kSnapshotFilePrefix + std::to_string(shard);
+}
+
+bool IsSnapshotFile(const std::string& fname) {
+  return Slice(fname).starts_with(kSnapshotFilePrefix) &&
+         !Slice(fname).ends_with(kTempFileSuffix);
+}
+
+// Only data and filter blocks can be created without the table reader
+// (index blocks depend on properties of their file)
+CacheDumpUnitType GetUnitType(CacheEntryRole role) {
+  switch (role) {
+    case CacheEntryRole::kDataBlock:
+      return CacheDumpUnitType::kData;
+    case CacheEntryRole::kFilterBlock:
+      return CacheDumpUnitType::kFilter;
+    default:
+      return CacheDumpUnitType::kBlockTypeMax;
+  }
+}
+
+// A column family whose blocks are saved or loaded
+struct SnapshotColumnFamily {
+  BlockBasedTableOptions table_options;
+  BlockCreateContext create_context;
+};
+
+// Gets the column families using a block cache, and maps the cache key
+// prefix of each of their live SST files to them
+Status GetSnapshotColumnFamilies(
+    DB* db, const std::vector<ColumnFamilyHandle*>& column_families,
+    std::vector<std::unique_ptr<SnapshotColumnFamily>>* cfs,
+    std::unordered_map<std::string, SnapshotColumnFamily*>* prefixes) {
+  std::vector<ColumnFamilyHandle*> handles = column_families;
+  if (handles.empty()) {
+    handles.push_back(db->DefaultColumnFamily());
+  }
+  Statistics* statistics = db->GetDBOptions().statistics.get();
+  for (ColumnFamilyHandle* handle : handles) {
+    const Options options = db->GetOptions(handle);
+    const auto* table_options =
+        options.table_factory->GetOptions<BlockBasedTableOptions>();
+    if (table_options == nullptr || table_options->block_cache == nullptr) {
+      continue;
+    }
+    TablePropertiesCollection props;
+    Status s = db->GetPropertiesOfAllTables(handle, &props);
+    if (!s.ok()) {
+      return s;
+    }
+    cfs->emplace_back(new SnapshotColumnFamily);
+    SnapshotColumnFamily* cf = cfs->back().get();
+    cf->table_options = *table_options;
+    cf->create_context = BlockCreateContext(
+        &cf->table_options, /*ioptions=*/nullptr, statistics,
+        /*using_zstd=*/false, options.block_protection_bytes_per_key,
+        options.comparator);
+    for (const auto& file_props : props) {
+      OffsetableCacheKey base;
+      bool is_stable;
+      BlockBasedTable::SetupBaseCacheKey(file_props.second.get(),
+                                         /*cur_db_session_id*/ "",
+                                         /*cur_file_num*/ 0, &base,
+                                         &is_stable);
+      if (is_stable) {
+        prefixes->emplace(base.CommonPrefixSlice().ToString(), cf);
+      }
+    }
+  }
+  return Status::OK();
+}
+
+SnapshotColumnFamily* FindColumnFamily(
+    const std::unordered_map<std::string, SnapshotColumnFamily*>& prefixes,
+    const Slice& key) {
+  if (key.size() < OffsetableCacheKey::kCommonPrefixSize) {
+    return nullptr;
+  }
+  auto it = prefixes.find(
+      std::string(key.data(), OffsetableCacheKey::kCommonPrefixSize));
+  return it != prefixes.end() ? it->second : nullptr;
+}
+
+// Writes the blocks with the given keys that are still in `cache` to a shard
+// file
+Status SaveShard(FileSystem* fs, Cache* cache,
+                 const std::vector<std::string>& keys,
+                 const std::string& fname) {
+  const std::string temp_fname = fname + kTempFileSuffix;
+  const FileOptions file_opts;
+  std::unique_ptr<FSWritableFile> file;
+  IOStatus io_s = fs->NewWritableFile(temp_fname, file_opts, &file, nullptr);
+  if (!io_s.ok()) {
+    return io_s;
+  }
+  WritableFileWriter writer(std::move(file), temp_fname, file_opts);
+  const IOOptions opts;
+
+  std::string buf;
+  PutFixed64(&buf, kSnapshotMagic);
+  PutFixed32(&buf, kSnapshotFormatVersion);
+  io_s = writer.Append(opts, buf);
+
+  for (const std::string& key : keys) {
+    if (!io_s.ok()) {
+      break;
+    }
+    Cache::Handle* handle = cache->BasicLookup(key, /*stats=*/nullptr);
+    if (handle == nullptr) {
+      // Evicted since listed
+      continue;
+    }
+    const Cache::CacheItemHelper* helper = cache->GetCacheItemHelper(handle);
+    Cache::ObjectPtr value = cache->Value(handle);
+    const size_t size = helper->size_cb(value);
+    buf.resize(kRecordHeaderSize);
+    buf.append(key);
+    buf.append(size, '\0');
+    Status s = helper->saveto_cb(value, /*from_offset=*/0, size,
+                                 &buf[kRecordHeaderSize + key.size()]);
+    const CacheDumpUnitType type = GetUnitType(helper->role);
+    cache->Release(handle);
+    if (!s.ok()) {
+      continue;
+    }
+    EncodeFixed32(&buf[4], static_cast<uint32_t>(key.size()));
+    EncodeFixed32(&buf[8], static_cast<uint32_t>(size));
+    buf[12] = static_cast<char>(type);
+    EncodeFixed32(&buf[0], crc32c::Mask(crc32c::Value(buf.data() + 4,
+                                                      buf.size() - 4)));
+    io_s = writer.Append(opts, buf);
+  }
+
+  if (io_s.ok()) {
+    io_s = writer.Sync(opts, /*use_fsync=*/false);
+  }
+  IOStatus close_s = writer.Close(opts);
+  if (io_s.ok()) {
+    io_s = close_s;
+  }
+  if (io_s.ok()) {
+    io_s = fs->RenameFile(temp_fname, fname, opts, nullptr);
+  }
+  return io_s;
+}
+
+// Reads exactly `n` bytes into `scratch`, unless at end of file
+IOStatus ReadFully(SequentialFileReader* reader, size_t n, char* scratch,
+                   bool* eof) {
+  Slice result;
+  IOStatus io_s = reader->Read(n, &result, scratch, Env::IO_TOTAL);
+  if (!io_s.ok()) {
+    return io_s;
+  }
+  *eof = result.empty();
+  if (!*eof && result.size() != n) {
+    return IOStatus::Corruption("Truncated block cache snapshot record");
+  }
+  if (!*eof && result.data() != scratch) {
+    memcpy(scratch, result.data(), n);
+  }
+  return io_s;
+}
+
+// Loads the blocks of a shard file belonging to live SST files into the block
+// cache of their column family, until that cache is full
+Status LoadShard(
+    const BlockCacheSnapshotOptions& options, FileSystem* fs,
+    const std::string& fname,
+    const std::unordered_map<std::string, SnapshotColumnFamily*>& prefixes) {
+  const FileOptions file_opts;
+  uint64_t file_size = 0;
+  IOStatus io_s = fs->GetFileSize(fname, file_opts.io_options, &file_size,
+                                  /*dbg=*/nullptr);
+  if (!io_s.ok()) {
+    return io_s;
+  }
+  std::unique_ptr<FSSequentialFile> file;
+  io_s = fs->NewSequentialFile(fname, file_opts, &file, nullptr);
+  if (!io_s.ok()) {
+    return io_s;
+  }
+  SequentialFileReader reader(std::move(file), fname, options.readahead_size);
+
+  std::string buf(kHeaderSize, '\0');
+  bool eof = false;
+  io_s = ReadFully(&reader, kHeaderSize, &buf[0], &eof);
+  if (!io_s.ok()) {
+    return io_s;
+  }
+  if (eof || DecodeFixed64(buf.data()) != kSnapshotMagic) {
+    return Status::Corruption("Not a block cache snapshot file", fname);
+  }
+  if (DecodeFixed32(buf.data() + 8) != kSnapshotFormatVersion) {
+    return Status::NotSupported("Unknown block cache snapshot version", fname);
+  }
+  // Bytes of the file not read yet
+  uint64_t remaining = file_size - kHeaderSize;
+
+  for (;;) {
+    buf.resize(kRecordHeaderSize);
+    io_s = ReadFully(&reader, kRecordHeaderSize, &buf[0], &eof);
+    if (!io_s.ok() || eof) {
+      return io_s;
+    }
+    const uint32_t checksum = crc32c::Unmask(DecodeFixed32(buf.data()));
+    const uint32_t key_size = DecodeFixed32(buf.data() + 4);
+    const uint32_t block_size = DecodeFixed32(buf.data() + 8);
+    const auto type = static_cast<CacheDumpUnitType>(buf[12]);
+    // Sizes read from the file are checked before anything is allocated for
+    // them
+    remaining -= std::min<uint64_t>(remaining, kRecordHeaderSize);
+    if (uint64_t{key_size} + block_size > remaining) {
+      return Status::Corruption("Truncated block cache snapshot record", fname);
+    }
+    remaining -= uint64_t{key_size} + block_size;
+    buf.resize(kRecordHeaderSize + size_t{key_size} + block_size);
+    io_s = ReadFully(&reader, size_t{key_size} + block_size,
+                     &buf[kRecordHeaderSize], &eof);
+    if (io_s.ok() && eof) {
+      io_s = IOStatus::Corruption("Truncated block cache snapshot record");
+    }
+    if (!io_s.ok()) {
+      return io_s;
+    }
+    if (crc32c::Value(buf.data() + 4, buf.size() - 4) != checksum) {
+      return Status::Corruption("Block cache snapshot checksum mismatch",
+                                fname);
+    }
+
+    const Slice key(buf.data() + kRecordHeaderSize, key_size);
+    const Slice block(key.data() + key_size, block_size);
+    SnapshotColumnFamily* cf = FindColumnFamily(prefixes, key);
+    if (cf == nullptr) {
+      // SST file no longer live
+      continue;
+    }
+    BlockType block_type;
+    Cache::Priority priority = Cache::Priority::LOW;
+    if (type == CacheDumpUnitType::kData) {
+      block_type = BlockType::kData;
+    } else if (type == CacheDumpUnitType::kFilter) {
+      block_type = BlockType::kFilter;
+      if (cf->table_options.cache_index_and_filter_blocks_with_high_priority) {
+        priority = Cache::Priority::HIGH;
+      }
+    } else {
+      return Status::Corruption("Unexpected block type in block cache snapshot",
+                                fname);
+    }
+
+    Cache* cache = cf->table_options.block_cache.get();
+    if (cache->GetUsage() >= cache->GetCapacity()) {
+      // Keep what was loaded rather than churn through the rest
+      return Status::OK();
+    }
+    Cache::Handle* handle = cache->BasicLookup(key, /*stats=*/nullptr);
+    if (handle != nullptr) {
+      // Already read by the DB
+      cache->Release(handle);
+      continue;
+    }
+    const Cache::CacheItemHelper* helper = GetCacheItemHelper(block_type);
+    Cache::ObjectPtr value = nullptr;
+    size_t charge = 0;
+    Status s = helper->create_cb(
+        block, kNoCompression, CacheTier::kVolatileTier, &cf->create_context,
+        cache->memory_allocator(), &value, &charge);
+    if (!s.ok()) {
+      return s;
+    }
+    if (value == nullptr) {
+      return Status::Corruption("Failed to create block from snapshot", fname);
+    }
+    s = cache->Insert(key, value, helper, charge, /*handle=*/nullptr, priority);
+    if (!s.ok()) {
+      // Full with strict capacity limit
+      helper->del_cb(value, cache->memory_allocator());
+      return Status::OK();
+    }
+  }
+}
+}  // namespace
+
+Status SaveBlockCacheSnapshot(
+    const BlockCacheSnapshotOptions& options, DB* db,
+    const std::vector<ColumnFamilyHandle*>& column_families,
+    const std::string& dir) {
+  if (options.num_shards <= 0) {
+    return Status::InvalidArgument("num_shards must be positive");
+  }
+  std::vector<std::unique_ptr<SnapshotColumnFamily>> cfs;
+  std::unordered_map<std::string, SnapshotColumnFamily*> prefixes;
+  Status s = GetSnapshotColumnFamilies(db, column_families, &cfs, &prefixes);
+  if (!s.ok()) {
+    return s;
+  }
+
+  FileSystem* fs = db->GetFileSystem();
+  const IOOptions opts;
+  s = fs->CreateDirIfMissing(dir, opts, nullptr);
+  if (!s.ok()) {
+    return s;
+  }
+  std::vector<std::string> children;
+  s = fs->GetChildren(dir, opts, &children, nullptr);
+  if (!s.ok()) {
+    return s;
+  }
+  for (const std::string& child : children) {
+    if (Slice(child).starts_with(kSnapshotFilePrefix)) {
+      s = fs->DeleteFile(dir + "/" + child, opts, nullptr);
+      if (!s.ok()) {
+        return s;
+      }
+    }
+  }
+
+  // List the blocks to save, sharded by key, from each distinct block cache.
+  // The blocks themselves are copied out by the shard threads.
+  std::vector<Cache*> caches;
+  for (const auto& cf : cfs) {
+    Cache* cache = cf->table_options.block_cache.get();
+    if (std::find(caches.begin(), caches.end(), cache) == caches.end()) {
+      caches.push_back(cache);
+    }
+  }
+  const auto num_shards = static_cast<size_t>(options.num_shards);
+  std::vector<std::vector<std::vector<std::string>>> keys(caches.size());
+  uint64_t listed_size = 0;
+  for (size_t i = 0; i < caches.size(); ++i) {
+    keys[i].resize(num_shards);
+    caches[i]->ApplyToAllEntries(
+        [&](const Slice& key, Cache::ObjectPtr value, size_t /*charge*/,
+            const Cache::CacheItemHelper* helper) {
+          if (helper == nullptr || helper->size_cb == nullptr ||
+              helper->saveto_cb == nullptr ||
+              GetUnitType(helper->role) == CacheDumpUnitType::kBlockTypeMax ||
+              FindColumnFamily(prefixes, key) == nullptr) {
+            return;
+          }
+          if (options.max_size_bytes > 0) {
+            if (listed_size >= options.max_size_bytes) {
+              return;
+            }
+            listed_size += helper->size_cb(value);
+          }
+          keys[i][GetSliceNPHash64(key) % num_shards].push_back(
+              key.ToString());
+        },
+        {});
+  }
+
+  std::vector<Status> statuses(num_shards);
+  std::vector<port::Thread> threads;
+  threads.reserve(num_shards);
+  for (size_t shard = 0; shard < num_shards; ++shard) {
+    threads.emplace_back([&, shard]() {
+      const std::string fname = SnapshotFileName(dir, static_cast<int>(shard));
+      for (size_t i = 0; i < caches.size() && statuses[shard].ok(); ++i) {
+        // One file per shard of each cache
+        const std::string part_fname =
+            caches.size() == 1 ? fname : fname + "." + std::to_string(i);
+        statuses[shard] = SaveShard(fs, caches[i], keys[i][shard], part_fname);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const Status& shard_s : statuses) {
+    if (!shard_s.ok()) {
+      return shard_s;
+    }
+  }
+  return Status::OK();
+}
+
+Status LoadBlockCacheSnapshot(
+    const BlockCacheSnapshotOptions& options, DB* db,
+    const std::vector<ColumnFamilyHandle*>& column_families,
+    const std::string& dir) {
+  std::vector<std::unique_ptr<SnapshotColumnFamily>> cfs;
+  std::unordered_map<std::string, SnapshotColumnFamily*> prefixes;
+  Status s = GetSnapshotColumnFamilies(db, column_families, &cfs, &prefixes);
+  if (!s.ok()) {
+    return s;
+  }
+
+  FileSystem* fs = db->GetFileSystem();
+  std::vector<std::string> children;
+  s = fs->GetChildren(dir, IOOptions(), &children, nullptr);
+  if (!s.ok()) {
+    return s;
+  }
+  std::vector<std::string> fnames;
+  for (const std::string& child : children) {
+    if (IsSnapshotFile(child)) {
+      fnames.push_back(dir + "/" + child);
+    }
+  }
+
+  std::vector<Status> statuses(fnames.size());
+  std::vector<port::Thread> threads;
+  threads.reserve(fnames.size());
+  for (size_t i = 0; i < fnames.size(); ++i) {
+    threads.emplace_back([&, i]() {
+      statuses[i] = LoadShard(options, fs, fnames[i], prefixes);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (const Status& shard_s : statuses) {
+    if (!shard_s.ok()) {
+      return shard_s;
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
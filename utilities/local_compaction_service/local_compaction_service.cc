@@ -0,0 +1,487 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/local_compaction_service.h"
+
+#ifndef OS_WIN
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <set>
+
+#include "db/compaction/compaction_job.h"
+#include "file/file_util.h"
+#include "file/filename.h"
+#include "port/port.h"
+#include "rocksdb/convenience.h"
+#include "rocksdb/db.h"
+#include "rocksdb/utilities/options_util.h"
+#include "util/mutexlock.h"
+#include "util/string_util.h"
+
+#ifndef OS_WIN
+extern char** environ;
+#endif
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// Files and directories of a job directory
+const char* const kInputFileName = "input";
+const char* const kResultFileName = "result";
+const char* const kOutputDirName = "output";
+const char* const kWorkerLogFileName = "worker.log";
+
+const char* const kDefaultWorkDirName = "local_compaction_jobs";
+
+#ifndef OS_WIN
+constexpr bool kWorkersSupported = true;
+#else
+constexpr bool kWorkersSupported = false;
+#endif
+
+class LocalCompactionService : public CompactionService {
+ public:
+  explicit LocalCompactionService(const LocalCompactionServiceOptions& options)
+      : options_(options), cv_(&mutex_) {}
+
+  static const char* kClassName() { return "LocalCompactionService"; }
+  const char* Name() const override { return kClassName(); }
+
+  CompactionServiceScheduleResponse Schedule(
+      const CompactionServiceJobInfo& info, const std::string& input) override;
+
+  CompactionServiceJobStatus Wait(const std::string& scheduled_job_id,
+                                  std::string* result) override;
+
+  void CancelAwaitingJobs() override;
+
+  void OnInstallation(const std::string& scheduled_job_id,
+                      CompactionServiceJobStatus status) override;
+
+ private:
+  struct Job {
+    std::string db_name;
+    std::string job_dir;
+  };
+
+  // Runs a worker for the job and waits for it to exit. Returns the result
+  // written by the worker if it succeeded, or else the status of the
+  // attempt, which is Aborted if the job was canceled.
+  Status RunWorker(const std::string& job_id, const Job& job,
+                   std::string* result);
+  // Starts a worker process with its output sent to `log_file`
+  Status SpawnWorker(const std::vector<std::string>& args,
+                     const std::string& log_file, int* pid);
+  void RemoveJob(const std::string& job_id);
+  // Removes the job directories in `work_dir` left by DB sessions that did
+  // not schedule their jobs through this service, e.g. before a crash
+  void RemoveStaleJobs(const std::string& work_dir);
+
+  const LocalCompactionServiceOptions options_;
+  std::atomic<uint64_t> next_job_number_{0};
+
+  port::Mutex mutex_;
+  port::CondVar cv_;
+  std::map<std::string, Job> jobs_;
+  // Worker processes of the jobs running
+  std::map<std::string, int> running_;
+  bool canceled_ = false;
+  // The DB sessions that scheduled jobs through this service. Job ids start
+  // with the session id.
+  std::set<std::string> sessions_;
+};
+
+CompactionServiceScheduleResponse LocalCompactionService::Schedule(
+    const CompactionServiceJobInfo& info, const std::string& input) {
+  if (!kWorkersSupported || options_.worker_command.empty() ||
+      (options_.offload_filter && !options_.offload_filter(info))) {
+    return CompactionServiceScheduleResponse(
+        CompactionServiceJobStatus::kUseLocal);
+  }
+  const std::string work_dir =
+      options_.work_dir.empty() ? info.db_name + "/" + kDefaultWorkDirName
+                                : options_.work_dir;
+  bool new_session = false;
+  {
+    MutexLock l(&mutex_);
+    new_session = sessions_.insert(info.db_session_id).second;
+  }
+  if (new_session) {
+    // The first job since the DB was opened
+    RemoveStaleJobs(work_dir);
+  }
+  // Subcompactions share the job id of their compaction
+  std::string job_id = info.db_session_id + "-" + std::to_string(info.job_id) +
+                       "-" + std::to_string(next_job_number_.fetch_add(1));
+  Job job{info.db_name, work_dir + "/" + job_id};
+
+  Env* env = options_.env;
+  Status s = env->CreateDirIfMissing(work_dir);
+  if (s.ok()) {
+    s = env->CreateDirIfMissing(job.job_dir);
+  }
+  if (s.ok()) {
+    s = WriteStringToFile(env, input, job.job_dir + "/" + kInputFileName);
+  }
+  if (!s.ok()) {
+    DestroyDir(env, job.job_dir).PermitUncheckedError();
+    return CompactionServiceScheduleResponse(
+        CompactionServiceJobStatus::kUseLocal);
+  }
+
+  MutexLock l(&mutex_);
+  if (canceled_) {
+    DestroyDir(env, job.job_dir).PermitUncheckedError();
+    return CompactionServiceScheduleResponse(
+        CompactionServiceJobStatus::kAborted);
+  }
+  jobs_.emplace(job_id, std::move(job));
+  return CompactionServiceScheduleResponse(
+      job_id, CompactionServiceJobStatus::kSuccess);
+}
+
+CompactionServiceJobStatus LocalCompactionService::Wait(
+    const std::string& scheduled_job_id, std::string* result) {
+  Job job;
+  {
+    MutexLock l(&mutex_);
+    auto it = jobs_.find(scheduled_job_id);
+    if (it == jobs_.end()) {
+      return CompactionServiceJobStatus::kFailure;
+    }
+    job = it->second;
+  }
+
+  Status s;
+  for (int attempt = 0; attempt < std::max(options_.max_attempts, 1);
+       ++attempt) {
+    result->clear();
+    s = RunWorker(scheduled_job_id, job, result);
+    if (s.ok()) {
+      // The job directory is removed once the output is installed
+      return CompactionServiceJobStatus::kSuccess;
+    }
+    if (s.IsAborted()) {
+      break;
+    }
+  }
+  RemoveJob(scheduled_job_id);
+  if (s.IsAborted()) {
+    return CompactionServiceJobStatus::kAborted;
+  }
+  if (options_.fallback_to_local) {
+    return CompactionServiceJobStatus::kUseLocal;
+  }
+  // With the status of the compaction in the result, if the worker got that
+  // far
+  return CompactionServiceJobStatus::kFailure;
+}
+
+Status LocalCompactionService::RunWorker(const std::string& job_id,
+                                         const Job& job, std::string* result) {
+  {
+    MutexLock l(&mutex_);
+    while (!canceled_ &&
+           running_.size() >= static_cast<size_t>(options_.max_workers)) {
+      cv_.Wait();
+    }
+    if (canceled_) {
+      return Status::Aborted();
+    }
+    // Reserve the worker
+    running_.emplace(job_id, 0);
+  }
+
+  // Start over from any previous attempt
+  Env* env = options_.env;
+  const std::string output_dir = job.job_dir + "/" + kOutputDirName;
+  const std::string result_file = job.job_dir + "/" + kResultFileName;
+  Status s = DestroyDir(env, output_dir);
+  if (s.ok() && env->FileExists(result_file).ok()) {
+    s = env->DeleteFile(result_file);
+  }
+
+  int pid = 0;
+  if (s.ok()) {
+    std::vector<std::string> args = options_.worker_command;
+    args.push_back("--db=" + job.db_name);
+    args.push_back("--job_dir=" + job.job_dir);
+    s = SpawnWorker(args, job.job_dir + "/" + kWorkerLogFileName, &pid);
+  }
+
+  bool canceled = false;
+  if (s.ok()) {
+    {
+      MutexLock l(&mutex_);
+      running_[job_id] = pid;
+      canceled = canceled_;
+    }
+#ifndef OS_WIN
+    if (canceled) {
+      // Canceled while starting the worker
+      kill(pid, SIGTERM);
+    }
+    int wstatus = 0;
+    while (waitpid(pid, &wstatus, 0) < 0) {
+      if (errno != EINTR) {
+        s = Status::IOError("waitpid", errnoStr(errno).c_str());
+        break;
+      }
+    }
+    if (s.ok() && !(WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0)) {
+      s = Status::Incomplete("Compaction worker failed with wait status " +
+                             std::to_string(wstatus));
+    }
+#endif  // !OS_WIN
+  }
+
+  {
+    MutexLock l(&mutex_);
+    running_.erase(job_id);
+    canceled = canceled || canceled_;
+    cv_.SignalAll();
+  }
+  if (canceled) {
+    return Status::Aborted();
+  }
+  // The worker may leave a result with the status of a failed compaction
+  Status read_s = ReadFileToString(env, result_file, result);
+  if (s.ok()) {
+    s = read_s;
+  } else {
+    read_s.PermitUncheckedError();
+  }
+  return s;
+}
+
+Status LocalCompactionService::SpawnWorker(const std::vector<std::string>& args,
+                                           const std::string& log_file,
+                                           int* pid) {
+#ifndef OS_WIN
+  std::vector<char*> argv;
+  argv.reserve(args.size() + 1);
+  for (const auto& arg : args) {
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  }
+  argv.push_back(nullptr);
+
+  posix_spawn_file_actions_t actions;
+  int err = posix_spawn_file_actions_init(&actions);
+  if (err != 0) {
+    return Status::IOError("posix_spawn_file_actions_init",
+                           errnoStr(err).c_str());
+  }
+  err = posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO,
+                                         log_file.c_str(),
+                                         O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (err == 0) {
+    err = posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO,
+                                           STDERR_FILENO);
+  }
+  pid_t child = 0;
+  if (err == 0) {
+    err = posix_spawnp(&child, argv[0], &actions, nullptr, argv.data(),
+                       environ);
+  }
+  posix_spawn_file_actions_destroy(&actions);
+  if (err != 0) {
+    return Status::IOError("Starting compaction worker " + args[0],
+                           errnoStr(err).c_str());
+  }
+  *pid = static_cast<int>(child);
+  return Status::OK();
+#else
+  (void)args;
+  (void)log_file;
+  (void)pid;
+  return Status::NotSupported("Compaction worker processes");
+#endif  // !OS_WIN
+}
+
+void LocalCompactionService::CancelAwaitingJobs() {
+  MutexLock l(&mutex_);
+  canceled_ = true;
+#ifndef OS_WIN
+  for (const auto& worker : running_) {
+    if (worker.second > 0) {
+      kill(worker.second, SIGTERM);
+    }
+  }
+#endif  // !OS_WIN
+  cv_.SignalAll();
+}
+
+void LocalCompactionService::OnInstallation(
+    const std::string& scheduled_job_id,
+    CompactionServiceJobStatus /*status*/) {
+  RemoveJob(scheduled_job_id);
+}
+
+void LocalCompactionService::RemoveJob(const std::string& job_id) {
+  std::string job_dir;
+  {
+    MutexLock l(&mutex_);
+    auto it = jobs_.find(job_id);
+    if (it == jobs_.end()) {
+      return;
+    }
+    job_dir = std::move(it->second.job_dir);
+    jobs_.erase(it);
+  }
+  DestroyDir(options_.env, job_dir).PermitUncheckedError();
+}
+
+void LocalCompactionService::RemoveStaleJobs(const std::string& work_dir) {
+  Env* env = options_.env;
+  std::vector<std::string> children;
+  Status s = env->GetChildren(work_dir, &children);
+  if (!s.ok()) {
+    // Missing if no job has run yet
+    s.PermitUncheckedError();
+    return;
+  }
+  // Listed before checking the sessions, so that the job directories of a
+  // session that is new since then are not taken as stale
+  std::vector<std::string> stale;
+  {
+    MutexLock l(&mutex_);
+    for (const std::string& child : children) {
+      if (sessions_.count(child.substr(0, child.find('-'))) == 0) {
+        stale.push_back(child);
+      }
+    }
+  }
+  for (const std::string& child : stale) {
+    DestroyDir(env, work_dir + "/" + child).PermitUncheckedError();
+  }
+}
+}  // namespace
+
+std::shared_ptr<CompactionService> NewLocalCompactionService(
+    const LocalCompactionServiceOptions& options) {
+  return std::make_shared<LocalCompactionService>(options);
+}
+
+Status RunLocalCompactionServiceJob(
+    const std::string& db_name, const std::string& job_dir,
+    CompactionServiceOptionsOverride override_options) {
+  Env* env = override_options.env;
+  std::string input;
+  Status s = ReadFileToString(env, job_dir + "/" + kInputFileName, &input);
+  if (!s.ok()) {
+    return s;
+  }
+  CompactionServiceInput compaction_input;
+  s = CompactionServiceInput::Read(input, &compaction_input);
+  if (!s.ok()) {
+    return s;
+  }
+
+  // Take the options not serializable in the options map from the OPTIONS
+  // file the compaction was picked with
+  ConfigOptions config_options;
+  config_options.env = env;
+  config_options.ignore_unknown_options = true;
+  DBOptions db_options;
+  std::vector<ColumnFamilyDescriptor> column_families;
+  s = LoadOptionsFromFile(
+      config_options,
+      OptionsFileName(db_name, compaction_input.options_file_number),
+      &db_options, &column_families);
+  if (!s.ok()) {
+    return s;
+  }
+  for (const auto& cf : column_families) {
+    if (cf.name != compaction_input.cf_name) {
+      continue;
+    }
+    if (override_options.comparator == BytewiseComparator()) {
+      override_options.comparator = cf.options.comparator;
+    }
+    if (override_options.merge_operator == nullptr) {
+      override_options.merge_operator = cf.options.merge_operator;
+    }
+    if (override_options.compaction_filter_factory == nullptr) {
+      override_options.compaction_filter_factory =
+          cf.options.compaction_filter_factory;
+    }
+    if (override_options.prefix_extractor == nullptr) {
+      override_options.prefix_extractor = cf.options.prefix_extractor;
+    }
+    if (override_options.table_factory == nullptr) {
+      override_options.table_factory = cf.options.table_factory;
+    }
+    if (override_options.sst_partitioner_factory == nullptr) {
+      override_options.sst_partitioner_factory =
+          cf.options.sst_partitioner_factory;
+    }
+    if (override_options.table_properties_collector_factories.empty()) {
+      override_options.table_properties_collector_factories =
+          cf.options.table_properties_collector_factories;
+    }
+    break;
+  }
+
+  std::string output;
+  s = DB::OpenAndCompact(db_name, job_dir + "/" + kOutputDirName, input,
+                         &output, override_options);
+  if (!output.empty()) {
+    // Written atomically, so that a result is never seen partially
+    const std::string result_file = job_dir + "/" + kResultFileName;
+    Status write_s =
+        WriteStringToFile(env, output, result_file + ".tmp", true);
+    if (write_s.ok()) {
+      write_s = env->RenameFile(result_file + ".tmp", result_file);
+    }
+    if (s.ok()) {
+      s = write_s;
+    } else {
+      write_s.PermitUncheckedError();
+    }
+  }
+  return s;
+}
+
+int LocalCompactionServiceWorkerMain(
+    int argc, char** argv,
+    const CompactionServiceOptionsOverride& override_options) {
+  static const std::string kDbFlag = "--db=";
+  static const std::string kJobDirFlag = "--job_dir=";
+  std::string db_name;
+  std::string job_dir;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg.compare(0, kDbFlag.size(), kDbFlag) == 0) {
+      db_name = arg.substr(kDbFlag.size());
+    } else if (arg.compare(0, kJobDirFlag.size(), kJobDirFlag) == 0) {
+      job_dir = arg.substr(kJobDirFlag.size());
+    }
+  }
+  if (db_name.empty() || job_dir.empty()) {
+    fprintf(stderr, "Usage: %s --db=<db name> --job_dir=<job directory>\n",
+            argv[0]);
+    return 2;
+  }
+  Status s = RunLocalCompactionServiceJob(db_name, job_dir, override_options);
+  if (!s.ok()) {
+    fprintf(stderr, "Compaction job %s failed: %s\n", job_dir.c_str(),
+            s.ToString().c_str());
+    return 1;
+  }
+  return 0;
+}
+
+}  // namespace ROCKSDB_NAMESPACE
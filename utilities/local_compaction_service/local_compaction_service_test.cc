@@ -0,0 +1,177 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/local_compaction_service.h"
+
+#include <cstring>
+#include <map>
+#include <string>
+
+#include "port/stack_trace.h"
+#include "rocksdb/db.h"
+#include "rocksdb/statistics.h"
+#include "test_util/testharness.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+// The test binary runs as the worker when given this argument
+const char* const kWorkerFlag = "--worker";
+// Makes the worker fail the first attempt of each job
+const char* const kFailFirstAttemptFlag = "--fail_first_attempt";
+
+std::string test_binary_path;
+
+int RunTestWorker(int argc, char** argv) {
+  bool fail_first_attempt = false;
+  std::string job_dir;
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], kFailFirstAttemptFlag) == 0) {
+      fail_first_attempt = true;
+    } else if (strncmp(argv[i], "--job_dir=", 10) == 0) {
+      job_dir = argv[i] + 10;
+    }
+  }
+  if (fail_first_attempt) {
+    Env* env = Env::Default();
+    const std::string marker = job_dir + "/failed_once";
+    if (env->FileExists(marker).IsNotFound()) {
+      EXPECT_OK(WriteStringToFile(env, "", marker));
+      return 1;
+    }
+  }
+  return LocalCompactionServiceWorkerMain(argc, argv);
+}
+
+#ifndef OS_WIN
+class LocalCompactionServiceTest : public testing::Test {
+ public:
+  LocalCompactionServiceTest()
+      : dbname_(test::PerThreadDBPath("local_compaction_service_test")),
+        stats_(CreateDBStatistics()) {
+    options_.create_if_missing = true;
+    options_.disable_auto_compactions = true;
+    options_.statistics = stats_;
+    EXPECT_OK(DestroyDB(dbname_, options_));
+    service_options_.worker_command = {test_binary_path, kWorkerFlag};
+  }
+
+  ~LocalCompactionServiceTest() override {
+    if (db_ != nullptr) {
+      EXPECT_OK(db_->Close());
+      db_.reset();
+    }
+    EXPECT_OK(DestroyDB(dbname_, options_));
+  }
+
+  // Writes overlapping L0 files and compacts them into L1
+  void WriteAndCompact() {
+    options_.compaction_service = NewLocalCompactionService(service_options_);
+    ASSERT_OK(DB::Open(options_, dbname_, &db_));
+    for (int f = 1; f <= 3; f++) {
+      for (int i = 0; i < 300; i += f) {
+        std::string key = "key" + std::to_string(1000 + i);
+        expected_[key] = "value" + std::to_string(f) + "_" + std::to_string(i);
+        ASSERT_OK(db_->Put(WriteOptions(), key, expected_[key]));
+      }
+      ASSERT_OK(db_->Flush(FlushOptions()));
+    }
+    ASSERT_OK(db_->CompactRange(CompactRangeOptions(), nullptr, nullptr));
+  }
+
+  void Verify() {
+    std::string num_l0_files;
+    ASSERT_TRUE(
+        db_->GetProperty("rocksdb.num-files-at-level0", &num_l0_files));
+    ASSERT_EQ("0", num_l0_files);
+    for (const auto& kv : expected_) {
+      std::string value;
+      ASSERT_OK(db_->Get(ReadOptions(), kv.first, &value));
+      ASSERT_EQ(kv.second, value);
+    }
+    // No job left behind
+    std::vector<std::string> jobs;
+    Status s = Env::Default()->GetChildren(dbname_ + "/local_compaction_jobs",
+                                           &jobs);
+    ASSERT_TRUE(s.ok() || s.IsNotFound());
+    ASSERT_TRUE(jobs.empty());
+  }
+
+  uint64_t RemoteReadBytes() {
+    return stats_->getTickerCount(REMOTE_COMPACT_READ_BYTES);
+  }
+
+  std::string dbname_;
+  std::shared_ptr<Statistics> stats_;
+  Options options_;
+  LocalCompactionServiceOptions service_options_;
+  std::unique_ptr<DB> db_;
+  std::map<std::string, std::string> expected_;
+};
+
+TEST_F(LocalCompactionServiceTest, CompactsInWorker) {
+  WriteAndCompact();
+  Verify();
+  ASSERT_GT(RemoteReadBytes(), 0);
+}
+
+TEST_F(LocalCompactionServiceTest, RetriesFailedWorker) {
+  service_options_.worker_command.push_back(kFailFirstAttemptFlag);
+  service_options_.max_attempts = 2;
+  WriteAndCompact();
+  Verify();
+  ASSERT_GT(RemoteReadBytes(), 0);
+}
+
+TEST_F(LocalCompactionServiceTest, FallsBackToLocal) {
+  service_options_.worker_command.push_back(kFailFirstAttemptFlag);
+  service_options_.max_attempts = 1;
+  WriteAndCompact();
+  Verify();
+  ASSERT_EQ(0, RemoteReadBytes());
+}
+
+TEST_F(LocalCompactionServiceTest, RemovesStaleJobs) {
+  // A job directory left by an earlier run of the DB
+  Env* env = Env::Default();
+  const std::string stale_job_dir =
+      dbname_ + "/local_compaction_jobs/STALESESSION-1-0";
+  ASSERT_OK(env->CreateDirIfMissing(dbname_));
+  ASSERT_OK(env->CreateDirIfMissing(dbname_ + "/local_compaction_jobs"));
+  ASSERT_OK(env->CreateDirIfMissing(stale_job_dir));
+  ASSERT_OK(WriteStringToFile(env, "", stale_job_dir + "/input"));
+  WriteAndCompact();
+  Verify();
+  ASSERT_GT(RemoteReadBytes(), 0);
+}
+
+TEST_F(LocalCompactionServiceTest, OffloadFilter) {
+  // Compacts into L1 rather than the last level
+  options_.level_compaction_dynamic_level_bytes = false;
+  int num_filtered = 0;
+  service_options_.offload_filter =
+      [&](const CompactionServiceJobInfo& info) {
+        num_filtered++;
+        return info.output_level > 1;
+      };
+  WriteAndCompact();
+  Verify();
+  ASSERT_GT(num_filtered, 0);
+  ASSERT_EQ(0, RemoteReadBytes());
+}
+#endif  // !OS_WIN
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  for (int i = 1; i < argc; ++i) {
+    if (strcmp(argv[i], ROCKSDB_NAMESPACE::kWorkerFlag) == 0) {
+      return ROCKSDB_NAMESPACE::RunTestWorker(argc, argv);
+    }
+  }
+  ROCKSDB_NAMESPACE::test_binary_path = argv[0];
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,273 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/memory_tuner.h"
+
+#include <algorithm>
+
+#include "monitoring/statistics_impl.h"
+#include "port/port.h"
+#include "util/timer.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+namespace {
+// A move between the caches needs the gain to exceed the loss by this factor,
+// so that noise does not make budget flip back and forth
+constexpr double kMinGainRatio = 1.25;
+
+class MemoryTunerImpl : public MemoryTuner {
+ public:
+  explicit MemoryTunerImpl(const MemoryTunerOptions& options)
+      : options_(options),
+        min_budget_(static_cast<size_t>(options.total_budget *
+                                        options.min_fraction)) {
+    write_buffer_budget_ = options_.write_buffer_manager != nullptr
+                               ? options_.write_buffer_manager->buffer_size()
+                               : 0;
+    if (options_.secondary_cache != nullptr) {
+      options_.secondary_cache->GetCapacity(secondary_cache_budget_)
+          .PermitUncheckedError();
+    }
+    block_cache_budget_ =
+        options_.total_budget - write_buffer_budget_ - secondary_cache_budget_;
+    options_.block_cache->SetCapacity(block_cache_budget_);
+    options_.block_cache->SetSimCapacity(block_cache_budget_ +
+                                         options_.step_size);
+    ReadCounters(&last_counters_);
+
+    if (options_.tune_period_sec > 0) {
+      timer_.reset(new Timer(options_.clock != nullptr
+                                 ? options_.clock.get()
+                                 : SystemClock::Default().get()));
+      const uint64_t period_us = options_.tune_period_sec * 1000000;
+      timer_->Add([this]() { TuneOnce(); }, "MemoryTuner", period_us,
+                  period_us);
+      timer_->Start();
+    }
+  }
+
+  ~MemoryTunerImpl() override {
+    if (timer_ != nullptr) {
+      timer_->Shutdown();
+    }
+  }
+
+  void TuneOnce() override;
+
+  size_t GetBlockCacheBudget() const override {
+    MutexLock l(&mutex_);
+    return block_cache_budget_;
+  }
+  size_t GetWriteBufferBudget() const override {
+    MutexLock l(&mutex_);
+    return write_buffer_budget_;
+  }
+  size_t GetSecondaryCacheBudget() const override {
+    MutexLock l(&mutex_);
+    return secondary_cache_budget_;
+  }
+
+ private:
+  enum Consumer { kBlockCache, kWriteBuffer, kSecondaryCache };
+
+  struct Counters {
+    uint64_t block_cache_hits = 0;
+    uint64_t sim_block_cache_hits = 0;
+    uint64_t secondary_cache_hits = 0;
+    uint64_t stall_micros = 0;
+  };
+
+  void ReadCounters(Counters* counters) const {
+    Statistics* stats = options_.statistics.get();
+    counters->block_cache_hits = stats->getTickerCount(BLOCK_CACHE_HIT);
+    counters->sim_block_cache_hits = options_.block_cache->get_hit_counter();
+    counters->secondary_cache_hits =
+        stats->getTickerCount(SECONDARY_CACHE_HITS);
+    counters->stall_micros = stats->getTickerCount(STALL_MICROS);
+  }
+
+  size_t* Budget(Consumer consumer) {
+    switch (consumer) {
+      case kBlockCache:
+        return &block_cache_budget_;
+      case kWriteBuffer:
+        return &write_buffer_budget_;
+      case kSecondaryCache:
+        return &secondary_cache_budget_;
+    }
+    return nullptr;
+  }
+
+  bool CanShrink(Consumer consumer) {
+    const size_t budget = *Budget(consumer);
+    return budget > 0 && budget >= min_budget_ + options_.step_size;
+  }
+
+  // Moves `step_size` of budget, applying the new sizes and recording the
+  // decision
+  // REQUIRES: mutex_ held
+  void Move(Consumer from, Consumer to);
+
+  // REQUIRES: mutex_ held
+  void Apply(Consumer consumer);
+
+  MemoryTunerOptions options_;
+  const size_t min_budget_;
+  std::unique_ptr<Timer> timer_;
+
+  mutable port::Mutex mutex_;
+  size_t block_cache_budget_ = 0;
+  size_t write_buffer_budget_ = 0;
+  size_t secondary_cache_budget_ = 0;
+  Counters last_counters_;
+};
+
+void MemoryTunerImpl::TuneOnce() {
+  MutexLock l(&mutex_);
+  Statistics* stats = options_.statistics.get();
+  RecordTick(stats, MEMORY_TUNER_ROUNDS);
+
+  Counters counters;
+  ReadCounters(&counters);
+  const Counters last = last_counters_;
+  last_counters_ = counters;
+
+  // Expected hits over the last period for one more (or one less) step of
+  // each cache
+  const uint64_t real_hits = counters.block_cache_hits - last.block_cache_hits;
+  const uint64_t sim_hits =
+      counters.sim_block_cache_hits - last.sim_block_cache_hits;
+  const double block_cache_gain =
+      sim_hits > real_hits ? static_cast<double>(sim_hits - real_hits) : 0.0;
+  double secondary_cache_gain = 0.0;
+  if (secondary_cache_budget_ > 0) {
+    secondary_cache_gain =
+        static_cast<double>(counters.secondary_cache_hits -
+                            last.secondary_cache_hits) *
+        static_cast<double>(options_.step_size) /
+        static_cast<double>(secondary_cache_budget_);
+  }
+  const bool has_secondary_cache = options_.secondary_cache != nullptr;
+  // The cache losing the fewest hits when shrunk, and the one gaining the
+  // most when grown
+  Consumer cheaper_cache = kBlockCache;
+  Consumer better_cache = kBlockCache;
+  if (has_secondary_cache) {
+    if (secondary_cache_gain < block_cache_gain) {
+      cheaper_cache = kSecondaryCache;
+    } else {
+      better_cache = kSecondaryCache;
+    }
+    if (!CanShrink(cheaper_cache)) {
+      cheaper_cache = cheaper_cache == kBlockCache ? kSecondaryCache
+                                                   : kBlockCache;
+    }
+  }
+
+  if (options_.write_buffer_manager != nullptr) {
+    const bool stalled = counters.stall_micros > last.stall_micros;
+    if (stalled) {
+      if (CanShrink(cheaper_cache)) {
+        Move(cheaper_cache, kWriteBuffer);
+      }
+      return;
+    }
+    if (options_.write_buffer_manager->memory_usage() <
+            write_buffer_budget_ / 2 &&
+        CanShrink(kWriteBuffer)) {
+      Move(kWriteBuffer, better_cache);
+      return;
+    }
+  }
+
+  if (has_secondary_cache) {
+    if (block_cache_gain > secondary_cache_gain * kMinGainRatio &&
+        CanShrink(kSecondaryCache)) {
+      Move(kSecondaryCache, kBlockCache);
+    } else if (secondary_cache_gain > block_cache_gain * kMinGainRatio &&
+               CanShrink(kBlockCache)) {
+      Move(kBlockCache, kSecondaryCache);
+    }
+  }
+}
+
+void MemoryTunerImpl::Move(Consumer from, Consumer to) {
+  static const Tickers kGrownTickers[] = {
+      MEMORY_TUNER_BLOCK_CACHE_GROWN_BYTES,
+      MEMORY_TUNER_WRITE_BUFFER_GROWN_BYTES,
+      MEMORY_TUNER_SECONDARY_CACHE_GROWN_BYTES};
+  static const Tickers kShrunkTickers[] = {
+      MEMORY_TUNER_BLOCK_CACHE_SHRUNK_BYTES,
+      MEMORY_TUNER_WRITE_BUFFER_SHRUNK_BYTES,
+      MEMORY_TUNER_SECONDARY_CACHE_SHRUNK_BYTES};
+
+  // Shrink first, so that the total stays within the budget
+  *Budget(from) -= options_.step_size;
+  Apply(from);
+  *Budget(to) += options_.step_size;
+  Apply(to);
+  RecordTick(options_.statistics.get(), kShrunkTickers[from],
+             options_.step_size);
+  RecordTick(options_.statistics.get(), kGrownTickers[to], options_.step_size);
+}
+
+void MemoryTunerImpl::Apply(Consumer consumer) {
+  switch (consumer) {
+    case kBlockCache:
+      options_.block_cache->SetCapacity(block_cache_budget_);
+      options_.block_cache->SetSimCapacity(block_cache_budget_ +
+                                           options_.step_size);
+      break;
+    case kWriteBuffer:
+      options_.write_buffer_manager->SetBufferSize(write_buffer_budget_);
+      break;
+    case kSecondaryCache:
+      options_.secondary_cache->SetCapacity(secondary_cache_budget_)
+          .PermitUncheckedError();
+      break;
+  }
+}
+}  // namespace
+
+Status NewMemoryTuner(const MemoryTunerOptions& options,
+                      std::unique_ptr<MemoryTuner>* tuner) {
+  if (options.block_cache == nullptr) {
+    return Status::InvalidArgument("block_cache must be a SimCache");
+  }
+  if (options.statistics == nullptr) {
+    return Status::InvalidArgument("statistics is required");
+  }
+  if (options.write_buffer_manager != nullptr &&
+      !options.write_buffer_manager->enabled()) {
+    return Status::InvalidArgument("write_buffer_manager must be enabled");
+  }
+  if (options.step_size == 0 || options.min_fraction < 0 ||
+      options.min_fraction >= 1.0 / 3) {
+    return Status::InvalidArgument(
+        "step_size must be positive and min_fraction in [0, 1/3)");
+  }
+  size_t used = 0;
+  if (options.write_buffer_manager != nullptr) {
+    used += options.write_buffer_manager->buffer_size();
+  }
+  if (options.secondary_cache != nullptr) {
+    size_t capacity = 0;
+    Status s = options.secondary_cache->GetCapacity(capacity);
+    if (!s.ok()) {
+      return s;
+    }
+    used += capacity;
+  }
+  if (used >= options.total_budget) {
+    return Status::InvalidArgument(
+        "total_budget must exceed the sizes of the memtables and secondary "
+        "cache");
+  }
+  tuner->reset(new MemoryTunerImpl(options));
+  return Status::OK();
+}
+
+}  // namespace ROCKSDB_NAMESPACE
@@ -0,0 +1,169 @@
+//  Copyright (c) Meta Platforms, Inc. and affiliates.
+//  This source code is licensed under both the GPLv2 (found in the
+//  COPYING file in the root directory) and Apache 2.0 License
+//  (found in the LICENSE.Apache file in the root directory).
+
+#include "rocksdb/utilities/memory_tuner.h"
+
+#include <string>
+
+#include "port/stack_trace.h"
+#include "rocksdb/cache.h"
+#include "test_util/testharness.h"
+
+namespace ROCKSDB_NAMESPACE {
+
+class MemoryTunerTest : public testing::Test {
+ public:
+  static constexpr size_t kMB = 1 << 20;
+
+  MemoryTunerTest() : stats_(CreateDBStatistics()) {
+    LRUCacheOptions lru_opts;
+    lru_opts.capacity = 64 * kMB;
+    lru_opts.num_shard_bits = 0;
+    lru_opts.metadata_charge_policy = kDontChargeCacheMetadata;
+    block_cache_ = NewSimCache(NewLRUCache(lru_opts), 64 * kMB,
+                               /*num_shard_bits=*/0);
+
+    options_.total_budget = 128 * kMB;
+    options_.block_cache = block_cache_;
+    options_.statistics = stats_;
+    options_.step_size = 8 * kMB;
+    options_.tune_period_sec = 0;
+  }
+
+  std::unique_ptr<MemoryTuner> NewTuner() {
+    std::unique_ptr<MemoryTuner> tuner;
+    EXPECT_OK(NewMemoryTuner(options_, &tuner));
+    return tuner;
+  }
+
+  void CheckBudgets(MemoryTuner* tuner, size_t block_cache,
+                    size_t write_buffer, size_t secondary_cache) {
+    ASSERT_EQ(block_cache, tuner->GetBlockCacheBudget());
+    ASSERT_EQ(write_buffer, tuner->GetWriteBufferBudget());
+    ASSERT_EQ(secondary_cache, tuner->GetSecondaryCacheBudget());
+    ASSERT_EQ(block_cache, block_cache_->GetCapacity());
+    ASSERT_EQ(block_cache + options_.step_size,
+              block_cache_->GetSimCapacity());
+    if (options_.write_buffer_manager != nullptr) {
+      ASSERT_EQ(write_buffer, options_.write_buffer_manager->buffer_size());
+    }
+    if (options_.secondary_cache != nullptr) {
+      size_t capacity = 0;
+      ASSERT_OK(options_.secondary_cache->GetCapacity(capacity));
+      ASSERT_EQ(secondary_cache, capacity);
+    }
+  }
+
+ protected:
+  std::shared_ptr<Statistics> stats_;
+  std::shared_ptr<SimCache> block_cache_;
+  MemoryTunerOptions options_;
+};
+
+TEST_F(MemoryTunerTest, InvalidOptions) {
+  std::unique_ptr<MemoryTuner> tuner;
+  MemoryTunerOptions opts = options_;
+  opts.block_cache = nullptr;
+  ASSERT_TRUE(NewMemoryTuner(opts, &tuner).IsInvalidArgument());
+  opts = options_;
+  opts.statistics = nullptr;
+  ASSERT_TRUE(NewMemoryTuner(opts, &tuner).IsInvalidArgument());
+  opts = options_;
+  opts.write_buffer_manager = std::make_shared<WriteBufferManager>(0);
+  ASSERT_TRUE(NewMemoryTuner(opts, &tuner).IsInvalidArgument());
+  opts = options_;
+  opts.write_buffer_manager =
+      std::make_shared<WriteBufferManager>(opts.total_budget);
+  ASSERT_TRUE(NewMemoryTuner(opts, &tuner).IsInvalidArgument());
+  opts = options_;
+  opts.min_fraction = 0.5;
+  ASSERT_TRUE(NewMemoryTuner(opts, &tuner).IsInvalidArgument());
+  ASSERT_EQ(nullptr, tuner);
+}
+
+TEST_F(MemoryTunerTest, WriteStallsGrowMemtables) {
+  options_.write_buffer_manager =
+      std::make_shared<WriteBufferManager>(32 * kMB);
+  std::unique_ptr<MemoryTuner> tuner = NewTuner();
+  // The rest of the total goes to the block cache
+  CheckBudgets(tuner.get(), 96 * kMB, 32 * kMB, 0);
+
+  stats_->recordTick(STALL_MICROS, 1000);
+  tuner->TuneOnce();
+  CheckBudgets(tuner.get(), 88 * kMB, 40 * kMB, 0);
+  ASSERT_EQ(1U, stats_->getTickerCount(MEMORY_TUNER_ROUNDS));
+  ASSERT_EQ(8 * kMB,
+            stats_->getTickerCount(MEMORY_TUNER_BLOCK_CACHE_SHRUNK_BYTES));
+  ASSERT_EQ(8 * kMB,
+            stats_->getTickerCount(MEMORY_TUNER_WRITE_BUFFER_GROWN_BYTES));
+
+  // The block cache keeps its minimum size
+  for (int i = 0; i < 20; ++i) {
+    stats_->recordTick(STALL_MICROS, 1000);
+    tuner->TuneOnce();
+  }
+  CheckBudgets(tuner.get(), 16 * kMB, 112 * kMB, 0);
+  ASSERT_EQ(21U, stats_->getTickerCount(MEMORY_TUNER_ROUNDS));
+
+  // Without stalls, unused memtable budget goes back to the block cache
+  tuner->TuneOnce();
+  CheckBudgets(tuner.get(), 24 * kMB, 104 * kMB, 0);
+  ASSERT_EQ(8 * kMB,
+            stats_->getTickerCount(MEMORY_TUNER_BLOCK_CACHE_GROWN_BYTES));
+}
+
+TEST_F(MemoryTunerTest, BalanceCaches) {
+  CompressedSecondaryCacheOptions sec_opts;
+  sec_opts.capacity = 32 * kMB;
+  sec_opts.compression_type = kNoCompression;
+  options_.secondary_cache = NewCompressedSecondaryCache(sec_opts);
+  std::unique_ptr<MemoryTuner> tuner = NewTuner();
+  CheckBudgets(tuner.get(), 96 * kMB, 0, 32 * kMB);
+
+  // Nothing happened, nothing moves
+  tuner->TuneOnce();
+  CheckBudgets(tuner.get(), 96 * kMB, 0, 32 * kMB);
+
+  // Hits in the secondary cache, none that the ghost cache would add to the
+  // block cache
+  stats_->recordTick(SECONDARY_CACHE_HITS, 100);
+  tuner->TuneOnce();
+  CheckBudgets(tuner.get(), 88 * kMB, 0, 40 * kMB);
+  ASSERT_EQ(8 * kMB,
+            stats_->getTickerCount(MEMORY_TUNER_SECONDARY_CACHE_GROWN_BYTES));
+
+  // A working set slightly over the block cache capacity, which the ghost
+  // cache would hold. (The helper outlives the test body, like the cache.)
+  static const Cache::CacheItemHelper helper(
+      CacheEntryRole::kMisc, [](Cache::ObjectPtr, MemoryAllocator*) {});
+  const int kNumKeys = 90;
+  for (int i = 0; i < kNumKeys; ++i) {
+    ASSERT_OK(block_cache_->Insert(std::to_string(i), nullptr, &helper, kMB));
+  }
+  uint64_t hits = 0;
+  for (int i = 0; i < kNumKeys; ++i) {
+    Cache::Handle* handle = block_cache_->BasicLookup(std::to_string(i),
+                                                      /*stats=*/nullptr);
+    if (handle != nullptr) {
+      ++hits;
+      block_cache_->Release(handle);
+    }
+  }
+  ASSERT_LT(hits, static_cast<uint64_t>(kNumKeys));
+  stats_->recordTick(BLOCK_CACHE_HIT, hits);
+  tuner->TuneOnce();
+  CheckBudgets(tuner.get(), 96 * kMB, 0, 32 * kMB);
+  ASSERT_EQ(8 * kMB,
+            stats_->getTickerCount(MEMORY_TUNER_BLOCK_CACHE_GROWN_BYTES));
+  ASSERT_EQ(3U, stats_->getTickerCount(MEMORY_TUNER_ROUNDS));
+}
+
+}  // namespace ROCKSDB_NAMESPACE
+
+int main(int argc, char** argv) {
+  ROCKSDB_NAMESPACE::port::InstallStackTraceHandler();
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}